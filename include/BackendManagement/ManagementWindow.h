@@ -36,6 +36,7 @@ signals:
 public slots:
     void showAndRaise();
     void refreshWidgetList();
+    void onWidgetsChanged(const WidgetChangeSet& changes);
 
 private slots:
     void onCreateWidget();
@@ -0,0 +1,118 @@
+#pragma once
+#include <QFlags>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <initializer_list>
+#include "Common/Types.h"
+
+// 配置的可独立应用的方面
+enum class ConfigAspect : quint32 {
+    None           = 0,
+    Identity       = 1 << 0,  // id、名称
+    Position       = 1 << 1,
+    Size           = 1 << 2,
+    Opacity        = 1 << 3,
+    WindowFlags    = 1 << 4,  // 置顶、置底、防止最小化、鼠标穿透
+    Locked         = 1 << 5,
+    UpdateInterval = 1 << 6,
+    AutoStart      = 1 << 7,
+    CustomSettings = 1 << 8,
+    All            = 0x1FF
+};
+Q_DECLARE_FLAGS(ConfigAspects, ConfigAspect)
+Q_DECLARE_OPERATORS_FOR_FLAGS(ConfigAspects)
+
+// 新旧WidgetConfig之间的差异
+struct ConfigDelta {
+    ConfigAspects aspects;
+    QSet<QString> changedCustomKeys;  // 新增、删除或值改变的customSettings键
+    bool allCustomKeys;               // 为true时视为所有customSettings键都已改变
+
+    ConfigDelta() : aspects(ConfigAspect::None), allCustomKeys(false) {}
+
+    bool isEmpty() const { return aspects == ConfigAspects(ConfigAspect::None); }
+    bool has(ConfigAspect aspect) const { return aspects.testFlag(aspect); }
+    bool onlyHas(ConfigAspects mask) const { return !isEmpty() && (aspects & ~mask) == ConfigAspects(); }
+
+    bool customKeyChanged(const QString& key) const {
+        return allCustomKeys || changedCustomKeys.contains(key);
+    }
+
+    bool anyCustomKeyChanged(std::initializer_list<const char*> keys) const {
+        if (allCustomKeys) {
+            return true;
+        }
+        for (const char* key : keys) {
+            if (changedCustomKeys.contains(QString::fromLatin1(key))) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 完整应用（首次应用配置或外部直接调用applyConfig时使用）
+    static ConfigDelta all() {
+        ConfigDelta delta;
+        delta.aspects = ConfigAspect::All;
+        delta.allCustomKeys = true;
+        return delta;
+    }
+
+    static ConfigDelta between(const WidgetConfig& oldConfig, const WidgetConfig& newConfig) {
+        ConfigDelta delta;
+
+        if (oldConfig.id != newConfig.id || oldConfig.name != newConfig.name) {
+            delta.aspects |= ConfigAspect::Identity;
+        }
+        if (oldConfig.position != newConfig.position) {
+            delta.aspects |= ConfigAspect::Position;
+        }
+        if (oldConfig.size != newConfig.size) {
+            delta.aspects |= ConfigAspect::Size;
+        }
+        if (!qFuzzyCompare(oldConfig.opacity, newConfig.opacity)) {
+            delta.aspects |= ConfigAspect::Opacity;
+        }
+        if (oldConfig.alwaysOnTop != newConfig.alwaysOnTop ||
+            oldConfig.alwaysOnBottom != newConfig.alwaysOnBottom ||
+            oldConfig.avoidMinimizeAll != newConfig.avoidMinimizeAll ||
+            oldConfig.clickThrough != newConfig.clickThrough) {
+            delta.aspects |= ConfigAspect::WindowFlags;
+        }
+        if (oldConfig.locked != newConfig.locked) {
+            delta.aspects |= ConfigAspect::Locked;
+        }
+        if (oldConfig.updateInterval != newConfig.updateInterval) {
+            delta.aspects |= ConfigAspect::UpdateInterval;
+        }
+        if (oldConfig.autoStart != newConfig.autoStart) {
+            delta.aspects |= ConfigAspect::AutoStart;
+        }
+
+        // 逐键比较customSettings
+        const QJsonObject& oldSettings = oldConfig.customSettings;
+        const QJsonObject& newSettings = newConfig.customSettings;
+        for (auto it = newSettings.constBegin(); it != newSettings.constEnd(); ++it) {
+            auto oldIt = oldSettings.constFind(it.key());
+            if (oldIt == oldSettings.constEnd() || oldIt.value() != it.value()) {
+                delta.changedCustomKeys.insert(it.key());
+            }
+        }
+        for (auto it = oldSettings.constBegin(); it != oldSettings.constEnd(); ++it) {
+            if (!newSettings.contains(it.key())) {
+                delta.changedCustomKeys.insert(it.key());
+            }
+        }
+
+        if (!delta.changedCustomKeys.isEmpty()) {
+            delta.aspects |= ConfigAspect::CustomSettings;
+            // 防止最小化的开关实际保存在customSettings中
+            if (delta.changedCustomKeys.contains(QStringLiteral("avoidMinimizeAll"))) {
+                delta.aspects |= ConfigAspect::WindowFlags;
+            }
+        }
+
+        return delta;
+    }
+};
@@ -4,8 +4,10 @@
 #include <QSize>
 #include <QRect>
 #include <QString>
+#include <QStringList>
 #include <QJsonObject>
 #include <QTimer>
+#include <QFlags>
 #include <memory>
 #include <vector>
 #include <map>
@@ -51,6 +53,7 @@ enum class WidgetStatus {
 struct WidgetConfig {
     QString id;
     WidgetType type;
+    QString pluginKey;  // 外部插件的类型标识，仅WidgetType::Custom使用
     QString name;
     QPoint position;
     QSize size;
@@ -78,6 +81,105 @@ struct WidgetConfig {
         locked(false) {}  // 默认不锁定
 };
 
+// 单次拖拽的统计信息
+struct DragStats {
+    int mouseEventCount;    // 本次拖拽收到的鼠标移动事件数
+    int frameCount;         // 实际移动窗口的帧数
+    qint64 durationMs;      // 拖拽持续时间（毫秒）
+    double avgLatencyMs;    // 鼠标事件到窗口移动的平均延迟（毫秒）
+    double maxLatencyMs;    // 最大延迟（毫秒）
+
+    DragStats() :
+        mouseEventCount(0),
+        frameCount(0),
+        durationMs(0),
+        avgLatencyMs(0.0),
+        maxLatencyMs(0.0) {}
+};
+
+// 小组件暂停更新的原因
+enum class SuspendReason : quint32 {
+    None          = 0,
+    Obscured      = 1 << 0,  // 窗口未暴露（最小化、隐藏等）；Windows和X11上被其他窗口盖住不算
+    DisplayOff    = 1 << 1,  // 显示器已关闭
+    SessionLocked = 1 << 2   // 会话已锁定
+};
+Q_DECLARE_FLAGS(SuspendReasons, SuspendReason)
+Q_DECLARE_OPERATORS_FOR_FLAGS(SuspendReasons)
+
+// 暂停统计信息
+struct SuspendStats {
+    int suspendCount;          // 进入暂停的次数
+    qint64 totalSuspendedMs;   // 累计暂停时长（毫秒，含当前这次）
+
+    SuspendStats() :
+        suspendCount(0),
+        totalSuspendedMs(0) {}
+};
+
+// 重绘优先级：帧预算用尽时低优先级的重绘顺延到下一帧
+enum class RenderPriority {
+    Low,
+    Normal,
+    High
+};
+
+// 渲染器帧统计信息
+struct RenderStats {
+    quint64 frameCount;        // 执行过重绘的帧数
+    quint64 repaintCount;      // 实际重绘的小组件次数
+    quint64 coalescedCount;    // 同一帧内被合并的重复请求数
+    quint64 deferredCount;     // 因超出帧预算被顺延的次数
+    int budgetOverruns;        // 帧耗时超过预算的帧数
+    double lastFrameMs;        // 最近一帧的耗时（毫秒）
+    double avgFrameMs;         // 平均帧耗时（毫秒）
+    double maxFrameMs;         // 最大帧耗时（毫秒）
+
+    RenderStats() :
+        frameCount(0),
+        repaintCount(0),
+        coalescedCount(0),
+        deferredCount(0),
+        budgetOverruns(0),
+        lastFrameMs(0.0),
+        avgFrameMs(0.0),
+        maxFrameMs(0.0) {}
+};
+
+// 配置持久化统计信息
+struct ConfigStoreStats {
+    quint64 saveCount;          // 成功写盘次数
+    quint64 skippedCount;       // 没有变化而跳过的保存次数
+    quint64 failedCount;        // 写盘失败次数
+    int lastSerializedEntries;  // 最近一次保存重新序列化的小组件数
+    qint64 lastBytesWritten;    // 最近一次写入的字节数
+    quint64 totalBytesWritten;  // 累计写入的字节数
+    double lastLatencyMs;       // 最近一次保存耗时（序列化+写盘，毫秒）
+    double avgLatencyMs;        // 平均保存耗时（毫秒）
+    double maxLatencyMs;        // 最大保存耗时（毫秒）
+
+    ConfigStoreStats() :
+        saveCount(0),
+        skippedCount(0),
+        failedCount(0),
+        lastSerializedEntries(0),
+        lastBytesWritten(0),
+        totalBytesWritten(0),
+        lastLatencyMs(0.0),
+        avgLatencyMs(0.0),
+        maxLatencyMs(0.0) {}
+};
+
+// 一次批量操作中发生变化的小组件，同一小组件只出现在一个列表中
+struct WidgetChangeSet {
+    QStringList created;
+    QStringList removed;
+    QStringList updated;
+
+    bool isEmpty() const { return created.isEmpty() && removed.isEmpty() && updated.isEmpty(); }
+    int size() const { return created.size() + removed.size() + updated.size(); }
+};
+
 // 回调函数类型
 using WidgetCallback = std::function<void(const QString&)>;
 using UpdateCallback = std::function<void()>;
@@ -6,9 +6,16 @@
 #include <QContextMenuEvent>
 #include <QMenu>
 #include <QAction>
+#include <QElapsedTimer>
+#include <QPixmap>
+#include <QVector>
+#include <functional>
 #include "Common/Types.h"
+#include "Common/ConfigDelta.h"
+#include "Framework/WidgetFramework.h"
+#include "Framework/FrameworkExport.h"
 
-class BaseWidget : public QWidget {
+class UWIDGET_FRAMEWORK_EXPORT BaseWidget : public QWidget {
     Q_OBJECT
 
 public:
@@ -48,6 +55,20 @@ public:
     void setLocked(bool locked);
     bool isLocked() const { return m_config.locked; }
 
+    // 拖拽统计
+    bool isDragging() const { return m_dragging; }
+    const DragStats& getLastDragStats() const { return m_lastDragStats; }
+    
+    // 暂停策略：窗口未暴露、熄屏或锁屏时暂停内容更新（遮挡检测的平台限制见eventFilter）
+    bool isSuspended() const { return m_suspended; }
+    SuspendReasons getSuspendReasons() const { return m_suspendReasons; }
+    SuspendStats getSuspendStats() const;
+    
+    // 重绘：通过WidgetRenderer合并到下一个显示帧
+    void scheduleRepaint();
+    void setRenderPriority(RenderPriority priority) { m_renderPriority = priority; }
+    RenderPriority getRenderPriority() const { return m_renderPriority; }
+
 #ifdef Q_OS_WIN
     // Windows平台特殊功能
     void applyWindowsAvoidMinimize();    // 应用Windows API防止最小化
@@ -60,6 +81,7 @@ signals:
     void closeRequested(const QString& widgetId);
     void settingsRequested(const QString& widgetId);
     void positionChanged(const QString& widgetId, const QPoint& newPosition);
+    void suspensionChanged(bool suspended);
 
 protected:
     // 事件处理
@@ -67,21 +89,47 @@ protected:
     void mouseMoveEvent(QMouseEvent* event) override;
     void mouseReleaseEvent(QMouseEvent* event) override;
     void contextMenuEvent(QContextMenuEvent* event) override;
+    bool event(QEvent* event) override;
+    bool eventFilter(QObject* watched, QEvent* event) override;
+    
+    // 暂停与恢复：子类在这里暂停/恢复自己的采样线程、网络刷新等
+    virtual void onSuspended() {}
+    virtual void onResumed() {}
+    void updateSuspension();
+    void refreshUpdateJob();
     
     // 绘制相关
     void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
     virtual void drawContent(QPainter& painter) = 0;
+    
+    // 静态图层：背景、边框、网格、标签等按注册顺序渲染进缓存位图，
+    // 只在尺寸、配置、主题或设备像素比变化时重新渲染；drawContent()只负责动态内容
+    using LayerPainter = std::function<void(QPainter&)>;
+    void addStaticLayer(const QString& name, LayerPainter painter);
+    void removeStaticLayer(const QString& name);
+    void invalidateStaticLayer(const QString& name);
+    void invalidateStaticLayers();
 
     // 辅助方法
     virtual QMenu* createContextMenu();
     void updateContextMenu();
     void updateWindowFlags();
-    void savePosition();
+    Qt::WindowFlags computeWindowFlags() const;
+    
+    // 当前applyConfig()需要处理的配置差异，子类据此只应用变化的部分
+    const ConfigDelta& configDelta() const { return m_configDelta; }
+    void ensureLayerCache();
+    void markStaticLayersDirty();
+    void beginDrag(const QPoint& grabOffset);
+    void finishDrag();
+    int dragFrameInterval() const;
 
 protected slots:
     virtual void onUpdateTimer();
     virtual void onSettingsAction();
     virtual void onCloseAction();
+    void onDragFrame();
     
     #ifdef Q_OS_WIN
     void maintainBottomLayer();  // 维持置底层级的定时器槽函数
@@ -89,13 +137,48 @@ protected slots:
 
 protected:
     WidgetConfig m_config;
+    ConfigDelta m_configDelta;
     WidgetStatus m_status;
-    QTimer* m_updateTimer;
+    TickJobId m_updateJob;            // 共享调度器中的内容更新任务
     int m_updateInterval;
     
-    // 拖拽相关
+    // 拖拽相关：拖拽期间只按显示刷新率移动窗口，配置与持久化在松开鼠标时一次性提交
     bool m_dragging;
     QPoint m_dragStartPosition;
+    QPoint m_dragOriginPosition;      // 拖拽开始时的窗口位置
+    QPoint m_pendingDragPosition;     // 尚未应用的最新目标位置
+    bool m_hasPendingDragMove;
+    qint64 m_pendingDragSinceNs;      // 最早一个未应用事件的到达时间
+    double m_dragLatencySumMs;
+    QTimer* m_dragFrameTimer;
+    QElapsedTimer m_dragClock;
+    DragStats m_currentDragStats;
+    DragStats m_lastDragStats;
+    
+    // 暂停相关
+    SuspendReasons m_suspendPolicy;   // 允许触发暂停的原因（按小组件配置）
+    SuspendReasons m_suspendReasons;  // 当前生效的暂停原因
+    bool m_obscured;
+    bool m_suspended;
+    QElapsedTimer m_suspendClock;
+    SuspendStats m_suspendStats;
+    
+    // 静态图层缓存
+    struct StaticLayer {
+        QString name;
+        LayerPainter painter;
+        QPixmap pixmap;
+        bool dirty = true;
+    };
+    QVector<StaticLayer> m_staticLayers;
+    QPixmap m_layerCache;             // 所有静态图层的合成结果
+    bool m_layerCacheDirty;
+    RenderPriority m_renderPriority;
+    
+    // 窗口标志：只有计算结果变化时才调用setWindowFlags重建原生窗口
+    Qt::WindowFlags m_appliedWindowFlags;
+    bool m_windowFlagsApplied;
+    bool m_deferWindowFlags;
     
     // UI元素
     QMenu* m_contextMenu;
@@ -1,8 +1,9 @@
 #pragma once
 #include <QObject>
+#include "Framework/FrameworkExport.h"
 
 // InteractionSystem - 交互系统（待实现）
-class InteractionSystem : public QObject {
+class UWIDGET_FRAMEWORK_EXPORT InteractionSystem : public QObject {
     Q_OBJECT
 public:
     explicit InteractionSystem(QObject* parent = nullptr);
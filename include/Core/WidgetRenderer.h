@@ -1,9 +1,59 @@
 #pragma once
 #include <QObject>
+#include <QHash>
+#include <QPointer>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QWidget>
+#include "Common/Types.h"
+#include "Framework/FrameworkExport.h"
 
-// WidgetRenderer - 高性能渲染器（待实现）
-class WidgetRenderer : public QObject {
+// WidgetRenderer - 按显示帧节奏批量重绘的渲染器：
+// 收集所有小组件的重绘请求，每个显示帧统一刷新一次，
+// 超出帧预算时低优先级的小组件顺延到下一帧
+class UWIDGET_FRAMEWORK_EXPORT WidgetRenderer : public QObject {
     Q_OBJECT
+
 public:
+    static WidgetRenderer& instance();
+
     explicit WidgetRenderer(QObject* parent = nullptr);
-}; 
\ No newline at end of file
+
+    // 请求在下一帧重绘，同一帧内的重复请求会被合并（可从任意线程调用）
+    void requestRepaint(QWidget* widget, RenderPriority priority = RenderPriority::Normal);
+    void cancelRepaint(QWidget* widget);
+
+    // 每帧用于重绘的时间预算（毫秒），<=0表示使用帧间隔的一半
+    void setFrameBudget(double budgetMs);
+    double frameBudget() const;
+    int frameInterval() const;
+
+    const RenderStats& getStatistics() const { return m_stats; }
+    void resetStatistics();
+
+signals:
+    void frameRendered(double frameMs, int repaintCount);
+
+private slots:
+    void onFrame();
+
+private:
+    struct PendingRepaint {
+        QPointer<QWidget> widget;
+        RenderPriority priority = RenderPriority::Normal;
+        qint64 requestedNs = 0;     // 首次请求的时间，同优先级先到先画
+        int deferredFrames = 0;     // 已被顺延的帧数
+    };
+
+    void scheduleFrame();
+    void updateStatistics(double frameMs, int repaintCount);
+
+private:
+    QHash<QWidget*, PendingRepaint> m_pending;
+    QTimer* m_frameTimer;
+    QElapsedTimer m_clock;
+    double m_frameBudgetMs;
+
+    RenderStats m_stats;
+    QElapsedTimer m_statsClock;
+};
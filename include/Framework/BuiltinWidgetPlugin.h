@@ -0,0 +1,50 @@
+#pragma once
+#include <QDialog>
+#include <QSize>
+#include <QString>
+#include <memory>
+#include "Framework/IWidgetPlugin.h"
+
+// BuiltinWidgetPlugin - 随程序发布的小组件类型的插件实现：小组件类和配置对话框作为模板参数。
+// 静态链接的类型直接注册到WidgetTypeRegistry，插件库中的类型由导出的QObject继承它
+template <typename Widget, typename Dialog>
+class BuiltinWidgetPlugin : public IWidgetPlugin {
+public:
+    BuiltinWidgetPlugin(const QString& typeKey, const QString& displayName, WidgetType type,
+                        const QSize& size, int updateInterval)
+        : m_typeKey(typeKey), m_displayName(displayName), m_type(type)
+        , m_size(size), m_updateInterval(updateInterval) {}
+
+    QString typeKey() const override { return m_typeKey; }
+    QString displayName() const override { return m_displayName; }
+    WidgetType widgetType() const override { return m_type; }
+
+    WidgetPtr createWidget(const WidgetConfig& config) override {
+        return std::make_shared<Widget>(config);
+    }
+
+    WidgetConfig defaultConfig() const override {
+        WidgetConfig config;
+        config.type = m_type;
+        config.name = m_displayName;
+        config.size = m_size;
+        config.updateInterval = m_updateInterval;
+        return config;
+    }
+
+    bool editConfig(WidgetConfig& config, QWidget* parent) override {
+        Dialog dialog(config, parent);
+        if (dialog.exec() != QDialog::Accepted) {
+            return false;
+        }
+        config = dialog.getUpdatedConfig();
+        return true;
+    }
+
+private:
+    QString m_typeKey;
+    QString m_displayName;
+    WidgetType m_type;
+    QSize m_size;
+    int m_updateInterval;
+};
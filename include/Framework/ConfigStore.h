@@ -0,0 +1,68 @@
+#pragma once
+#include <QObject>
+#include <QMap>
+#include <QSet>
+#include <QTimer>
+#include <QThreadPool>
+#include <QJsonObject>
+#include <functional>
+#include "Common/Types.h"
+
+// ConfigStore - 小组件配置的持久化存储：
+// 跟踪发生变化的小组件，只重新序列化这些条目，
+// 在后台线程中通过临时文件+重命名原子地写入配置文件
+class ConfigStore : public QObject {
+    Q_OBJECT
+
+public:
+    // 按ID取得小组件的当前配置，小组件不存在时返回false
+    using ConfigProvider = std::function<bool(const QString& widgetId, WidgetConfig& config)>;
+
+    explicit ConfigStore(QObject* parent = nullptr);
+    ~ConfigStore();
+
+    void setFilePath(const QString& filePath);
+    QString filePath() const { return m_filePath; }
+    void setConfigProvider(ConfigProvider provider);
+    void setSaveDelay(int delayMs);
+
+    // 以加载到的配置重置缓存，之后只有被标记的条目会重新序列化
+    void resetEntries(const QList<QJsonObject>& objects);
+
+    // 变更跟踪
+    void markDirty(const QString& widgetId);
+    void markRemoved(const QString& widgetId);
+    bool hasPendingChanges() const;
+
+    // 延迟写入：合并一段时间内的所有变更后在后台线程写盘
+    void scheduleSave();
+    // 立即同步写盘（退出、重新加载前使用）
+    bool saveNow();
+
+    const ConfigStoreStats& getStatistics() const { return m_stats; }
+
+    // 配置与JSON之间的转换
+    static QJsonObject toJson(const WidgetConfig& config);
+    static WidgetConfig fromJson(const QJsonObject& obj);
+
+signals:
+    void saved(bool success, qint64 bytesWritten, double latencyMs);
+
+private slots:
+    void onSaveTimer();
+
+private:
+    QByteArray buildDocument(int& serializedEntries);
+    static bool writeFile(const QString& filePath, const QByteArray& data, QString& errorString);
+    void recordResult(bool success, qint64 bytesWritten, double latencyMs, const QString& errorString);
+
+private:
+    QString m_filePath;
+    ConfigProvider m_provider;
+    QMap<QString, QByteArray> m_entries;   // 每个小组件序列化后的紧凑JSON，按ID排序
+    QSet<QString> m_dirtyIds;
+    bool m_structureDirty;                 // 有条目被删除，或上次写入失败
+    QTimer* m_saveTimer;
+    QThreadPool m_writerPool;              // 单线程，保证写入按顺序完成
+    ConfigStoreStats m_stats;
+};
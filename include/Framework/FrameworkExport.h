@@ -0,0 +1,10 @@
+#pragma once
+#include <QtGlobal>
+
+// uwidget-framework共享库的导出宏：库自身编译时定义UWIDGET_FRAMEWORK_LIBRARY，
+// 可执行文件和小组件插件链接同一份框架，BaseWidget的元对象、日志分类等数据符号也随类一起导出
+#ifdef UWIDGET_FRAMEWORK_LIBRARY
+#  define UWIDGET_FRAMEWORK_EXPORT Q_DECL_EXPORT
+#else
+#  define UWIDGET_FRAMEWORK_EXPORT Q_DECL_IMPORT
+#endif
@@ -0,0 +1,31 @@
+#pragma once
+#include <QtPlugin>
+#include <QString>
+#include "Common/Types.h"
+#include "Core/BaseWidget.h"
+
+class QWidget;
+
+#define IWidgetPlugin_iid "org.DesktopWidgetSystem.IWidgetPlugin/1.0"
+
+// IWidgetPlugin - 小组件类型插件接口：
+// 每种小组件类型提供工厂、默认配置和配置对话框。
+// 外部插件库需在Q_PLUGIN_METADATA的JSON中声明"typeKey"和"displayName"，
+// 注册表只读取元数据即可列出类型，真正创建该类型的小组件时才加载库
+class IWidgetPlugin {
+public:
+    virtual ~IWidgetPlugin() = default;
+
+    // 类型标识，写入配置文件，必须稳定且唯一
+    virtual QString typeKey() const = 0;
+    virtual QString displayName() const = 0;
+    // 内置类型返回对应的枚举值，外部插件返回WidgetType::Custom
+    virtual WidgetType widgetType() const { return WidgetType::Custom; }
+
+    virtual WidgetPtr createWidget(const WidgetConfig& config) = 0;
+    virtual WidgetConfig defaultConfig() const = 0;
+    // 以模态对话框编辑配置，用户确认后写回config并返回true
+    virtual bool editConfig(WidgetConfig& config, QWidget* parent) = 0;
+};
+
+Q_DECLARE_INTERFACE(IWidgetPlugin, IWidgetPlugin_iid)
@@ -1,9 +1,110 @@
 #pragma once
 #include <QObject>
+#include <QTimer>
+#include <QHash>
+#include <QVector>
+#include <QElapsedTimer>
+#include <QMetaObject>
+#include <QAbstractNativeEventFilter>
+#include <functional>
+#include "Framework/FrameworkExport.h"
 
-// WidgetFramework - Widget框架（待实现）
-class WidgetFramework : public QObject {
+class QWindow;
+
+// 定时任务的精度类别
+enum class TickClass {
+    Coarse,   // 周期量化后对齐到墙钟边界（整秒等），兼容周期的任务合并为同一次唤醒
+    Precise   // 按注册周期准时触发，不做墙钟对齐
+};
+
+using TickJobId = quint64;
+
+// WidgetFramework - Widget框架：进程内共享的时间轮调度器，
+// 所有小组件的周期性任务都注册到这里，由单个定时器统一唤醒；
+// 同时跟踪会话锁定和显示器电源等全局状态
+class UWIDGET_FRAMEWORK_EXPORT WidgetFramework : public QObject, public QAbstractNativeEventFilter {
     Q_OBJECT
+
 public:
+    static WidgetFramework& instance();
+
     explicit WidgetFramework(QObject* parent = nullptr);
-}; 
\ No newline at end of file
+    ~WidgetFramework();
+
+    // 注册周期任务，owner销毁时自动注销
+    TickJobId registerJob(QObject* owner, int periodMs, TickClass tickClass,
+                          std::function<void()> callback, bool active = true);
+    void unregisterJob(TickJobId id);
+    void setJobPeriod(TickJobId id, int periodMs);
+    void setJobActive(TickJobId id, bool active);
+    bool isJobActive(TickJobId id) const;
+    int jobPeriod(TickJobId id) const;
+
+    // 统计信息
+    int jobCount() const { return m_jobs.size(); }
+    quint64 totalWakeups() const { return m_totalWakeups; }
+    double wakeupsPerSecond() const { return m_wakeupRate; }
+
+    // 全局会话状态
+    bool isSessionLocked() const { return m_sessionLocked; }
+    bool isDisplayOff() const { return m_displayOff; }
+
+    bool nativeEventFilter(const QByteArray& eventType, void* message, qintptr* result) override;
+
+signals:
+    void statisticsUpdated(double wakeupsPerSecond, int jobCount);
+    void sessionStateChanged();
+
+private slots:
+    void onWheelTimer();
+    // Linux桌面会话通知（D-Bus），没有QtDBus时不会被连接
+    void onLoginSessionLock();
+    void onLoginSessionUnlock();
+    void onScreenSaverActiveChanged(bool active);
+
+private:
+    struct Job {
+        QObject* owner = nullptr;
+        int periodMs = 0;           // 量化后的周期
+        TickClass tickClass = TickClass::Coarse;
+        std::function<void()> callback;
+        bool active = false;
+        qint64 dueTick = -1;        // 下次触发的绝对槽位，-1表示未调度
+        QMetaObject::Connection ownerConnection;
+    };
+
+    struct SlotEntry {
+        TickJobId id;
+        qint64 dueTick;             // 与Job::dueTick不一致的条目视为过期
+    };
+
+    qint64 currentTick() const;
+    int quantizePeriod(int periodMs, TickClass tickClass) const;
+    void scheduleJob(TickJobId id, Job& job, qint64 nowTick, bool afterRun);
+    void rearmTimer();
+    void updateStatistics();
+    void setupSessionMonitoring();
+    bool setupDBusSessionMonitoring();
+    void setSessionLocked(bool locked);
+    void setDisplayOff(bool off);
+
+private:
+    QHash<TickJobId, Job> m_jobs;
+    QVector<QVector<SlotEntry>> m_slots;
+    TickJobId m_nextJobId;
+    qint64 m_lastProcessedTick;
+
+    QTimer* m_wheelTimer;
+    QElapsedTimer m_clock;
+
+    // 唤醒统计
+    QElapsedTimer m_statsClock;
+    quint64 m_totalWakeups;
+    quint64 m_wakeupsSinceMark;
+    double m_wakeupRate;
+
+    // 会话状态
+    bool m_sessionLocked;
+    bool m_displayOff;
+    QWindow* m_notifyWindow;        // Windows下接收会话与电源通知的隐藏窗口
+};
@@ -2,11 +2,14 @@
 #include <QObject>
 #include <QMap>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QJsonDocument>
 #include <QJsonArray>
 #include "Common/Types.h"
 #include "Core/BaseWidget.h"
 
+class ConfigStore;
+
 class WidgetManager : public QObject {
     Q_OBJECT
 
@@ -22,6 +25,15 @@ public:
     void startAllWidgets();
     void stopAllWidgets();
     void cleanupAllWidgets();
+    
+    // 批量操作：beginBatch()与commitBatch()之间的所有变更合并为一次widgetsChanged信号
+    // 和一次延迟保存，可以嵌套；不在批量中的单个变更视为只含一项的批量
+    void beginBatch();
+    void commitBatch();
+    bool isBatching() const { return m_batchDepth > 0; }
+    int createWidgets(const QList<WidgetConfig>& configs);
+    int removeWidgets(const QStringList& widgetIds);
+    int updateWidgetConfigs(const QList<WidgetConfig>& configs);
 
     // Widget查询
     WidgetPtr getWidget(const QString& widgetId) const;
@@ -29,6 +41,13 @@ public:
     QList<WidgetPtr> getWidgetsByType(WidgetType type) const;
     bool hasWidget(const QString& widgetId) const;
     int getWidgetCount() const;
+    
+    // 延迟实例化：加载配置时只登记配置，自动启动的小组件按优先级逐个实例化，
+    // 其余小组件在首次startWidget()时才实例化；getWidget()只返回已实例化的小组件
+    bool isWidgetLoaded(const QString& widgetId) const;
+    WidgetStatus getWidgetStatus(const QString& widgetId) const;
+    WidgetPtr ensureWidget(const QString& widgetId);
+    bool isLoading() const { return !m_loadQueue.isEmpty(); }
 
     // 配置管理
     bool updateWidgetConfig(const QString& widgetId, const WidgetConfig& config);
@@ -61,6 +80,8 @@ signals:
     void widgetStatusChanged(const QString& widgetId, WidgetStatus status);
     void widgetPositionManuallyChanged(const QString& widgetId, const QPoint& newPosition);
     void configurationChanged();
+    void loadingFinished(int loadedCount, qint64 elapsedMs);
+    void widgetsChanged(const WidgetChangeSet& changes);
 
 private slots:
     void onWidgetCloseRequested(const QString& widgetId);
@@ -68,10 +89,12 @@ private slots:
     void onWidgetConfigChanged(const WidgetConfig& config);
     void onWidgetStatusChanged(WidgetStatus status);
     void onWidgetPositionChanged(const QString& widgetId, const QPoint& newPosition);
+    void onLoadStep();
 
 private:
-    // Widget工厂方法
-    WidgetPtr createWidgetByType(WidgetType type, const WidgetConfig& config);
+    // 通过类型注册表创建小组件并纳入管理
+    WidgetPtr instantiateWidget(const WidgetConfig& config);
+    bool isOnScreen(const WidgetConfig& config) const;
     
     // 配置文件路径
     QString getConfigFilePath() const;
@@ -82,10 +105,28 @@ private:
     bool validateConfig(const WidgetConfig& config) const;
     void connectWidgetSignals(WidgetPtr widget);
     void disconnectWidgetSignals(WidgetPtr widget);
+    
+    // 变更跟踪：标记给配置存储并按需触发延迟保存
+    void markConfigDirty(const QString& widgetId);
+    void markConfigRemoved(const QString& widgetId);
+    
+    // 记录到当前批量的变更集，不在批量中时立即发出
+    void recordCreated(const QString& widgetId);
+    void recordRemoved(const QString& widgetId);
+    void recordUpdated(const QString& widgetId);
+    void flushChanges();
 
 private:
     QMap<QString, WidgetPtr> m_widgets;
+    QMap<QString, WidgetConfig> m_deferredConfigs;  // 已登记但尚未实例化的小组件
+    QStringList m_loadQueue;                        // 等待分批实例化并启动的小组件
+    QTimer* m_loadTimer;
+    QElapsedTimer m_loadClock;
+    int m_loadedCount;
     QMap<QString, WidgetConfig> m_templates;
-    mutable QTimer* m_saveTimer; // 延迟保存
+    ConfigStore* m_store;  // 配置持久化，只重新序列化变化的条目
     bool m_autoSave;
+    int m_batchDepth;
+    WidgetChangeSet m_pendingChanges;
+    QElapsedTimer m_batchClock;
 }; 
\ No newline at end of file
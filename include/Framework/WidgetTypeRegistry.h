@@ -0,0 +1,74 @@
+#pragma once
+#include <QObject>
+#include <QHash>
+#include <QVector>
+#include <QString>
+#include <memory>
+#include "Common/Types.h"
+#include "Framework/IWidgetPlugin.h"
+#include "Framework/FrameworkExport.h"
+
+class QPluginLoader;
+
+// 已注册的小组件类型描述
+struct WidgetTypeInfo {
+    QString typeKey;
+    QString displayName;
+    WidgetType type = WidgetType::Custom;
+    bool builtin = false;
+    bool loaded = false;    // 外部插件的库是否已加载
+    QString filePath;       // 外部插件的库文件路径
+};
+
+// WidgetTypeRegistry - 小组件类型注册表：
+// 内置类型由程序启动时注册；外部插件扫描目录时只读取元数据，
+// 首次需要该类型的工厂、默认配置或配置对话框时才加载对应的库
+class UWIDGET_FRAMEWORK_EXPORT WidgetTypeRegistry : public QObject {
+    Q_OBJECT
+
+public:
+    static WidgetTypeRegistry& instance();
+
+    explicit WidgetTypeRegistry(QObject* parent = nullptr);
+    ~WidgetTypeRegistry();
+
+    // 注册内置类型，注册表接管插件对象
+    void registerBuiltin(IWidgetPlugin* plugin);
+    // 扫描目录中的插件库，返回新登记的类型数量
+    int scanPluginDirectory(const QString& dirPath);
+    static QString defaultPluginDirectory();
+
+    // 类型查询（不会加载插件库）
+    QList<WidgetTypeInfo> availableTypes() const;
+    bool hasType(const QString& typeKey) const;
+    QString typeKeyOf(const WidgetConfig& config) const;
+    QString builtinTypeKey(WidgetType type) const;
+    QString displayName(const WidgetConfig& config) const;
+    // 按类型标识设置配置的type和pluginKey
+    void setConfigType(WidgetConfig& config, const QString& typeKey) const;
+    int loadedPluginCount() const;
+
+    // 取得插件，外部插件在此时才加载
+    IWidgetPlugin* plugin(const QString& typeKey);
+    IWidgetPlugin* pluginFor(const WidgetConfig& config);
+
+    // 便捷方法
+    WidgetPtr createWidget(const WidgetConfig& config);
+    WidgetConfig defaultConfig(const QString& typeKey);
+    bool editConfig(WidgetConfig& config, QWidget* parent);
+
+private:
+    struct Entry {
+        WidgetTypeInfo info;
+        std::unique_ptr<IWidgetPlugin> builtin;
+        QPluginLoader* loader = nullptr;
+        IWidgetPlugin* plugin = nullptr;
+    };
+
+    bool loadPlugin(Entry& entry);
+
+private:
+    QVector<Entry*> m_entries;              // 按注册顺序，决定界面中的类型顺序
+    QHash<QString, Entry*> m_entriesByKey;
+    QHash<int, QString> m_builtinKeys;      // WidgetType -> typeKey
+};
@@ -0,0 +1,255 @@
+#pragma once
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <cstring>
+
+// BinaryLogFormat - 二进制日志文件格式，由LogWriter写入、uwidget-logdump解码：
+//
+//   文件头:  "UWLG" + 版本(u8) + 保留(u8)
+//   记录:    类型(u8) + 负载长度(varint) + 负载
+//
+//   StringDef负载: 字符串ID(varint) + UTF-8文本
+//   Event负载:     时间戳ms(varint) + 级别(u8) + 分类ID(varint) + 线程ID(varint)
+//                  + 小组件ID(varint) + 消息模板ID(varint) + 参数个数(u8) + 参数...
+//   参数:          类型(u8) + 值（整数为zigzag varint，浮点为8字节小端，字符串为长度varint+UTF-8）
+//
+// 分类名、消息模板和小组件ID在首次出现时以StringDef写出一次，之后只写ID；
+// ID 0表示“无”，模板ID为0时第一个字符串参数即为已格式化的消息。
+// 每次打开文件时ID从头分配，解码器遇到重复定义时以后出现的为准。
+// 未知类型的记录可按负载长度跳过，便于以后扩展。
+namespace BinaryLog {
+
+constexpr char kMagic[4] = {'U', 'W', 'L', 'G'};
+constexpr quint8 kVersion = 1;
+constexpr int kHeaderSize = 6;
+constexpr int kMaxArgs = 255;
+
+enum RecordKind : quint8 {
+    StringDef = 1,
+    Event = 2
+};
+
+enum ArgType : quint8 {
+    IntArg = 1,
+    DoubleArg = 2,
+    StringArg = 3
+};
+
+// 结构化日志参数，构造函数不做格式化，格式化推迟到写入线程或解码工具
+struct Arg {
+    ArgType type = IntArg;
+    qint64 i = 0;
+    double d = 0.0;
+    QString s;
+
+    Arg() = default;
+    Arg(int value) : type(IntArg), i(value) {}
+    Arg(unsigned int value) : type(IntArg), i(value) {}
+    Arg(long value) : type(IntArg), i(value) {}
+    Arg(unsigned long value) : type(IntArg), i(static_cast<qint64>(value)) {}
+    Arg(long long value) : type(IntArg), i(value) {}
+    Arg(unsigned long long value) : type(IntArg), i(static_cast<qint64>(value)) {}
+    Arg(bool value) : type(IntArg), i(value ? 1 : 0) {}
+    Arg(double value) : type(DoubleArg), d(value) {}
+    Arg(const QString& value) : type(StringArg), s(value) {}
+    Arg(const char* value) : type(StringArg), s(QString::fromUtf8(value)) {}
+
+    QString toString() const {
+        switch (type) {
+            case IntArg: return QString::number(i);
+            case DoubleArg: return QString::number(d, 'f', 2);   // 与原先arg(value, 0, 'f', 2)的输出一致
+            case StringArg: return s;
+        }
+        return QString();
+    }
+};
+
+// 模板中位置pos处的占位符%1~%99，返回其长度并写出编号，不是占位符时返回0
+inline qsizetype placeholderAt(const QString& text, qsizetype pos, int& number) {
+    if (text.at(pos) != QLatin1Char('%') || pos + 1 >= text.size()) {
+        return 0;
+    }
+    number = text.at(pos + 1).digitValue();
+    if (number < 0) {
+        return 0;
+    }
+    qsizetype length = 2;
+    if (pos + 2 < text.size() && text.at(pos + 2).digitValue() >= 0) {
+        number = number * 10 + text.at(pos + 2).digitValue();
+        length = 3;
+    }
+    return number > 0 ? length : 0;
+}
+
+// 编号与QString::arg()的规则相同：编号最小的占位符对应第一个参数，依此类推。
+// 一次扫描完成全部替换，参数值中出现的%N（如小组件名称）保持原样
+inline QString formatMessage(const QString& messageTemplate, const QVector<Arg>& args) {
+    bool used[100] = {};
+    int number = 0;
+    for (qsizetype pos = 0; pos < messageTemplate.size(); ++pos) {
+        if (const qsizetype length = placeholderAt(messageTemplate, pos, number)) {
+            used[number] = true;
+            pos += length - 1;
+        }
+    }
+    int argIndex[100];
+    int next = 0;
+    for (int i = 0; i < 100; ++i) {
+        argIndex[i] = used[i] && next < args.size() ? next++ : -1;   // 参数不足时占位符保持原样
+    }
+
+    QString message;
+    message.reserve(messageTemplate.size());
+    for (qsizetype pos = 0; pos < messageTemplate.size(); ++pos) {
+        const qsizetype length = placeholderAt(messageTemplate, pos, number);
+        if (length > 0 && argIndex[number] >= 0) {
+            message += args.at(argIndex[number]).toString();
+            pos += length - 1;
+        } else {
+            message += messageTemplate.at(pos);
+        }
+    }
+    return message;
+}
+
+inline const char* levelName(int level) {
+    switch (level) {
+        case 0: return "DEBUG";
+        case 1: return "INFO";
+        case 2: return "WARNING";
+        case 3: return "ERROR";
+        default: return "UNKNOWN";
+    }
+}
+
+// 编码：追加到QByteArray
+inline void putVarint(QByteArray& out, quint64 value) {
+    while (value >= 0x80) {
+        out.append(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.append(static_cast<char>(value));
+}
+
+inline void putString(QByteArray& out, const QString& value) {
+    const QByteArray utf8 = value.toUtf8();
+    putVarint(out, static_cast<quint64>(utf8.size()));
+    out.append(utf8);
+}
+
+inline void putArg(QByteArray& out, const Arg& arg) {
+    out.append(static_cast<char>(arg.type));
+    switch (arg.type) {
+        case IntArg:
+            putVarint(out, (static_cast<quint64>(arg.i) << 1) ^ static_cast<quint64>(arg.i >> 63));
+            break;
+        case DoubleArg: {
+            quint64 bits;
+            std::memcpy(&bits, &arg.d, sizeof(bits));
+            for (int shift = 0; shift < 64; shift += 8) {
+                out.append(static_cast<char>((bits >> shift) & 0xFF));
+            }
+            break;
+        }
+        case StringArg:
+            putString(out, arg.s);
+            break;
+    }
+}
+
+inline void putHeader(QByteArray& out) {
+    out.append(kMagic, sizeof(kMagic));
+    out.append(static_cast<char>(kVersion));
+    out.append('\0');
+}
+
+// 写出一条记录：类型 + 负载长度 + 负载
+inline void putRecord(QByteArray& out, RecordKind kind, const QByteArray& payload) {
+    out.append(static_cast<char>(kind));
+    putVarint(out, static_cast<quint64>(payload.size()));
+    out.append(payload);
+}
+
+// 解码：顺序读取一段内存，越界时ok()变为false
+class Reader {
+public:
+    Reader(const char* data, qsizetype size) : m_data(data), m_end(data + size) {}
+
+    bool ok() const { return m_ok; }
+    bool atEnd() const { return m_data >= m_end; }
+    qsizetype remaining() const { return m_end - m_data; }
+
+    quint8 byte() {
+        if (m_data >= m_end) {
+            m_ok = false;
+            return 0;
+        }
+        return static_cast<quint8>(*m_data++);
+    }
+
+    quint64 varint() {
+        quint64 value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            const quint8 b = byte();
+            value |= quint64(b & 0x7F) << shift;
+            if (!(b & 0x80) || !m_ok) {
+                return value;
+            }
+        }
+        m_ok = false;
+        return value;
+    }
+
+    QByteArray bytes(quint64 size) {
+        if (size > quint64(remaining())) {
+            m_ok = false;
+            return QByteArray();
+        }
+        QByteArray result(m_data, static_cast<qsizetype>(size));
+        m_data += size;
+        return result;
+    }
+
+    QString string() {
+        return QString::fromUtf8(bytes(varint()));
+    }
+
+    Arg arg() {
+        Arg result;
+        result.type = static_cast<ArgType>(byte());
+        switch (result.type) {
+            case IntArg: {
+                const quint64 zigzag = varint();
+                result.i = static_cast<qint64>(zigzag >> 1) ^ -static_cast<qint64>(zigzag & 1);
+                break;
+            }
+            case DoubleArg: {
+                quint64 bits = 0;
+                for (int shift = 0; shift < 64; shift += 8) {
+                    bits |= quint64(byte()) << shift;
+                }
+                std::memcpy(&result.d, &bits, sizeof(bits));
+                break;
+            }
+            case StringArg:
+                result.s = string();
+                break;
+            default:
+                m_ok = false;
+                break;
+        }
+        return result;
+    }
+
+private:
+    const char* m_data;
+    const char* m_end;
+    bool m_ok = true;
+};
+
+inline bool hasHeader(const QByteArray& data) {
+    return data.size() >= kHeaderSize && std::memcmp(data.constData(), kMagic, sizeof(kMagic)) == 0;
+}
+
+} // namespace BinaryLog
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <utility>
+#include <vector>
+
+#ifdef Q_OS_LINUX
+#include "Utils/ProcReader.h"
+#endif
+
+// 单块磁盘在一个采样周期内的I/O
+struct DiskDeviceStats {
+    QString name;
+    double readKBps = 0.0;          // 读取速度 (KB/s)
+    double writeKBps = 0.0;         // 写入速度 (KB/s)
+    double readIops = 0.0;          // 每秒完成的读请求
+    double writeIops = 0.0;         // 每秒完成的写请求
+    double avgServiceMs = 0.0;      // 每个请求的平均耗时（含排队，同iostat的await）
+    double busyPercent = 0.0;       // 有请求在处理的时间比例 (0-100)
+};
+
+// DiskIoSampler - 按物理磁盘统计吞吐、IOPS和平均耗时：
+// Linux取/proc/diskstats两次读数的差值，只统计整块磁盘——分区、回环和内存盘，
+// 以及叠加在其他磁盘之上的设备（LVM/dm、md阵列）都不计入，同一份I/O不会重复计数；
+// Windows对每块\\.\PhysicalDriveN发送IOCTL_DISK_PERFORMANCE。
+// 状态属于各实例，只在采样线程中使用，不加锁
+class DiskIoSampler {
+public:
+    static constexpr int kMaxTopCount = 8;      // topDevices最多返回的磁盘数
+
+    DiskIoSampler();
+    ~DiskIoSampler();
+    DiskIoSampler(const DiskIoSampler&) = delete;
+    DiskIoSampler& operator=(const DiskIoSampler&) = delete;
+
+    // 读取所有磁盘的计数器并更新各项速率，失败时返回false
+    bool sample();
+
+    double readKBps() const { return m_readKBps; }
+    double writeKBps() const { return m_writeKBps; }
+    double busiestPercent() const { return m_busiestPercent; }
+
+    // 按读写吞吐之和取前count块磁盘
+    void topDevices(int count, QVector<DiskDeviceStats>& out);
+
+private:
+    // 累计计数，时间统一为微秒
+    struct Counters {
+        quint64 readOps = 0;
+        quint64 writeOps = 0;
+        quint64 readBytes = 0;
+        quint64 writeBytes = 0;
+        quint64 ioTimeUs = 0;       // 各请求耗时之和
+        quint64 busyUs = 0;         // 有请求在处理的时间
+    };
+
+    struct Entry {
+        DiskDeviceStats stats;
+        Counters last;
+        quint64 generation = 0;     // 最近一次出现的采样轮次，磁盘移除后清理
+        bool hasBaseline = false;
+        bool included = true;       // Linux：是否为需要统计的整块物理磁盘
+        void* handle = nullptr;     // Windows磁盘句柄，保持打开
+    };
+
+    using EntryMap = QHash<QByteArray, Entry>;
+
+    bool readCounters();
+    void updateDevice(Entry& entry, const Counters& counters);
+    void releaseEntry(Entry& entry);
+
+    EntryMap m_entries;                      // Linux以设备名、Windows以磁盘编号为键
+    QElapsedTimer m_clock;                   // 从上一次成功读取计数器开始计时
+    qint64 m_elapsedMs;                      // 本次与上一次成功采样的间隔
+    quint64 m_generation;
+    double m_readKBps;
+    double m_writeKBps;
+    double m_busiestPercent;
+    std::vector<std::pair<double, const Entry*>> m_ranking; // 复用的排序数组
+
+#ifdef Q_OS_LINUX
+    ProcFs::ProcFile m_diskstatsFile;
+    ProcFs::ProcBuffer m_readBuffer;
+#endif
+};
@@ -0,0 +1,11 @@
+#pragma once
+#include <QLoggingCategory>
+#include "Framework/FrameworkExport.h"
+
+// 各子系统的日志分类，运行时可通过QT_LOGGING_RULES或
+// QLoggingCategory::setFilterRules()单独开关，例如 "uwidget.network.debug=true"
+Q_DECLARE_EXPORTED_LOGGING_CATEGORY(lcMonitor, UWIDGET_FRAMEWORK_EXPORT)   // 性能采样
+Q_DECLARE_EXPORTED_LOGGING_CATEGORY(lcNetwork, UWIDGET_FRAMEWORK_EXPORT)   // 网络流量与网络请求
+Q_DECLARE_EXPORTED_LOGGING_CATEGORY(lcRender, UWIDGET_FRAMEWORK_EXPORT)    // 渲染调度
+Q_DECLARE_EXPORTED_LOGGING_CATEGORY(lcConfig, UWIDGET_FRAMEWORK_EXPORT)    // 配置读写
+Q_DECLARE_EXPORTED_LOGGING_CATEGORY(lcWidget, UWIDGET_FRAMEWORK_EXPORT)    // 小组件生命周期与交互
@@ -0,0 +1,137 @@
+#pragma once
+#include <QThread>
+#include <QFile>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QHash>
+#include <atomic>
+#include "Utils/Logger.h"
+#include "Utils/MpscRingBuffer.h"
+#include "Framework/FrameworkExport.h"
+
+// 一条日志记录：普通记录的消息已由调用方格式化；
+// 结构化记录只携带模板和参数，由写入线程格式化或编码
+struct LogRecord {
+    qint64 timestampMs = 0;
+    int level = Logger::Info;
+    quintptr threadId = 0;
+    const char* category = nullptr;          // 静态存储的分类名，未分类时为空
+    QString message;
+    QString widgetId;                        // 结构化记录关联的小组件
+    const char* messageTemplate = nullptr;   // 静态存储的消息模板，普通记录为空
+    QVector<BinaryLog::Arg> args;
+};
+
+// LogWriter - 异步日志写入线程：
+// 生产者把记录放入无锁环形队列后立即返回，写入线程批量取出记录，
+// 写入常开的日志文件（文本或二进制格式）和控制台，并按固定间隔刷新控制台；
+// 日志文件不经过QFile的缓冲，每批记录一次write(2)，写出后即使进程崩溃也不会丢失。
+// 文件超过大小或时间上限时由写入线程轮转，历史文件在线程池中压缩和清理
+class UWIDGET_FRAMEWORK_EXPORT LogWriter : public QThread {
+public:
+    explicit LogWriter(size_t capacity = 8192);
+    ~LogWriter();
+
+    // 可由任意线程调用；写入线程已停止或记录被丢弃时返回false
+    bool enqueue(LogRecord&& record, Logger::OverflowPolicy policy);
+
+    void setFilePath(const QString& filePath);
+    void setFlushInterval(int intervalMs);
+    void setRotationPolicy(const LogRotationPolicy& policy);
+    void setFileFormat(Logger::FileFormat format);
+    void setConsoleOutput(bool enabled);
+
+    bool flush(int timeoutMs);
+    void stop();
+    bool isAccepting() const { return m_accepting.load(); }
+    LogStats statistics() const;
+
+    // 崩溃处理函数调用（异步信号安全）：把已取出但尚未写出的文本和队列中剩余的记录以文本行写到fd
+    void writeCrashDump(int fd) const;
+    // 用write(2)写出全部数据，异步信号安全
+    static void writeRaw(int fd, const char* data, size_t length);
+
+protected:
+    void run() override;
+
+private:
+    void wakeWriter();
+    int drain();
+    void appendRecord(const LogRecord& record);
+    void appendBinaryRecord(const LogRecord& record);
+    quint64 staticStringId(const char* text);
+    quint64 widgetStringId(const QString& widgetId);
+    quint64 defineString(const QString& text);
+    void writeBuffer();
+    void publishBufferForCrash();
+    void flushOutputs();
+    void applyPendingSettings();
+    void openLogFile(const QString& filePath);
+    QString filePathForFormat(const QString& filePath) const;
+    void reportDropped();
+
+    // 轮转与压缩
+    void rotateIfNeeded();
+    void rotateFile();
+    QString rotatedFilePath() const;
+    void scheduleCompression(const QStringList& segments);
+    static void compressAndPrune(const QStringList& segments, const QString& logFilePath,
+                                 bool compress, int retentionCount);
+
+private:
+    MpscRingBuffer<LogRecord> m_ring;
+
+    // 生产者只在写入线程休眠时才加锁唤醒
+    QMutex m_mutex;
+    QWaitCondition m_wakeCondition;
+    QWaitCondition m_flushedCondition;
+    std::atomic<bool> m_sleeping;
+    std::atomic<bool> m_stopping;
+    std::atomic<bool> m_accepting;
+    std::atomic<bool> m_flushRequested;
+    std::atomic<bool> m_consoleOutput;     // 是否同时输出到标准输出
+
+    // 崩溃处理函数可见的m_buffer：写入线程修改m_buffer之前清空，修改之后重新发布
+    std::atomic<const char*> m_crashText;
+    std::atomic<size_t> m_crashTextLength;
+    std::atomic<qint64> m_utcOffsetMs;     // 崩溃时无法调用localtime，由写入线程定期更新
+
+    // 仅由写入线程访问
+    QFile m_file;
+    QByteArray m_buffer;
+    QElapsedTimer m_flushClock;
+    bool m_unflushed;
+    quint64 m_reportedDropped;
+    qint64 m_fileBytes;                    // 当前日志文件的大小
+    qint64 m_segmentStartMs;               // 当前日志文件开始写入的时间
+    LogRotationPolicy m_rotation;          // 写入线程使用的轮转策略副本
+    Logger::FileFormat m_format;           // 写入线程使用的文件格式
+    QString m_basePath;                    // 未按格式调整扩展名的日志文件路径
+
+    // 二进制格式：当前文件中已定义的字符串，每次打开文件时清空
+    QByteArray m_binaryBuffer;
+    QHash<const void*, quint64> m_staticStringIds;
+    QHash<QString, quint64> m_widgetStringIds;
+    quint64 m_lastStringId;
+
+    // 由m_mutex保护
+    QString m_pendingFilePath;
+    bool m_filePathChanged;
+    int m_flushIntervalMs;
+    LogRotationPolicy m_pendingRotation;
+    bool m_rotationChanged;
+    Logger::FileFormat m_pendingFormat;
+    bool m_formatChanged;
+
+    // 统计
+    std::atomic<quint64> m_enqueued;
+    std::atomic<quint64> m_processed;
+    std::atomic<quint64> m_flushedUpTo;    // 已写出并刷盘的记录数
+    std::atomic<quint64> m_dropped;
+    std::atomic<quint64> m_blocked;
+    std::atomic<quint64> m_flushes;
+    std::atomic<quint64> m_maxDepth;
+    std::atomic<quint64> m_rotations;
+};
@@ -4,8 +4,33 @@
 #include <QFile>
 #include <QTextStream>
 #include <QMutex>
+#include <QLoggingCategory>
+#include "Utils/BinaryLogFormat.h"
+#include "Framework/FrameworkExport.h"
+#include <atomic>
 
-class Logger {
+class LogWriter;
+
+// 日志后端统计
+struct LogStats {
+    quint64 enqueuedCount = 0;   // 进入队列的记录数
+    quint64 writtenCount = 0;    // 已写出的记录数
+    quint64 droppedCount = 0;    // 队列满时丢弃的记录数
+    quint64 blockedCount = 0;    // 队列满时生产者等待的次数
+    quint64 flushCount = 0;      // 文件刷盘次数
+    quint64 maxQueueDepth = 0;   // 写入线程观察到的最大队列深度
+    quint64 rotationCount = 0;   // 日志文件轮转次数
+};
+
+// 日志轮转策略
+struct LogRotationPolicy {
+    qint64 maxFileBytes = 5 * 1024 * 1024;  // 单个日志文件的最大字节数，0表示不按大小轮转
+    int maxAgeHours = 24;                   // 单个日志文件的最长写入时间，0表示不按时间轮转
+    int retentionCount = 10;                // 保留的历史日志文件数
+    bool compress = true;                   // 是否在后台压缩历史日志文件
+};
+
+class UWIDGET_FRAMEWORK_EXPORT Logger {
 public:
     enum LogLevel {
         Debug = 0,
@@ -14,22 +39,119 @@ public:
         Error = 3
     };
 
+    // 队列满时的处理方式
+    enum OverflowPolicy {
+        DropNewest = 0,  // 丢弃新记录并计数，生产者从不等待
+        Block = 1        // 生产者等待写入线程腾出空间
+    };
+
+    // 日志文件格式
+    enum FileFormat {
+        TextFormat = 0,   // 每条记录一行文本
+        BinaryFormat = 1  // 紧凑的二进制记录，写入同目录下的.ulog文件，由uwidget-logdump解码
+    };
+
     static void initialize();
     static void setLogLevel(LogLevel level);
     static void setLogFile(const QString& filePath);
-    
+    static void setOverflowPolicy(OverflowPolicy policy);
+    static void setRotationPolicy(const LogRotationPolicy& policy);
+    static void setFileFormat(FileFormat format);
+    // 是否同时输出到标准输出，默认在标准输出可用时开启
+    static void setConsoleOutput(bool enabled);
+
     static void debug(const QString& message);
     static void info(const QString& message);
     static void warning(const QString& message);
     static void error(const QString& message);
-    
+
     static void log(LogLevel level, const QString& message);
+    static void log(LogLevel level, const char* category, const QString& message);
+
+    // 结构化日志：分类名和消息模板必须是静态存储的字符串（模板使用%1、%2占位），
+    // 参数原样入队，由写入线程格式化为文本或编码为二进制记录
+    template <typename... Args>
+    static void logEvent(LogLevel level, const char* category, const QString& widgetId,
+                         const char* messageTemplate, const Args&... args) {
+        if (level < s_logLevel.load(std::memory_order_relaxed)) {
+            return;
+        }
+        enqueueEvent(level, category, widgetId, messageTemplate,
+                     QVector<BinaryLog::Arg>{BinaryLog::Arg(args)...});
+    }
+
+    // 运行时级别检查，供日志宏在构造消息之前调用
+    static bool isEnabled(LogLevel level) { return level >= s_logLevel.load(std::memory_order_relaxed); }
+    static bool isEnabled(const QLoggingCategory& category, LogLevel level) {
+        return isEnabled(level) && category.isEnabled(toMsgType(level));
+    }
+
+    // 等待此前的记录全部写出并刷盘
+    static bool flush(int timeoutMs = 2000);
+    // 写出剩余记录并停止写入线程，之后的日志同步输出到控制台
+    static void shutdown();
+    static LogStats getStatistics();
 
-private:
-    static void writeLog(LogLevel level, const QString& message);
     static QString levelToString(LogLevel level);
-    
-    static LogLevel s_logLevel;
+    static QtMsgType toMsgType(LogLevel level);
+
+    // 崩溃处理函数追加消息的文件，由写入线程在每次打开日志文件时设置；空路径表示只写标准错误
+    static void setCrashLogFile(const QString& filePath);
+
+private:
+    static void installCrashHandlers();
+    static void enqueueEvent(LogLevel level, const char* category, const QString& widgetId,
+                             const char* messageTemplate, QVector<BinaryLog::Arg>&& args);
+
+    // 日志调用的热路径上无锁读取，只需要原子性，不需要与其他数据同步
+    static std::atomic<LogLevel> s_logLevel;
+    static std::atomic<OverflowPolicy> s_overflowPolicy;
+    static LogRotationPolicy s_rotationPolicy;
+    static FileFormat s_fileFormat;
+    static bool s_consoleOutput;
+    static bool s_consoleOutputSet;      // 未设置时由写入线程按标准输出是否可用决定
     static QString s_logFilePath;
     static QMutex s_mutex;
-}; 
\ No newline at end of file
+};
+
+// 编译期最低日志级别，低于该级别的日志宏展开为空分支，由编译器整体删除；
+// 发布构建（定义了NDEBUG）默认去掉调试日志，可通过编译定义覆盖
+#ifndef UWIDGET_LOG_MIN_LEVEL
+#  ifdef NDEBUG
+#    define UWIDGET_LOG_MIN_LEVEL 1
+#  else
+#    define UWIDGET_LOG_MIN_LEVEL 0
+#  endif
+#endif
+
+// 日志宏：级别被关闭时不求值消息参数，QString::arg()等格式化开销只在真正输出时产生
+#define UWIDGET_LOG(level, message) \
+    do { \
+        if ((level) >= UWIDGET_LOG_MIN_LEVEL && Logger::isEnabled(level)) \
+            Logger::log((level), (message)); \
+    } while (0)
+
+#define UWIDGET_CLOG(level, category, message) \
+    do { \
+        if ((level) >= UWIDGET_LOG_MIN_LEVEL && Logger::isEnabled(category(), (level))) \
+            Logger::log((level), category().categoryName(), (message)); \
+    } while (0)
+
+// 结构化日志宏，参数在级别关闭时同样不求值，例如：
+// LOG_CEVENT(Logger::Debug, lcWidget, widgetId, "实例化完成, 耗时 %1ms", elapsed);
+#define LOG_CEVENT(level, category, widgetId, ...) \
+    do { \
+        if ((level) >= UWIDGET_LOG_MIN_LEVEL && Logger::isEnabled(category(), (level))) \
+            Logger::logEvent((level), category().categoryName(), (widgetId), __VA_ARGS__); \
+    } while (0)
+
+#define LOG_DEBUG(message)   UWIDGET_LOG(Logger::Debug, message)
+#define LOG_INFO(message)    UWIDGET_LOG(Logger::Info, message)
+#define LOG_WARNING(message) UWIDGET_LOG(Logger::Warning, message)
+#define LOG_ERROR(message)   UWIDGET_LOG(Logger::Error, message)
+
+// 按分类过滤的版本，category为Utils/LogCategories.h中声明的分类
+#define LOG_CDEBUG(category, message)   UWIDGET_CLOG(Logger::Debug, category, message)
+#define LOG_CINFO(category, message)    UWIDGET_CLOG(Logger::Info, category, message)
+#define LOG_CWARNING(category, message) UWIDGET_CLOG(Logger::Warning, category, message)
+#define LOG_CERROR(category, message)   UWIDGET_CLOG(Logger::Error, category, message)
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <QFile>
+#include <QString>
+#include <QtGlobal>
+#include <functional>
+
+// 归档中的一条定长记录（64字节）。各字段组只在fields中对应的位被置上时有效
+struct MetricsArchiveRecord {
+    // 字段组，取值与MetricSource相同
+    enum Field : quint32 {
+        CpuField = 0x01,
+        MemoryField = 0x02,
+        DiskField = 0x04,
+        NetworkField = 0x08,
+        VolumesField = 0x10
+    };
+
+    qint64 timestampMs = 0;         // 毫秒时间戳
+    quint32 fields = 0;             // 本条记录中有效的字段组
+    quint32 reserved = 0;
+    float cpuUsage = 0.0f;          // (0-100)
+    float memoryUsage = 0.0f;       // (0-100)
+    float diskUsage = 0.0f;         // 最忙磁盘的繁忙度 (0-100)
+    float diskReadKBps = 0.0f;
+    float diskWriteKBps = 0.0f;
+    float networkUpload = 0.0f;     // (KB/s)
+    float networkDownload = 0.0f;   // (KB/s)
+    quint32 usedMemoryMB = 0;
+    quint32 totalMemoryMB = 0;
+    quint32 usedDiskGB = 0;
+    quint32 totalDiskGB = 0;
+    quint32 padding = 0;
+};
+static_assert(sizeof(MetricsArchiveRecord) == 64, "archive records must stay 64 bytes");
+
+// 段文件头（64字节），后面紧跟capacity条记录的预分配空间：
+//
+//   "UWMA" + 版本(u32) + 记录大小(u32) + 容量(u32) + 已写入条数(u32) + 保留(u32)
+//   + 第一条记录的时间戳(i64) + 填充
+//
+// 段文件以创建时的毫秒时间戳命名为metrics-<13位时间戳>.uwm，按名称排序即按时间排序。
+// 数值按本机字节序存储，只在同一台机器上读写
+struct MetricsArchiveHeader {
+    char magic[4];
+    quint32 version;
+    quint32 recordSize;
+    quint32 capacity;
+    quint32 count;                  // 已发布的条数：记录写完后才以release存储增加，读取方acquire读取；发布后的记录不再修改
+    quint32 reserved;
+    qint64 firstTimestampMs;
+    char padding[32];
+};
+static_assert(sizeof(MetricsArchiveHeader) == 64, "archive header must stay 64 bytes");
+
+// MetricsArchive - 持久化的性能指标时间序列：
+// 当前段文件在创建时预分配并整体映射到内存，追加一条记录只是一次内存拷贝，
+// 不做格式化也不调用fsync，脏页由操作系统写回（系统掉电可能丢失最近的记录）。
+// 同一秒内的多次采样先在内存中合并为一条，进入下一秒或close()时才写入映射并发布，
+// 已发布的记录不再修改，因此并发回放的读取方不会读到合并了一半的记录；代价是进程崩溃时丢失当前这一秒。
+// 时钟回拨时并入当前这一秒，记录始终按时间递增。
+// 段写满后滚动到新文件，超过保留时间或数量上限的旧段在滚动时删除。
+// 写入只在采样线程中进行，不加锁
+class MetricsArchive {
+public:
+    static constexpr int kDefaultSegmentRecords = 24 * 3600;   // 每秒一条时一个段为一天，约5.3MB
+    static constexpr int kDefaultRetentionDays = 7;            // 与MetricsHistory最粗档位的保留时间一致
+    static constexpr int kMaxSegments = 32;                    // 无论保留时间多长，磁盘占用不超过约170MB
+
+    MetricsArchive();
+    ~MetricsArchive();
+    MetricsArchive(const MetricsArchive&) = delete;
+    MetricsArchive& operator=(const MetricsArchive&) = delete;
+
+    // 应用数据目录下的metrics子目录
+    static QString defaultDirectory();
+
+    // 最新的段未写满时继续追加，否则新建一个段
+    bool open(const QString& directory, int segmentRecords = kDefaultSegmentRecords);
+    void close();
+    bool isOpen() const { return m_header != nullptr; }
+    QString directory() const { return m_directory; }
+
+    // 保留最近days天的段，下一次滚动时生效；每秒一条时一个段为一天，
+    // 段数上限为kMaxSegments，更长的保留时间不会生效，因此限制在[1, kMaxSegments]
+    void setRetentionDays(int days);
+
+    void append(const MetricsArchiveRecord& record);
+
+    // 把update中有效的字段组写入target
+    static void merge(MetricsArchiveRecord& target, const MetricsArchiveRecord& update);
+
+private:
+    bool createSegment();
+    void publishPending();
+    bool mapSegment(const QString& filePath, bool create);
+    void pruneSegments();
+
+    QString m_directory;
+    QFile m_file;
+    MetricsArchiveHeader* m_header;
+    MetricsArchiveRecord* m_records;
+    int m_segmentRecords;
+    int m_retentionDays;
+    MetricsArchiveRecord m_pending;     // 当前这一秒尚未发布的记录
+    bool m_hasPending;
+};
+
+// MetricsArchiveReader - 以只读方式映射段文件，按时间顺序回放一个时间范围内的记录。
+// 可与写入同时进行，正在写入的段只读到当时已完成的记录
+class MetricsArchiveReader {
+public:
+    explicit MetricsArchiveReader(const QString& directory);
+
+    // 依次回放timestampMs在[fromMs, toMs]内的记录，返回回放的条数
+    qint64 replay(qint64 fromMs, qint64 toMs, const std::function<void(const MetricsArchiveRecord&)>& visitor) const;
+
+private:
+    QString m_directory;
+};
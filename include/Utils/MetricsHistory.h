@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Utils/MetricsArchive.h"
+#include <QMutex>
+#include <QVector>
+#include <QtGlobal>
+#include <vector>
+
+// 记录历史的指标
+enum class HistoryMetric {
+    Cpu = 0,          // CPU使用率 (%)
+    Memory,           // 内存使用率 (%)
+    Disk,             // 磁盘繁忙度 (%)
+    NetworkUpload,    // 上传速度 (KB/s)
+    NetworkDownload,  // 下载速度 (KB/s)
+    Count
+};
+
+// 历史数据的分辨率档位
+enum class HistoryResolution {
+    Second = 0,       // 1秒，保留1小时
+    Minute,           // 1分钟汇总，保留24小时
+    QuarterHour,      // 15分钟汇总，保留7天
+    Count
+};
+
+// 查询结果，按时间升序；1秒档的min/max与avg相同。
+// 调用方可复用同一个对象，容量足够时查询不再分配内存
+struct HistorySeries {
+    HistoryResolution resolution = HistoryResolution::Second;
+    QVector<qint64> timeMs;     // 每个点所在区间的起始时间（毫秒时间戳）
+    QVector<float> avg;
+    QVector<float> min;
+    QVector<float> max;
+
+    int size() const { return timeMs.size(); }
+    void clear() { timeMs.clear(); avg.clear(); min.clear(); max.clear(); }
+};
+
+// MetricsHistory - 性能指标的定长时间序列：
+// 1秒档为每个指标一列的环形缓冲区（结构数组），每分钟和每15分钟滚动汇总出min/max/avg；
+// 所有缓冲区在构造时一次分配，记录样本时不分配内存。
+// 只有收到采样的秒才占用一个槽位，该秒内没有采样的指标（只采样了其他来源）记为NaN；
+// 完全没有采样的秒不占槽位，因此绘制时还需按相邻点的时间间隔判断是否断开曲线。
+// record()由采样线程调用，查询可在任意线程进行
+class MetricsHistory {
+public:
+    static constexpr int kMetricCount = static_cast<int>(HistoryMetric::Count);
+    static constexpr int kSecondCapacity = 3600;         // 1小时
+    static constexpr int kMinuteCapacity = 24 * 60;      // 24小时
+    static constexpr int kQuarterHourCapacity = 7 * 96;  // 7天
+
+    MetricsHistory();
+
+    // 记录一次采样；mask的第i位表示values[i]本次有效，其余指标不更新
+    void record(qint64 timestampMs, quint32 mask, const double (&values)[kMetricCount]);
+    // 记录一条采样或归档回放的记录，只更新其中有效的指标
+    void record(const MetricsArchiveRecord& sample);
+
+    // 取最近windowSeconds秒内的数据，自动选择能覆盖该窗口的最细分辨率
+    void query(HistoryMetric metric, int windowSeconds, HistorySeries& out) const;
+    void query(HistoryMetric metric, HistoryResolution resolution, qint64 sinceMs, HistorySeries& out) const;
+
+    static HistoryResolution resolutionForWindow(int windowSeconds);
+    static qint64 resolutionMs(HistoryResolution resolution);
+
+    void clear();
+
+private:
+    // 一个分辨率档位：共享的时间列 + 每个指标的min/avg/max列
+    struct Tier {
+        int capacity = 0;
+        int head = 0;                       // 下一个写入位置
+        int count = 0;
+        std::vector<qint64> timeMs;
+        std::vector<float> avg[kMetricCount];
+        std::vector<float> min[kMetricCount];   // 1秒档不分配，与avg相同
+        std::vector<float> max[kMetricCount];
+
+        void allocate(int size, bool withRange);
+        int append(qint64 bucketStartMs);   // 返回新槽位，各指标初始化为NaN
+        int last() const { return (head + capacity - 1) % capacity; }
+    };
+
+    // 正在累积的汇总区间
+    struct Accumulator {
+        qint64 bucketStartMs = -1;
+        double sum[kMetricCount];
+        float min[kMetricCount];
+        float max[kMetricCount];
+        int samples[kMetricCount];
+
+        void reset(qint64 bucketStart);
+    };
+
+    void addToAccumulator(Accumulator& acc, int metric, float avg, float min, float max, int samples);
+    void flushMinute();
+    void flushQuarterHour();
+
+    mutable QMutex m_mutex;
+    Tier m_tiers[static_cast<int>(HistoryResolution::Count)];
+    Accumulator m_minuteAcc;
+    Accumulator m_quarterAcc;
+    qint64 m_currentSecond;     // 1秒档最后一个槽位对应的秒
+};
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "Utils/DiskIoSampler.h"
+#include "Utils/NetworkSampler.h"
+#include "Utils/ProcessScanner.h"
+#include <QDateTime>
+#include <QMap>
+#include <QPair>
+#include <QStringList>
+#include <QVector>
+#include <utility>
+#include <vector>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <pdh.h>
+#endif
+
+#ifdef Q_OS_LINUX
+#include "Utils/ProcReader.h"
+#endif
+
+// 可订阅的指标来源，每个来源在一次采样中只读取一次
+enum class MetricSource {
+    Cpu = 0x01,       // CPU使用率
+    Memory = 0x02,    // 物理内存
+    Disk = 0x04,      // 各物理磁盘的吞吐、IOPS和繁忙度
+    Network = 0x08,   // 网络吞吐
+    Volumes = 0x10,   // 各挂载点的容量，刷新周期不短于10秒
+    CpuCores = 0x20,  // 每个核心的使用率和当前频率
+    Processes = 0x40  // 占用CPU和内存最多的进程
+};
+Q_DECLARE_FLAGS(MetricSources, MetricSource)
+Q_DECLARE_OPERATORS_FOR_FLAGS(MetricSources)
+
+// 性能数据结构
+struct PerformanceData {
+    double cpuUsage = 0.0;          // CPU使用率 (0-100)
+    double memoryUsage = 0.0;       // 内存使用率 (0-100)
+    double diskUsage = 0.0;         // 最忙的一块磁盘的繁忙度 (0-100)
+    double diskReadKBps = 0.0;      // 所有物理磁盘的读取速度 (KB/s)
+    double diskWriteKBps = 0.0;     // 所有物理磁盘的写入速度 (KB/s)
+    double networkUpload = 0.0;     // 网络上传速度 (KB/s)，未被过滤的接口之和
+    double networkDownload = 0.0;   // 网络下载速度 (KB/s)
+    qint64 totalMemory = 0;         // 总内存 (MB)
+    qint64 usedMemory = 0;          // 已用内存 (MB)
+    qint64 totalDisk = 0;           // 已挂载本地文件系统的总空间 (GB)，随Volumes更新
+    qint64 usedDisk = 0;            // 已用空间 (GB)
+    QMap<QString, QPair<qint64, qint64>> volumes; // 挂载点 -> {总空间, 可用空间}（字节）
+    QVector<DiskDeviceStats> diskDevices;       // 按读写吞吐降序，最多DiskIoSampler::kMaxTopCount个
+    QVector<float> coreUsage;       // 每个核心的使用率 (0-100)，按核心编号排列
+    QVector<float> coreFrequencyMhz; // 每个核心的当前频率 (MHz)，0表示平台不提供
+    QVector<ProcessSample> topCpuProcesses;     // 按CPU降序，最多ProcessScanner::kMaxTopCount个
+    QVector<ProcessSample> topMemoryProcesses;  // 按常驻内存降序
+    ProcessScanStats processScanStats;
+    QVector<InterfaceThroughput> topInterfaces; // 按收发速率之和降序，最多NetworkSampler::kMaxTopCount个
+    MetricSources updatedSources;   // 本次采样更新过的来源，其余字段沿用上一次的值
+    QDateTime timestamp;            // 数据时间戳
+};
+
+// MetricsSampler - 读取CPU、内存、磁盘、网络和进程的当前值：
+// 持有常开的系统句柄和计算差值所需的上一次读数，PerformanceMonitor的采样线程和
+// uwidget-procbench使用同一份实现。挂载点容量（Volumes）由PerformanceMonitor读取。
+// 状态属于各实例，只在一个线程中使用，不加锁
+class MetricsSampler {
+public:
+    MetricsSampler();
+    ~MetricsSampler();
+    MetricsSampler(const MetricsSampler&) = delete;
+    MetricsSampler& operator=(const MetricsSampler&) = delete;
+
+    // 采样sources中的来源，只写入data中对应的字段；读取失败的来源保持原值
+    void sample(MetricSources sources, PerformanceData& data);
+    // 网络总量和接口列表忽略的接口名前缀
+    void setIgnoredInterfaces(const QStringList& prefixes);
+
+private:
+    double getCpuUsage();
+    double updateCpuUsage(quint64 total, quint64 idle);
+    void getMemoryInfo(qint64& total, qint64& used);
+    void sampleDisks(PerformanceData& data);
+    void sampleNetwork(PerformanceData& data);
+
+#ifdef Q_OS_WIN
+    void initializePdh();
+    void uninitializePdh();
+    double getCpuUsagePdh();
+    void getPerCoreInfoPdh(QVector<float>& usage, QVector<float>& frequencyMhz);
+    bool readPdhCoreArray(PDH_HCOUNTER counter, QVector<float>& values);
+#endif
+
+#ifdef Q_OS_LINUX
+    void getPerCoreInfo(QVector<float>& usage, QVector<float>& frequencyMhz, double* totalUsage);
+#endif
+
+private:
+    quint64 m_lastCpuTotal;                  // 上一次读取的累计CPU时间片（Windows为100ns单位）
+    quint64 m_lastCpuIdle;
+    double m_lastCpuUsage;
+
+    ProcessScanner m_processScanner;
+    NetworkSampler m_networkSampler;
+    DiskIoSampler m_diskSampler;
+
+#ifdef Q_OS_WIN
+    PDH_HQUERY m_hQuery;
+    PDH_HCOUNTER m_hCpuTotal;
+    PDH_HCOUNTER m_hCoreTime;                   // \Processor Information(*)\% Processor Time
+    PDH_HCOUNTER m_hCoreFrequency;              // \Processor Information(*)\Processor Frequency
+    QByteArray m_pdhArrayBuffer;                // 复用的计数器数组缓冲区
+    std::vector<std::pair<int, float>> m_pdhCoreValues; // 核心排序键 -> 数值
+#endif
+
+#ifdef Q_OS_LINUX
+    // 常开的/proc文件，每次采样从头pread一次
+    ProcFs::ProcFile m_statFile;
+    ProcFs::ProcFile m_meminfoFile;
+    ProcFs::ProcBuffer m_readBuffer;          // 复用的读取缓冲区
+    // 每个核心的累计时间片，按核心编号连续存放，便于向量化计算差值
+    std::vector<quint64> m_coreTotal;
+    std::vector<quint64> m_coreIdle;
+    std::vector<quint64> m_prevCoreTotal;
+    std::vector<quint64> m_prevCoreIdle;
+    std::vector<ProcFs::ProcFile> m_coreFrequencyFiles; // cpufreq/scaling_cur_freq，未打开表示不可用
+#endif
+};
@@ -0,0 +1,107 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+// MpscRingBuffer - 有界无锁多生产者单消费者环形队列：
+// 每个槽位带有序号，生产者通过CAS抢占写入位置，消费者按顺序读取；
+// 队列满时tryPush()立即返回false，由调用方决定丢弃还是等待
+template <typename T>
+class MpscRingBuffer {
+public:
+    explicit MpscRingBuffer(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        m_mask = size - 1;
+        m_slots.reset(new Slot[size]);
+        for (size_t i = 0; i < size; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        m_enqueuePos.store(0, std::memory_order_relaxed);
+        m_dequeuePos.store(0, std::memory_order_relaxed);
+    }
+
+    MpscRingBuffer(const MpscRingBuffer&) = delete;
+    MpscRingBuffer& operator=(const MpscRingBuffer&) = delete;
+
+    // 可由任意线程调用
+    bool tryPush(T&& value) {
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        Slot* slot = nullptr;
+        for (;;) {
+            slot = &m_slots[pos & m_mask];
+            const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = intptr_t(sequence) - intptr_t(pos);
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;   // 队列已满
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->value = std::move(value);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 只能由唯一的消费者线程调用
+    bool tryPop(T& value) {
+        const size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        Slot* slot = &m_slots[pos & m_mask];
+        const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        if (intptr_t(sequence) - intptr_t(pos + 1) < 0) {
+            return false;   // 队列为空，或队首的生产者尚未写完
+        }
+
+        value = std::move(slot->value);
+        slot->value = T();
+        slot->sequence.store(pos + m_mask + 1, std::memory_order_release);
+        m_dequeuePos.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // 崩溃处理专用：只读地依次访问已写完但尚未被取出的元素，不修改队列、不分配内存也不加锁。
+    // 与生产者或消费者并发时只是尽力而为，正在写入的槽位被跳过
+    template <typename Visitor>
+    void peekPending(Visitor&& visit) const {
+        const size_t begin = m_dequeuePos.load(std::memory_order_acquire);
+        const size_t end = m_enqueuePos.load(std::memory_order_acquire);
+        for (size_t pos = begin; pos != end && pos - begin <= m_mask; ++pos) {
+            const Slot& slot = m_slots[pos & m_mask];
+            if (slot.sequence.load(std::memory_order_acquire) == pos + 1) {
+                visit(slot.value);
+            }
+        }
+    }
+
+    bool isEmpty() const {
+        return m_enqueuePos.load() == m_dequeuePos.load();
+    }
+
+    size_t sizeApprox() const {
+        const size_t enqueued = m_enqueuePos.load(std::memory_order_relaxed);
+        const size_t dequeued = m_dequeuePos.load(std::memory_order_relaxed);
+        return enqueued >= dequeued ? enqueued - dequeued : 0;
+    }
+
+    size_t capacity() const { return m_mask + 1; }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    size_t m_mask;
+    alignas(64) std::atomic<size_t> m_enqueuePos;
+    alignas(64) std::atomic<size_t> m_dequeuePos;
+};
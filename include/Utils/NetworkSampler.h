@@ -0,0 +1,90 @@
+#pragma once
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <utility>
+#include <vector>
+
+#ifdef Q_OS_LINUX
+#include "Utils/ProcReader.h"
+#endif
+
+// 单个网络接口的吞吐
+struct InterfaceThroughput {
+    QString name;
+    double uploadKBps = 0.0;        // 发送速度 (KB/s)
+    double downloadKBps = 0.0;      // 接收速度 (KB/s)
+    quint64 txBytes = 0;            // 累计发送字节
+    quint64 rxBytes = 0;            // 累计接收字节
+};
+
+// NetworkSampler - 按接口分别统计的网络吞吐：
+// 每个接口单独保存上一次的64位累计计数，分别计算收发速率；
+// 回环接口总是忽略，名称以过滤前缀开头的接口（容器、虚拟网桥等）不计入总量也不列出。
+// 当前的计数来源（/proc/net/dev、GetIfTable2）都是64位，计数器变小只能是接口重建或驱动重置，
+// 该周期速率记为0并以新读数为基准；只有已知为32位的来源（如旧的GetIfTable）才按回绕处理。
+// 状态属于各实例，只在采样线程中使用，不加锁
+class NetworkSampler {
+public:
+    static constexpr int kMaxTopCount = 8;      // topInterfaces最多返回的接口数
+
+    NetworkSampler();
+    ~NetworkSampler();
+    NetworkSampler(const NetworkSampler&) = delete;
+    NetworkSampler& operator=(const NetworkSampler&) = delete;
+
+    // 默认忽略的接口名前缀
+    static QStringList defaultIgnoredPrefixes();
+    // 前缀不区分大小写；修改后已跟踪的接口重新判断
+    void setIgnoredPrefixes(const QStringList& prefixes);
+
+    // 读取所有接口的计数器并更新速率，失败时返回false且速率不变
+    bool sample();
+
+    double uploadKBps() const { return m_uploadKBps; }
+    double downloadKBps() const { return m_downloadKBps; }
+
+    // 按收发速率之和取前count个接口
+    void topInterfaces(int count, QVector<InterfaceThroughput>& out);
+
+    // 两次读数之间的差值；counterBits为32时计数器变小按回绕处理，否则视为重置并返回0
+    static quint64 counterDelta(quint64 current, quint64 previous, int counterBits = 64);
+
+private:
+    struct Entry {
+        QString name;
+        quint64 rxBytes = 0;
+        quint64 txBytes = 0;
+        double uploadKBps = 0.0;
+        double downloadKBps = 0.0;
+        quint64 generation = 0;     // 最近一次出现的采样轮次，接口消失后清理
+        bool hasBaseline = false;
+        bool loopback = false;
+        bool ignored = false;       // 回环或匹配过滤前缀
+    };
+
+    using EntryMap = QHash<QByteArray, Entry>;
+
+    bool readCounters();
+    EntryMap::iterator addEntry(const QByteArray& key, const QString& name, bool loopback);
+    void updateCounters(Entry& entry, quint64 rxBytes, quint64 txBytes);
+    bool isIgnored(const QString& name) const;
+
+    EntryMap m_entries;                      // Linux以接口名、Windows以LUID为键
+    QStringList m_ignoredPrefixes;
+    QElapsedTimer m_clock;                   // 从上一次成功读取计数器开始计时
+    qint64 m_elapsedMs;                      // 本次与上一次成功采样的间隔
+    quint64 m_generation;
+    double m_uploadKBps;
+    double m_downloadKBps;
+    std::vector<std::pair<double, const Entry*>> m_ranking; // 复用的排序数组
+
+#ifdef Q_OS_LINUX
+    ProcFs::ProcFile m_netDevFile;
+    ProcFs::ProcBuffer m_readBuffer;
+#endif
+};
@@ -0,0 +1,137 @@
+#pragma once
+#include "Utils/MetricsArchive.h"
+#include "Utils/MetricsHistory.h"
+#include "Utils/MetricsSampler.h"
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+#include <functional>
+#include <memory>
+
+// 发布给订阅者的快照，发布后不再修改，可在线程间共享而无需加锁
+using PerformanceSnapshot = std::shared_ptr<const PerformanceData>;
+
+// 采样开销和调度精度统计
+struct SamplingStats {
+    quint64 sampleCount = 0;        // 采样次数
+    double lastCostUs = 0.0;        // 最近一次采样耗时（微秒）
+    double avgCostUs = 0.0;         // 平均采样耗时（微秒）
+    double maxCostUs = 0.0;         // 最大采样耗时（微秒）
+    double lastJitterUs = 0.0;      // 最近一次采样相对计划时间的偏差（微秒，正数为延迟）
+    double avgJitterUs = 0.0;       // 偏差绝对值的平均（微秒）
+    double maxJitterUs = 0.0;       // 偏差绝对值的最大值（微秒）
+    int shortestIntervalMs = 0;     // 自适应调整后最短的来源采样周期，0表示没有来源在采样
+};
+
+using MetricSubscriptionId = quint64;
+
+// PerformanceMonitor - 进程内共享的性能采样线程：
+// 小组件按需订阅指标来源和刷新周期，每个来源按订阅者中最短的周期只采样一次，
+// 采样结果作为不可变快照在界面线程中分发给各订阅者；
+// 没有活动订阅时采样线程休眠，因此打开多少个监控小组件都只有一个采样线程。
+// 每次采样同时追加到磁盘上的归档，采样线程启动时从归档恢复历史数据
+class PerformanceMonitor : public QThread {
+    Q_OBJECT
+
+public:
+    static PerformanceMonitor& instance();
+    // 已创建的实例，不会创建新实例；应用程序退出阶段析构的对象用它退订
+    static PerformanceMonitor* existingInstance();
+
+    explicit PerformanceMonitor(QObject* parent = nullptr);
+    ~PerformanceMonitor();
+
+    // 以下订阅接口只能在界面线程中调用；receiver销毁时自动退订
+    MetricSubscriptionId subscribe(QObject* receiver, MetricSources sources, int intervalMs,
+                                   std::function<void(const PerformanceSnapshot&)> callback);
+    void unsubscribe(MetricSubscriptionId id);
+    void updateSubscription(MetricSubscriptionId id, MetricSources sources, int intervalMs);
+    void setSubscriptionActive(MetricSubscriptionId id, bool active);
+    // 自适应订阅允许采样线程调整周期：数值剧烈变化或被查看时加快，长时间平稳时放慢
+    void setSubscriptionAdaptive(MetricSubscriptionId id, bool adaptive);
+    // 订阅者正被用户查看（例如鼠标悬停）时，自适应订阅的来源按较快的周期采样
+    void setSubscriptionFocused(MetricSubscriptionId id, bool focused);
+    // 按intervalMs订阅的来源相邻两次采样的最长间隔：来源周期不长于任何订阅者的周期，
+    // 自适应订阅在平稳时最多放慢到几倍；历史曲线据此判断缺数据
+    static int longestSampleInterval(int intervalMs, bool adaptive);
+
+    // 网络总量和接口列表忽略的接口名前缀，对所有订阅者生效；可在任意线程调用
+    void setIgnoredInterfaces(const QStringList& prefixes);
+    // 归档的保留天数，对所有订阅者生效；可在任意线程调用
+    void setArchiveRetentionDays(int days);
+
+    void stopMonitoring();
+    PerformanceSnapshot latestSnapshot() const;
+    SamplingStats getSamplingStats() const;
+
+    // 采样线程写入的历史数据，可在任意线程查询
+    const MetricsHistory& history() const { return m_history; }
+
+protected:
+    void run() override;
+
+private:
+    struct Subscription {
+        QObject* receiver = nullptr;
+        MetricSources sources;
+        int intervalMs = 1000;
+        std::function<void(const PerformanceSnapshot&)> callback;
+        bool active = true;
+        bool adaptive = false;
+        bool focused = false;
+        qint64 lastDeliveredMs = -1;
+        QMetaObject::Connection receiverConnection;
+    };
+
+    static constexpr int kSourceCount = 7;
+
+    // 一个来源的采样要求，由订阅表汇总得到
+    struct SourceSchedule {
+        int intervalMs = 0;         // 订阅者中最短的周期，0表示无人订阅
+        bool adaptive = false;      // 有自适应订阅者：允许加快
+        bool fixed = false;         // 有固定周期的订阅者：不允许放慢
+        bool focused = false;       // 有正被查看的自适应订阅者
+    };
+
+    void updateSchedule();
+    void deliver(const PerformanceSnapshot& snapshot);
+    int effectiveInterval(int source) const;
+    void updateCadence(MetricSources sources, const PerformanceData& data);
+    void collectPerformanceData(MetricSources sources, double jitterUs);
+    void openArchive();
+    static MetricsArchiveRecord toArchiveRecord(const PerformanceData& data);
+
+private:
+    // 订阅表，只在界面线程中访问
+    QHash<MetricSubscriptionId, Subscription> m_subscriptions;
+    MetricSubscriptionId m_nextSubscriptionId;
+    QElapsedTimer m_deliveryClock;
+
+    // 采样计划，由m_scheduleMutex保护
+    QMutex m_scheduleMutex;
+    QWaitCondition m_scheduleCondition;
+    bool m_running;
+    SourceSchedule m_sourceSchedule[kSourceCount];
+    bool m_scheduleChanged;
+    QStringList m_pendingNetworkFilter;      // 等待采样线程应用的接口过滤规则
+    bool m_networkFilterChanged;
+    int m_pendingArchiveRetentionDays;       // 等待采样线程应用的归档保留天数
+    bool m_archiveRetentionChanged;
+
+    // 仅由采样线程访问
+    qint64 m_nextDueMs[kSourceCount];        // 各来源下次采样的截止时间（m_sampleClock的毫秒数）
+    QElapsedTimer m_sampleClock;             // 单调时钟，不受系统时间调整影响
+    double m_cadenceScale[kSourceCount];     // 自适应周期倍率，由最近的数值变化决定
+    int m_quietSamples[kSourceCount];        // 连续平稳的采样次数
+    double m_lastActivity[kSourceCount];     // 上一次采样用于判断变化的数值，负数表示尚无基准
+
+    MetricsSampler m_sampler;                // 仅由采样线程访问
+    MetricsArchive m_archive;                // 仅由采样线程访问
+
+    PerformanceSnapshot m_latest;
+    MetricsHistory m_history;
+    SamplingStats m_samplingStats;
+    mutable QMutex m_dataMutex;
+};
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <QtGlobal>
+#include <cstddef>
+#include <vector>
+
+// ProcReader - Linux监控路径共用的/proc读取和解析工具：
+// ProcFile把/proc文件保持常开，每次从偏移0 pread（/proc文件每次从头读取时重新生成内容）；
+// 结果读入调用方的栈缓冲区或可复用的ProcBuffer，Scanner在原地解析文本，
+// 稳态下整个采样路径没有堆分配。只在Linux上编译
+namespace ProcFs {
+
+// 可复用的读取缓冲区：文件第一次超出容量时加倍，之后一直复用
+class ProcBuffer {
+public:
+    explicit ProcBuffer(size_t initialCapacity = 16 * 1024);
+
+    const char* data() const { return m_storage.data(); }   // 以'\0'结尾
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_storage.size(); }
+
+private:
+    friend class ProcFile;
+    std::vector<char> m_storage;
+    size_t m_size;
+};
+
+class ProcFile {
+public:
+    ProcFile() = default;
+    explicit ProcFile(const char* path);
+    ~ProcFile();
+
+    ProcFile(ProcFile&& other) noexcept;
+    ProcFile& operator=(ProcFile&& other) noexcept;
+    ProcFile(const ProcFile&) = delete;
+    ProcFile& operator=(const ProcFile&) = delete;
+
+    bool open(const char* path);
+    bool openAt(int dirFd, const char* relativePath);
+    void close();
+    bool isOpen() const { return m_fd >= 0; }
+    int fd() const { return m_fd; }
+
+    // 读到缓冲区写满或文件结束，结果以'\0'结尾；返回读取的字节数，失败返回-1
+    qint64 read(char* buffer, size_t size) const;
+    // 只做一次pread：只需要文件开头几行时避免读取整个文件
+    qint64 readHead(char* buffer, size_t size) const;
+    // 读取整个文件到buffer，容量不足时扩容后重读
+    bool readAll(ProcBuffer& buffer) const;
+
+private:
+    int m_fd = -1;
+};
+
+// 打开、读取并关闭dirFd下的短期文件（如/proc/[pid]/stat），结果以'\0'结尾
+bool readFileAt(int dirFd, const char* relativePath, char* buffer, size_t size);
+
+// 在以'\0'结尾的文本上原地解析，不复制、不分配；
+// 数字为手写的十进制解析，不依赖locale，比strtoull快
+class Scanner {
+public:
+    explicit Scanner(const char* text) : m_cursor(text) {}
+
+    const char* position() const { return m_cursor; }
+    void seek(const char* position) { m_cursor = position; }
+    bool atEnd() const { return *m_cursor == '\0'; }
+    char peek() const { return *m_cursor; }
+
+    // 跳过空格和制表符，不跨行
+    void skipBlanks() {
+        while (*m_cursor == ' ' || *m_cursor == '\t') {
+            ++m_cursor;
+        }
+    }
+
+    // 移动到下一行开头，没有下一行时返回false
+    bool nextLine() {
+        while (*m_cursor && *m_cursor != '\n') {
+            ++m_cursor;
+        }
+        if (*m_cursor == '\0') {
+            return false;
+        }
+        ++m_cursor;
+        return *m_cursor != '\0';
+    }
+
+    bool startsWith(const char* prefix) const {
+        const char* p = m_cursor;
+        while (*prefix) {
+            if (*p++ != *prefix++) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 当前位置以prefix开头时跳过它
+    bool consume(const char* prefix) {
+        const char* p = m_cursor;
+        while (*prefix) {
+            if (*p++ != *prefix++) {
+                return false;
+            }
+        }
+        m_cursor = p;
+        return true;
+    }
+
+    // 从当前行起查找以prefix开头的行，找到后停在prefix之后
+    bool findLine(const char* prefix) {
+        do {
+            if (consume(prefix)) {
+                return true;
+            }
+        } while (nextLine());
+        return false;
+    }
+
+    // 向后跳过字符c（不跨行），找不到时返回false且位置不变
+    bool skipPast(char c) {
+        const char* p = m_cursor;
+        while (*p && *p != '\n' && *p != c) {
+            ++p;
+        }
+        if (*p != c) {
+            return false;
+        }
+        m_cursor = p + 1;
+        return true;
+    }
+
+    bool readUInt(quint64& value) {
+        skipBlanks();
+        const char* p = m_cursor;
+        quint64 result = 0;
+        while (static_cast<unsigned>(*p - '0') < 10u) {
+            result = result * 10 + static_cast<unsigned>(*p - '0');
+            ++p;
+        }
+        if (p == m_cursor) {
+            return false;
+        }
+        value = result;
+        m_cursor = p;
+        return true;
+    }
+
+    quint64 readUInt() {
+        quint64 value = 0;
+        readUInt(value);
+        return value;
+    }
+
+    bool readInt(qint64& value) {
+        skipBlanks();
+        const bool negative = *m_cursor == '-';
+        const char* start = m_cursor;
+        if (negative) {
+            ++m_cursor;
+        }
+        quint64 magnitude = 0;
+        if (!readUInt(magnitude)) {
+            m_cursor = start;
+            return false;
+        }
+        value = negative ? -static_cast<qint64>(magnitude) : static_cast<qint64>(magnitude);
+        return true;
+    }
+
+    // 读取一个由空白分隔的字段，返回[begin, end)
+    bool readToken(const char*& begin, const char*& end) {
+        skipBlanks();
+        const char* p = m_cursor;
+        while (*p && *p != ' ' && *p != '\t' && *p != '\n') {
+            ++p;
+        }
+        if (p == m_cursor) {
+            return false;
+        }
+        begin = m_cursor;
+        end = p;
+        m_cursor = p;
+        return true;
+    }
+
+    void skipFields(int count) {
+        const char* begin;
+        const char* end;
+        for (int i = 0; i < count && readToken(begin, end); ++i) {
+        }
+    }
+
+private:
+    const char* m_cursor;
+};
+
+// 以下解析函数由PerformanceMonitor和uwidget-procbench共用
+
+// 解析"cpu"或"cpuN"之后的时间片：user nice system idle iowait irq softirq steal；
+// idle包含iowait
+void parseCpuTimes(Scanner& scanner, quint64& total, quint64& idle);
+
+// 只解析/proc/stat开头的"cpu"汇总行
+bool parseCpuSummary(const char* text, quint64& total, quint64& idle);
+
+// 解析整个/proc/stat：汇总行写入total和idle，"cpuN"行写入coreTotal[N]和coreIdle[N]，
+// 只在出现更大的核心编号时扩容。返回是否找到汇总行
+bool parseCpuStat(const char* text, quint64& total, quint64& idle,
+                  std::vector<quint64>& coreTotal, std::vector<quint64>& coreIdle);
+
+// 由两次读数计算每个核心的使用率 (0-100)
+void computeCoreUsage(const quint64* total, const quint64* idle,
+                      const quint64* prevTotal, const quint64* prevIdle,
+                      float* usage, size_t count);
+
+// 解析/proc/meminfo的总内存和可用内存（kB），没有MemTotal时返回false
+bool parseMemInfo(const char* text, quint64& totalKb, quint64& availableKb);
+
+// /proc/[pid]/stat中需要的字段，name指向原文本中括号内的进程名
+struct ProcessStat {
+    const char* name = nullptr;
+    size_t nameLength = 0;
+    quint64 cpuTime = 0;            // utime + stime（时钟滴答）
+    quint64 startTime = 0;          // 系统启动后的时钟滴答，用于识别PID复用
+};
+
+// 解析/proc/[pid]/stat，格式不完整时返回false
+bool parseProcessStat(const char* text, ProcessStat& stat);
+
+} // namespace ProcFs
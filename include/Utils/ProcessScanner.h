@@ -0,0 +1,94 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <utility>
+#include <vector>
+
+#ifdef Q_OS_LINUX
+#include <dirent.h>
+#endif
+
+// 进程采样结果
+struct ProcessSample {
+    qint64 pid = 0;
+    QString name;
+    float cpuPercent = 0.0f;        // 占单个核心的百分比，与top一致，多线程进程可超过100
+    qint64 rssBytes = 0;            // 常驻内存（Windows为工作集）
+};
+
+// 进程扫描开销统计
+struct ProcessScanStats {
+    quint64 scanCount = 0;          // 扫描次数
+    int processCount = 0;           // 当前跟踪的进程数
+    int refreshedCount = 0;         // 最近一次扫描刷新的进程数
+    double lastScanUs = 0.0;        // 最近一次扫描耗时（微秒）
+    double avgScanUs = 0.0;         // 平均扫描耗时（微秒）
+    double maxScanUs = 0.0;         // 最大扫描耗时（微秒）
+    quint64 budgetHits = 0;         // 因超出预算而中途停止的次数
+};
+
+// ProcessScanner - 增量的进程扫描器：
+// 在两次扫描之间保留每个进程的状态（上次的CPU时间、名称、启动时间），
+// 每次扫描最多花费一个时间预算（默认kScanBudgetUs），没扫完的进程留到下一次继续，
+// 因此在有数千个进程的系统上每次采样的开销也有上限；
+// 一轮扫描结束时清理已退出的进程。只在采样线程中使用，不加锁
+class ProcessScanner {
+public:
+    static constexpr int kScanBudgetUs = 5000;   // 每次扫描的时间预算
+    static constexpr int kMaxTopCount = 10;      // topByCpu/topByMemory最多返回的进程数
+
+    ProcessScanner();
+#ifdef Q_OS_LINUX
+    // 从procRoot（默认/proc）枚举进程，便于在测试中使用伪造的目录
+    explicit ProcessScanner(const char* procRoot);
+#endif
+    ~ProcessScanner();
+    ProcessScanner(const ProcessScanner&) = delete;
+    ProcessScanner& operator=(const ProcessScanner&) = delete;
+
+    void scan();
+    void setScanBudgetUs(int budgetUs) { m_scanBudgetUs = qMax(0, budgetUs); }
+
+    // 按CPU或常驻内存取前count个进程，使用部分选择而不是全排序
+    void topByCpu(int count, QVector<ProcessSample>& out);
+    void topByMemory(int count, QVector<ProcessSample>& out);
+
+    const ProcessScanStats& stats() const { return m_stats; }
+
+private:
+    struct Entry {
+        QString name;
+        quint64 cpuTime = 0;        // 累计CPU时间（Linux为时钟滴答，Windows为100ns）
+        quint64 startTime = 0;      // 进程启动时间，用于识别PID复用
+        qint64 lastSampleMs = -1;
+        float cpuPercent = 0.0f;
+        qint64 rssBytes = 0;
+        quint64 generation = 0;     // 最近一次在枚举中出现的轮次
+        void* handle = nullptr;     // Windows进程句柄，保持打开以免每次扫描重新打开（句柄打开期间PID不会被复用）
+    };
+
+    bool enumerateProcesses();
+    bool sampleProcess(qint64 pid, Entry& entry);
+    void releaseEntry(Entry& entry);
+    void finishRound();
+    void selectTop(int count, bool byCpu, QVector<ProcessSample>& out);
+
+    QHash<qint64, Entry> m_entries;
+    std::vector<qint64> m_pids;         // 本轮枚举到的进程，复用以避免每次分配
+    size_t m_cursor;                    // 本轮下一个要采样的位置
+    quint64 m_generation;
+    int m_scanBudgetUs;
+    std::vector<std::pair<qint64, const Entry*>> m_ranking; // 部分选择用的复用数组
+    QElapsedTimer m_clock;
+    ProcessScanStats m_stats;
+
+#ifdef Q_OS_LINUX
+    DIR* m_procDir;
+    int m_procFd;                       // /proc目录，用openat读取各进程文件
+    long m_clockTicks;
+    long m_pageSize;
+#endif
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <QString>
+#include <QMap>
+#include <QPair>
+#include <memory>
+
+// SystemInfoBackend - 系统信息的平台实现：
+// 每个平台在各自的源文件中实现本接口和create()，CMake只编译当前平台的实现，
+// Windows和Linux之外的平台使用SystemInfoBackendGeneric.cpp；
+// 磁盘空间由PerformanceMonitor的采样线程周期调用，实现中不应启动进程或做阻塞I/O；
+// CPU和内存使用率由PerformanceMonitor直接采样，不经过本接口
+class SystemInfoBackend {
+public:
+    virtual ~SystemInfoBackend() = default;
+
+    static std::unique_ptr<SystemInfoBackend> create();
+
+    // 静态信息，由SystemInfoCollector缓存
+    virtual QString cpuModel() = 0;
+    virtual void osInfo(QString& osName, QString& osVersion, QString& computerName, QString& userName) = 0;
+
+    // 周期采样
+    virtual QMap<QString, QPair<qint64, qint64>> diskSpace() = 0;  // 挂载点 -> {总空间, 可用空间}
+};
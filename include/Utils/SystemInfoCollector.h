@@ -2,6 +2,9 @@
 
 #include <QString>
 #include <QMap>
+#include <memory>
+
+class SystemInfoBackend;
 
 class SystemInfoCollector {
 public:
@@ -28,18 +31,28 @@ public:
         QMap<QString, QPair<qint64, qint64>> diskSpace; // 盘符 -> {总空间, 可用空间}
     };
 
-    SystemInfo collectSystemInfo();
-    double getCurrentCpuUsage();
-    void updateMemoryInfo(qint64& total, qint64& available);
+    // 只填充CPU型号、核心数和系统信息，不做任何采样；
+    // 使用率、内存和磁盘由PerformanceMonitor的采样线程读取，界面线程应订阅其快照
+    SystemInfo collectStaticInfo();
     QMap<QString, QPair<qint64, qint64>> getDiskSpace();
 
 private:
-    SystemInfoCollector() = default;
-    ~SystemInfoCollector() = default;
+    SystemInfoCollector();
+    ~SystemInfoCollector();
     SystemInfoCollector(const SystemInfoCollector&) = delete;
     SystemInfoCollector& operator=(const SystemInfoCollector&) = delete;
 
     QString getCpuModel();
     int getCpuCores();
     void getSystemInfo(QString& osName, QString& osVersion, QString& computerName, QString& userName);
+
+    std::unique_ptr<SystemInfoBackend> m_backend;
+
+    // CPU型号和系统信息在运行期间不变，只查询一次
+    bool m_staticInfoLoaded;
+    QString m_cpuModel;
+    QString m_osName;
+    QString m_osVersion;
+    QString m_computerName;
+    QString m_userName;
 }; 
\ No newline at end of file
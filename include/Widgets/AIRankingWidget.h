@@ -44,6 +44,8 @@ protected:
     void drawContent(QPainter& painter) override;
     void applyConfig() override;
     void resizeEvent(QResizeEvent* event) override;
+    void onSuspended() override;
+    void onResumed() override;
 
 private slots:
     void onNetworkReplyFinished();
@@ -68,6 +70,7 @@ private:
     void parseDefaultData(const QJsonDocument& doc);
     void initializeRecentModelData();
     
+    void drawFrame(QPainter& painter);
     void drawHeader(QPainter& painter);
     void drawRankingList(QPainter& painter);
     void drawModelItem(QPainter& painter, const AIModelInfo& model, const QRect& itemRect, bool isEven);
@@ -79,7 +82,7 @@ private:
 private:
     // 网络管理
     QNetworkAccessManager* m_networkManager;
-    QTimer* m_refreshTimer;
+    TickJobId m_refreshJob;         // 共享调度器中的刷新任务
     
     // 数据存储
     QList<AIModelInfo> m_aiModels;
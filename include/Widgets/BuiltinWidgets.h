@@ -0,0 +1,7 @@
+#pragma once
+
+class WidgetTypeRegistry;
+
+// 把随程序一起编译的小组件类型注册到注册表，需在扫描插件目录之前调用，
+// 内置类型优先占用对应的WidgetType
+void registerBuiltinWidgets(WidgetTypeRegistry& registry);
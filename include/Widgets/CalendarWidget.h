@@ -30,6 +30,7 @@ private:
     void parseCustomSettings();
     void loadBackgroundImage();
     void drawBackground(QPainter& painter);
+    void drawFrame(QPainter& painter);
     void drawCalendarGrid(QPainter& painter);
     void drawHeader(QPainter& painter);
     void drawWeekHeaders(QPainter& painter);
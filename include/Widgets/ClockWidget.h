@@ -25,6 +25,7 @@ private:
     void parseCustomSettings();
     void loadBackgroundImage();
     void drawBackground(QPainter& painter);
+    void drawFrame(QPainter& painter);
 
 private:
     QDateTime m_currentTime;
@@ -21,7 +21,6 @@ public:
 
 protected:
     void drawContent(QPainter& painter) override;
-    void paintEvent(QPaintEvent* event) override;
     void applyConfig() override;
     void resizeEvent(QResizeEvent* event) override;
     void contextMenuEvent(QContextMenuEvent* event) override;
@@ -36,6 +35,7 @@ private slots:
 
 private:
     void setupUI();
+    void drawPaper(QPainter& painter);
     void parseCustomSettings();
     void saveNote();
     void loadNote();
@@ -69,6 +69,6 @@ private:
     QColor m_backgroundColor;
     QColor m_widgetBackgroundColor;
     
-    // 定时器
-    QTimer* m_autoSaveTimer;
+    // 共享调度器中的自动保存任务
+    TickJobId m_autoSaveJob;
 }; 
\ No newline at end of file
@@ -2,10 +2,10 @@
 
 #include "Core/BaseWidget.h"
 #include "Utils/SystemInfoCollector.h"
+#include "Utils/PerformanceMonitor.h"
 #include <QLabel>
 #include <QVBoxLayout>
 #include <QProgressBar>
-#include <QTimer>
 #include <QMap>
 
 class QGridLayout;
@@ -21,17 +21,20 @@ protected:
     // BaseWidget纯虚函数实现
     void updateContent() override;
     void drawContent(QPainter& painter) override;
+    void onSuspended() override;
+    void onResumed() override;
 
 private:
     void initUI();
     void initConnections();
     void updateTheme();
 
-private slots:
     void updateSystemInfo();
-    void updateCPUUsage();
-    void updateMemoryUsage();
-    void updateDiskUsage();
+    void applySnapshot(const PerformanceData& data);
+    void updateCPUUsage(const PerformanceData& data);
+    void updateMemoryUsage(const PerformanceData& data);
+    void updateDiskUsage(const PerformanceData& data);
+    void rebuildDiskRows(const QMap<QString, QPair<qint64, qint64>>& volumes);
 
 private:
     QString formatSize(qint64 bytes);
@@ -56,6 +59,6 @@ private:
     QMap<QString, QProgressBar*> diskUsageBars;
     QMap<QString, QLabel*> diskLabels;
     
-    QTimer* updateTimer;
+    MetricSubscriptionId usageSubscription;   // 使用率来自共享采样线程
     SystemInfoCollector& systemInfo;
 }; 
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 #include "Core/BaseWidget.h"
+#include "Utils/PerformanceMonitor.h"
 #include <QDateTime>
+#include <QEnterEvent>
 #include <QFont>
 #include <QColor>
 #include <QPainter>
@@ -8,78 +10,7 @@
 #include <QList>
 #include <QTimer>
 #include <QMutex>
-#include <QThread>
-#include <QProcess>
-#include <QRegularExpression>
-
-#ifdef Q_OS_WIN
-#include <windows.h>
-#include <pdh.h>
-#endif
-
-// 性能数据结构
-struct PerformanceData {
-    double cpuUsage = 0.0;          // CPU使用率 (0-100)
-    double memoryUsage = 0.0;       // 内存使用率 (0-100)
-    double diskUsage = 0.0;         // 磁盘使用率 (0-100)
-    double networkUpload = 0.0;     // 网络上传速度 (KB/s)
-    double networkDownload = 0.0;   // 网络下载速度 (KB/s)
-    qint64 totalMemory = 0;         // 总内存 (MB)
-    qint64 usedMemory = 0;          // 已用内存 (MB)
-    qint64 totalDisk = 0;           // 总磁盘空间 (GB)
-    qint64 usedDisk = 0;            // 已用磁盘空间 (GB)
-    QDateTime timestamp;            // 数据时间戳
-};
-
-// 性能监测线程
-class PerformanceMonitor : public QThread {
-    Q_OBJECT
-
-public:
-    explicit PerformanceMonitor(QObject* parent = nullptr);
-    ~PerformanceMonitor();
-    
-    void stopMonitoring();
-    PerformanceData getCurrentData() const;
-
-protected:
-    void run() override;
-
-signals:
-    void dataUpdated(const PerformanceData& data);
-
-private:
-    void collectPerformanceData();
-    double getCpuUsage();
-    void getMemoryInfo(qint64& total, qint64& used);
-    void getDiskInfo(qint64& total, qint64& used);
-    void getNetworkInfo(double& upload, double& download);
-
-    // PDH相关函数
-    void initializePdh();
-    void uninitializePdh();
-    double getCpuUsagePdh();
-    double getDiskUsagePdh();
-    void getNetworkInfoPdh(double& upload, double& download);
-
-private:
-    bool m_running;
-    PerformanceData m_currentData;
-    mutable QMutex m_dataMutex;
-    
-    // 网络监测相关
-    qint64 m_lastBytesReceived;
-    qint64 m_lastBytesSent;
-    QDateTime m_lastNetworkCheckTime;
-
-    // PDH相关成员变量
-#ifdef Q_OS_WIN
-    PDH_HQUERY m_hQuery;
-    PDH_HCOUNTER m_hCpuTotal;
-    PDH_HCOUNTER m_hDiskTime;
-    PDH_HCOUNTER m_hNetworkTotal;
-#endif
-};
+#include <memory>
 
 class SystemPerformanceWidget : public BaseWidget {
     Q_OBJECT
@@ -93,24 +24,46 @@ public:
 protected:
     void drawContent(QPainter& painter) override;
     void applyConfig() override;
-
-private slots:
-    void onPerformanceDataUpdated(const PerformanceData& data);
+    void onSuspended() override;
+    void onResumed() override;
+    void enterEvent(QEnterEvent* event) override;
+    void leaveEvent(QEvent* event) override;
 
 private:
+    void onPerformanceDataUpdated(const PerformanceData& data);
+    MetricSources subscribedSources() const;
     void setupDefaultConfig();
     void parseCustomSettings();
-    void drawPerformanceGraph(QPainter& painter, const QRect& rect, 
-                             const QString& label, double value, 
+    void loadReplay(const QDateTime& from, const QDateTime& to);
+    void applyReplay(quint64 generation, const std::shared_ptr<MetricsHistory>& history,
+                     qint64 endMs, int windowSeconds);
+    bool showsSparkline() const { return m_graphStyle == GraphStyle::Sparkline || m_replayHistory; }
+    
+    // 静态部分（标签、进度条底色）进入图层缓存，动态部分（数值、进度）每次重绘
+    enum class PaintPass { Static, Dynamic };
+    void drawFrame(QPainter& painter);
+    void drawItems(QPainter& painter, PaintPass pass);
+    void drawPerformanceGraph(QPainter& painter, const QRect& rect, PaintPass pass,
+                             const QString& label, HistoryMetric metric, double value, 
                              const QColor& color, const QString& unit = "%");
-    void drawProgressBar(QPainter& painter, const QRect& rect, 
+    void drawProgressBar(QPainter& painter, const QRect& rect, PaintPass pass,
                         double value, const QColor& color);
-    void drawMemoryInfo(QPainter& painter, const QRect& rect);
-    void drawDiskInfo(QPainter& painter, const QRect& rect);
-    void drawNetworkInfo(QPainter& painter, const QRect& rect);
+    // 进度条或历史曲线，由graphStyle决定
+    void drawValueTrack(QPainter& painter, const QRect& rect, PaintPass pass,
+                        HistoryMetric metric, double value, const QColor& color);
+    void drawSparkline(QPainter& painter, const QRect& rect, PaintPass pass,
+                       HistoryMetric metric, const QColor& color);
+    void drawCoreHeatmap(QPainter& painter, const QRect& rect, PaintPass pass, const PerformanceData& data);
+    void drawMemoryInfo(QPainter& painter, const QRect& rect, PaintPass pass, const PerformanceData& data);
+    void drawDiskInfo(QPainter& painter, const QRect& rect, PaintPass pass, const PerformanceData& data);
+    void drawNetworkInfo(QPainter& painter, const QRect& rect, PaintPass pass, const PerformanceData& data);
+    void drawInterfaceTable(QPainter& painter, const QRect& rect, PaintPass pass, const PerformanceData& data);
+    void drawDiskDeviceTable(QPainter& painter, const QRect& rect, PaintPass pass, const PerformanceData& data);
+    void drawProcessTable(QPainter& painter, const QRect& rect, PaintPass pass, const PerformanceData& data);
+    void drawDebugOverlay(QPainter& painter, const PerformanceData& data);
 
 private:
-    PerformanceMonitor* m_monitor;
+    MetricSubscriptionId m_subscription;   // 在共享采样线程上的订阅
     PerformanceData m_currentData;
     QMutex m_dataMutex;
     
@@ -132,6 +85,26 @@ private:
     bool m_showDetailed;
     bool m_showProgressBars;
     
+    // 图表样式：Bar为当前值进度条，Sparkline为最近m_historyWindow秒的面积图
+    enum class GraphStyle { Bar, Sparkline };
+    GraphStyle m_graphStyle;
+    int m_historyWindow;            // 秒
+    bool m_showCoreHeatmap;         // CPU一栏显示每核心热力图
+    bool m_showProcesses;           // 显示占用最多的进程
+    bool m_sortProcessesByMemory;   // 进程按常驻内存排序，否则按CPU
+    int m_processCount;
+    bool m_showDebugOverlay;        // 在底部显示采样和进程扫描的开销
+    bool m_adaptiveSampling;        // 允许采样线程按数值变化和是否被查看调整刷新周期
+    bool m_showInterfaces;          // 网络一栏按接口分别显示
+    int m_interfaceCount;
+    bool m_showDiskDevices;         // 磁盘一栏按物理磁盘分别显示
+    int m_diskDeviceCount;
+    HistorySeries m_historySeries;  // 复用的查询缓冲区
+    std::shared_ptr<MetricsHistory> m_replayHistory;   // 从归档回放的历史，为空时曲线显示实时历史
+    qint64 m_replayEndMs;
+    int m_replayWindow;             // 秒
+    quint64 m_replayGeneration;     // 每次请求回放或取消回放时递增，丢弃过期的后台回放结果
+    
     int m_itemSpacing;
     int m_borderRadius;
     double m_backgroundOpacity;
@@ -71,6 +71,7 @@ private:
     QString getWeatherIconPath(const QString& iconCode) const;
     void loadWeatherIcons();
     double convertTemperature(double celsius) const;
+    void drawWeather(QPainter& painter);
     void drawMiniWeather(QPainter& painter, const QRect& rect);
     void drawCompactWeather(QPainter& painter, const QRect& rect);
     void drawDetailedWeather(QPainter& painter, const QRect& rect);
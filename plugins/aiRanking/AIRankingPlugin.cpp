@@ -0,0 +1,24 @@
+/**
+ * @file AIRankingPlugin.cpp
+ * @brief AI排行榜小组件插件
+ * @details AI排行榜依赖Qt Network，单独构建为插件库，只有配置中用到时才加载
+ * @version 1.0.0
+ */
+
+#include "Framework/BuiltinWidgetPlugin.h"
+#include "Widgets/AIRankingWidget.h"
+#include "BackendManagement/AIRankingConfigDialog.h"
+#include <QObject>
+
+class AIRankingWidgetPlugin : public QObject, public BuiltinWidgetPlugin<AIRankingWidget, AIRankingConfigDialog> {
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID IWidgetPlugin_iid FILE "aiRanking.json")
+    Q_INTERFACES(IWidgetPlugin)
+
+public:
+    // 默认尺寸和更新间隔与原先内置注册时一致
+    AIRankingWidgetPlugin()
+        : BuiltinWidgetPlugin("aiRanking", "AI排行榜", WidgetType::AIRanking, QSize(400, 300), 1000) {}
+};
+
+#include "AIRankingPlugin.moc"
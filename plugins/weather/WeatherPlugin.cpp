@@ -0,0 +1,24 @@
+/**
+ * @file WeatherPlugin.cpp
+ * @brief 天气小组件插件
+ * @details 天气小组件依赖Qt Network，单独构建为插件库，只有配置中用到时才加载
+ * @version 1.0.0
+ */
+
+#include "Framework/BuiltinWidgetPlugin.h"
+#include "Widgets/WeatherWidget.h"
+#include "BackendManagement/WeatherConfigDialog.h"
+#include <QObject>
+
+class WeatherWidgetPlugin : public QObject, public BuiltinWidgetPlugin<WeatherWidget, WeatherConfigDialog> {
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID IWidgetPlugin_iid FILE "weather.json")
+    Q_INTERFACES(IWidgetPlugin)
+
+public:
+    // 默认尺寸和更新间隔与原先内置注册时一致
+    WeatherWidgetPlugin()
+        : BuiltinWidgetPlugin("weather", "天气", WidgetType::Weather, QSize(250, 150), 300000) {}
+};
+
+#include "WeatherPlugin.moc"
@@ -1,4 +1,5 @@
 #include "BackendManagement/CreateWidgetDialog.h"
+#include "Framework/WidgetTypeRegistry.h"
 #include <QDateTime>
 #include <QMessageBox>
 #include <QScreen>
@@ -48,13 +49,11 @@ void CreateWidgetDialog::setupUI() {
     
     m_nameLineEdit = new QLineEdit;
     m_typeComboBox = new QComboBox;
-    m_typeComboBox->addItem("时钟", static_cast<int>(WidgetType::Clock));
-    m_typeComboBox->addItem("天气", static_cast<int>(WidgetType::Weather));
-    m_typeComboBox->addItem("系统信息", static_cast<int>(WidgetType::SystemInfo));
-    m_typeComboBox->addItem("日历", static_cast<int>(WidgetType::Calendar));
-    m_typeComboBox->addItem("极简便签", static_cast<int>(WidgetType::SimpleNotes));
-    m_typeComboBox->addItem("AI排行榜", static_cast<int>(WidgetType::AIRanking));
-    m_typeComboBox->addItem("系统性能监测", static_cast<int>(WidgetType::SystemPerformance));
+    // 类型列表来自类型注册表，包括已发现但尚未加载的插件
+    const QList<WidgetTypeInfo> widgetTypes = WidgetTypeRegistry::instance().availableTypes();
+    for (const WidgetTypeInfo& info : widgetTypes) {
+        m_typeComboBox->addItem(info.displayName, info.typeKey);
+    }
     
     basicLayout->addRow("名称:", m_nameLineEdit);
     basicLayout->addRow("类型:", m_typeComboBox);
@@ -170,56 +169,15 @@ void CreateWidgetDialog::setupUI() {
 }
 
 void CreateWidgetDialog::onWidgetTypeChanged() {
-    WidgetType type = static_cast<WidgetType>(m_typeComboBox->currentData().toInt());
-    
-    // 根据Widget类型设置默认值
-    switch (type) {
-        case WidgetType::Clock:
-            m_nameLineEdit->setText("时钟");
-            m_widthSpinBox->setValue(200);
-            m_heightSpinBox->setValue(100);
-            m_updateIntervalSpinBox->setValue(1000);
-            break;
-        case WidgetType::Weather:
-            m_nameLineEdit->setText("天气");
-            m_widthSpinBox->setValue(250);
-            m_heightSpinBox->setValue(150);
-            m_updateIntervalSpinBox->setValue(300000); // 5分钟
-            break;
-        case WidgetType::SystemInfo:
-            m_nameLineEdit->setText("系统信息");
-            m_widthSpinBox->setValue(300);
-            m_heightSpinBox->setValue(200);
-            m_updateIntervalSpinBox->setValue(2000);
-            break;
-        case WidgetType::Calendar:
-            m_nameLineEdit->setText("日历");
-            m_widthSpinBox->setValue(250);
-            m_heightSpinBox->setValue(200);
-            m_updateIntervalSpinBox->setValue(60000); // 1分钟
-            break;
-        case WidgetType::SimpleNotes:
-            m_nameLineEdit->setText("极简便签");
-            m_widthSpinBox->setValue(250);
-            m_heightSpinBox->setValue(200);
-            m_updateIntervalSpinBox->setValue(0); // 不需要自动更新
-            break;
-        case WidgetType::AIRanking:
-            m_nameLineEdit->setText("AI排行榜");
-            m_widthSpinBox->setValue(400);
-            m_heightSpinBox->setValue(300);
-            m_updateIntervalSpinBox->setValue(1000); // 1秒更新间隔
-            break;
-        case WidgetType::SystemPerformance:
-            m_nameLineEdit->setText("系统性能监测");
-            m_widthSpinBox->setValue(280);
-            m_heightSpinBox->setValue(220);
-            m_updateIntervalSpinBox->setValue(2000); // 2秒更新间隔
-            break;
-        default:
-            m_nameLineEdit->setText("自定义组件");
-            break;
-    }
+    // 默认值由类型对应的插件提供，外部插件在首次选中时加载
+    const QString typeKey = m_typeComboBox->currentData().toString();
+    const WidgetConfig defaults = WidgetTypeRegistry::instance().defaultConfig(typeKey);
+    
+    m_nameLineEdit->setText(defaults.name.isEmpty() ? QString("自定义组件") : defaults.name);
+    m_widthSpinBox->setValue(defaults.size.width());
+    m_heightSpinBox->setValue(defaults.size.height());
+    m_updateIntervalSpinBox->setValue(defaults.updateInterval);
+    m_config.customSettings = defaults.customSettings;
     
     updatePreview();
 }
@@ -235,7 +193,7 @@ void CreateWidgetDialog::onAccept() {
     // 更新配置
     m_config.id = generateUniqueId();
     m_config.name = m_nameLineEdit->text().trimmed();
-    m_config.type = static_cast<WidgetType>(m_typeComboBox->currentData().toInt());
+    WidgetTypeRegistry::instance().setConfigType(m_config, m_typeComboBox->currentData().toString());
     m_config.position = QPoint(m_xSpinBox->value(), m_ySpinBox->value());
     m_config.size = QSize(m_widthSpinBox->value(), m_heightSpinBox->value());
     m_config.opacity = m_opacitySpinBox->value();
@@ -302,11 +260,9 @@ void CreateWidgetDialog::setWidgetConfig(const WidgetConfig& config) {
     m_nameLineEdit->setText(config.name);
     
     // 设置类型下拉框
-    for (int i = 0; i < m_typeComboBox->count(); ++i) {
-        if (static_cast<WidgetType>(m_typeComboBox->itemData(i).toInt()) == config.type) {
-            m_typeComboBox->setCurrentIndex(i);
-            break;
-        }
+    int typeIndex = m_typeComboBox->findData(WidgetTypeRegistry::instance().typeKeyOf(config));
+    if (typeIndex >= 0) {
+        m_typeComboBox->setCurrentIndex(typeIndex);
     }
     
     m_xSpinBox->setValue(config.position.x());
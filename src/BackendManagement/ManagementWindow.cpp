@@ -1,9 +1,7 @@
 #include "BackendManagement/ManagementWindow.h"
 #include "BackendManagement/CreateWidgetDialog.h"
-#include "BackendManagement/ConfigWindow.h"
-#include "BackendManagement/AIRankingConfigDialog.h"
-#include "BackendManagement/WeatherConfigDialog.h"
 #include "Framework/WidgetManager.h"
+#include "Framework/WidgetTypeRegistry.h"
 #include <QApplication>
 #include <QCloseEvent>
 #include <QHeaderView>
@@ -51,13 +49,9 @@ ManagementWindow::ManagementWindow(WidgetManager* widgetManager, QWidget* parent
     if (m_widgetManager) {
         connect(m_widgetManager, &WidgetManager::widgetPositionManuallyChanged,
                 this, &ManagementWindow::onWidgetManuallyMoved);
-        // 可以考虑在这里也连接widgetConfigUpdated信号，如果通过其他方式更新配置也需要刷新UI
-        connect(m_widgetManager, &WidgetManager::widgetConfigUpdated,
-            [this](const QString& widgetId, const WidgetConfig& /*config*/) {
-                if (widgetId == getCurrentSelectedWidgetId()) {
-                    updateSettingsPanel(); // 如果当前选中的组件配置被更新，则刷新设置面板
-                }
-            });
+        // 创建、删除和配置更新以变更集的形式通知，批量操作只刷新一次列表
+        connect(m_widgetManager, &WidgetManager::widgetsChanged,
+                this, &ManagementWindow::onWidgetsChanged);
     }
 }
 
@@ -69,15 +63,25 @@ void ManagementWindow::showAndRaise() {
     activateWindow();
 }
 
+void ManagementWindow::onWidgetsChanged(const WidgetChangeSet& changes) {
+    // 重建列表后恢复原来的选中项，被删除的除外
+    const QString selectedId = getCurrentSelectedWidgetId();
+    refreshWidgetList();
+    if (!selectedId.isEmpty() && !changes.removed.contains(selectedId)) {
+        restoreWidgetSelection(selectedId);
+    }
+}
+
 void ManagementWindow::refreshWidgetList() {
     if (!m_widgetListWidget) return;
     
     m_widgetListWidget->clear();
     
-    auto widgets = m_widgetManager->getAllWidgets();
-    for (const auto& widget : widgets) {
-        const auto& config = widget->getConfig();
-        WidgetStatus status = widget->getStatus();
+    // 尚未实例化的小组件（延迟加载）同样列出，状态取自管理器
+    const QStringList widgetIds = m_widgetManager->getWidgetIds();
+    for (const QString& widgetId : widgetIds) {
+        const WidgetConfig config = m_widgetManager->getWidgetConfig(widgetId);
+        WidgetStatus status = m_widgetManager->getWidgetStatus(widgetId);
         
         QString statusText;
         QString statusColor;
@@ -100,19 +104,12 @@ void ManagementWindow::refreshWidgetList() {
                 statusColor = "red";
                 break;
         }
-        
-        QString typeText;
-        switch (config.type) {
-            case WidgetType::Clock: typeText = "时钟"; break;
-            case WidgetType::Weather: typeText = "天气"; break;
-            case WidgetType::SystemInfo: typeText = "系统信息"; break;
-            case WidgetType::Calendar: typeText = "日历"; break;
-            case WidgetType::SimpleNotes: typeText = "极简便签"; break;
-            case WidgetType::AIRanking: typeText = "AI排行榜"; break;
-            case WidgetType::SystemPerformance: typeText = "系统性能监测"; break;
-            default: typeText = "自定义"; break;
+        if (!m_widgetManager->isWidgetLoaded(widgetId)) {
+            statusText = "未加载";
         }
         
+        QString typeText = WidgetTypeRegistry::instance().displayName(config);
+        
         QString lockText = config.locked ? " 🔒" : "";
         QString itemText = QString("%1 [%2] - %3%4 (%5)")
                           .arg(config.name)
@@ -301,13 +298,11 @@ void ManagementWindow::setupSettingsPanel() {
     m_nameLineEdit->setReadOnly(true);
     
     m_typeComboBox = new QComboBox;
-    m_typeComboBox->addItem("时钟", static_cast<int>(WidgetType::Clock));
-    m_typeComboBox->addItem("天气", static_cast<int>(WidgetType::Weather));
-    m_typeComboBox->addItem("系统信息", static_cast<int>(WidgetType::SystemInfo));
-    m_typeComboBox->addItem("日历", static_cast<int>(WidgetType::Calendar));
-    m_typeComboBox->addItem("极简便签", static_cast<int>(WidgetType::SimpleNotes));
-    m_typeComboBox->addItem("AI排行榜", static_cast<int>(WidgetType::AIRanking));
-    m_typeComboBox->addItem("系统性能监测", static_cast<int>(WidgetType::SystemPerformance));
+    // 类型列表来自类型注册表，包括已发现但尚未加载的插件
+    const QList<WidgetTypeInfo> widgetTypes = WidgetTypeRegistry::instance().availableTypes();
+    for (const WidgetTypeInfo& info : widgetTypes) {
+        m_typeComboBox->addItem(info.displayName, info.typeKey);
+    }
     m_typeComboBox->setEnabled(false);
     
     basicLayout->addRow("名称:", m_nameLineEdit);
@@ -757,7 +752,6 @@ void ManagementWindow::onCreateWidget() {
     if (dialog.exec() == QDialog::Accepted) {
         WidgetConfig config = dialog.getWidgetConfig();
         if (m_widgetManager->createWidget(config)) {
-            refreshWidgetList();
             updateWidgetInfo();
             m_statusLabel->setText(QString("成功创建组件: %1").arg(config.name));
             
@@ -784,20 +778,18 @@ void ManagementWindow::onRemoveWidget() {
         return;
     }
     
-    auto widget = m_widgetManager->getWidget(widgetId);
-    if (!widget) {
+    if (!m_widgetManager->hasWidget(widgetId)) {
         QMessageBox::warning(this, "错误", "选中的组件不存在！");
         return;
     }
     
-    QString widgetName = widget->getConfig().name;
+    QString widgetName = m_widgetManager->getWidgetConfig(widgetId).name;
     int ret = QMessageBox::question(this, "确认删除", 
         QString("确定要删除组件 '%1' 吗？").arg(widgetName),
         QMessageBox::Yes | QMessageBox::No);
     
     if (ret == QMessageBox::Yes) {
         if (m_widgetManager->removeWidget(widgetId)) {
-            refreshWidgetList();
             updateWidgetInfo();
             m_statusLabel->setText(QString("已删除组件: %1").arg(widgetName));
         } else {
@@ -813,14 +805,13 @@ void ManagementWindow::onStartWidget() {
         return;
     }
     
-    auto widget = m_widgetManager->getWidget(widgetId);
-    if (!widget) {
+    if (!m_widgetManager->hasWidget(widgetId)) {
         QMessageBox::warning(this, "错误", "选中的组件不存在！");
         return;
     }
     
     if (m_widgetManager->startWidget(widgetId)) {
-        m_statusLabel->setText(QString("已启动组件: %1").arg(widget->getConfig().name));
+        m_statusLabel->setText(QString("已启动组件: %1").arg(m_widgetManager->getWidgetConfig(widgetId).name));
     } else {
         QMessageBox::warning(this, "启动失败", "组件启动失败！");
     }
@@ -833,14 +824,13 @@ void ManagementWindow::onStopWidget() {
         return;
     }
     
-    auto widget = m_widgetManager->getWidget(widgetId);
-    if (!widget) {
+    if (!m_widgetManager->hasWidget(widgetId)) {
         QMessageBox::warning(this, "错误", "选中的组件不存在！");
         return;
     }
     
     if (m_widgetManager->stopWidget(widgetId)) {
-        m_statusLabel->setText(QString("已停止组件: %1").arg(widget->getConfig().name));
+        m_statusLabel->setText(QString("已停止组件: %1").arg(m_widgetManager->getWidgetConfig(widgetId).name));
     } else {
         QMessageBox::warning(this, "停止失败", "组件停止失败！");
     }
@@ -853,61 +843,22 @@ void ManagementWindow::onConfigureWidget() {
         return;
     }
     
-    auto widget = m_widgetManager->getWidget(widgetId);
-    if (!widget) {
+    if (!m_widgetManager->hasWidget(widgetId)) {
         QMessageBox::warning(this, "错误", "选中的组件不存在！");
         return;
     }
     
-    WidgetConfig config = widget->getConfig();
-    QDialog* configDialog = nullptr;
-    
-    // 根据小组件类型创建相应的配置对话框
-    switch (config.type) {
-        case WidgetType::Weather: {
-            configDialog = new WeatherConfigDialog(config, this);
-            break;
-        }
-        case WidgetType::AIRanking: {
-            configDialog = new AIRankingConfigDialog(config, this);
-            break;
-        }
-        case WidgetType::Clock:
-        case WidgetType::SystemInfo:
-        case WidgetType::Calendar:
-        case WidgetType::SimpleNotes:
-        case WidgetType::SystemPerformance:
-        case WidgetType::Custom:
-        default: {
-            configDialog = new ConfigWindow(config, this);
-            break;
-        }
-    }
-    
-    if (configDialog && configDialog->exec() == QDialog::Accepted) {
-        // 使用统一的方式获取更新后的配置
-        WidgetConfig updatedConfig;
-        
-        if (auto weatherDialog = qobject_cast<WeatherConfigDialog*>(configDialog)) {
-            updatedConfig = weatherDialog->getUpdatedConfig();
-        } else if (auto aiDialog = qobject_cast<AIRankingConfigDialog*>(configDialog)) {
-            updatedConfig = aiDialog->getUpdatedConfig();
-        } else if (auto generalDialog = qobject_cast<ConfigWindow*>(configDialog)) {
-            updatedConfig = generalDialog->getUpdatedConfig();
-        }
-        
-        if (m_widgetManager->updateWidgetConfig(widgetId, updatedConfig)) {
-            m_statusLabel->setText(QString("已配置组件: %1").arg(updatedConfig.name));
-            refreshWidgetList();
-            updateSettingsPanel();
-        } else {
-            QMessageBox::warning(this, "错误", "配置应用失败！");
-        }
+    // 由小组件类型对应的插件提供配置对话框
+    WidgetConfig updatedConfig = m_widgetManager->getWidgetConfig(widgetId);
+    if (!WidgetTypeRegistry::instance().editConfig(updatedConfig, this)) {
+        return;
     }
     
-    // 清理对话框内存
-    if (configDialog) {
-        configDialog->deleteLater();
+    if (m_widgetManager->updateWidgetConfig(widgetId, updatedConfig)) {
+        m_statusLabel->setText(QString("已配置组件: %1").arg(updatedConfig.name));
+        updateSettingsPanel();
+    } else {
+        QMessageBox::warning(this, "错误", "配置应用失败！");
     }
 }
 
@@ -926,8 +877,7 @@ void ManagementWindow::onApplySettings() {
         return;
     }
     
-    auto widget = m_widgetManager->getWidget(widgetId);
-    if (!widget) {
+    if (!m_widgetManager->hasWidget(widgetId)) {
         return;
     }
     
@@ -949,7 +899,6 @@ void ManagementWindow::onApplySettings() {
         if (m_widgetManager->updateWidgetConfig(widgetId, newConfig)) {
             m_applyButton->setEnabled(false);
             m_statusLabel->setText(QString("已应用设置: %1").arg(newConfig.name));
-            refreshWidgetList();
         } else {
             QMessageBox::warning(this, "应用失败", "设置应用失败！");
         }
@@ -964,8 +913,7 @@ void ManagementWindow::onResetSettings() {
         return;
     }
     
-    auto widget = m_widgetManager->getWidget(widgetId);
-    if (!widget) {
+    if (!m_widgetManager->hasWidget(widgetId)) {
         return;
     }
     
@@ -974,7 +922,7 @@ void ManagementWindow::onResetSettings() {
         QMessageBox::Yes | QMessageBox::No);
     
     if (ret == QMessageBox::Yes) {
-        populateSettingsFromConfig(widget->getConfig());
+        populateSettingsFromConfig(m_widgetManager->getWidgetConfig(widgetId));
         m_applyButton->setEnabled(false);
         m_statusLabel->setText("设置已重置");
     }
@@ -1034,13 +982,12 @@ void ManagementWindow::updateSettingsPanel() {
         return;
     }
     
-    auto widget = m_widgetManager->getWidget(widgetId);
-    if (!widget) {
+    if (!m_widgetManager->hasWidget(widgetId)) {
         clearSettingsPanel();
         return;
     }
     
-    populateSettingsFromConfig(widget->getConfig());
+    populateSettingsFromConfig(m_widgetManager->getWidgetConfig(widgetId));
     
     // 启用设置控件
     m_xSpinBox->setEnabled(true);
@@ -1161,9 +1108,8 @@ void ManagementWindow::restoreWidgetSelection(const QString& widgetId) {
             m_widgetListWidget->blockSignals(false);
             
             // 手动触发设置面板更新，但不清空
-            auto widget = m_widgetManager->getWidget(widgetId);
-            if (widget) {
-                populateSettingsFromConfig(widget->getConfig());
+            if (m_widgetManager->hasWidget(widgetId)) {
+                populateSettingsFromConfig(m_widgetManager->getWidgetConfig(widgetId));
                 
                 // 确保控件处于启用状态
                 m_xSpinBox->setEnabled(true);
@@ -1224,11 +1170,9 @@ void ManagementWindow::populateSettingsFromConfig(const WidgetConfig& config) {
     m_nameLineEdit->setText(config.name);
     
     // 设置类型下拉框
-    for (int i = 0; i < m_typeComboBox->count(); ++i) {
-        if (static_cast<WidgetType>(m_typeComboBox->itemData(i).toInt()) == config.type) {
-            m_typeComboBox->setCurrentIndex(i);
-            break;
-        }
+    int typeIndex = m_typeComboBox->findData(WidgetTypeRegistry::instance().typeKeyOf(config));
+    if (typeIndex >= 0) {
+        m_typeComboBox->setCurrentIndex(typeIndex);
     }
     
     m_xSpinBox->setValue(config.position.x());
@@ -1306,7 +1250,7 @@ WidgetConfig ManagementWindow::getConfigFromSettings() const {
     WidgetConfig config;
     
     config.name = m_nameLineEdit->text();
-    config.type = static_cast<WidgetType>(m_typeComboBox->currentData().toInt());
+    WidgetTypeRegistry::instance().setConfigType(config, m_typeComboBox->currentData().toString());
     config.position = QPoint(m_xSpinBox->value(), m_ySpinBox->value());
     config.size = QSize(m_widthSpinBox->value(), m_heightSpinBox->value());
     config.opacity = m_opacitySpinBox->value();
@@ -1345,8 +1289,7 @@ void ManagementWindow::onInstantApplySettings() {
     // 即时应用配置更改（用于回车、失去焦点等场景）
     QString widgetId = getCurrentSelectedWidgetId();
     if (!widgetId.isEmpty()) {
-        auto widget = m_widgetManager->getWidget(widgetId);
-        if (widget) {
+        if (m_widgetManager->hasWidget(widgetId)) {
             try {
                 WidgetConfig newConfig = getConfigFromSettings();
                 newConfig.id = widgetId; // 保持原有ID
@@ -1364,15 +1307,7 @@ void ManagementWindow::onInstantApplySettings() {
                 
                 // 立即应用配置更改
                 if (m_widgetManager->updateWidgetConfig(widgetId, newConfig)) {
-                    // 记住当前选中的Widget ID
-                    QString currentSelectedId = widgetId;
-                    
-                    // 刷新Widget列表以显示状态变化
-                    refreshWidgetList();
-                    
-                    // 恢复选中状态，保持在管理界面
-                    restoreWidgetSelection(currentSelectedId);
-                    
+                    // 列表已由widgetsChanged刷新并恢复了选中状态
                     m_statusLabel->setText(QString("实时更新: %1").arg(newConfig.name));
                     // 不重置应用按钮状态，保持管理状态
                 }
@@ -24,15 +24,21 @@
  */
 
 #include "Core/BaseWidget.h"
+#include "Framework/WidgetFramework.h"
+#include "Core/WidgetRenderer.h"
+#include "Utils/Logger.h"
+#include "Utils/LogCategories.h"
 #include <QPainter>
 #include <QApplication>
 #include <QStyleOption>
-#include <QSettings>
 #include <QMouseEvent>
 #include <QContextMenuEvent>
 #include <QMenu>
 #include <QAction>
 #include <QDebug>
+#include <QScreen>
+#include <QtMath>
+#include <QWindow>
 
 #ifdef Q_OS_WIN
 #include <windows.h>
@@ -64,10 +70,23 @@
 BaseWidget::BaseWidget(const WidgetConfig& config, QWidget* parent)
     : QWidget(parent)
     , m_config(config)
+    , m_configDelta(ConfigDelta::all())
     , m_status(WidgetStatus::Active)
-    , m_updateTimer(new QTimer(this))
+    , m_updateJob(0)
     , m_updateInterval(config.updateInterval)
     , m_dragging(false)
+    , m_hasPendingDragMove(false)
+    , m_pendingDragSinceNs(0)
+    , m_dragLatencySumMs(0.0)
+    , m_dragFrameTimer(new QTimer(this))
+    , m_suspendPolicy(SuspendReason::Obscured | SuspendReason::DisplayOff | SuspendReason::SessionLocked)
+    , m_suspendReasons(SuspendReason::None)
+    , m_obscured(false)
+    , m_suspended(false)
+    , m_layerCacheDirty(true)
+    , m_renderPriority(RenderPriority::Normal)
+    , m_windowFlagsApplied(false)
+    , m_deferWindowFlags(false)
     , m_contextMenu(nullptr)
     , m_settingsAction(nullptr)
     , m_lockAction(nullptr)
@@ -83,8 +102,22 @@ BaseWidget::BaseWidget(const WidgetConfig& config, QWidget* parent)
     setAttribute(Qt::WA_TranslucentBackground, true); // 启用透明背景
     // 初始窗口标志将在applyConfig()中正确设置
     
-    // 连接更新定时器到更新槽函数
-    connect(m_updateTimer, &QTimer::timeout, this, &BaseWidget::onUpdateTimer);
+    // 在共享调度器中注册内容更新任务（启动时才激活）
+    m_updateJob = WidgetFramework::instance().registerJob(
+        this, m_updateInterval, TickClass::Coarse, [this]() { onUpdateTimer(); }, false);
+    
+    // 锁屏、熄屏等全局状态变化时重新评估暂停状态
+    connect(&WidgetFramework::instance(), &WidgetFramework::sessionStateChanged,
+            this, &BaseWidget::updateSuspension);
+    
+    // 拖拽帧定时器：拖拽期间按显示刷新率合并鼠标事件
+    m_dragFrameTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_dragFrameTimer, &QTimer::timeout, this, &BaseWidget::onDragFrame);
+    
+    // 默认的半透明背景作为最底层的静态图层
+    addStaticLayer(QStringLiteral("base"), [this](QPainter& painter) {
+        painter.fillRect(rect(), QColor(0, 0, 0, 50));
+    });
     
     // 执行子类特定的初始化
     initialize();
@@ -106,23 +139,19 @@ void BaseWidget::start() {
         setStatus(WidgetStatus::Active);
     }
     
-    if (m_updateInterval > 0) {
-        m_updateTimer->start(m_updateInterval);
-    }
-    
     show();
+    refreshUpdateJob();
     updateContent();
 }
 
 void BaseWidget::stop() {
-    m_updateTimer->stop();
     setStatus(WidgetStatus::Hidden);
+    refreshUpdateJob();
     hide();
 }
 
 void BaseWidget::cleanup() {
     stop();
-    savePosition();
     
     #ifdef Q_OS_WIN
     // 清理维持置底的定时器
@@ -134,34 +163,91 @@ void BaseWidget::cleanup() {
     #endif
 }
 
+/**
+ * @brief 设置新配置
+ * @param config 新的配置
+ * 
+ * 先计算新旧配置的差异，applyConfig()及子类重写只处理变化的部分；
+ * 配置完全相同时直接返回，不触发任何重新应用。
+ */
 void BaseWidget::setConfig(const WidgetConfig& config) {
+    ConfigDelta delta = ConfigDelta::between(m_config, config);
+    if (delta.isEmpty()) {
+        return;
+    }
+    
     m_config = config;
+    m_configDelta = delta;
     applyConfig();
+    // 在setConfig之外直接调用applyConfig()时按完整配置处理
+    m_configDelta = ConfigDelta::all();
+    
     emit configChanged(m_config);
 }
 
+/**
+ * @brief 按configDelta()应用配置
+ * 
+ * 位置、大小、透明度、窗口标志等基础属性在这里处理。子类重写时先调用
+ * BaseWidget::applyConfig()，再只对自己关心的ConfigAspect（通常是CustomSettings）
+ * 重新解析设置、刷新内容，其余变化不必重复处理。
+ */
 void BaseWidget::applyConfig() {
-    setPosition(m_config.position);
-    resize(m_config.size);
-    setOpacity(m_config.opacity);
+    const ConfigDelta& delta = m_configDelta;
     
-    // 从customSettings中读取avoidMinimizeAll设置并优先应用
-    bool avoidMinimizeAll = m_config.customSettings.value("avoidMinimizeAll").toBool(false);
-    m_config.avoidMinimizeAll = avoidMinimizeAll;
+    if (delta.has(ConfigAspect::Position)) {
+        setPosition(m_config.position);
+    }
+    if (delta.has(ConfigAspect::Size)) {
+        resize(m_config.size);
+    }
+    if (delta.has(ConfigAspect::Opacity)) {
+        setOpacity(m_config.opacity);
+    }
     
-    // 应用避免最小化设置
-    setAvoidMinimizeAll(avoidMinimizeAll);
+    if (delta.has(ConfigAspect::WindowFlags)) {
+        // 合并所有窗口层级相关的设置，最多只重建一次原生窗口
+        m_deferWindowFlags = true;
+        
+        // 从customSettings中读取avoidMinimizeAll设置并优先应用
+        bool avoidMinimizeAll = m_config.customSettings.value("avoidMinimizeAll").toBool(false);
+        setAvoidMinimizeAll(avoidMinimizeAll);
+        
+        // 应用窗口层级设置（现在兼容防止最小化功能）
+        setAlwaysOnTop(m_config.alwaysOnTop);
+        setAlwaysOnBottom(m_config.alwaysOnBottom);
+        setClickThrough(m_config.clickThrough);
+        
+        m_deferWindowFlags = false;
+        updateWindowFlags();
+    }
     
-    // 应用窗口层级设置（现在兼容防止最小化功能）
-    setAlwaysOnTop(m_config.alwaysOnTop);
-    setAlwaysOnBottom(m_config.alwaysOnBottom);
+    if (delta.has(ConfigAspect::Locked)) {
+        setLocked(m_config.locked);
+    }
+    if (delta.has(ConfigAspect::UpdateInterval)) {
+        setUpdateInterval(m_config.updateInterval);
+    }
+    
+    if (delta.has(ConfigAspect::Identity)) {
+        setWindowTitle(m_config.name);
+        setObjectName(m_config.id);
+    }
     
-    setClickThrough(m_config.clickThrough);
-    setLocked(m_config.locked);
-    setUpdateInterval(m_config.updateInterval);
+    if (delta.anyCustomKeyChanged({"suspendWhenObscured", "suspendWhenDisplayOff", "suspendWhenLocked"})) {
+        const QJsonObject& settings = m_config.customSettings;
+        SuspendReasons policy;
+        policy.setFlag(SuspendReason::Obscured, settings.value("suspendWhenObscured").toBool(true));
+        policy.setFlag(SuspendReason::DisplayOff, settings.value("suspendWhenDisplayOff").toBool(true));
+        policy.setFlag(SuspendReason::SessionLocked, settings.value("suspendWhenLocked").toBool(true));
+        m_suspendPolicy = policy;
+        updateSuspension();
+    }
     
-    setWindowTitle(m_config.name);
-    setObjectName(m_config.id);
+    // 自定义设置可能改变颜色、字体、背景图片等静态内容
+    if (delta.has(ConfigAspect::CustomSettings)) {
+        invalidateStaticLayers();
+    }
 }
 
 void BaseWidget::setStatus(WidgetStatus status) {
@@ -175,12 +261,9 @@ void BaseWidget::setUpdateInterval(int interval) {
     m_updateInterval = interval;
     m_config.updateInterval = interval;
     
-    if (m_updateTimer->isActive()) {
-        m_updateTimer->stop();
-        if (interval > 0) {
-            m_updateTimer->start(interval);
-        }
-    }
+    // 运行中的任务会按新周期重新调度，周期无效时自动停止
+    WidgetFramework::instance().setJobPeriod(m_updateJob, interval);
+    refreshUpdateJob();
 }
 
 void BaseWidget::setPosition(const QPoint& position) {
@@ -253,7 +336,7 @@ void BaseWidget::setLocked(bool locked) {
     }
 }
 
-void BaseWidget::updateWindowFlags() {
+Qt::WindowFlags BaseWidget::computeWindowFlags() const {
     Qt::WindowFlags flags = Qt::FramelessWindowHint | Qt::Tool;
     
     // 设置避免Win+D的基础属性
@@ -268,8 +351,6 @@ void BaseWidget::updateWindowFlags() {
     if (m_config.avoidMinimizeAll && m_config.alwaysOnBottom) {
         // 特殊情况：同时开启防止最小化和始终置底
         // 优先保证防止最小化功能，但尽量实现置底效果
-        qDebug() << "Widget" << m_config.name << "检测到防止最小化与始终置底冲突，将使用混合模式";
-        
         #ifdef Q_OS_WIN
         // 在Windows上使用特殊的混合实现
         flags |= Qt::WindowStaysOnBottomHint;  // 先设置置底标志
@@ -279,24 +360,41 @@ void BaseWidget::updateWindowFlags() {
         #endif
     } else if (m_config.alwaysOnTop) {
         flags |= Qt::WindowStaysOnTopHint;
-        qDebug() << "Widget" << m_config.name << "设置为始终置顶" << (m_config.avoidMinimizeAll ? " + 防止最小化" : "");
     } else if (m_config.alwaysOnBottom) {
         flags |= Qt::WindowStaysOnBottomHint;
-        qDebug() << "Widget" << m_config.name << "设置为始终置底" << (m_config.avoidMinimizeAll ? " (混合模式)" : "");
-    } else {
+    } else if (m_config.avoidMinimizeAll) {
         // 如果只开启了防止最小化而没有其他层级设置，则使用默认置顶来防止被最小化
-        if (m_config.avoidMinimizeAll) {
-            flags |= Qt::WindowStaysOnTopHint;
-            qDebug() << "Widget" << m_config.name << "设置为正常层级 + 防止最小化（默认置顶）";
-        } else {
-            qDebug() << "Widget" << m_config.name << "设置为正常层级";
-        }
+        flags |= Qt::WindowStaysOnTopHint;
     }
     
     if (m_config.clickThrough) {
         flags |= Qt::WindowTransparentForInput;
     }
     
+    return flags;
+}
+
+void BaseWidget::updateWindowFlags() {
+    if (m_deferWindowFlags) {
+        return; // 由applyConfig()在最后统一更新
+    }
+    
+    Qt::WindowFlags flags = computeWindowFlags();
+    
+    // setWindowFlags会重建原生窗口，标志未变化时跳过
+    if (m_windowFlagsApplied && flags == m_appliedWindowFlags) {
+        return;
+    }
+    m_appliedWindowFlags = flags;
+    m_windowFlagsApplied = true;
+    
+    LOG_CDEBUG(lcWidget, QString("Widget %1 窗口标志变更: %2%3%4")
+                             .arg(m_config.name,
+                                  m_config.alwaysOnTop ? QStringLiteral("始终置顶")
+                                      : m_config.alwaysOnBottom ? QStringLiteral("始终置底") : QStringLiteral("正常层级"),
+                                  m_config.avoidMinimizeAll ? QStringLiteral(" + 防止最小化") : QString(),
+                                  m_config.clickThrough ? QStringLiteral(" + 鼠标穿透") : QString()));
+    
     // 保存当前的可见性状态
     bool wasVisible = isVisible();
     
@@ -406,8 +504,7 @@ void BaseWidget::removeWindowsAvoidMinimize() {
 
 void BaseWidget::mousePressEvent(QMouseEvent* event) {
     if (event->button() == Qt::LeftButton && !m_config.clickThrough && !m_config.locked) {
-        m_dragging = true;
-        m_dragStartPosition = event->globalPosition().toPoint() - frameGeometry().topLeft();
+        beginDrag(event->globalPosition().toPoint() - frameGeometry().topLeft());
         event->accept();
     }
     QWidget::mousePressEvent(event);
@@ -415,10 +512,14 @@ void BaseWidget::mousePressEvent(QMouseEvent* event) {
 
 void BaseWidget::mouseMoveEvent(QMouseEvent* event) {
     if (m_dragging && (event->buttons() & Qt::LeftButton) && !m_config.clickThrough && !m_config.locked) {
-        QPoint newPosition = event->globalPosition().toPoint() - m_dragStartPosition;
-        setPosition(newPosition);
+        // 只记录目标位置，由帧定时器统一移动窗口
+        if (!m_hasPendingDragMove) {
+            m_hasPendingDragMove = true;
+            m_pendingDragSinceNs = m_dragClock.nsecsElapsed();
+        }
+        m_pendingDragPosition = event->globalPosition().toPoint() - m_dragStartPosition;
+        m_currentDragStats.mouseEventCount++;
         event->accept();
-        emit positionChanged(m_config.id, newPosition);
     }
     QWidget::mouseMoveEvent(event);
 }
@@ -426,14 +527,79 @@ void BaseWidget::mouseMoveEvent(QMouseEvent* event) {
 void BaseWidget::mouseReleaseEvent(QMouseEvent* event) {
     if (event->button() == Qt::LeftButton) {
         if (m_dragging) {
-            m_dragging = false;
-            savePosition();
+            finishDrag();
             event->accept();
         }
     }
     QWidget::mouseReleaseEvent(event);
 }
 
+/**
+ * @brief 进入拖拽模式
+ * @param grabOffset 鼠标按下点相对窗口左上角的偏移
+ * 
+ * 拖拽期间不修改配置、不写持久化，也不重建窗口标志，
+ * 仅由帧定时器以显示刷新率移动原生窗口。
+ */
+void BaseWidget::beginDrag(const QPoint& grabOffset) {
+    m_dragging = true;
+    m_dragStartPosition = grabOffset;
+    m_dragOriginPosition = pos();
+    m_hasPendingDragMove = false;
+    m_dragLatencySumMs = 0.0;
+    m_currentDragStats = DragStats();
+    m_dragClock.start();
+    m_dragFrameTimer->start(dragFrameInterval());
+}
+
+void BaseWidget::onDragFrame() {
+    if (!m_dragging || !m_hasPendingDragMove) {
+        return;
+    }
+    
+    move(m_pendingDragPosition);
+    m_hasPendingDragMove = false;
+    
+    double latencyMs = (m_dragClock.nsecsElapsed() - m_pendingDragSinceNs) / 1000000.0;
+    m_dragLatencySumMs += latencyMs;
+    m_currentDragStats.maxLatencyMs = qMax(m_currentDragStats.maxLatencyMs, latencyMs);
+    m_currentDragStats.frameCount++;
+}
+
+/**
+ * @brief 结束拖拽并一次性提交位置
+ * 
+ * 应用最后一个未处理的位置，写入配置并只发出一次positionChanged，
+ * 由WidgetManager负责后续的保存调度。
+ */
+void BaseWidget::finishDrag() {
+    onDragFrame();
+    m_dragFrameTimer->stop();
+    m_dragging = false;
+    
+    m_currentDragStats.durationMs = m_dragClock.elapsed();
+    if (m_currentDragStats.frameCount > 0) {
+        m_currentDragStats.avgLatencyMs = m_dragLatencySumMs / m_currentDragStats.frameCount;
+    }
+    m_lastDragStats = m_currentDragStats;
+    
+    if (pos() == m_dragOriginPosition) {
+        return; // 只是点击，没有实际移动
+    }
+    
+    setPosition(pos());
+    emit positionChanged(m_config.id, m_config.position);
+}
+
+int BaseWidget::dragFrameInterval() const {
+    QScreen* currentScreen = screen();
+    qreal refreshRate = currentScreen ? currentScreen->refreshRate() : 60.0;
+    if (refreshRate <= 0.0) {
+        refreshRate = 60.0;
+    }
+    return qMax(1, qFloor(1000.0 / refreshRate));
+}
+
 void BaseWidget::contextMenuEvent(QContextMenuEvent* event) {
     if (m_contextMenu && !m_config.clickThrough) {
         m_contextMenu->exec(event->globalPos());
@@ -444,15 +610,142 @@ void BaseWidget::paintEvent(QPaintEvent* event) {
     QPainter painter(this);
     painter.setRenderHint(QPainter::Antialiasing);
     
-    // 绘制背景
-    painter.fillRect(rect(), QColor(0, 0, 0, 50));
+    // 合成静态图层（默认包含半透明背景）
+    ensureLayerCache();
+    painter.drawPixmap(0, 0, m_layerCache);
     
-    // 调用子类的绘制方法
+    // 调用子类的绘制方法，只绘制动态内容
     drawContent(painter);
     
     QWidget::paintEvent(event);
 }
 
+void BaseWidget::resizeEvent(QResizeEvent* event) {
+    // 尺寸变化后Qt会立即重绘，这里只需标记缓存失效
+    markStaticLayersDirty();
+    QWidget::resizeEvent(event);
+}
+
+/**
+ * @brief 请求重绘
+ * 
+ * 与直接调用update()不同，请求交给WidgetRenderer合并到下一个显示帧，
+ * 并按小组件的重绘优先级参与帧预算分配。
+ */
+void BaseWidget::scheduleRepaint() {
+    WidgetRenderer::instance().requestRepaint(this, m_renderPriority);
+}
+
+/**
+ * @brief 注册静态图层
+ * @param name 图层名称，同名图层会被替换
+ * @param painter 图层绘制函数，使用小组件的逻辑坐标
+ * 
+ * 图层按注册顺序叠加，全部位于drawContent()绘制的动态内容之下。
+ */
+void BaseWidget::addStaticLayer(const QString& name, LayerPainter painter) {
+    for (StaticLayer& layer : m_staticLayers) {
+        if (layer.name == name) {
+            layer.painter = std::move(painter);
+            invalidateStaticLayer(name);
+            return;
+        }
+    }
+    
+    StaticLayer layer;
+    layer.name = name;
+    layer.painter = std::move(painter);
+    m_staticLayers.append(layer);
+    m_layerCacheDirty = true;
+    update();
+}
+
+void BaseWidget::removeStaticLayer(const QString& name) {
+    for (int i = 0; i < m_staticLayers.size(); ++i) {
+        if (m_staticLayers[i].name == name) {
+            m_staticLayers.removeAt(i);
+            m_layerCacheDirty = true;
+            update();
+            return;
+        }
+    }
+}
+
+void BaseWidget::invalidateStaticLayer(const QString& name) {
+    for (StaticLayer& layer : m_staticLayers) {
+        if (layer.name == name) {
+            layer.dirty = true;
+            m_layerCacheDirty = true;
+            scheduleRepaint();
+            return;
+        }
+    }
+}
+
+void BaseWidget::invalidateStaticLayers() {
+    markStaticLayersDirty();
+    scheduleRepaint();
+}
+
+void BaseWidget::markStaticLayersDirty() {
+    for (StaticLayer& layer : m_staticLayers) {
+        layer.dirty = true;
+    }
+    m_layerCacheDirty = true;
+}
+
+/**
+ * @brief 按需重新渲染脏图层并重新合成缓存
+ * 
+ * 位图按设备像素比分配，尺寸或设备像素比变化（如跨屏拖动）时全部重绘。
+ */
+void BaseWidget::ensureLayerCache() {
+    const qreal dpr = devicePixelRatioF();
+    const QSize pixelSize = size() * dpr;
+    
+    if (m_layerCache.size() != pixelSize || !qFuzzyCompare(m_layerCache.devicePixelRatio(), dpr)) {
+        markStaticLayersDirty();
+    }
+    
+    if (!m_layerCacheDirty || pixelSize.isEmpty()) {
+        return;
+    }
+    
+    for (StaticLayer& layer : m_staticLayers) {
+        if (!layer.dirty) {
+            continue;
+        }
+        if (layer.pixmap.size() != pixelSize) {
+            layer.pixmap = QPixmap(pixelSize);
+        }
+        layer.pixmap.setDevicePixelRatio(dpr);
+        layer.pixmap.fill(Qt::transparent);
+        
+        QPainter layerPainter(&layer.pixmap);
+        layerPainter.setRenderHint(QPainter::Antialiasing);
+        layer.painter(layerPainter);
+        layer.dirty = false;
+    }
+    
+    // 只有一个图层时直接共享其位图
+    if (m_staticLayers.size() == 1) {
+        m_layerCache = m_staticLayers.first().pixmap;
+    } else {
+        if (m_layerCache.size() != pixelSize) {
+            m_layerCache = QPixmap(pixelSize);
+        }
+        m_layerCache.setDevicePixelRatio(dpr);
+        m_layerCache.fill(Qt::transparent);
+        
+        QPainter cachePainter(&m_layerCache);
+        for (const StaticLayer& layer : m_staticLayers) {
+            cachePainter.drawPixmap(0, 0, layer.pixmap);
+        }
+    }
+    
+    m_layerCacheDirty = false;
+}
+
 QMenu* BaseWidget::createContextMenu() {
     QMenu* menu = new QMenu(this);
     
@@ -523,19 +816,111 @@ void BaseWidget::updateContextMenu() {
     }
 }
 
-void BaseWidget::savePosition() {
-    QSettings settings;
-    settings.beginGroup("Widgets/" + m_config.id);
-    settings.setValue("position", pos());
-    settings.endGroup();
-}
-
 void BaseWidget::onUpdateTimer() {
-    if (m_status == WidgetStatus::Active) {
+    if (m_status == WidgetStatus::Active && !m_suspended) {
         updateContent();
     }
 }
 
+/**
+ * @brief 根据状态、暂停情况和更新间隔激活或停止内容更新任务
+ */
+void BaseWidget::refreshUpdateJob() {
+    bool shouldRun = m_status == WidgetStatus::Active && isVisible() && !m_suspended && m_updateInterval > 0;
+    WidgetFramework::instance().setJobActive(m_updateJob, shouldRun);
+}
+
+bool BaseWidget::event(QEvent* event) {
+    switch (event->type()) {
+    case QEvent::WinIdChange:
+    case QEvent::Show:
+        // 原生窗口（重新）创建后在其QWindow上监听暴露事件
+        if (QWindow* handle = windowHandle()) {
+            handle->installEventFilter(this);
+        }
+        break;
+    case QEvent::PaletteChange:
+    case QEvent::StyleChange:
+    case QEvent::FontChange:
+    case QEvent::ThemeChange:
+        // 主题变化后静态图层需要按新的调色板和字体重绘
+        invalidateStaticLayers();
+        break;
+    default:
+        break;
+    }
+    return QWidget::event(event);
+}
+
+/**
+ * @brief 根据原生窗口的暴露状态更新遮挡标志
+ *
+ * isExposed()只反映窗口系统是否还需要绘制该窗口：最小化、隐藏或切到其他虚拟桌面时为false。
+ * Windows和X11不报告窗口之间的遮挡，被其他窗口完全盖住的小组件仍然是exposed，
+ * 这种情况检测不到，不会因此暂停；只有会报告遮挡的平台（如macOS）才能据此暂停。
+ */
+bool BaseWidget::eventFilter(QObject* watched, QEvent* event) {
+    if (event->type() == QEvent::Expose && watched == windowHandle()) {
+        bool obscured = isVisible() && !windowHandle()->isExposed();
+        if (obscured != m_obscured) {
+            m_obscured = obscured;
+            updateSuspension();
+        }
+    }
+    return QWidget::eventFilter(watched, event);
+}
+
+/**
+ * @brief 重新评估暂停状态
+ * 
+ * 暂停时停止内容更新任务并通知子类暂停采样和网络刷新；
+ * 恢复时立即补一次updateContent()，让显示内容追上当前状态。
+ */
+void BaseWidget::updateSuspension() {
+    const WidgetFramework& framework = WidgetFramework::instance();
+    
+    SuspendReasons reasons;
+    reasons.setFlag(SuspendReason::Obscured, m_obscured);
+    reasons.setFlag(SuspendReason::DisplayOff, framework.isDisplayOff());
+    reasons.setFlag(SuspendReason::SessionLocked, framework.isSessionLocked());
+    reasons &= m_suspendPolicy;
+    m_suspendReasons = reasons;
+    
+    bool suspend = reasons != SuspendReasons(SuspendReason::None);
+    if (suspend == m_suspended) {
+        return;
+    }
+    
+    m_suspended = suspend;
+    if (suspend) {
+        m_suspendStats.suspendCount++;
+        m_suspendClock.start();
+        refreshUpdateJob();
+        onSuspended();
+    } else {
+        m_suspendStats.totalSuspendedMs += m_suspendClock.elapsed();
+        m_suspendClock.invalidate();
+        refreshUpdateJob();
+        onResumed();
+        if (m_status == WidgetStatus::Active && isVisible()) {
+            updateContent();
+        }
+    }
+    
+    LOG_CDEBUG(lcWidget, QString("Widget %1 %2, 累计暂停 %3ms")
+                             .arg(m_config.name, suspend ? QStringLiteral("暂停更新") : QStringLiteral("恢复更新"))
+                             .arg(getSuspendStats().totalSuspendedMs));
+    emit suspensionChanged(suspend);
+}
+
+SuspendStats BaseWidget::getSuspendStats() const {
+    SuspendStats stats = m_suspendStats;
+    if (m_suspended && m_suspendClock.isValid()) {
+        stats.totalSuspendedMs += m_suspendClock.elapsed();
+    }
+    return stats;
+}
+
 void BaseWidget::onSettingsAction() {
     emit settingsRequested(m_config.id);
 }
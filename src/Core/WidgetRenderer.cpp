@@ -1,45 +1,244 @@
 /**
  * @file WidgetRenderer.cpp
- * @brief 高性能小组件渲染引擎实现
- * @details 提供小组件的高效渲染和图形处理功能
+ * @brief 小组件重绘调度器实现
+ * @details 按显示帧节奏批量执行所有小组件的重绘
  * @author 李子豪 (AstreoX)
  * @date 2025-5
  * @version 1.0.0
- * 
- * 高性能渲染器核心功能：
- * - GPU加速渲染管线
- * - 多线程渲染任务调度
- * - 智能缓存和内存管理
- * - 实时性能监控和优化
- * - 跨平台图形API抽象
- * 
- * 渲染器采用现代OpenGL/DirectX技术栈，
- * 支持硬件加速的2D/3D图形渲染，
- * 为小组件提供流畅的视觉体验。
+ *
+ * 渲染器核心功能：
+ * - 收集所有小组件的重绘请求，同一帧内的重复请求合并为一次
+ * - 请求对齐到显示刷新率的帧边界，每帧统一刷新一次
+ * - 每帧有时间预算，超出后低优先级的小组件顺延到下一帧
+ * - 顺延过多帧的请求自动提升为高优先级，避免被饿死
+ * - 统计帧耗时、重绘次数、合并和顺延次数
+ *
+ * 各小组件的定时器在同一秒触发时，重绘不再各自落在任意时刻，
+ * 而是集中在一帧内按优先级完成，平滑了绘制峰值。
  */
 
 #include "Core/WidgetRenderer.h"
+#include "Utils/Logger.h"
+#include "Utils/LogCategories.h"
+#include <QCoreApplication>
+#include <QGuiApplication>
+#include <QScreen>
+#include <QThread>
+#include <QVector>
+#include <algorithm>
+
+namespace {
+    constexpr int kDefaultRefreshRate = 60;     // 无法获取屏幕刷新率时使用
+    constexpr int kMaxDeferredFrames = 4;       // 顺延超过这个帧数后提升为高优先级
+    constexpr int kStatsWindowMs = 10000;       // 帧统计日志输出间隔
+}
+
+/**
+ * @brief 获取全局渲染器实例
+ *
+ * 实例挂在QCoreApplication下，随应用程序一起销毁。
+ */
+WidgetRenderer& WidgetRenderer::instance() {
+    static QPointer<WidgetRenderer> s_instance;
+    if (!s_instance) {
+        s_instance = new WidgetRenderer(QCoreApplication::instance());
+    }
+    return *s_instance;
+}
 
 /**
  * @brief 渲染器构造函数
  * @param parent 父对象指针
- * 
- * 初始化高性能渲染引擎：
- * - 创建渲染上下文
- * - 初始化GPU资源管理器
- * - 设置渲染管线状态
- * - 配置多线程渲染队列
- * - 建立性能监控系统
- * 
- * 渲染器采用延迟初始化策略，
- * 仅在需要时创建昂贵的GPU资源。
+ *
+ * 帧定时器只在有待处理的重绘请求时启动，空闲时不产生任何唤醒。
+ */
+WidgetRenderer::WidgetRenderer(QObject* parent)
+    : QObject(parent)
+    , m_frameTimer(new QTimer(this))
+    , m_frameBudgetMs(0.0)
+{
+    m_frameTimer->setSingleShot(true);
+    m_frameTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_frameTimer, &QTimer::timeout, this, &WidgetRenderer::onFrame);
+
+    m_clock.start();
+    m_statsClock.start();
+}
+
+/**
+ * @brief 请求在下一帧重绘小组件
+ * @param widget 需要重绘的小组件
+ * @param priority 重绘优先级，同一帧内多次请求取最高值
+ *
+ * 从工作线程调用时转发到渲染器所在线程处理。
+ */
+void WidgetRenderer::requestRepaint(QWidget* widget, RenderPriority priority) {
+    if (!widget) {
+        return;
+    }
+
+    if (QThread::currentThread() != thread()) {
+        QPointer<QWidget> guard(widget);
+        QMetaObject::invokeMethod(this, [this, guard, priority]() {
+            if (guard) {
+                requestRepaint(guard, priority);
+            }
+        }, Qt::QueuedConnection);
+        return;
+    }
+
+    auto it = m_pending.find(widget);
+    if (it != m_pending.end() && it->widget) {
+        // 同一帧内的重复请求合并，保留较高的优先级
+        if (priority > it->priority) {
+            it->priority = priority;
+        }
+        m_stats.coalescedCount++;
+        return;
+    }
+
+    PendingRepaint pending;
+    pending.widget = widget;
+    pending.priority = priority;
+    pending.requestedNs = m_clock.nsecsElapsed();
+    m_pending.insert(widget, pending);
+
+    scheduleFrame();
+}
+
+void WidgetRenderer::cancelRepaint(QWidget* widget) {
+    m_pending.remove(widget);
+}
+
+void WidgetRenderer::setFrameBudget(double budgetMs) {
+    m_frameBudgetMs = budgetMs;
+}
+
+double WidgetRenderer::frameBudget() const {
+    if (m_frameBudgetMs > 0.0) {
+        return m_frameBudgetMs;
+    }
+    // 默认留出半帧给事件处理和合成
+    return frameInterval() / 2.0;
+}
+
+int WidgetRenderer::frameInterval() const {
+    int refreshRate = kDefaultRefreshRate;
+    if (QScreen* screen = QGuiApplication::primaryScreen()) {
+        if (screen->refreshRate() > 1.0) {
+            refreshRate = qRound(screen->refreshRate());
+        }
+    }
+    return qMax(1, 1000 / refreshRate);
+}
+
+void WidgetRenderer::resetStatistics() {
+    m_stats = RenderStats();
+    m_statsClock.restart();
+}
+
+/**
+ * @brief 在下一个帧边界启动帧定时器
+ *
+ * 帧边界按渲染器时钟和刷新间隔计算，不同来源的请求因此落在同一帧内。
  */
-WidgetRenderer::WidgetRenderer(QObject* parent) : QObject(parent) {
-    // TODO: 实现高性能渲染器初始化
-    // - 检测GPU硬件能力
-    // - 创建渲染上下文和设备
-    // - 初始化着色器程序
-    // - 设置顶点缓冲区和纹理池
-    // - 配置渲染状态机
-    // - 启动渲染线程池
-} 
\ No newline at end of file
+void WidgetRenderer::scheduleFrame() {
+    if (m_pending.isEmpty() || m_frameTimer->isActive()) {
+        return;
+    }
+
+    const qint64 frameNs = qint64(frameInterval()) * 1000000;
+    const qint64 nowNs = m_clock.nsecsElapsed();
+    const qint64 nextFrameNs = (nowNs / frameNs + 1) * frameNs;
+    m_frameTimer->start(int((nextFrameNs - nowNs + 999999) / 1000000));
+}
+
+/**
+ * @brief 执行一帧的批量重绘
+ *
+ * 请求按优先级和请求时间排序后依次同步重绘；帧耗时超过预算后，
+ * 除高优先级外的请求全部顺延到下一帧。
+ */
+void WidgetRenderer::onFrame() {
+    if (m_pending.isEmpty()) {
+        return;
+    }
+
+    QElapsedTimer frameClock;
+    frameClock.start();
+    const double budgetMs = frameBudget();
+
+    QVector<PendingRepaint> batch;
+    batch.reserve(m_pending.size());
+    for (auto it = m_pending.cbegin(); it != m_pending.cend(); ++it) {
+        if (it->widget) {
+            batch.append(it.value());
+        }
+    }
+    m_pending.clear();
+
+    std::sort(batch.begin(), batch.end(), [](const PendingRepaint& a, const PendingRepaint& b) {
+        if (a.priority != b.priority) {
+            return a.priority > b.priority;
+        }
+        return a.requestedNs < b.requestedNs;
+    });
+
+    int repaintCount = 0;
+    for (PendingRepaint& pending : batch) {
+        QWidget* widget = pending.widget;
+        if (!widget || !widget->isVisible()) {
+            continue;
+        }
+
+        const double elapsedMs = frameClock.nsecsElapsed() / 1e6;
+        if (elapsedMs >= budgetMs && pending.priority != RenderPriority::High) {
+            pending.deferredFrames++;
+            if (pending.deferredFrames >= kMaxDeferredFrames) {
+                pending.priority = RenderPriority::High;
+            }
+            // 顺延期间又收到的新请求已在m_pending中，保留顺延次数较多的那一份
+            auto it = m_pending.find(widget);
+            if (it == m_pending.end() || !it->widget) {
+                m_pending.insert(widget, pending);
+            } else {
+                it->deferredFrames = pending.deferredFrames;
+                it->priority = qMax(it->priority, pending.priority);
+                it->requestedNs = pending.requestedNs;
+            }
+            m_stats.deferredCount++;
+            continue;
+        }
+
+        widget->repaint();
+        repaintCount++;
+    }
+
+    const double frameMs = frameClock.nsecsElapsed() / 1e6;
+    if (repaintCount > 0) {
+        updateStatistics(frameMs, repaintCount);
+        emit frameRendered(frameMs, repaintCount);
+    }
+
+    // 顺延的请求和重绘期间新到达的请求留给下一帧
+    scheduleFrame();
+}
+
+void WidgetRenderer::updateStatistics(double frameMs, int repaintCount) {
+    m_stats.frameCount++;
+    m_stats.repaintCount += repaintCount;
+    m_stats.lastFrameMs = frameMs;
+    m_stats.avgFrameMs += (frameMs - m_stats.avgFrameMs) / m_stats.frameCount;
+    m_stats.maxFrameMs = qMax(m_stats.maxFrameMs, frameMs);
+    if (frameMs > frameBudget()) {
+        m_stats.budgetOverruns++;
+    }
+
+    if (m_statsClock.elapsed() >= kStatsWindowMs) {
+        m_statsClock.restart();
+        LOG_CEVENT(Logger::Debug, lcRender, QString(),
+                   "渲染统计: %1 帧, %2 次重绘, 合并 %3, 顺延 %4, 平均 %5ms, 最大 %6ms, 超预算 %7 帧",
+                   m_stats.frameCount, m_stats.repaintCount, m_stats.coalescedCount, m_stats.deferredCount,
+                   m_stats.avgFrameMs, m_stats.maxFrameMs, m_stats.budgetOverruns);
+    }
+}
@@ -0,0 +1,275 @@
+/**
+ * @file ConfigStore.cpp
+ * @brief 小组件配置持久化存储实现
+ * @details 脏条目跟踪、延迟写入和原子写盘
+ * @version 1.0.0
+ *
+ * 配置存储的工作方式：
+ * - 每个小组件的配置缓存为一段紧凑JSON，只有被标记为脏的条目才重新序列化
+ * - 配置文件由缓存的条目拼接而成，每个小组件占一行
+ * - 变更在一段时间内合并后由单线程的后台线程池写盘
+ * - 写盘使用QSaveFile（临时文件+重命名），中途崩溃不会留下半个文件
+ * - 位置、窗口属性和自定义设置都经由同一条写入路径持久化
+ */
+
+#include "Framework/ConfigStore.h"
+#include "Utils/Logger.h"
+#include "Utils/LogCategories.h"
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QSaveFile>
+
+namespace {
+    constexpr int kDefaultSaveDelayMs = 5000;   // 与原先的自动保存延迟一致
+}
+
+ConfigStore::ConfigStore(QObject* parent)
+    : QObject(parent)
+    , m_structureDirty(false)
+    , m_saveTimer(new QTimer(this))
+{
+    m_saveTimer->setSingleShot(true);
+    m_saveTimer->setInterval(kDefaultSaveDelayMs);
+    connect(m_saveTimer, &QTimer::timeout, this, &ConfigStore::onSaveTimer);
+
+    m_writerPool.setMaxThreadCount(1);
+}
+
+/**
+ * @brief 析构函数
+ *
+ * 等待进行中的写入完成；尚未写盘的变更由所有者在销毁前调用saveNow()落盘。
+ */
+ConfigStore::~ConfigStore() {
+    m_writerPool.waitForDone();
+}
+
+void ConfigStore::setFilePath(const QString& filePath) {
+    m_filePath = filePath;
+}
+
+void ConfigStore::setConfigProvider(ConfigProvider provider) {
+    m_provider = std::move(provider);
+}
+
+void ConfigStore::setSaveDelay(int delayMs) {
+    m_saveTimer->setInterval(qMax(0, delayMs));
+}
+
+void ConfigStore::resetEntries(const QList<QJsonObject>& objects) {
+    m_entries.clear();
+    for (const QJsonObject& obj : objects) {
+        m_entries.insert(obj["id"].toString(), QJsonDocument(obj).toJson(QJsonDocument::Compact));
+    }
+    m_dirtyIds.clear();
+    m_structureDirty = false;
+}
+
+void ConfigStore::markDirty(const QString& widgetId) {
+    m_dirtyIds.insert(widgetId);
+}
+
+void ConfigStore::markRemoved(const QString& widgetId) {
+    m_dirtyIds.remove(widgetId);
+    m_entries.remove(widgetId);
+    m_structureDirty = true;
+}
+
+bool ConfigStore::hasPendingChanges() const {
+    return m_structureDirty || !m_dirtyIds.isEmpty();
+}
+
+void ConfigStore::scheduleSave() {
+    m_saveTimer->start();
+}
+
+/**
+ * @brief 延迟写入：在GUI线程序列化脏条目，在后台线程写盘
+ */
+void ConfigStore::onSaveTimer() {
+    if (!hasPendingChanges()) {
+        m_stats.skippedCount++;
+        return;
+    }
+
+    QElapsedTimer serializeTimer;
+    serializeTimer.start();
+    int serializedEntries = 0;
+    const QByteArray data = buildDocument(serializedEntries);
+    const double serializeMs = serializeTimer.nsecsElapsed() / 1e6;
+    m_stats.lastSerializedEntries = serializedEntries;
+
+    const QString filePath = m_filePath;
+    m_writerPool.start([this, filePath, data, serializeMs]() {
+        QElapsedTimer writeTimer;
+        writeTimer.start();
+        QString errorString;
+        const bool success = writeFile(filePath, data, errorString);
+        const double latencyMs = serializeMs + writeTimer.nsecsElapsed() / 1e6;
+
+        QMetaObject::invokeMethod(this, [this, success, data, latencyMs, errorString]() {
+            recordResult(success, data.size(), latencyMs, errorString);
+        }, Qt::QueuedConnection);
+    });
+}
+
+/**
+ * @brief 立即同步写盘
+ * @return 写入成功或没有需要写入的变更时返回true
+ */
+bool ConfigStore::saveNow() {
+    m_saveTimer->stop();
+    m_writerPool.waitForDone();
+
+    // 配置文件还不存在时即使没有变更也写出一份
+    if (!hasPendingChanges() && QFileInfo::exists(m_filePath)) {
+        m_stats.skippedCount++;
+        return true;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    int serializedEntries = 0;
+    const QByteArray data = buildDocument(serializedEntries);
+    m_stats.lastSerializedEntries = serializedEntries;
+
+    QString errorString;
+    const bool success = writeFile(m_filePath, data, errorString);
+    recordResult(success, data.size(), timer.nsecsElapsed() / 1e6, errorString);
+    return success;
+}
+
+/**
+ * @brief 重新序列化脏条目并拼接完整的配置文档
+ * @param serializedEntries 输出本次重新序列化的条目数
+ */
+QByteArray ConfigStore::buildDocument(int& serializedEntries) {
+    serializedEntries = 0;
+    for (const QString& widgetId : std::as_const(m_dirtyIds)) {
+        WidgetConfig config;
+        if (m_provider && m_provider(widgetId, config)) {
+            m_entries.insert(widgetId, QJsonDocument(toJson(config)).toJson(QJsonDocument::Compact));
+            serializedEntries++;
+        }
+    }
+    m_dirtyIds.clear();
+    m_structureDirty = false;
+
+    QByteArray data;
+    data.reserve(128 + m_entries.size() * 512);
+    data += "{\n";
+    data += "    \"last_saved\": \"" + QDateTime::currentDateTime().toString(Qt::ISODate).toUtf8() + "\",\n";
+    data += "    \"version\": \"1.0\",\n";
+    data += "    \"widgets\": [";
+
+    bool first = true;
+    for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it) {
+        data += first ? "\n        " : ",\n        ";
+        data += it.value();
+        first = false;
+    }
+
+    data += first ? "]\n" : "\n    ]\n";
+    data += "}\n";
+    return data;
+}
+
+bool ConfigStore::writeFile(const QString& filePath, const QByteArray& data, QString& errorString) {
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+    // QSaveFile先写临时文件，commit()时再原子地替换目标文件
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        errorString = file.errorString();
+        return false;
+    }
+
+    if (file.write(data) != data.size()) {
+        errorString = file.errorString();
+        file.cancelWriting();
+        return false;
+    }
+
+    if (!file.commit()) {
+        errorString = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+void ConfigStore::recordResult(bool success, qint64 bytesWritten, double latencyMs, const QString& errorString) {
+    if (!success) {
+        m_stats.failedCount++;
+        // 缓存的条目已经是最新的，下次保存时整体重写
+        m_structureDirty = true;
+        LOG_CERROR(lcConfig, "无法写入配置文件: " + errorString);
+        emit saved(false, 0, latencyMs);
+        return;
+    }
+
+    m_stats.saveCount++;
+    m_stats.lastBytesWritten = bytesWritten;
+    m_stats.totalBytesWritten += bytesWritten;
+    m_stats.lastLatencyMs = latencyMs;
+    m_stats.avgLatencyMs += (latencyMs - m_stats.avgLatencyMs) / m_stats.saveCount;
+    m_stats.maxLatencyMs = qMax(m_stats.maxLatencyMs, latencyMs);
+
+    LOG_CINFO(lcConfig, QString("配置保存成功: 重新序列化 %1 个条目, 写入 %2 字节, 耗时 %3ms")
+              .arg(m_stats.lastSerializedEntries)
+              .arg(bytesWritten)
+              .arg(latencyMs, 0, 'f', 2));
+    emit saved(true, bytesWritten, latencyMs);
+}
+
+QJsonObject ConfigStore::toJson(const WidgetConfig& config) {
+    QJsonObject obj;
+
+    obj["id"] = config.id;
+    obj["type"] = static_cast<int>(config.type);
+    if (!config.pluginKey.isEmpty()) {
+        obj["plugin"] = config.pluginKey;
+    }
+    obj["name"] = config.name;
+    obj["x"] = config.position.x();
+    obj["y"] = config.position.y();
+    obj["width"] = config.size.width();
+    obj["height"] = config.size.height();
+    obj["alwaysOnTop"] = config.alwaysOnTop;
+    obj["alwaysOnBottom"] = config.alwaysOnBottom;
+    obj["clickThrough"] = config.clickThrough;
+    obj["opacity"] = config.opacity;
+    obj["autoStart"] = config.autoStart;
+    obj["updateInterval"] = config.updateInterval;
+    obj["locked"] = config.locked;
+
+    if (!config.customSettings.isEmpty()) {
+        obj["customSettings"] = config.customSettings;
+    }
+    return obj;
+}
+
+WidgetConfig ConfigStore::fromJson(const QJsonObject& obj) {
+    WidgetConfig config;
+
+    config.id = obj["id"].toString();
+    config.type = static_cast<WidgetType>(obj["type"].toInt());
+    config.pluginKey = obj["plugin"].toString();
+    config.name = obj["name"].toString();
+    config.position = QPoint(obj["x"].toInt(), obj["y"].toInt());
+    config.size = QSize(obj["width"].toInt(), obj["height"].toInt());
+    config.alwaysOnTop = obj["alwaysOnTop"].toBool(false);
+    config.alwaysOnBottom = obj["alwaysOnBottom"].toBool(false);
+    config.clickThrough = obj["clickThrough"].toBool(false);
+    config.opacity = obj["opacity"].toDouble(1.0);
+    config.autoStart = obj["autoStart"].toBool(false);
+    config.updateInterval = obj["updateInterval"].toInt(1000);
+    config.locked = obj["locked"].toBool(false);
+
+    if (obj.contains("customSettings") && obj["customSettings"].isObject()) {
+        config.customSettings = obj["customSettings"].toObject();
+    }
+    return config;
+}
@@ -1,36 +1,514 @@
 /**
  * @file WidgetFramework.cpp
  * @brief 桌面小组件框架核心实现
- * @details 提供小组件系统的基础架构和生命周期管理
+ * @details 提供小组件系统的基础架构和共享的定时调度
  * @author 李子豪 (AstreoX)
  * @date 2025-5
  * @version 1.0.0
- * 
+ *
  * 该文件是桌面小组件系统的核心框架，负责：
  * - 小组件系统的初始化和配置
  * - 框架级别的资源管理
  * - 全局事件处理机制
  * - 系统级别的性能优化
+ *
+ * 共享调度器采用哈希时间轮：
+ * - 所有周期任务放入固定数量的槽位，只使用一个单次定时器
+ * - 粗粒度任务的周期被量化并对齐到墙钟边界，周期兼容的任务在同一次唤醒中执行；
+ *   合并只会推迟粗粒度任务（最多一个容差），从不在边界之前触发
+ * - 精确任务按注册周期触发，下一次唤醒只含粗粒度任务时使用CoarseTimer
+ *
+ * 会话状态跟踪：
+ * - Windows：通过WTS会话通知和GUID_CONSOLE_DISPLAY_STATE电源通知检测锁屏和熄屏
+ * - Linux（有QtDBus时）：logind会话的Lock/Unlock信号检测锁屏，
+ *   org.freedesktop.ScreenSaver的ActiveChanged信号检测屏保/熄屏。
+ *   DPMS单独关闭显示器而不启动屏保时没有通用的通知，这种情况检测不到
+ * - 其他平台：没有可用屏幕视为熄屏，应用程序被挂起视为会话不活动
+ *   （桌面系统上这两个条件在锁屏和熄屏时通常都不会成立）
  */
 
 #include "Framework/WidgetFramework.h"
+#include "Utils/Logger.h"
+#include "Utils/LogCategories.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QPointer>
+#include <QGuiApplication>
+#include <QScreen>
+#include <QWindow>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <wtsapi32.h>
+#endif
+
+#if defined(Q_OS_LINUX) && defined(QT_DBUS_LIB)
+#include <QDBusConnection>
+#include <QDBusInterface>
+#include <QDBusObjectPath>
+#include <QDBusReply>
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr int kSlotMs = 10;                 // 时间轮槽位宽度
+    constexpr int kWheelSlots = 512;            // 槽位数量（一圈约5秒）
+    constexpr int kCoarseSlackTicks = 5;        // 粗粒度任务为合并唤醒允许推迟的槽位数（50ms）
+    constexpr int kCoarseGridMs = 250;          // 1秒以上粗粒度周期的量化粒度
+    constexpr int kFineGridMs = 50;             // 1秒以下周期的量化粒度
+    constexpr int kStatsWindowMs = 10000;       // 唤醒频率统计窗口
+
+#ifdef Q_OS_WIN
+    // GUID_CONSOLE_DISPLAY_STATE {6FE69556-704A-47A0-8F24-C28D936FDA47}
+    const GUID kConsoleDisplayState =
+        { 0x6fe69556, 0x704a, 0x47a0, { 0x8f, 0x24, 0xc2, 0x8d, 0x93, 0x6f, 0xda, 0x47 } };
+#endif
+}
+
+/**
+ * @brief 获取全局框架实例
+ *
+ * 实例挂在QCoreApplication下，随应用程序一起销毁。
+ */
+WidgetFramework& WidgetFramework::instance() {
+    static QPointer<WidgetFramework> s_instance;
+    if (!s_instance) {
+        s_instance = new WidgetFramework(QCoreApplication::instance());
+    }
+    return *s_instance;
+}
 
 /**
  * @brief 构造函数
  * @param parent 父对象指针
- * 
- * 初始化小组件框架的核心组件：
- * - 事件处理系统
- * - 资源管理器
- * - 性能监控模块
- * - 全局配置管理
- * 
- * 框架采用单例模式设计，确保全局只有一个框架实例
+ *
+ * 初始化时间轮槽位和唯一的调度定时器。
+ */
+WidgetFramework::WidgetFramework(QObject* parent)
+    : QObject(parent)
+    , m_slots(kWheelSlots)
+    , m_nextJobId(1)
+    , m_lastProcessedTick(0)
+    , m_wheelTimer(new QTimer(this))
+    , m_totalWakeups(0)
+    , m_wakeupsSinceMark(0)
+    , m_wakeupRate(0.0)
+    , m_sessionLocked(false)
+    , m_displayOff(false)
+    , m_notifyWindow(nullptr)
+{
+    m_clock.start();
+    m_statsClock.start();
+
+    m_wheelTimer->setSingleShot(true);
+    connect(m_wheelTimer, &QTimer::timeout, this, &WidgetFramework::onWheelTimer);
+
+    setupSessionMonitoring();
+}
+
+WidgetFramework::~WidgetFramework() {
+    for (auto& job : m_jobs) {
+        disconnect(job.ownerConnection);
+    }
+
+    if (QCoreApplication::instance()) {
+        QCoreApplication::instance()->removeNativeEventFilter(this);
+    }
+#ifdef Q_OS_WIN
+    if (m_notifyWindow) {
+        WTSUnRegisterSessionNotification(reinterpret_cast<HWND>(m_notifyWindow->winId()));
+    }
+#endif
+    delete m_notifyWindow;
+}
+
+TickJobId WidgetFramework::registerJob(QObject* owner, int periodMs, TickClass tickClass,
+                                       std::function<void()> callback, bool active) {
+    const TickJobId id = m_nextJobId++;
+
+    Job job;
+    job.owner = owner;
+    job.periodMs = quantizePeriod(periodMs, tickClass);
+    job.tickClass = tickClass;
+    job.callback = std::move(callback);
+    if (owner) {
+        job.ownerConnection = connect(owner, &QObject::destroyed, this, [this, id]() {
+            unregisterJob(id);
+        });
+    }
+
+    m_jobs.insert(id, job);
+    if (active) {
+        setJobActive(id, true);
+    }
+    return id;
+}
+
+void WidgetFramework::unregisterJob(TickJobId id) {
+    auto it = m_jobs.find(id);
+    if (it == m_jobs.end()) {
+        return;
+    }
+    disconnect(it->ownerConnection);
+    m_jobs.erase(it);
+    // 槽位中的条目在扫描时作为过期条目清理
+    rearmTimer();
+}
+
+void WidgetFramework::setJobPeriod(TickJobId id, int periodMs) {
+    auto it = m_jobs.find(id);
+    if (it == m_jobs.end()) {
+        return;
+    }
+
+    const int quantized = quantizePeriod(periodMs, it->tickClass);
+    if (quantized == it->periodMs) {
+        return;
+    }
+    it->periodMs = quantized;
+
+    if (it->active) {
+        if (quantized > 0) {
+            scheduleJob(id, *it, currentTick(), false);
+        } else {
+            it->active = false;
+            it->dueTick = -1;
+        }
+        rearmTimer();
+    }
+}
+
+void WidgetFramework::setJobActive(TickJobId id, bool active) {
+    auto it = m_jobs.find(id);
+    if (it == m_jobs.end()) {
+        return;
+    }
+
+    // 周期无效的任务不能启动
+    if (active && it->periodMs <= 0) {
+        active = false;
+    }
+    if (it->active == active) {
+        return;
+    }
+
+    it->active = active;
+    if (active) {
+        scheduleJob(id, *it, currentTick(), false);
+    } else {
+        it->dueTick = -1;
+    }
+    rearmTimer();
+}
+
+bool WidgetFramework::isJobActive(TickJobId id) const {
+    auto it = m_jobs.constFind(id);
+    return it != m_jobs.constEnd() && it->active;
+}
+
+int WidgetFramework::jobPeriod(TickJobId id) const {
+    auto it = m_jobs.constFind(id);
+    return it != m_jobs.constEnd() ? it->periodMs : 0;
+}
+
+qint64 WidgetFramework::currentTick() const {
+    return m_clock.elapsed() / kSlotMs;
+}
+
+int WidgetFramework::quantizePeriod(int periodMs, TickClass tickClass) const {
+    if (periodMs <= 0) {
+        return 0;
+    }
+    if (tickClass == TickClass::Precise) {
+        return qMax(kSlotMs, (periodMs + kSlotMs / 2) / kSlotMs * kSlotMs);
+    }
+    const int grid = periodMs >= 1000 ? kCoarseGridMs : kFineGridMs;
+    return qMax(grid, (periodMs + grid / 2) / grid * grid);
+}
+
+/**
+ * @brief 计算任务的下一次触发槽位并放入时间轮
+ * @param afterRun 是否刚执行完（精确任务据此按周期累加，避免漂移）
+ *
+ * 粗粒度任务对齐到墙钟上周期的整数倍（如2秒任务总在偶数秒触发），
+ * 因此所有兼容周期的任务自然落在同一个槽位。槽位向上取整，
+ * 保证任务不早于墙钟边界执行（时钟类小组件读取当前时间时不会读到上一秒）。
+ */
+void WidgetFramework::scheduleJob(TickJobId id, Job& job, qint64 nowTick, bool afterRun) {
+    const qint64 periodTicks = qMax<qint64>(1, job.periodMs / kSlotMs);
+    qint64 dueTick;
+
+    if (job.tickClass == TickClass::Coarse) {
+        // 取严格晚于当前时间的下一个墙钟边界；任务总在边界之后执行，不会对同一边界触发两次
+        const qint64 wallNow = QDateTime::currentMSecsSinceEpoch();
+        const qint64 boundary = (wallNow / job.periodMs + 1) * job.periodMs;
+        const qint64 dueMs = m_clock.elapsed() + (boundary - wallNow);
+        dueTick = (dueMs + kSlotMs - 1) / kSlotMs;
+    } else if (afterRun && job.dueTick >= 0) {
+        dueTick = job.dueTick + periodTicks;
+        if (dueTick <= nowTick) {
+            dueTick = nowTick + periodTicks; // 落后太多时不补发
+        }
+    } else {
+        dueTick = nowTick + periodTicks;
+    }
+
+    job.dueTick = dueTick;
+    m_slots[dueTick % kWheelSlots].append({id, dueTick});
+}
+
+void WidgetFramework::onWheelTimer() {
+    const qint64 nowTick = currentTick();
+
+    m_totalWakeups++;
+    m_wakeupsSinceMark++;
+
+    // 扫描上次处理之后到当前的槽位，最多一整圈；未到期的任务（包括粗粒度任务）一律不提前执行
+    qint64 fromTick = m_lastProcessedTick + 1;
+    if (nowTick - fromTick + 1 > kWheelSlots) {
+        fromTick = nowTick - kWheelSlots + 1;
+    }
+
+    QVector<TickJobId> dueJobs;
+    for (qint64 tick = fromTick; tick <= nowTick; ++tick) {
+        QVector<SlotEntry>& slot = m_slots[tick % kWheelSlots];
+        for (int i = 0; i < slot.size();) {
+            const SlotEntry entry = slot.at(i);
+            auto it = m_jobs.constFind(entry.id);
+            if (it == m_jobs.constEnd() || !it->active || it->dueTick != entry.dueTick) {
+                slot.remove(i); // 过期条目
+                continue;
+            }
+            if (entry.dueTick <= nowTick) {
+                dueJobs.append(entry.id);
+                slot.remove(i);
+                continue;
+            }
+            ++i;
+        }
+    }
+    m_lastProcessedTick = nowTick;
+
+    for (TickJobId id : dueJobs) {
+        auto it = m_jobs.find(id);
+        if (it == m_jobs.end() || !it->active) {
+            continue; // 已被之前的回调注销或暂停
+        }
+        // 先重新调度再执行，回调内可能注销任务
+        scheduleJob(id, *it, nowTick, true);
+        std::function<void()> callback = it->callback;
+        if (callback) {
+            callback();
+        }
+    }
+
+    updateStatistics();
+    rearmTimer();
+}
+
+/**
+ * @brief 按最早到期的任务重新设定唯一的定时器
+ *
+ * 只含粗粒度任务的唤醒向后推迟到容差范围内最晚到期的粗粒度任务，
+ * 使相近边界上的任务合并为一次唤醒；推迟不会越过下一个精确任务。
+ */
+void WidgetFramework::rearmTimer() {
+    qint64 nextPrecise = -1;
+    qint64 nextCoarse = -1;
+
+    for (const auto& job : m_jobs) {
+        if (!job.active || job.dueTick < 0) {
+            continue;
+        }
+        qint64& next = job.tickClass == TickClass::Precise ? nextPrecise : nextCoarse;
+        if (next < 0 || job.dueTick < next) {
+            next = job.dueTick;
+        }
+    }
+
+    qint64 coarseWake = nextCoarse;
+    if (nextCoarse >= 0) {
+        for (const auto& job : m_jobs) {
+            if (job.active && job.tickClass == TickClass::Coarse &&
+                job.dueTick > coarseWake && job.dueTick <= nextCoarse + kCoarseSlackTicks) {
+                coarseWake = job.dueTick;
+            }
+        }
+    }
+
+    qint64 nextTick;
+    bool needPrecise;
+    if (nextPrecise >= 0 && (coarseWake < 0 || nextPrecise <= coarseWake)) {
+        nextTick = nextPrecise;
+        needPrecise = true;
+    } else if (coarseWake >= 0) {
+        nextTick = coarseWake;
+        needPrecise = false;
+    } else {
+        m_wheelTimer->stop();
+        return;
+    }
+
+    // CoarseTimer可能提前最多5%触发，提前唤醒时任务不会执行，只会重新设定定时器
+    const qint64 delayMs = qMax<qint64>(0, nextTick * kSlotMs - m_clock.elapsed());
+    m_wheelTimer->setTimerType(needPrecise ? Qt::PreciseTimer : Qt::CoarseTimer);
+    m_wheelTimer->start(static_cast<int>(delayMs));
+}
+
+void WidgetFramework::updateStatistics() {
+    const qint64 elapsed = m_statsClock.elapsed();
+    if (elapsed < kStatsWindowMs) {
+        return;
+    }
+
+    m_wakeupRate = m_wakeupsSinceMark * 1000.0 / elapsed;
+    m_wakeupsSinceMark = 0;
+    m_statsClock.restart();
+
+    LOG_CDEBUG(lcRender, QString("调度器统计: %1 个任务, %2 次唤醒/秒")
+                  .arg(m_jobs.size())
+                  .arg(m_wakeupRate, 0, 'f', 2));
+    emit statisticsUpdated(m_wakeupRate, m_jobs.size());
+}
+
+/**
+ * @brief 建立会话锁定和显示器状态的监测
+ *
+ * 这些状态由所有小组件共享，小组件据此决定是否暂停更新。
+ */
+void WidgetFramework::setupSessionMonitoring() {
+    QGuiApplication* guiApp = qobject_cast<QGuiApplication*>(QCoreApplication::instance());
+    if (!guiApp) {
+        return;
+    }
+
+#ifdef Q_OS_WIN
+    // 创建一个不显示的原生窗口用于接收WTS和电源广播消息
+    m_notifyWindow = new QWindow();
+    m_notifyWindow->create();
+    HWND hwnd = reinterpret_cast<HWND>(m_notifyWindow->winId());
+    if (hwnd) {
+        WTSRegisterSessionNotification(hwnd, NOTIFY_FOR_THIS_SESSION);
+        RegisterPowerSettingNotification(hwnd, &kConsoleDisplayState, DEVICE_NOTIFY_WINDOW_HANDLE);
+    }
+    guiApp->installNativeEventFilter(this);
+#else
+    if (setupDBusSessionMonitoring()) {
+        return;
+    }
+
+    // 没有原生通知时退化为：没有可用屏幕视为熄屏，应用挂起视为会话不活动
+    auto updateScreens = [this]() {
+        setDisplayOff(QGuiApplication::screens().isEmpty());
+    };
+    connect(guiApp, &QGuiApplication::screenAdded, this, updateScreens);
+    connect(guiApp, &QGuiApplication::screenRemoved, this, updateScreens);
+    connect(guiApp, &QGuiApplication::applicationStateChanged, this, [this](Qt::ApplicationState state) {
+        setSessionLocked(state == Qt::ApplicationSuspended);
+    });
+#endif
+}
+
+/**
+ * @brief 订阅logind和屏保服务的D-Bus信号
+ * @return 至少订阅到一个信号时返回true
+ *
+ * logind的Lock/Unlock由本会话的对象发出，先按进程号查询会话路径，
+ * 查询失败时用XDG_SESSION_ID；屏保服务在会话总线上，各桌面环境都实现了这一接口。
  */
-WidgetFramework::WidgetFramework(QObject* parent) : QObject(parent) {
-    // TODO: 初始化框架核心组件
-    // - 设置全局事件处理器
-    // - 初始化资源管理系统
-    // - 配置性能监控
-    // - 建立组件间通信机制
-} 
\ No newline at end of file
+bool WidgetFramework::setupDBusSessionMonitoring() {
+#if defined(Q_OS_LINUX) && defined(QT_DBUS_LIB)
+    bool connected = false;
+
+    QDBusConnection systemBus = QDBusConnection::systemBus();
+    if (systemBus.isConnected()) {
+        QDBusInterface manager("org.freedesktop.login1", "/org/freedesktop/login1",
+                               "org.freedesktop.login1.Manager", systemBus);
+        QDBusReply<QDBusObjectPath> session = manager.call("GetSessionByPID", static_cast<quint32>(::getpid()));
+        if (!session.isValid() && qEnvironmentVariableIsSet("XDG_SESSION_ID")) {
+            session = manager.call("GetSession", qEnvironmentVariable("XDG_SESSION_ID"));
+        }
+        if (session.isValid()) {
+            const QString path = session.value().path();
+            connected |= systemBus.connect("org.freedesktop.login1", path, "org.freedesktop.login1.Session",
+                                           "Lock", this, SLOT(onLoginSessionLock()));
+            connected |= systemBus.connect("org.freedesktop.login1", path, "org.freedesktop.login1.Session",
+                                           "Unlock", this, SLOT(onLoginSessionUnlock()));
+        }
+    }
+
+    QDBusConnection sessionBus = QDBusConnection::sessionBus();
+    if (sessionBus.isConnected()) {
+        connected |= sessionBus.connect("org.freedesktop.ScreenSaver", "/org/freedesktop/ScreenSaver",
+                                        "org.freedesktop.ScreenSaver", "ActiveChanged",
+                                        this, SLOT(onScreenSaverActiveChanged(bool)));
+    }
+
+    if (!connected) {
+        LOG_CWARNING(lcWidget, "无法订阅logind或屏保服务的D-Bus信号，锁屏和熄屏检测不可用");
+    }
+    return connected;
+#else
+    return false;
+#endif
+}
+
+void WidgetFramework::onLoginSessionLock() {
+    setSessionLocked(true);
+}
+
+void WidgetFramework::onLoginSessionUnlock() {
+    setSessionLocked(false);
+}
+
+void WidgetFramework::onScreenSaverActiveChanged(bool active) {
+    // 屏保启动时桌面通常已被遮住或熄屏，按熄屏处理
+    setDisplayOff(active);
+}
+
+bool WidgetFramework::nativeEventFilter(const QByteArray& eventType, void* message, qintptr* result) {
+    Q_UNUSED(result);
+#ifdef Q_OS_WIN
+    if (eventType != "windows_generic_MSG") {
+        return false;
+    }
+
+    MSG* msg = static_cast<MSG*>(message);
+    if (msg->message == WM_WTSSESSION_CHANGE) {
+        if (msg->wParam == WTS_SESSION_LOCK) {
+            setSessionLocked(true);
+        } else if (msg->wParam == WTS_SESSION_UNLOCK) {
+            setSessionLocked(false);
+        }
+    } else if (msg->message == WM_POWERBROADCAST && msg->wParam == PBT_POWERSETTINGCHANGE) {
+        auto* setting = reinterpret_cast<POWERBROADCAST_SETTING*>(msg->lParam);
+        if (setting && IsEqualGUID(setting->PowerSetting, kConsoleDisplayState)) {
+            // 0 = 关闭, 1 = 打开, 2 = 变暗
+            DWORD state = *reinterpret_cast<const DWORD*>(setting->Data);
+            setDisplayOff(state == 0);
+        }
+    }
+#else
+    Q_UNUSED(eventType);
+    Q_UNUSED(message);
+#endif
+    return false;
+}
+
+void WidgetFramework::setSessionLocked(bool locked) {
+    if (m_sessionLocked == locked) {
+        return;
+    }
+    m_sessionLocked = locked;
+    LOG_CINFO(lcWidget, locked ? "会话已锁定，暂停小组件更新" : "会话已解锁，恢复小组件更新");
+    emit sessionStateChanged();
+}
+
+void WidgetFramework::setDisplayOff(bool off) {
+    if (m_displayOff == off) {
+        return;
+    }
+    m_displayOff = off;
+    LOG_CINFO(lcWidget, off ? "显示器已关闭，暂停小组件更新" : "显示器已打开，恢复小组件更新");
+    emit sessionStateChanged();
+}
@@ -22,49 +22,62 @@
  */
 
 #include "Framework/WidgetManager.h"
-#include "Widgets/ClockWidget.h"
-#include "Widgets/WeatherWidget.h"
-#include "Widgets/AIRankingWidget.h"
-#include "Widgets/SystemPerformanceWidget.h"
-#include "Widgets/SimpleNotesWidget.h"
-#include "Widgets/CalendarWidget.h"
-#include "Widgets/SystemInfoWidget.h"
-#include "BackendManagement/ConfigWindow.h"
-#include "BackendManagement/AIRankingConfigDialog.h"
-#include "BackendManagement/WeatherConfigDialog.h"
+#include "Framework/ConfigStore.h"
+#include "Framework/WidgetTypeRegistry.h"
 #include "Utils/Logger.h"
+#include "Utils/LogCategories.h"
 #include <QJsonDocument>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QStandardPaths>
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
 #include <QDateTime>
+#include <QGuiApplication>
+#include <QScreen>
+#include <algorithm>
 
 /**
  * @brief WidgetManager构造函数
  * @param parent 父QObject指针
  * 
  * 初始化小组件管理器的核心组件：
- * - 设置自动保存定时器（5秒延迟）
+ * - 设置配置存储（5秒延迟写盘）
  * - 初始化小组件容器
  * - 配置错误处理机制
  * - 建立信号槽连接
  * 
  * 自动保存机制设计：
- * - 使用单次触发定时器避免频繁保存
- * - 在配置更改后延迟5秒保存，避免性能影响
+ * - 只标记发生变化的小组件，写盘时只重新序列化这些条目
+ * - 在配置更改后延迟5秒在后台线程写盘，避免性能影响
  * - 支持手动保存和强制保存模式
  */
 WidgetManager::WidgetManager(QObject* parent)
     : QObject(parent)
-    , m_saveTimer(new QTimer(this))
+    , m_loadTimer(new QTimer(this))
+    , m_loadedCount(0)
+    , m_store(new ConfigStore(this))
     , m_autoSave(true)
+    , m_batchDepth(0)
 {
-    // 配置自动保存定时器
-    m_saveTimer->setSingleShot(true);
-    m_saveTimer->setInterval(5000); // 5秒延迟保存，平衡性能和数据安全
-    connect(m_saveTimer, &QTimer::timeout, this, [this](){ this->saveConfiguration(); });
+    // 配置存储：变更5秒后合并写盘，平衡性能和数据安全；
+    // 存储只向管理器索取被标记为脏的小组件的配置
+    m_store->setFilePath(getConfigFilePath());
+    m_store->setSaveDelay(5000);
+    m_store->setConfigProvider([this](const QString& widgetId, WidgetConfig& config) {
+        if (!hasWidget(widgetId)) {
+            return false;
+        }
+        config = getWidgetConfig(widgetId);
+        return true;
+    });
+    
+    // 分批实例化定时器：每次只实例化一个小组件，然后回到事件循环，
+    // 让托盘图标和已创建的小组件先完成绘制
+    m_loadTimer->setSingleShot(true);
+    m_loadTimer->setInterval(0);
+    connect(m_loadTimer, &QTimer::timeout, this, &WidgetManager::onLoadStep);
 }
 
 /**
@@ -101,23 +114,43 @@ WidgetManager::~WidgetManager() {
 bool WidgetManager::createWidget(const WidgetConfig& config) {
     // 验证Widget ID的唯一性
     if (hasWidget(config.id)) {
-        Logger::warning(QString("Widget已存在: %1").arg(config.id));
+        LOG_CWARNING(lcWidget, QString("Widget已存在: %1").arg(config.id));
         return false;
     }
     
     // 验证配置的完整性和有效性
     if (!validateConfig(config)) {
-        Logger::error(QString("Widget配置无效: %1").arg(config.id));
+        LOG_CERROR(lcWidget, QString("Widget配置无效: %1").arg(config.id));
         return false;
     }
     
-    // 使用工厂方法创建具体类型的Widget
-    WidgetPtr widget = createWidgetByType(config.type, config);
+    // 创建Widget实例并纳入管理
+    WidgetPtr widget = instantiateWidget(config);
     if (!widget) {
-        Logger::error(QString("无法创建Widget: %1").arg(config.id));
         return false;
     }
     
+    // 触发自动保存机制
+    markConfigDirty(config.id);
+    recordCreated(config.id);
+    
+    LOG_CINFO(lcWidget, QString("Widget创建成功: %1").arg(config.id));
+    return true;
+}
+
+/**
+ * @brief 使用工厂方法创建小组件并纳入管理
+ * @param config 小组件配置信息
+ * @return 创建的小组件，失败时返回nullptr
+ */
+WidgetPtr WidgetManager::instantiateWidget(const WidgetConfig& config) {
+    // 由类型注册表中对应的插件创建具体类型的Widget，外部插件在此时才加载
+    WidgetPtr widget = WidgetTypeRegistry::instance().createWidget(config);
+    if (!widget) {
+        LOG_CERROR(lcWidget, QString("无法创建Widget: %1").arg(config.id));
+        return nullptr;
+    }
+    
     // 将Widget添加到管理容器
     m_widgets[config.id] = widget;
     
@@ -126,17 +159,20 @@ bool WidgetManager::createWidget(const WidgetConfig& config) {
     
     // 通知外部组件Widget创建完成
     emit widgetCreated(config.id);
-    
-    // 触发自动保存机制
-    if (m_autoSave) {
-        m_saveTimer->start();
-    }
-    
-    Logger::info(QString("Widget创建成功: %1").arg(config.id));
-    return true;
+    return widget;
 }
 
 bool WidgetManager::removeWidget(const QString& widgetId) {
+    // 尚未实例化的小组件只需移除其配置
+    if (m_deferredConfigs.remove(widgetId) > 0) {
+        m_loadQueue.removeAll(widgetId);
+        emit widgetRemoved(widgetId);
+        markConfigRemoved(widgetId);
+        recordRemoved(widgetId);
+        LOG_CINFO(lcWidget, QString("Widget移除成功: %1").arg(widgetId));
+        return true;
+    }
+    
     auto it = m_widgets.find(widgetId);
     if (it == m_widgets.end()) {
         return false;
@@ -149,16 +185,16 @@ bool WidgetManager::removeWidget(const QString& widgetId) {
     m_widgets.erase(it);
     emit widgetRemoved(widgetId);
     
-    if (m_autoSave) {
-        m_saveTimer->start();
-    }
+    markConfigRemoved(widgetId);
+    recordRemoved(widgetId);
     
-    Logger::info(QString("Widget移除成功: %1").arg(widgetId));
+    LOG_CINFO(lcWidget, QString("Widget移除成功: %1").arg(widgetId));
     return true;
 }
 
 bool WidgetManager::startWidget(const QString& widgetId) {
-    WidgetPtr widget = getWidget(widgetId);
+    // 延迟加载的小组件在首次启动时才实例化
+    WidgetPtr widget = ensureWidget(widgetId);
     if (!widget) {
         return false;
     }
@@ -170,7 +206,8 @@ bool WidgetManager::startWidget(const QString& widgetId) {
 bool WidgetManager::stopWidget(const QString& widgetId) {
     WidgetPtr widget = getWidget(widgetId);
     if (!widget) {
-        return false;
+        // 尚未实例化的小组件本来就没有运行
+        return m_deferredConfigs.contains(widgetId);
     }
     
     widget->stop();
@@ -178,6 +215,11 @@ bool WidgetManager::stopWidget(const QString& widgetId) {
 }
 
 void WidgetManager::startAllWidgets() {
+    const QStringList deferredIds = m_deferredConfigs.keys();
+    for (const QString& widgetId : deferredIds) {
+        ensureWidget(widgetId);
+    }
+    
     for (auto& widget : m_widgets) {
         widget->start();
     }
@@ -190,6 +232,15 @@ void WidgetManager::stopAllWidgets() {
 }
 
 void WidgetManager::cleanupAllWidgets() {
+    // 清理前先把尚未写盘的变更落盘，之后配置存储将无法再取得这些配置
+    if (m_store->hasPendingChanges()) {
+        m_store->saveNow();
+    }
+    
+    m_loadTimer->stop();
+    m_loadQueue.clear();
+    m_deferredConfigs.clear();
+    
     for (auto& widget : m_widgets) {
         widget->cleanup();
     }
@@ -215,29 +266,81 @@ QList<WidgetPtr> WidgetManager::getWidgetsByType(WidgetType type) const {
 }
 
 bool WidgetManager::hasWidget(const QString& widgetId) const {
-    return m_widgets.contains(widgetId);
+    return m_widgets.contains(widgetId) || m_deferredConfigs.contains(widgetId);
 }
 
 int WidgetManager::getWidgetCount() const {
-    return m_widgets.size();
+    return m_widgets.size() + m_deferredConfigs.size();
 }
 
 QStringList WidgetManager::getWidgetIds() const {
-    return m_widgets.keys();
+    QStringList ids = m_widgets.keys() + m_deferredConfigs.keys();
+    ids.sort();
+    return ids;
+}
+
+bool WidgetManager::isWidgetLoaded(const QString& widgetId) const {
+    return m_widgets.contains(widgetId);
+}
+
+WidgetStatus WidgetManager::getWidgetStatus(const QString& widgetId) const {
+    WidgetPtr widget = getWidget(widgetId);
+    if (widget) {
+        return widget->getStatus();
+    }
+    // 尚未实例化的小组件视为隐藏
+    return WidgetStatus::Hidden;
+}
+
+/**
+ * @brief 获取小组件实例，尚未实例化时立即创建
+ * @param widgetId 小组件ID
+ * @return 小组件实例，ID不存在时返回nullptr
+ */
+WidgetPtr WidgetManager::ensureWidget(const QString& widgetId) {
+    WidgetPtr widget = getWidget(widgetId);
+    if (widget) {
+        return widget;
+    }
+    
+    auto it = m_deferredConfigs.find(widgetId);
+    if (it == m_deferredConfigs.end()) {
+        return nullptr;
+    }
+    
+    WidgetConfig config = it.value();
+    m_deferredConfigs.erase(it);
+    m_loadQueue.removeAll(widgetId);
+    
+    QElapsedTimer timer;
+    timer.start();
+    widget = instantiateWidget(config);
+    if (widget) {
+        LOG_CEVENT(Logger::Debug, lcWidget, widgetId, "Widget实例化完成, 耗时 %1ms", timer.elapsed());
+    }
+    return widget;
 }
 
 bool WidgetManager::updateWidgetConfig(const QString& widgetId, const WidgetConfig& config) {
+    // 尚未实例化的小组件只更新登记的配置，等到启动时再应用
+    auto deferred = m_deferredConfigs.find(widgetId);
+    if (deferred != m_deferredConfigs.end()) {
+        deferred.value() = config;
+        markConfigDirty(widgetId);
+        emit widgetConfigUpdated(widgetId, config);
+        recordUpdated(widgetId);
+        return true;
+    }
+    
     WidgetPtr widget = getWidget(widgetId);
     if (!widget) {
-        Logger::warning(QString("尝试更新不存在的Widget: %1").arg(widgetId));
+        LOG_CWARNING(lcWidget, QString("尝试更新不存在的Widget: %1").arg(widgetId));
         return false;
     }
     
+    // 配置有变化时setConfig()发出configChanged，由onWidgetConfigChanged标记保存、
+    // 发出widgetConfigUpdated并记录变更，这里不再重复；没有变化时什么也不做
     widget->setConfig(config);
-    if (m_autoSave) {
-        m_saveTimer->start();
-    }
-    emit widgetConfigUpdated(widgetId, config);
     return true;
 }
 
@@ -246,66 +349,157 @@ WidgetConfig WidgetManager::getWidgetConfig(const QString& widgetId) const {
     if (widget) {
         return widget->getConfig();
     }
-    return WidgetConfig();
+    return m_deferredConfigs.value(widgetId, WidgetConfig());
 }
 
 QList<WidgetConfig> WidgetManager::getAllConfigs() const {
-    QList<WidgetConfig> configs;
-    for(const auto& widget : m_widgets.values()) {
-        configs.append(widget->getConfig());
+    // 合并已实例化和延迟加载的小组件，按ID排序
+    QMap<QString, WidgetConfig> configs = m_deferredConfigs;
+    for (auto it = m_widgets.cbegin(); it != m_widgets.cend(); ++it) {
+        configs.insert(it.key(), it.value()->getConfig());
     }
-    return configs;
+    return configs.values();
 }
 
 bool WidgetManager::saveConfiguration() const {
-    QString configPath = getConfigFilePath();
-    QDir().mkpath(QFileInfo(configPath).absolutePath());
-
-    QJsonObject root;
-    QJsonArray widgetsArray;
-    for (const auto& widget : m_widgets) {
-        const auto& config = widget->getConfig();
-        QJsonObject obj;
-        
-        obj["id"] = config.id;
-        obj["type"] = static_cast<int>(config.type);
-        obj["name"] = config.name;
-        obj["x"] = config.position.x();
-        obj["y"] = config.position.y();
-        obj["width"] = config.size.width();
-        obj["height"] = config.size.height();
-        obj["alwaysOnTop"] = config.alwaysOnTop;
-        obj["alwaysOnBottom"] = config.alwaysOnBottom;
-        obj["clickThrough"] = config.clickThrough;
-        obj["opacity"] = config.opacity;
-        obj["autoStart"] = config.autoStart;
-        obj["updateInterval"] = config.updateInterval;
-        obj["locked"] = config.locked;
-        
-        if (!config.customSettings.isEmpty()) {
-            obj["customSettings"] = config.customSettings;
-        }
-        
-        widgetsArray.append(obj);
+    // 所有变更都已在发生时标记给配置存储，这里只需立即写盘
+    return m_store->saveNow();
+}
+
+void WidgetManager::markConfigDirty(const QString& widgetId) {
+    m_store->markDirty(widgetId);
+    // 批量中只标记，提交时统一安排一次保存
+    if (m_autoSave && m_batchDepth == 0) {
+        m_store->scheduleSave();
+    }
+}
+
+void WidgetManager::markConfigRemoved(const QString& widgetId) {
+    m_store->markRemoved(widgetId);
+    if (m_autoSave && m_batchDepth == 0) {
+        m_store->scheduleSave();
+    }
+}
+
+/**
+ * @brief 开始批量操作
+ * 
+ * 批量期间的创建、删除和配置更新照常生效，单个小组件的信号照常发出，
+ * 但变更集和保存推迟到最外层的commitBatch()。
+ */
+void WidgetManager::beginBatch() {
+    if (m_batchDepth++ == 0) {
+        m_batchClock.start();
+    }
+}
+
+/**
+ * @brief 提交批量操作，发出一次汇总的widgetsChanged信号并安排一次保存
+ */
+void WidgetManager::commitBatch() {
+    if (m_batchDepth == 0) {
+        LOG_CWARNING(lcWidget, "commitBatch()没有对应的beginBatch()");
+        return;
+    }
+    if (--m_batchDepth > 0) {
+        return;
     }
     
-    root["widgets"] = widgetsArray;
-    root["version"] = "1.0";
-    root["last_saved"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    const int changeCount = m_pendingChanges.size();
+    flushChanges();
     
-    QJsonDocument doc(root);
-    QFile file(configPath);
+    if (m_autoSave && m_store->hasPendingChanges()) {
+        m_store->scheduleSave();
+    }
     
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        Logger::error("无法打开配置文件进行写入: " + file.errorString());
-        return false;
+    if (changeCount > 1) {
+        LOG_DEBUG(QString("批量操作完成: %1 项变更, 耗时 %2ms").arg(changeCount).arg(m_batchClock.elapsed()));
+    }
+}
+
+int WidgetManager::createWidgets(const QList<WidgetConfig>& configs) {
+    int created = 0;
+    beginBatch();
+    for (const WidgetConfig& config : configs) {
+        if (createWidget(config)) {
+            created++;
+        }
+    }
+    commitBatch();
+    return created;
+}
+
+int WidgetManager::removeWidgets(const QStringList& widgetIds) {
+    int removed = 0;
+    beginBatch();
+    for (const QString& widgetId : widgetIds) {
+        if (removeWidget(widgetId)) {
+            removed++;
+        }
+    }
+    commitBatch();
+    return removed;
+}
+
+int WidgetManager::updateWidgetConfigs(const QList<WidgetConfig>& configs) {
+    int updated = 0;
+    beginBatch();
+    for (const WidgetConfig& config : configs) {
+        if (updateWidgetConfig(config.id, config)) {
+            updated++;
+        }
+    }
+    commitBatch();
+    return updated;
+}
+
+void WidgetManager::recordCreated(const QString& widgetId) {
+    // 同一批量中先删除后重新创建的小组件视为更新
+    if (m_pendingChanges.removed.removeAll(widgetId) > 0) {
+        if (!m_pendingChanges.updated.contains(widgetId)) {
+            m_pendingChanges.updated.append(widgetId);
+        }
+    } else if (!m_pendingChanges.created.contains(widgetId)) {
+        m_pendingChanges.created.append(widgetId);
     }
     
-    file.write(doc.toJson(QJsonDocument::Indented));
-    file.close();
+    if (m_batchDepth == 0) {
+        flushChanges();
+    }
+}
+
+void WidgetManager::recordRemoved(const QString& widgetId) {
+    m_pendingChanges.updated.removeAll(widgetId);
+    // 同一批量中创建又删除的小组件不出现在变更集中
+    if (m_pendingChanges.created.removeAll(widgetId) == 0 &&
+        !m_pendingChanges.removed.contains(widgetId)) {
+        m_pendingChanges.removed.append(widgetId);
+    }
     
-    Logger::info("配置保存成功。");
-    return true;
+    if (m_batchDepth == 0) {
+        flushChanges();
+    }
+}
+
+void WidgetManager::recordUpdated(const QString& widgetId) {
+    if (!m_pendingChanges.created.contains(widgetId) &&
+        !m_pendingChanges.updated.contains(widgetId)) {
+        m_pendingChanges.updated.append(widgetId);
+    }
+    
+    if (m_batchDepth == 0) {
+        flushChanges();
+    }
+}
+
+void WidgetManager::flushChanges() {
+    if (m_pendingChanges.isEmpty()) {
+        return;
+    }
+    
+    const WidgetChangeSet changes = m_pendingChanges;
+    m_pendingChanges = WidgetChangeSet();
+    emit widgetsChanged(changes);
 }
 
 bool WidgetManager::loadConfiguration() {
@@ -314,7 +508,7 @@ bool WidgetManager::loadConfiguration() {
 
 bool WidgetManager::exportConfiguration(const QString& filePath) const {
     if (filePath.isEmpty()) {
-        Logger::warning("导出失败：路径为空。");
+        LOG_CWARNING(lcConfig, "导出失败：路径为空。");
         return false;
     }
     // This is a simple implementation. In a real scenario, you might want to format it differently.
@@ -324,7 +518,7 @@ bool WidgetManager::exportConfiguration(const QString& filePath) const {
 
 bool WidgetManager::importConfiguration(const QString& filePath) {
     if (filePath.isEmpty() || !QFile::exists(filePath)) {
-        Logger::warning("导入失败：文件不存在或路径为空。");
+        LOG_CWARNING(lcConfig, "导入失败：文件不存在或路径为空。");
         return false;
     }
     return loadConfigurationFromFile(filePath);
@@ -333,12 +527,12 @@ bool WidgetManager::importConfiguration(const QString& filePath) {
 bool WidgetManager::loadConfigurationFromFile(const QString& filePath) {
     QFile file(filePath);
     if (!file.exists()) {
-        Logger::warning("配置文件不存在，将使用默认设置。");
+        LOG_CWARNING(lcConfig, "配置文件不存在，将使用默认设置。");
         return saveConfiguration();
     }
     
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        Logger::error("无法打开配置文件进行读取: " + file.errorString());
+        LOG_CERROR(lcConfig, "无法打开配置文件进行读取: " + file.errorString());
         return false;
     }
     
@@ -349,12 +543,12 @@ bool WidgetManager::loadConfigurationFromFile(const QString& filePath) {
     QJsonDocument doc = QJsonDocument::fromJson(data, &error);
     
     if (error.error != QJsonParseError::NoError) {
-        Logger::error("解析配置文件失败: " + error.errorString());
+        LOG_CERROR(lcConfig, "解析配置文件失败: " + error.errorString());
         return false;
     }
     
     if (!doc.isObject()) {
-        Logger::error("配置文件格式错误，根节点不是一个对象。");
+        LOG_CERROR(lcConfig, "配置文件格式错误，根节点不是一个对象。");
         return false;
     }
     
@@ -363,43 +557,107 @@ bool WidgetManager::loadConfigurationFromFile(const QString& filePath) {
     
     cleanupAllWidgets();
     
+    // 第一阶段：只登记配置，不创建任何小组件
+    QList<WidgetConfig> autoStartConfigs;
+    QList<QJsonObject> loadedEntries;
     for (const auto& value : widgetsArray) {
         QJsonObject obj = value.toObject();
-        WidgetConfig config;
-        
-        config.id = obj["id"].toString();
-        config.type = static_cast<WidgetType>(obj["type"].toInt());
-        config.name = obj["name"].toString();
-        config.position = QPoint(obj["x"].toInt(), obj["y"].toInt());
-        config.size = QSize(obj["width"].toInt(), obj["height"].toInt());
-        config.alwaysOnTop = obj["alwaysOnTop"].toBool(false);
-        config.alwaysOnBottom = obj["alwaysOnBottom"].toBool(false);
-        config.clickThrough = obj["clickThrough"].toBool(false);
-        config.opacity = obj["opacity"].toDouble(1.0);
-        config.autoStart = obj["autoStart"].toBool(false);
-        config.updateInterval = obj["updateInterval"].toInt(1000);
-        config.locked = obj["locked"].toBool(false);
+        WidgetConfig config = ConfigStore::fromJson(obj);
         
-        if (obj.contains("customSettings") && obj["customSettings"].isObject()) {
-            config.customSettings = obj["customSettings"].toObject();
+        if (!validateConfig(config) || hasWidget(config.id)) {
+            LOG_CWARNING(lcConfig, QString("跳过无效或重复的Widget配置: %1").arg(config.id));
+            continue;
         }
         
-        createWidget(config);
+        m_deferredConfigs.insert(config.id, config);
+        loadedEntries.append(obj);
+        if (config.autoStart) {
+            autoStartConfigs.append(config);
+        }
+    }
+    
+    // 第二阶段：自动启动的小组件按优先级排队，位于当前屏幕内的优先；
+    // 其余小组件保持未实例化，直到首次startWidget()
+    std::stable_sort(autoStartConfigs.begin(), autoStartConfigs.end(),
+                     [this](const WidgetConfig& a, const WidgetConfig& b) {
+                         return isOnScreen(a) && !isOnScreen(b);
+                     });
+    for (const auto& config : autoStartConfigs) {
+        m_loadQueue.append(config.id);
+    }
+    
+    // 加载到的条目作为存储的初始缓存，之后只有变化的小组件会被重新序列化；
+    // 从其他路径导入时缓存与主配置文件不一致，需要整体写回
+    m_store->resetEntries(loadedEntries);
+    if (QFileInfo(filePath) != QFileInfo(m_store->filePath())) {
+        for (const QJsonObject& obj : std::as_const(loadedEntries)) {
+            markConfigDirty(obj["id"].toString());
+        }
     }
     
-    Logger::info("配置加载成功。");
+    m_loadedCount = 0;
+    m_loadClock.start();
+    
+    LOG_CINFO(lcConfig, QString("配置加载成功: %1 个Widget, 其中 %2 个将分批实例化")
+                 .arg(m_deferredConfigs.size())
+                 .arg(m_loadQueue.size()));
     emit configurationChanged();
+    
+    if (m_loadQueue.isEmpty()) {
+        emit loadingFinished(0, 0);
+    } else {
+        m_loadTimer->start();
+    }
     return true;
 }
 
+/**
+ * @brief 分批实例化的单步：创建并启动队首的小组件
+ * 
+ * 每步结束后回到事件循环，后续小组件在下一轮事件循环中继续创建。
+ */
+void WidgetManager::onLoadStep() {
+    if (m_loadQueue.isEmpty()) {
+        return;
+    }
+    
+    const QString widgetId = m_loadQueue.takeFirst();
+    WidgetPtr widget = ensureWidget(widgetId);
+    if (widget) {
+        widget->start();
+        m_loadedCount++;
+    }
+    
+    if (!m_loadQueue.isEmpty()) {
+        m_loadTimer->start();
+        return;
+    }
+    
+    LOG_CINFO(lcWidget, QString("Widget分批实例化完成: %1 个, 耗时 %2ms, %3 个延迟到首次启动")
+                 .arg(m_loadedCount)
+                 .arg(m_loadClock.elapsed())
+                 .arg(m_deferredConfigs.size()));
+    emit loadingFinished(m_loadedCount, m_loadClock.elapsed());
+}
+
+bool WidgetManager::isOnScreen(const WidgetConfig& config) const {
+    const QRect widgetRect(config.position, config.size);
+    const QList<QScreen*> screens = QGuiApplication::screens();
+    for (QScreen* screen : screens) {
+        if (screen->availableGeometry().intersects(widgetRect)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 QList<WidgetConfig> WidgetManager::getTemplates() const {
     return m_templates.values();
 }
 
 bool WidgetManager::saveAsTemplate(const QString& widgetId, const QString& templateName) {
-    WidgetPtr widget = getWidget(widgetId);
-    if (!widget) return false;
-    m_templates[templateName] = widget->getConfig();
+    if (!hasWidget(widgetId)) return false;
+    m_templates[templateName] = getWidgetConfig(widgetId);
     // Here you would also save templates to a file
     return true;
 }
@@ -413,8 +671,8 @@ bool WidgetManager::createFromTemplate(const QString& templateName, const QStrin
 
 QMap<WidgetType, int> WidgetManager::getWidgetStatistics() const {
     QMap<WidgetType, int> stats;
-    for(const auto& widget : m_widgets) {
-        stats[widget->getConfig().type]++;
+    for(const auto& config : getAllConfigs()) {
+        stats[config.type]++;
     }
     return stats;
 }
@@ -436,14 +694,13 @@ void WidgetManager::onWidgetCloseRequested(const QString& widgetId) {
 void WidgetManager::onWidgetSettingsRequested(const QString& widgetId) {
     // This could open a generic settings dialog, or a specific one
     // For now, let's just log it.
-    Logger::info(QString("Settings requested for widget: %1").arg(widgetId));
+    LOG_CINFO(lcWidget, QString("Settings requested for widget: %1").arg(widgetId));
 }
 
 void WidgetManager::onWidgetConfigChanged(const WidgetConfig& config) {
-    if (m_autoSave) {
-        m_saveTimer->start();
-    }
+    markConfigDirty(config.id);
     emit widgetConfigUpdated(config.id, config);
+    recordUpdated(config.id);
 }
 
 void WidgetManager::onWidgetStatusChanged(WidgetStatus status) {
@@ -457,38 +714,22 @@ void WidgetManager::onWidgetStatusChanged(WidgetStatus status) {
 void WidgetManager::onWidgetPositionChanged(const QString& widgetId, const QPoint& newPosition) {
     WidgetPtr widget = getWidget(widgetId);
     if (widget) {
-        WidgetConfig config = widget->getConfig();
-        config.position = newPosition;
-        widget->setConfig(config);
-        // Do not call updateWidgetConfig to avoid loops if not careful
-        if (m_autoSave) {
-            m_saveTimer->start();
-        }
+        // 拖拽结束时小组件已自行更新了配置中的位置，这里不再调用setConfig，
+        // 避免重新应用全部配置（包括重建原生窗口）
+        const DragStats& stats = widget->getLastDragStats();
+        LOG_CEVENT(Logger::Debug, lcWidget, widgetId,
+                   "Widget拖拽完成, 事件数 %1, 移动帧数 %2, 耗时 %3ms, 平均延迟 %4ms, 最大延迟 %5ms",
+                   stats.mouseEventCount, stats.frameCount, stats.durationMs,
+                   stats.avgLatencyMs, stats.maxLatencyMs);
+        
+        // 和updateWidgetConfig一样记入变更集，管理面板据此刷新坐标
+        markConfigDirty(widgetId);
+        emit widgetConfigUpdated(widgetId, widget->getConfig());
+        recordUpdated(widgetId);
         emit widgetPositionManuallyChanged(widgetId, newPosition);
     }
 }
 
-WidgetPtr WidgetManager::createWidgetByType(WidgetType type, const WidgetConfig& config) {
-    switch (type) {
-        case WidgetType::Clock:
-            return std::make_shared<ClockWidget>(config);
-        case WidgetType::Weather:
-            return std::make_shared<WeatherWidget>(config);
-        case WidgetType::AIRanking:
-            return std::make_shared<AIRankingWidget>(config);
-        case WidgetType::SystemPerformance:
-            return std::make_shared<SystemPerformanceWidget>(config);
-        case WidgetType::SimpleNotes:
-            return std::make_shared<SimpleNotesWidget>(config);
-        case WidgetType::Calendar:
-            return std::make_shared<CalendarWidget>(config);
-        case WidgetType::SystemInfo:
-            return std::make_shared<SystemInfoWidget>(config);
-        default:
-            return nullptr;
-    }
-}
-
 QString WidgetManager::getConfigFilePath() const {
     return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/widget_config.json";
 }
@@ -0,0 +1,277 @@
+/**
+ * @file WidgetTypeRegistry.cpp
+ * @brief 小组件类型注册表实现
+ * @details 内置类型的登记和外部插件的按需加载
+ * @version 1.0.0
+ *
+ * 注册表的工作方式：
+ * - 每种小组件类型由一个IWidgetPlugin提供工厂、默认配置和配置对话框
+ * - 注册表属于uwidget-framework共享库，内置类型随程序一起编译，
+ *   由程序在启动时通过registerBuiltin()注册（见Widgets/BuiltinWidgets.cpp）
+ * - 依赖Qt Network的天气和AI排行榜作为随程序发布的插件库构建，
+ *   只使用时钟、便签等类型时不会加载它们和Qt Network
+ * - 外部插件扫描目录时只读取库中嵌入的元数据，不加载库
+ * - 只有配置中实际用到的类型，在首次实例化时才加载对应的库
+ */
+
+#include "Framework/WidgetTypeRegistry.h"
+#include "Utils/Logger.h"
+#include "Utils/LogCategories.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QLibrary>
+#include <QPluginLoader>
+#include <QPointer>
+
+WidgetTypeRegistry& WidgetTypeRegistry::instance() {
+    static QPointer<WidgetTypeRegistry> s_instance;
+    if (!s_instance) {
+        s_instance = new WidgetTypeRegistry(QCoreApplication::instance());
+    }
+    return *s_instance;
+}
+
+WidgetTypeRegistry::WidgetTypeRegistry(QObject* parent)
+    : QObject(parent)
+{
+}
+
+/**
+ * @brief 析构函数
+ *
+ * 已加载的插件库不会卸载：由插件创建的小组件可能仍然存活，
+ * 卸载库会让它们的虚函数表失效。
+ */
+WidgetTypeRegistry::~WidgetTypeRegistry() {
+    qDeleteAll(m_entries);
+}
+
+void WidgetTypeRegistry::registerBuiltin(IWidgetPlugin* plugin) {
+    if (!plugin) {
+        return;
+    }
+
+    const QString typeKey = plugin->typeKey();
+    if (typeKey.isEmpty() || m_entriesByKey.contains(typeKey)) {
+        LOG_CWARNING(lcWidget, QString("忽略重复或无效的小组件类型: %1").arg(typeKey));
+        delete plugin;
+        return;
+    }
+
+    Entry* entry = new Entry;
+    entry->info.typeKey = typeKey;
+    entry->info.displayName = plugin->displayName();
+    entry->info.type = plugin->widgetType();
+    entry->info.builtin = true;
+    entry->info.loaded = true;
+    entry->builtin.reset(plugin);
+    entry->plugin = plugin;
+
+    m_entries.append(entry);
+    m_entriesByKey.insert(typeKey, entry);
+    if (entry->info.type != WidgetType::Custom) {
+        m_builtinKeys.insert(static_cast<int>(entry->info.type), typeKey);
+    }
+}
+
+/**
+ * @brief 扫描目录中的小组件插件
+ * @param dirPath 插件目录
+ * @return 新登记的类型数量
+ *
+ * QPluginLoader::metaData()直接从库文件中读取嵌入的JSON，不会加载库。
+ * 随程序发布的插件在元数据中声明"widgetType"（WidgetType的整数值），
+ * 已有配置中按枚举值保存的该类型小组件由它提供。
+ */
+int WidgetTypeRegistry::scanPluginDirectory(const QString& dirPath) {
+    QDir dir(dirPath);
+    if (!dir.exists()) {
+        return 0;
+    }
+
+    int registered = 0;
+    const QFileInfoList files = dir.entryInfoList(QDir::Files);
+    for (const QFileInfo& fileInfo : files) {
+        const QString filePath = fileInfo.absoluteFilePath();
+        if (!QLibrary::isLibrary(filePath)) {
+            continue;
+        }
+
+        QPluginLoader* loader = new QPluginLoader(filePath, this);
+        const QJsonObject metaData = loader->metaData();
+        if (metaData.value("IID").toString() != QLatin1String(IWidgetPlugin_iid)) {
+            delete loader;
+            continue;
+        }
+
+        const QJsonObject typeData = metaData.value("MetaData").toObject();
+        const QString typeKey = typeData.value("typeKey").toString();
+        if (typeKey.isEmpty() || m_entriesByKey.contains(typeKey)) {
+            LOG_CWARNING(lcWidget, QString("跳过重复或缺少typeKey的小组件插件: %1").arg(filePath));
+            delete loader;
+            continue;
+        }
+
+        Entry* entry = new Entry;
+        entry->info.typeKey = typeKey;
+        entry->info.displayName = typeData.value("displayName").toString(typeKey);
+        entry->info.filePath = filePath;
+        entry->loader = loader;
+
+        const int widgetType = typeData.value("widgetType").toInt(static_cast<int>(WidgetType::Custom));
+        if (widgetType >= 0 && widgetType < static_cast<int>(WidgetType::Custom) &&
+            !m_builtinKeys.contains(widgetType)) {
+            entry->info.type = static_cast<WidgetType>(widgetType);
+            m_builtinKeys.insert(widgetType, typeKey);
+        }
+
+        m_entries.append(entry);
+        m_entriesByKey.insert(typeKey, entry);
+        registered++;
+    }
+
+    if (registered > 0) {
+        LOG_CINFO(lcWidget, QString("发现 %1 个小组件插件: %2").arg(registered).arg(dirPath));
+    }
+    return registered;
+}
+
+QString WidgetTypeRegistry::defaultPluginDirectory() {
+    return QCoreApplication::applicationDirPath() + "/plugins/widgets";
+}
+
+QList<WidgetTypeInfo> WidgetTypeRegistry::availableTypes() const {
+    QList<WidgetTypeInfo> types;
+    types.reserve(m_entries.size());
+    for (const Entry* entry : m_entries) {
+        types.append(entry->info);
+    }
+    return types;
+}
+
+bool WidgetTypeRegistry::hasType(const QString& typeKey) const {
+    return m_entriesByKey.contains(typeKey);
+}
+
+/**
+ * @brief 取得配置对应的类型标识
+ *
+ * 内置类型由枚举值决定，外部插件类型记录在配置的pluginKey中。
+ */
+QString WidgetTypeRegistry::typeKeyOf(const WidgetConfig& config) const {
+    if (config.type == WidgetType::Custom) {
+        return config.pluginKey;
+    }
+    return builtinTypeKey(config.type);
+}
+
+QString WidgetTypeRegistry::builtinTypeKey(WidgetType type) const {
+    return m_builtinKeys.value(static_cast<int>(type));
+}
+
+QString WidgetTypeRegistry::displayName(const WidgetConfig& config) const {
+    const Entry* entry = m_entriesByKey.value(typeKeyOf(config), nullptr);
+    return entry ? entry->info.displayName : QStringLiteral("自定义");
+}
+
+void WidgetTypeRegistry::setConfigType(WidgetConfig& config, const QString& typeKey) const {
+    const Entry* entry = m_entriesByKey.value(typeKey, nullptr);
+    config.type = entry ? entry->info.type : WidgetType::Custom;
+    config.pluginKey = config.type == WidgetType::Custom ? typeKey : QString();
+}
+
+int WidgetTypeRegistry::loadedPluginCount() const {
+    int count = 0;
+    for (const Entry* entry : m_entries) {
+        if (!entry->info.builtin && entry->info.loaded) {
+            count++;
+        }
+    }
+    return count;
+}
+
+IWidgetPlugin* WidgetTypeRegistry::plugin(const QString& typeKey) {
+    Entry* entry = m_entriesByKey.value(typeKey, nullptr);
+    if (!entry) {
+        return nullptr;
+    }
+    if (!entry->plugin && !loadPlugin(*entry)) {
+        return nullptr;
+    }
+    return entry->plugin;
+}
+
+IWidgetPlugin* WidgetTypeRegistry::pluginFor(const WidgetConfig& config) {
+    return plugin(typeKeyOf(config));
+}
+
+/**
+ * @brief 加载外部插件库并取得插件接口
+ */
+bool WidgetTypeRegistry::loadPlugin(Entry& entry) {
+    if (!entry.loader) {
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QObject* root = entry.loader->instance();
+    IWidgetPlugin* plugin = qobject_cast<IWidgetPlugin*>(root);
+    if (!plugin) {
+        LOG_CERROR(lcWidget, QString("无法加载小组件插件 %1: %2")
+                      .arg(entry.info.filePath, entry.loader->errorString()));
+        // 避免每次实例化都重试加载失败的库
+        entry.loader->deleteLater();
+        entry.loader = nullptr;
+        return false;
+    }
+
+    if (plugin->typeKey() != entry.info.typeKey) {
+        LOG_CWARNING(lcWidget, QString("小组件插件的typeKey与元数据不一致: %1 / %2")
+                        .arg(plugin->typeKey(), entry.info.typeKey));
+    }
+
+    entry.plugin = plugin;
+    entry.info.loaded = true;
+    LOG_CINFO(lcWidget, QString("小组件插件已加载: %1, 耗时 %2ms").arg(entry.info.typeKey).arg(timer.elapsed()));
+    return true;
+}
+
+WidgetPtr WidgetTypeRegistry::createWidget(const WidgetConfig& config) {
+    IWidgetPlugin* widgetPlugin = pluginFor(config);
+    if (!widgetPlugin) {
+        LOG_CERROR(lcWidget, QString("未知的小组件类型: %1").arg(typeKeyOf(config)));
+        return nullptr;
+    }
+    return widgetPlugin->createWidget(config);
+}
+
+WidgetConfig WidgetTypeRegistry::defaultConfig(const QString& typeKey) {
+    IWidgetPlugin* widgetPlugin = plugin(typeKey);
+    if (!widgetPlugin) {
+        return WidgetConfig();
+    }
+
+    WidgetConfig config = widgetPlugin->defaultConfig();
+    if (config.type == WidgetType::Custom) {
+        config.pluginKey = typeKey;
+    }
+    return config;
+}
+
+bool WidgetTypeRegistry::editConfig(WidgetConfig& config, QWidget* parent) {
+    IWidgetPlugin* widgetPlugin = pluginFor(config);
+    if (widgetPlugin) {
+        return widgetPlugin->editConfig(config, parent);
+    }
+
+    // 插件不可用时退回通用配置窗口
+    ConfigWindow dialog(config, parent);
+    if (dialog.exec() != QDialog::Accepted) {
+        return false;
+    }
+    config = dialog.getUpdatedConfig();
+    return true;
+}
@@ -0,0 +1,275 @@
+#include "Utils/DiskIoSampler.h"
+#include <algorithm>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <winioctl.h>
+#include <string>
+#endif
+
+#ifdef Q_OS_LINUX
+#include <cstring>
+#include <dirent.h>
+#endif
+
+namespace {
+#ifdef Q_OS_WIN
+    constexpr int kMaxPhysicalDrives = 32;
+    constexpr quint64 kRescanInterval = 60;     // 每隔多少次采样查找新接入的磁盘
+#endif
+#ifdef Q_OS_LINUX
+    constexpr quint64 kSectorBytes = 512;       // diskstats的扇区数固定以512字节计
+#endif
+}
+
+DiskIoSampler::DiskIoSampler()
+    : m_elapsedMs(0)
+    , m_generation(0)
+    , m_readKBps(0.0)
+    , m_writeKBps(0.0)
+    , m_busiestPercent(0.0)
+#ifdef Q_OS_LINUX
+    , m_diskstatsFile("/proc/diskstats")
+#endif
+{
+}
+
+DiskIoSampler::~DiskIoSampler() {
+    for (Entry& entry : m_entries) {
+        releaseEntry(entry);
+    }
+}
+
+bool DiskIoSampler::sample() {
+    // 读取失败时不重新计时，下一次成功读取的间隔从上一次成功读取算起，速率不会被放大
+    m_elapsedMs = m_clock.isValid() ? m_clock.elapsed() : 0;
+    m_generation++;
+    if (!readCounters()) {
+        return false;
+    }
+    m_clock.start();
+
+    double readKBps = 0.0;
+    double writeKBps = 0.0;
+    double busiest = 0.0;
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (it->generation != m_generation) {
+            releaseEntry(*it);
+            it = m_entries.erase(it);   // 磁盘已移除
+            continue;
+        }
+        if (it->included) {
+            readKBps += it->stats.readKBps;
+            writeKBps += it->stats.writeKBps;
+            busiest = qMax(busiest, it->stats.busyPercent);
+        }
+        ++it;
+    }
+    m_readKBps = readKBps;
+    m_writeKBps = writeKBps;
+    m_busiestPercent = busiest;
+    return true;
+}
+
+/**
+ * 计数器变小说明设备被重新挂接或驱动重置了统计，这一次只建立新的基准
+ */
+void DiskIoSampler::updateDevice(Entry& entry, const Counters& counters) {
+    const Counters& last = entry.last;
+    const bool monotonic = counters.readOps >= last.readOps && counters.writeOps >= last.writeOps &&
+                           counters.readBytes >= last.readBytes && counters.writeBytes >= last.writeBytes &&
+                           counters.ioTimeUs >= last.ioTimeUs && counters.busyUs >= last.busyUs;
+
+    DiskDeviceStats& stats = entry.stats;
+    if (entry.hasBaseline && monotonic && m_elapsedMs > 0) {
+        const double seconds = m_elapsedMs / 1000.0;
+        const quint64 readOps = counters.readOps - last.readOps;
+        const quint64 writeOps = counters.writeOps - last.writeOps;
+        stats.readKBps = (counters.readBytes - last.readBytes) / 1024.0 / seconds;
+        stats.writeKBps = (counters.writeBytes - last.writeBytes) / 1024.0 / seconds;
+        stats.readIops = readOps / seconds;
+        stats.writeIops = writeOps / seconds;
+        stats.avgServiceMs = readOps + writeOps > 0
+            ? (counters.ioTimeUs - last.ioTimeUs) / 1000.0 / (readOps + writeOps) : 0.0;
+        stats.busyPercent = qMin(100.0, (counters.busyUs - last.busyUs) / 10.0 / m_elapsedMs);
+    } else {
+        stats.readKBps = stats.writeKBps = 0.0;
+        stats.readIops = stats.writeIops = 0.0;
+        stats.avgServiceMs = 0.0;
+        stats.busyPercent = 0.0;
+    }
+    entry.last = counters;
+    entry.hasBaseline = true;
+    entry.generation = m_generation;
+}
+
+/**
+ * 磁盘只有几块，partial_sort即可；吞吐相同（通常都为0）时按名称排序，避免列表顺序跳动
+ */
+void DiskIoSampler::topDevices(int count, QVector<DiskDeviceStats>& out) {
+    m_ranking.clear();
+    for (const Entry& entry : m_entries) {
+        if (entry.included) {
+            m_ranking.emplace_back(entry.stats.readKBps + entry.stats.writeKBps, &entry);
+        }
+    }
+
+    const size_t n = std::min<size_t>(m_ranking.size(), static_cast<size_t>(qBound(0, count, kMaxTopCount)));
+    std::partial_sort(m_ranking.begin(), m_ranking.begin() + n, m_ranking.end(),
+                      [](const std::pair<double, const Entry*>& a, const std::pair<double, const Entry*>& b) {
+                          return a.first != b.first ? a.first > b.first : a.second->stats.name < b.second->stats.name;
+                      });
+
+    out.resize(static_cast<qsizetype>(n));
+    for (size_t i = 0; i < n; ++i) {
+        out[static_cast<qsizetype>(i)] = m_ranking[i].second->stats;
+    }
+}
+
+#ifdef Q_OS_WIN
+/**
+ * 句柄在磁盘第一次出现时打开并保留；IOCTL_DISK_PERFORMANCE不需要读写权限，普通用户即可查询。
+ * 时间单位为100ns；QueryTime - IdleTime的差值即本周期内的繁忙时间
+ */
+bool DiskIoSampler::readCounters() {
+    if (m_generation % kRescanInterval == 1) {
+        for (int drive = 0; drive < kMaxPhysicalDrives; ++drive) {
+            const QByteArray key = QByteArray::number(drive);
+            if (m_entries.contains(key)) {
+                continue;
+            }
+            const std::wstring path = L"\\\\.\\PhysicalDrive" + std::to_wstring(drive);
+            HANDLE handle = CreateFileW(path.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                                        OPEN_EXISTING, 0, nullptr);
+            if (handle == INVALID_HANDLE_VALUE) {
+                continue;
+            }
+            Entry entry;
+            entry.stats.name = QString("磁盘 %1").arg(drive);
+            entry.handle = handle;
+            m_entries.insert(key, entry);
+        }
+    }
+
+    for (Entry& entry : m_entries) {
+        DISK_PERFORMANCE performance;
+        DWORD bytesReturned = 0;
+        if (!DeviceIoControl(static_cast<HANDLE>(entry.handle), IOCTL_DISK_PERFORMANCE, nullptr, 0,
+                             &performance, sizeof(performance), &bytesReturned, nullptr)) {
+            continue;   // 磁盘已移除：不更新轮次，由sample()清理
+        }
+        Counters counters;
+        counters.readOps = performance.ReadCount;
+        counters.writeOps = performance.WriteCount;
+        counters.readBytes = static_cast<quint64>(performance.BytesRead.QuadPart);
+        counters.writeBytes = static_cast<quint64>(performance.BytesWritten.QuadPart);
+        counters.ioTimeUs = static_cast<quint64>(performance.ReadTime.QuadPart + performance.WriteTime.QuadPart) / 10;
+        counters.busyUs = static_cast<quint64>(performance.QueryTime.QuadPart - performance.IdleTime.QuadPart) / 10;
+        updateDevice(entry, counters);
+    }
+    return !m_entries.isEmpty();
+}
+
+void DiskIoSampler::releaseEntry(Entry& entry) {
+    if (entry.handle) {
+        CloseHandle(static_cast<HANDLE>(entry.handle));
+    }
+    entry.handle = nullptr;
+}
+#elif defined(Q_OS_LINUX)
+namespace {
+    /**
+     * 整块磁盘在/sys/block下有对应目录（名称中的'/'替换为'!'），分区没有；
+     * slaves目录非空的设备（dm、md）叠加在其他磁盘之上，其I/O已计入底层磁盘
+     */
+    bool isPhysicalDisk(const char* name, qsizetype length) {
+        for (const char* prefix : {"loop", "ram", "zram"}) {
+            const size_t prefixLength = std::strlen(prefix);
+            if (static_cast<size_t>(length) >= prefixLength && std::strncmp(name, prefix, prefixLength) == 0) {
+                return false;
+            }
+        }
+
+        char path[160] = "/sys/block/";
+        size_t offset = std::strlen(path);
+        for (qsizetype i = 0; i < length && offset < 100; ++i) {
+            path[offset++] = name[i] == '/' ? '!' : name[i];
+        }
+        std::strcpy(path + offset, "/slaves");
+
+        DIR* slaves = ::opendir(path);
+        if (!slaves) {
+            return false;
+        }
+        bool stacked = false;
+        while (const dirent* item = ::readdir(slaves)) {
+            if (item->d_name[0] != '.') {
+                stacked = true;
+                break;
+            }
+        }
+        ::closedir(slaves);
+        return !stacked;
+    }
+}
+
+/**
+ * /proc/diskstats每行：主设备号 次设备号 设备名，之后依次为
+ * 读完成数 读合并数 读扇区数 读耗时(ms) 写完成数 写合并数 写扇区数 写耗时(ms) 进行中的请求 I/O时间(ms) ...
+ * 设备名只在第一次出现时复制并判断类型
+ */
+bool DiskIoSampler::readCounters() {
+    if (!m_diskstatsFile.readAll(m_readBuffer)) {
+        return false;
+    }
+
+    ProcFs::Scanner scanner(m_readBuffer.data());
+    for (bool more = !scanner.atEnd(); more; more = scanner.nextLine()) {
+        const char* nameBegin;
+        const char* nameEnd;
+        scanner.skipFields(2);
+        if (!scanner.readToken(nameBegin, nameEnd)) {
+            continue;
+        }
+        const qsizetype nameLength = nameEnd - nameBegin;
+
+        auto it = m_entries.find(QByteArray::fromRawData(nameBegin, nameLength));
+        if (it == m_entries.end()) {
+            Entry entry;
+            entry.stats.name = QString::fromLatin1(nameBegin, nameLength);
+            entry.included = isPhysicalDisk(nameBegin, nameLength);
+            it = m_entries.insert(QByteArray(nameBegin, nameLength), entry);
+        }
+        if (!it->included) {
+            it->generation = m_generation;
+            continue;
+        }
+
+        quint64 fields[10];
+        for (quint64& field : fields) {
+            field = scanner.readUInt();
+        }
+        Counters counters;
+        counters.readOps = fields[0];
+        counters.readBytes = fields[2] * kSectorBytes;
+        counters.writeOps = fields[4];
+        counters.writeBytes = fields[6] * kSectorBytes;
+        counters.ioTimeUs = (fields[3] + fields[7]) * 1000;
+        counters.busyUs = fields[9] * 1000;
+        updateDevice(*it, counters);
+    }
+    return true;
+}
+
+void DiskIoSampler::releaseEntry(Entry& entry) {
+    Q_UNUSED(entry);
+}
+#else
+bool DiskIoSampler::readCounters() {
+    return false;
+}
+
+void DiskIoSampler::releaseEntry(Entry& entry) {
+    Q_UNUSED(entry);
+}
+#endif
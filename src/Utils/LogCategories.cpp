@@ -0,0 +1,8 @@
+#include "Utils/LogCategories.h"
+
+// 调试输出默认关闭，采样和渲染路径上的调试语句只剩一次分类检查
+Q_LOGGING_CATEGORY(lcMonitor, "uwidget.monitor", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcNetwork, "uwidget.network", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcRender, "uwidget.render", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcConfig, "uwidget.config", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcWidget, "uwidget.widget", QtInfoMsg)
@@ -0,0 +1,872 @@
+#include "Utils/LogWriter.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QMutex>
+#include <QThreadPool>
+#include <cstdio>
+#include <limits>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr int kDefaultFlushIntervalMs = 1000;   // 常规记录的最长刷盘延迟
+    constexpr int kMaxBatchRecords = 512;           // 每批最多取出的记录数
+    constexpr int kIdleWaitMs = 10000;              // 空闲时的兜底唤醒间隔
+    constexpr int kBlockSpinLimit = 64;             // Block策略下让出CPU后改为短暂休眠的次数
+    const char* const kCompressedSuffix = ".qz";    // qCompress格式：4字节长度头+zlib数据
+    const char* const kBinarySuffix = "ulog";       // 二进制格式日志文件的扩展名
+    constexpr qint64 kDayMs = 24 * 3600 * 1000LL;
+
+    // 标准输出是否连接到终端、管道或文件；Windows图形界面程序没有标准输出
+    bool hasConsole() {
+#ifdef Q_OS_WIN
+        return _fileno(stdout) >= 0 && _get_osfhandle(_fileno(stdout)) >= 0;
+#else
+        return ::fcntl(STDOUT_FILENO, F_GETFL) != -1;
+#endif
+    }
+
+    // 历史日志文件的匹配模式：<基础名>.<时间戳>.<扩展名>[.qz]
+    QStringList segmentPatterns(const QFileInfo& logFile) {
+        const QString pattern = logFile.completeBaseName() + ".*." + logFile.suffix();
+        return QStringList() << pattern << pattern + kCompressedSuffix;
+    }
+
+    // 消息模板中p处的占位符%1~%99，规则与BinaryLog::placeholderAt()相同
+    int placeholderAt(const char* p, int& number) {
+        if (p[0] != '%' || p[1] < '0' || p[1] > '9') {
+            return 0;
+        }
+        number = p[1] - '0';
+        int length = 2;
+        if (p[2] >= '0' && p[2] <= '9') {
+            number = number * 10 + (p[2] - '0');
+            length = 3;
+        }
+        return number > 0 ? length : 0;
+    }
+
+    // CrashLine - 崩溃处理函数中格式化一行日志的定长缓冲：
+    // 只做逐字节拷贝和整数运算，不分配内存、不加锁、不调用C库的格式化函数，超长部分截断
+    class CrashLine {
+    public:
+        const char* data() const { return m_data; }
+        size_t length() const { return m_length; }
+
+        void append(char c) {
+            if (m_length < sizeof(m_data)) {
+                m_data[m_length++] = c;
+            }
+        }
+
+        void append(const char* text) {
+            for (; *text; ++text) {
+                append(*text);
+            }
+        }
+
+        // QString的UTF-16内容按UTF-8追加
+        void append(const QString& text) {
+            const QChar* chars = text.constData();
+            const qsizetype size = text.size();
+            for (qsizetype i = 0; i < size; ++i) {
+                char32_t code = chars[i].unicode();
+                if (QChar::isHighSurrogate(code) && i + 1 < size && chars[i + 1].isLowSurrogate()) {
+                    code = QChar::surrogateToUcs4(chars[i].unicode(), chars[i + 1].unicode());
+                    ++i;
+                }
+                if (code < 0x80) {
+                    append(static_cast<char>(code));
+                } else if (code < 0x800) {
+                    append(static_cast<char>(0xC0 | (code >> 6)));
+                    append(static_cast<char>(0x80 | (code & 0x3F)));
+                } else if (code < 0x10000) {
+                    append(static_cast<char>(0xE0 | (code >> 12)));
+                    append(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+                    append(static_cast<char>(0x80 | (code & 0x3F)));
+                } else {
+                    append(static_cast<char>(0xF0 | (code >> 18)));
+                    append(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+                    append(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+                    append(static_cast<char>(0x80 | (code & 0x3F)));
+                }
+            }
+        }
+
+        void appendNumber(qint64 value, int minDigits = 1) {
+            char digits[24];
+            int count = 0;
+            quint64 magnitude = value < 0 ? 0 - static_cast<quint64>(value) : static_cast<quint64>(value);
+            do {
+                digits[count++] = static_cast<char>('0' + magnitude % 10);
+                magnitude /= 10;
+            } while (magnitude > 0);
+            while (count < minDigits && count < int(sizeof(digits))) {
+                digits[count++] = '0';
+            }
+            if (value < 0) {
+                append('-');
+            }
+            while (count > 0) {
+                append(digits[--count]);
+            }
+        }
+
+        // 两位小数，与BinaryLog::Arg::toString()一致；极大的值改用指数形式
+        void appendFixed(double value) {
+            if (value != value) {
+                append("nan");
+                return;
+            }
+            if (value < 0) {
+                append('-');
+                value = -value;
+            }
+            if (value > std::numeric_limits<double>::max()) {
+                append("inf");
+                return;
+            }
+            int exponent = 0;
+            if (value >= 1e15) {
+                while (value >= 10) {
+                    value /= 10;
+                    exponent++;
+                }
+            }
+            const qint64 cents = static_cast<qint64>(value * 100 + 0.5);
+            appendNumber(cents / 100);
+            append('.');
+            appendNumber(cents % 100, 2);
+            if (exponent > 0) {
+                append("e+");
+                appendNumber(exponent);
+            }
+        }
+
+        void appendArg(const BinaryLog::Arg& arg) {
+            switch (arg.type) {
+                case BinaryLog::IntArg: appendNumber(arg.i); break;
+                case BinaryLog::DoubleArg: appendFixed(arg.d); break;
+                case BinaryLog::StringArg: append(arg.s); break;
+            }
+        }
+
+        // 编号规则与BinaryLog::formatMessage()相同：编号最小的占位符对应第一个参数
+        void appendTemplate(const char* messageTemplate, const QVector<BinaryLog::Arg>& args) {
+            bool used[100] = {};
+            int number = 0;
+            for (const char* p = messageTemplate; *p; ++p) {
+                if (const int length = placeholderAt(p, number)) {
+                    used[number] = true;
+                    p += length - 1;
+                }
+            }
+            int argIndex[100];
+            int next = 0;
+            for (int i = 0; i < 100; ++i) {
+                argIndex[i] = used[i] && next < args.size() ? next++ : -1;
+            }
+
+            const BinaryLog::Arg* values = args.constData();
+            for (const char* p = messageTemplate; *p; ++p) {
+                const int length = placeholderAt(p, number);
+                if (length > 0 && argIndex[number] >= 0) {
+                    appendArg(values[argIndex[number]]);
+                    p += length - 1;
+                } else {
+                    append(*p);
+                }
+            }
+        }
+
+        // yyyy-MM-dd hh:mm:ss.zzz，公历日期由天数直接换算，不调用localtime
+        void appendTimestamp(qint64 msecs) {
+            qint64 days = msecs / kDayMs;
+            qint64 msOfDay = msecs % kDayMs;
+            if (msOfDay < 0) {
+                msOfDay += kDayMs;
+                days--;
+            }
+            days += 719468;     // 以0000-03-01为起点，闰日落在每年末尾
+            const qint64 era = (days >= 0 ? days : days - 146096) / 146097;
+            const qint64 dayOfEra = days - era * 146097;
+            const qint64 yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+            const qint64 dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+            const qint64 monthIndex = (5 * dayOfYear + 2) / 153;
+            const qint64 day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+            const qint64 month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+            const qint64 year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
+
+            appendNumber(year, 4);
+            append('-');
+            appendNumber(month, 2);
+            append('-');
+            appendNumber(day, 2);
+            append(' ');
+            appendNumber(msOfDay / 3600000, 2);
+            append(':');
+            appendNumber(msOfDay / 60000 % 60, 2);
+            append(':');
+            appendNumber(msOfDay / 1000 % 60, 2);
+            append('.');
+            appendNumber(msOfDay % 1000, 3);
+        }
+
+        // 与LogWriter::appendRecord()的文本行格式相同
+        void appendRecord(const LogRecord& record, qint64 utcOffsetMs) {
+            append('[');
+            appendTimestamp(record.timestampMs + utcOffsetMs);
+            append("] [");
+            append(BinaryLog::levelName(record.level));
+            append("] ");
+            if (record.category) {
+                append('[');
+                append(record.category);
+                append("] ");
+            }
+            if (!record.widgetId.isEmpty()) {
+                append('[');
+                append(record.widgetId);
+                append("] ");
+            }
+            if (record.messageTemplate) {
+                appendTemplate(record.messageTemplate, record.args);
+            } else {
+                append(record.message);
+            }
+            if (m_length == sizeof(m_data)) {
+                m_length--;     // 截断时保留换行
+            }
+            append('\n');
+        }
+
+    private:
+        char m_data[1024];
+        size_t m_length = 0;
+    };
+}
+
+LogWriter::LogWriter(size_t capacity)
+    : m_ring(capacity)
+    , m_sleeping(false)
+    , m_stopping(false)
+    , m_accepting(true)
+    , m_flushRequested(false)
+    , m_consoleOutput(hasConsole())
+    , m_crashText(nullptr)
+    , m_crashTextLength(0)
+    , m_utcOffsetMs(QDateTime::currentDateTime().offsetFromUtc() * 1000LL)
+    , m_unflushed(false)
+    , m_reportedDropped(0)
+    , m_fileBytes(0)
+    , m_segmentStartMs(0)
+    , m_format(Logger::TextFormat)
+    , m_lastStringId(0)
+    , m_filePathChanged(false)
+    , m_flushIntervalMs(kDefaultFlushIntervalMs)
+    , m_rotationChanged(false)
+    , m_pendingFormat(Logger::TextFormat)
+    , m_formatChanged(false)
+    , m_enqueued(0)
+    , m_processed(0)
+    , m_flushedUpTo(0)
+    , m_dropped(0)
+    , m_blocked(0)
+    , m_flushes(0)
+    , m_maxDepth(0)
+    , m_rotations(0)
+{
+    setObjectName("LogWriter");
+}
+
+LogWriter::~LogWriter() {
+    stop();
+}
+
+bool LogWriter::enqueue(LogRecord&& record, Logger::OverflowPolicy policy) {
+    if (!m_accepting.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    if (!m_ring.tryPush(std::move(record))) {
+        if (policy == Logger::DropNewest) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        // Block：唤醒写入线程并等待其腾出空间
+        m_blocked.fetch_add(1, std::memory_order_relaxed);
+        int attempts = 0;
+        do {
+            wakeWriter();
+            if (!m_accepting.load(std::memory_order_acquire)) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            if (++attempts < kBlockSpinLimit) {
+                QThread::yieldCurrentThread();
+            } else {
+                QThread::usleep(100);
+            }
+        } while (!m_ring.tryPush(std::move(record)));
+    }
+
+    m_enqueued.fetch_add(1, std::memory_order_release);
+    wakeWriter();
+    return true;
+}
+
+/**
+ * 只有写入线程处于休眠时才需要加锁唤醒，正常情况下生产者不接触任何锁
+ */
+void LogWriter::wakeWriter() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleeping.load()) {
+        QMutexLocker locker(&m_mutex);
+        m_wakeCondition.wakeOne();
+    }
+}
+
+void LogWriter::setFilePath(const QString& filePath) {
+    QMutexLocker locker(&m_mutex);
+    m_pendingFilePath = filePath;
+    m_filePathChanged = true;
+    if (m_sleeping.load()) {
+        m_wakeCondition.wakeOne();
+    }
+}
+
+void LogWriter::setFlushInterval(int intervalMs) {
+    QMutexLocker locker(&m_mutex);
+    m_flushIntervalMs = qMax(1, intervalMs);
+}
+
+void LogWriter::setRotationPolicy(const LogRotationPolicy& policy) {
+    QMutexLocker locker(&m_mutex);
+    m_pendingRotation = policy;
+    m_rotationChanged = true;
+}
+
+void LogWriter::setFileFormat(Logger::FileFormat format) {
+    QMutexLocker locker(&m_mutex);
+    m_pendingFormat = format;
+    m_formatChanged = true;
+    if (m_sleeping.load()) {
+        m_wakeCondition.wakeOne();
+    }
+}
+
+void LogWriter::setConsoleOutput(bool enabled) {
+    m_consoleOutput.store(enabled, std::memory_order_relaxed);
+}
+
+bool LogWriter::flush(int timeoutMs) {
+    if (!isRunning()) {
+        return true;
+    }
+
+    const quint64 target = m_enqueued.load(std::memory_order_acquire);
+    QElapsedTimer timer;
+    timer.start();
+
+    QMutexLocker locker(&m_mutex);
+    while (m_flushedUpTo.load(std::memory_order_acquire) < target) {
+        m_flushRequested.store(true);
+        m_wakeCondition.wakeOne();
+        const qint64 remaining = timeoutMs - timer.elapsed();
+        if (remaining <= 0 || !isRunning()) {
+            return false;
+        }
+        m_flushedCondition.wait(&m_mutex, static_cast<unsigned long>(remaining));
+    }
+    return true;
+}
+
+/**
+ * 停止接收新记录，写出队列中剩余的记录后结束写入线程
+ */
+void LogWriter::stop() {
+    m_accepting.store(false, std::memory_order_release);
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stopping.store(true);
+        m_wakeCondition.wakeOne();
+    }
+    if (isRunning()) {
+        wait();
+    }
+}
+
+LogStats LogWriter::statistics() const {
+    LogStats stats;
+    stats.enqueuedCount = m_enqueued.load(std::memory_order_relaxed);
+    stats.writtenCount = m_processed.load(std::memory_order_relaxed);
+    stats.droppedCount = m_dropped.load(std::memory_order_relaxed);
+    stats.blockedCount = m_blocked.load(std::memory_order_relaxed);
+    stats.flushCount = m_flushes.load(std::memory_order_relaxed);
+    stats.maxQueueDepth = m_maxDepth.load(std::memory_order_relaxed);
+    stats.rotationCount = m_rotations.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void LogWriter::run() {
+    m_flushClock.start();
+
+    for (;;) {
+        applyPendingSettings();
+        const int written = drain();
+        reportDropped();
+        rotateIfNeeded();
+
+        int flushIntervalMs;
+        {
+            QMutexLocker locker(&m_mutex);
+            flushIntervalMs = m_flushIntervalMs;
+        }
+
+        if (m_unflushed && (m_flushRequested.load() || m_flushClock.elapsed() >= flushIntervalMs)) {
+            flushOutputs();
+        }
+        if (m_flushRequested.exchange(false) || written > 0) {
+            QMutexLocker locker(&m_mutex);
+            m_flushedCondition.wakeAll();
+        }
+
+        if (m_stopping.load() && m_ring.isEmpty()) {
+            break;
+        }
+        if (written > 0) {
+            continue;
+        }
+
+        // 队列为空时休眠：有未刷盘的数据时最多等到下一次刷盘
+        QMutexLocker locker(&m_mutex);
+        m_sleeping.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_ring.isEmpty() && !m_stopping.load() && !m_flushRequested.load() && !m_filePathChanged && !m_rotationChanged &&
+            !m_formatChanged) {
+            const qint64 waitMs = m_unflushed ? qMax<qint64>(1, m_flushIntervalMs - m_flushClock.elapsed())
+                                              : kIdleWaitMs;
+            m_wakeCondition.wait(&m_mutex, static_cast<unsigned long>(waitMs));
+        }
+        m_sleeping.store(false);
+    }
+
+    flushOutputs();
+    m_file.close();
+    QMutexLocker locker(&m_mutex);
+    m_flushedCondition.wakeAll();
+}
+
+/**
+ * 批量取出记录，格式化后一次性写出
+ */
+int LogWriter::drain() {
+    const quint64 depth = m_ring.sizeApprox();
+    if (depth > m_maxDepth.load(std::memory_order_relaxed)) {
+        m_maxDepth.store(depth, std::memory_order_relaxed);
+    }
+
+    int count = 0;
+    bool urgent = false;
+    LogRecord record;
+    while (count < kMaxBatchRecords && m_ring.tryPop(record)) {
+        appendRecord(record);
+        urgent = urgent || record.level >= Logger::Error;
+        count++;
+    }
+
+    if (count > 0) {
+        writeBuffer();
+        m_processed.fetch_add(count, std::memory_order_release);
+        // 错误级别的记录立即刷盘，崩溃前的最后几行不会留在缓冲区
+        if (urgent) {
+            flushOutputs();
+        }
+    }
+    return count;
+}
+
+/**
+ * 文本行只在有文本输出（控制台或文本格式的文件）时才格式化；
+ * 没有控制台的二进制模式只编码参数
+ */
+void LogWriter::appendRecord(const LogRecord& record) {
+    if (m_format == Logger::BinaryFormat && m_file.isOpen()) {
+        appendBinaryRecord(record);
+    }
+    const bool console = m_consoleOutput.load(std::memory_order_relaxed);
+    if (!console && (m_format != Logger::TextFormat || !m_file.isOpen())) {
+        return;
+    }
+
+    QString prefix = record.category ? QString("[%1] ").arg(QLatin1String(record.category)) : QString();
+    if (!record.widgetId.isEmpty()) {
+        prefix += QString("[%1] ").arg(record.widgetId);
+    }
+    const QString message = record.messageTemplate
+        ? BinaryLog::formatMessage(QString::fromUtf8(record.messageTemplate), record.args)
+        : record.message;
+    const QString line = QString("[%1] [%2] %3%4\n")
+                         .arg(QDateTime::fromMSecsSinceEpoch(record.timestampMs).toString("yyyy-MM-dd hh:mm:ss.zzz"))
+                         .arg(Logger::levelToString(static_cast<Logger::LogLevel>(record.level)))
+                         .arg(prefix)
+                         .arg(message);
+    m_crashText.store(nullptr);
+    m_buffer += line.toUtf8();
+    publishBufferForCrash();
+}
+
+/**
+ * 编码为二进制事件记录；分类名、模板和小组件ID首次出现时先写出字符串定义
+ */
+void LogWriter::appendBinaryRecord(const LogRecord& record) {
+    // 先分配字符串ID，定义记录必须位于引用它的事件之前
+    const quint64 categoryId = staticStringId(record.category);
+    const quint64 widgetId = widgetStringId(record.widgetId);
+    const quint64 templateId = staticStringId(record.messageTemplate);
+
+    QByteArray payload;
+    BinaryLog::putVarint(payload, static_cast<quint64>(record.timestampMs));
+    payload.append(static_cast<char>(record.level));
+    BinaryLog::putVarint(payload, categoryId);
+    BinaryLog::putVarint(payload, record.threadId);
+    BinaryLog::putVarint(payload, widgetId);
+    BinaryLog::putVarint(payload, templateId);
+    if (record.messageTemplate) {
+        const int count = qMin(static_cast<int>(record.args.size()), BinaryLog::kMaxArgs);
+        payload.append(static_cast<char>(count));
+        for (int i = 0; i < count; ++i) {
+            BinaryLog::putArg(payload, record.args.at(i));
+        }
+    } else {
+        payload.append(static_cast<char>(1));
+        BinaryLog::putArg(payload, BinaryLog::Arg(record.message));
+    }
+    BinaryLog::putRecord(m_binaryBuffer, BinaryLog::Event, payload);
+}
+
+quint64 LogWriter::staticStringId(const char* text) {
+    if (!text) {
+        return 0;
+    }
+    // 静态字符串按地址查找，热路径上不需要比较或哈希字符串内容
+    const auto it = m_staticStringIds.constFind(text);
+    if (it != m_staticStringIds.constEnd()) {
+        return it.value();
+    }
+    const quint64 id = defineString(QString::fromUtf8(text));
+    m_staticStringIds.insert(text, id);
+    return id;
+}
+
+quint64 LogWriter::widgetStringId(const QString& widgetId) {
+    if (widgetId.isEmpty()) {
+        return 0;
+    }
+    const auto it = m_widgetStringIds.constFind(widgetId);
+    if (it != m_widgetStringIds.constEnd()) {
+        return it.value();
+    }
+    const quint64 id = defineString(widgetId);
+    m_widgetStringIds.insert(widgetId, id);
+    return id;
+}
+
+quint64 LogWriter::defineString(const QString& text) {
+    const quint64 id = ++m_lastStringId;
+    QByteArray payload;
+    BinaryLog::putVarint(payload, id);
+    payload.append(text.toUtf8());
+    BinaryLog::putRecord(m_binaryBuffer, BinaryLog::StringDef, payload);
+    return id;
+}
+
+void LogWriter::writeBuffer() {
+    if (m_buffer.isEmpty() && m_binaryBuffer.isEmpty()) {
+        return;
+    }
+
+    if (m_consoleOutput.load(std::memory_order_relaxed) && !m_buffer.isEmpty()) {
+        std::fwrite(m_buffer.constData(), 1, static_cast<size_t>(m_buffer.size()), stdout);
+    }
+    if (m_file.isOpen()) {
+        const QByteArray& fileData = m_format == Logger::BinaryFormat ? m_binaryBuffer : m_buffer;
+        m_file.write(fileData);
+        m_fileBytes += fileData.size();
+    }
+    m_crashText.store(nullptr);
+    m_buffer.clear();
+    m_binaryBuffer.clear();
+    m_unflushed = true;
+}
+
+void LogWriter::flushOutputs() {
+    std::fflush(stdout);
+    if (m_file.isOpen()) {
+        m_file.flush();
+    }
+    m_unflushed = false;
+    m_flushedUpTo.store(m_processed.load(std::memory_order_relaxed), std::memory_order_release);
+    m_flushClock.restart();
+    m_flushes.fetch_add(1, std::memory_order_relaxed);
+    m_utcOffsetMs.store(QDateTime::currentDateTime().offsetFromUtc() * 1000LL, std::memory_order_relaxed);
+}
+
+/**
+ * 先存长度再存指针；崩溃处理函数先后两次读取指针，两次相同时长度对应的就是这块内存
+ */
+void LogWriter::publishBufferForCrash() {
+    m_crashTextLength.store(static_cast<size_t>(m_buffer.size()));
+    m_crashText.store(m_buffer.isEmpty() ? nullptr : m_buffer.constData());
+}
+
+/**
+ * 在崩溃线程中运行，写入线程可能仍在工作：只读取已发布的数据，正在写入的槽位被跳过；
+ * 写入线程恰好在写出同一批数据时可能重复输出几行
+ */
+void LogWriter::writeCrashDump(int fd) const {
+    const char* text = m_crashText.load();
+    const size_t length = m_crashTextLength.load();
+    if (text && text == m_crashText.load()) {
+        writeRaw(fd, text, length);
+    }
+
+    const qint64 utcOffsetMs = m_utcOffsetMs.load(std::memory_order_relaxed);
+    m_ring.peekPending([fd, utcOffsetMs](const LogRecord& record) {
+        CrashLine line;
+        line.appendRecord(record, utcOffsetMs);
+        writeRaw(fd, line.data(), line.length());
+    });
+}
+
+void LogWriter::writeRaw(int fd, const char* data, size_t length) {
+#ifdef Q_OS_WIN
+    _write(fd, data, static_cast<unsigned int>(length));
+#else
+    while (length > 0) {
+        const ssize_t written = ::write(fd, data, length);
+        if (written <= 0) {
+            break;
+        }
+        data += written;
+        length -= static_cast<size_t>(written);
+    }
+#endif
+}
+
+void LogWriter::applyPendingSettings() {
+    bool reopen = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_rotationChanged) {
+            m_rotation = m_pendingRotation;
+            m_rotationChanged = false;
+        }
+        if (m_filePathChanged) {
+            m_basePath = m_pendingFilePath;
+            m_filePathChanged = false;
+            reopen = true;
+        }
+        if (m_formatChanged) {
+            reopen = reopen || m_pendingFormat != m_format;
+            m_format = m_pendingFormat;
+            m_formatChanged = false;
+        }
+    }
+
+    if (reopen) {
+        openLogFile(filePathForFormat(m_basePath));
+    }
+}
+
+/**
+ * 二进制格式写入同目录下同名的.ulog文件，两种格式的文件各自轮转
+ */
+QString LogWriter::filePathForFormat(const QString& filePath) const {
+    if (filePath.isEmpty() || m_format != Logger::BinaryFormat) {
+        return filePath;
+    }
+    const QFileInfo logFile(filePath);
+    return logFile.absolutePath() + "/" + logFile.completeBaseName() + "." + kBinarySuffix;
+}
+
+void LogWriter::openLogFile(const QString& filePath) {
+    if (m_file.isOpen()) {
+        flushOutputs();
+        m_file.close();
+    }
+    // 字符串ID只在单个文件内有效
+    m_staticStringIds.clear();
+    m_widgetStringIds.clear();
+    m_lastStringId = 0;
+    // 崩溃消息是文本行，二进制日志中只写到标准错误
+    Logger::setCrashLogFile(m_format == Logger::TextFormat ? filePath : QString());
+    if (filePath.isEmpty()) {
+        return;
+    }
+
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Unbuffered)) {
+        std::fprintf(stderr, "无法打开日志文件: %s\n", qPrintable(m_file.errorString()));
+        return;
+    }
+
+    // 续写已有文件时，文件年龄从其创建时间算起
+    m_fileBytes = m_file.size();
+    if (m_format == Logger::BinaryFormat && m_fileBytes == 0) {
+        QByteArray header;
+        BinaryLog::putHeader(header);
+        m_fileBytes = qMax<qint64>(0, m_file.write(header));
+    }
+    const QDateTime birthTime = QFileInfo(filePath).fileTime(QFileDevice::FileBirthTime);
+    m_segmentStartMs = (m_fileBytes > 0 && birthTime.isValid()) ? birthTime.toMSecsSinceEpoch()
+                                                                : QDateTime::currentMSecsSinceEpoch();
+
+    // 上次退出时尚未压缩的历史文件
+    if (m_rotation.compress) {
+        const QFileInfo logFile(filePath);
+        const QFileInfoList segments = logFile.absoluteDir().entryInfoList(
+            QStringList() << logFile.completeBaseName() + ".*." + logFile.suffix(), QDir::Files);
+        QStringList pending;
+        for (const QFileInfo& segment : segments) {
+            pending.append(segment.absoluteFilePath());
+        }
+        if (!pending.isEmpty()) {
+            scheduleCompression(pending);
+        }
+    }
+}
+
+/**
+ * 当前文件超过大小或时间上限时轮转，只在写入线程中执行
+ */
+void LogWriter::rotateIfNeeded() {
+    if (!m_file.isOpen() || m_fileBytes == 0) {
+        return;
+    }
+
+    const bool tooLarge = m_rotation.maxFileBytes > 0 && m_fileBytes >= m_rotation.maxFileBytes;
+    const bool tooOld = m_rotation.maxAgeHours > 0 &&
+        QDateTime::currentMSecsSinceEpoch() - m_segmentStartMs >= qint64(m_rotation.maxAgeHours) * 3600 * 1000;
+    if (tooLarge || tooOld) {
+        rotateFile();
+    }
+}
+
+/**
+ * 轮转只是关闭、重命名并重新打开文件，压缩和清理交给线程池，
+ * 写入线程因此只停顿极短的时间，生产者完全不受影响
+ */
+void LogWriter::rotateFile() {
+    const QString filePath = m_file.fileName();
+    flushOutputs();
+    m_file.close();
+    // 崩溃处理函数持有的描述符也要先释放，Windows上打开的文件不能重命名
+    Logger::setCrashLogFile(QString());
+
+    const QString segmentPath = rotatedFilePath();
+    if (!QFile::rename(filePath, segmentPath)) {
+        std::fprintf(stderr, "无法轮转日志文件: %s\n", qPrintable(filePath));
+        // 重命名失败时继续写原文件，避免日志丢失；再写满一个周期后重试
+        m_file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Unbuffered);
+        Logger::setCrashLogFile(m_format == Logger::TextFormat ? filePath : QString());
+        m_fileBytes = 0;
+        m_segmentStartMs = QDateTime::currentMSecsSinceEpoch();
+        return;
+    }
+
+    m_rotations.fetch_add(1, std::memory_order_relaxed);
+    // 启用压缩时，重新打开文件会把刚轮转出的文件交给线程池压缩和清理
+    openLogFile(filePath);
+    if (!m_rotation.compress) {
+        scheduleCompression(QStringList());
+    }
+}
+
+QString LogWriter::rotatedFilePath() const {
+    const QFileInfo logFile(m_file.fileName());
+    const QString stem = logFile.absolutePath() + "/" + logFile.completeBaseName() + "." +
+                         QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss");
+    QString candidate = stem + "." + logFile.suffix();
+    for (int i = 1; QFile::exists(candidate) || QFile::exists(candidate + kCompressedSuffix); ++i) {
+        candidate = QString("%1-%2.%3").arg(stem).arg(i).arg(logFile.suffix());
+    }
+    return candidate;
+}
+
+void LogWriter::scheduleCompression(const QStringList& segments) {
+    const QString logFilePath = m_file.fileName();
+    const bool compress = m_rotation.compress;
+    const int retentionCount = m_rotation.retentionCount;
+    QThreadPool::globalInstance()->start([segments, logFilePath, compress, retentionCount]() {
+        compressAndPrune(segments, logFilePath, compress, retentionCount);
+    });
+}
+
+/**
+ * 在线程池中压缩历史日志文件，并只保留最新的retentionCount个
+ */
+void LogWriter::compressAndPrune(const QStringList& segments, const QString& logFilePath,
+                                 bool compress, int retentionCount) {
+    // 多次轮转的任务可能同时运行，串行执行避免重复压缩或删除
+    static QMutex s_pruneMutex;
+    QMutexLocker locker(&s_pruneMutex);
+
+    if (compress) {
+        for (const QString& segmentPath : segments) {
+            QFile input(segmentPath);
+            if (!input.open(QIODevice::ReadOnly)) {
+                continue;
+            }
+            const QByteArray compressed = qCompress(input.readAll(), 9);
+            input.close();
+
+            QFile output(segmentPath + kCompressedSuffix);
+            if (output.open(QIODevice::WriteOnly) && output.write(compressed) == compressed.size()) {
+                output.close();
+                QFile::remove(segmentPath);
+            } else {
+                output.close();
+                QFile::remove(output.fileName());
+            }
+        }
+    }
+
+    if (retentionCount <= 0) {
+        return;
+    }
+
+    // 时间戳在文件名中，按名称排序即按时间排序
+    const QFileInfo logFile(logFilePath);
+    QFileInfoList history = logFile.absoluteDir().entryInfoList(segmentPatterns(logFile), QDir::Files, QDir::Name);
+    while (history.size() > retentionCount) {
+        QFile::remove(history.takeFirst().absoluteFilePath());
+    }
+}
+
+/**
+ * 把上次报告以来丢弃的记录数写入日志，丢弃本身不会悄无声息
+ */
+void LogWriter::reportDropped() {
+    const quint64 dropped = m_dropped.load(std::memory_order_relaxed);
+    if (dropped == m_reportedDropped) {
+        return;
+    }
+
+    LogRecord record;
+    record.timestampMs = QDateTime::currentMSecsSinceEpoch();
+    record.level = Logger::Warning;
+    record.message = QString("日志队列已满，丢弃了 %1 条日志").arg(dropped - m_reportedDropped);
+    m_reportedDropped = dropped;
+
+    appendRecord(record);
+    writeBuffer();
+}
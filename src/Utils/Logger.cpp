@@ -1,25 +1,155 @@
 #include "Utils/Logger.h"
+#include "Utils/LogWriter.h"
 #include <QStandardPaths>
 #include <QDir>
 #include <QDebug>
-#include <iostream>
+#include <QThread>
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
 
-Logger::LogLevel Logger::s_logLevel = Logger::Info;
+#ifdef Q_OS_WIN
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+std::atomic<Logger::LogLevel> Logger::s_logLevel{Logger::Info};
+std::atomic<Logger::OverflowPolicy> Logger::s_overflowPolicy{Logger::DropNewest};
+LogRotationPolicy Logger::s_rotationPolicy;
+Logger::FileFormat Logger::s_fileFormat = Logger::TextFormat;
+bool Logger::s_consoleOutput = true;
+bool Logger::s_consoleOutputSet = false;
 QString Logger::s_logFilePath;
 QMutex Logger::s_mutex;
 
+namespace {
+    // 写入线程启动后不再销毁：退出阶段仍可能有其他线程在记录日志，
+    // shutdown()之后的记录改为同步输出到控制台
+    std::atomic<LogWriter*> s_writer{nullptr};
+
+    void writeToConsole(Logger::LogLevel level, const char* category, const QString& message) {
+        const QString prefix = category ? QString("[%1] ").arg(QLatin1String(category)) : QString();
+        const QString line = QString("[%1] [%2] %3%4\n")
+                             .arg(QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz"))
+                             .arg(Logger::levelToString(level))
+                             .arg(prefix)
+                             .arg(message);
+        std::fputs(line.toUtf8().constData(), stdout);
+    }
+
+    // 崩溃消息在安装处理函数时预先格式化，处理函数中只调用异步信号安全的函数
+    struct CrashMessage {
+        int signal = 0;
+        char text[128] = {};
+        size_t length = 0;
+    };
+    CrashMessage s_crashMessages[4];
+    std::atomic<int> s_crashFd{-1};
+    // 第一次打开崩溃日志文件得到的描述符号，之后只用dup2把它指向新文件而从不关闭，
+    // 处理函数读到的号码因此总是有效的；由s_crashFileMutex保护
+    int s_crashFdSlot = -1;
+    QMutex s_crashFileMutex;
+
+    /**
+     * 不能在这里分配内存、加锁或调用C库的格式化函数：崩溃可能发生在malloc或写入线程持有锁的时候。
+     * 先把写入线程尚未写出的记录用write(2)补写到崩溃日志文件（二进制格式时写到标准错误），
+     * 再追加一行预先格式化的消息，然后按默认方式终止
+     */
+    void onFatalSignal(int signal) {
+        static std::atomic_flag s_handling = ATOMIC_FLAG_INIT;
+        if (!s_handling.test_and_set()) {
+            const int fd = s_crashFd.load();
+            if (const LogWriter* writer = s_writer.load()) {
+                writer->writeCrashDump(fd >= 0 ? fd : 2);
+            }
+            for (const CrashMessage& message : s_crashMessages) {
+                if (message.signal != signal) {
+                    continue;
+                }
+                LogWriter::writeRaw(2, message.text, message.length);
+                if (fd >= 0) {
+                    LogWriter::writeRaw(fd, message.text, message.length);
+                }
+                break;
+            }
+        }
+        std::signal(signal, SIG_DFL);
+        std::raise(signal);
+    }
+}
+
 void Logger::initialize() {
     QString appDataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
     QDir().mkpath(appDataPath);
+
+    QMutexLocker locker(&s_mutex);
     s_logFilePath = appDataPath + "/widget_system.log";
+
+    if (!s_writer.load()) {
+        LogWriter* writer = new LogWriter();
+        writer->setRotationPolicy(s_rotationPolicy);
+        writer->setFileFormat(s_fileFormat);
+        if (s_consoleOutputSet) {
+            writer->setConsoleOutput(s_consoleOutput);
+        }
+        writer->setFilePath(s_logFilePath);
+        writer->start(QThread::LowPriority);
+        s_writer.store(writer);
+
+        // 正常退出时写出剩余日志；此时main()中的对象已析构完毕
+        std::atexit(&Logger::shutdown);
+        installCrashHandlers();
+    } else {
+        s_writer.load()->setFilePath(s_logFilePath);
+    }
 }
 
 void Logger::setLogLevel(LogLevel level) {
-    s_logLevel = level;
+    s_logLevel.store(level, std::memory_order_relaxed);
 }
 
 void Logger::setLogFile(const QString& filePath) {
+    QMutexLocker locker(&s_mutex);
     s_logFilePath = filePath;
+    if (LogWriter* writer = s_writer.load()) {
+        writer->setFilePath(filePath);
+    }
+}
+
+void Logger::setOverflowPolicy(OverflowPolicy policy) {
+    s_overflowPolicy.store(policy, std::memory_order_relaxed);
+}
+
+void Logger::setRotationPolicy(const LogRotationPolicy& policy) {
+    QMutexLocker locker(&s_mutex);
+    s_rotationPolicy = policy;
+    if (LogWriter* writer = s_writer.load()) {
+        writer->setRotationPolicy(policy);
+    }
+}
+
+void Logger::setFileFormat(FileFormat format) {
+    QMutexLocker locker(&s_mutex);
+    s_fileFormat = format;
+    if (LogWriter* writer = s_writer.load()) {
+        writer->setFileFormat(format);
+    }
+}
+
+void Logger::setConsoleOutput(bool enabled) {
+    QMutexLocker locker(&s_mutex);
+    s_consoleOutputSet = true;
+    s_consoleOutput = enabled;
+    if (LogWriter* writer = s_writer.load()) {
+        writer->setConsoleOutput(enabled);
+    }
 }
 
 void Logger::debug(const QString& message) {
@@ -38,34 +168,151 @@ void Logger::error(const QString& message) {
     log(Error, message);
 }
 
+/**
+ * 记录放入写入线程的队列后立即返回，调用线程不等待任何I/O
+ */
 void Logger::log(LogLevel level, const QString& message) {
-    if (level < s_logLevel) {
+    log(level, nullptr, message);
+}
+
+/**
+ * category必须是静态存储的字符串（QLoggingCategory::categoryName()），写入线程直接引用它
+ */
+void Logger::log(LogLevel level, const char* category, const QString& message) {
+    if (level < s_logLevel.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    LogWriter* writer = s_writer.load(std::memory_order_acquire);
+    if (writer && writer->isAccepting()) {
+        LogRecord record;
+        record.timestampMs = QDateTime::currentMSecsSinceEpoch();
+        record.level = level;
+        record.threadId = reinterpret_cast<quintptr>(QThread::currentThreadId());
+        record.category = category;
+        record.message = message;
+        // 错误总是等待入队，其他级别按溢出策略处理
+        writer->enqueue(std::move(record), level >= Error ? Block : s_overflowPolicy.load(std::memory_order_relaxed));
         return;
     }
-    
-    writeLog(level, message);
+
+    // 写入线程尚未启动或已停止
+    writeToConsole(level, category, message);
 }
 
-void Logger::writeLog(LogLevel level, const QString& message) {
-    QMutexLocker locker(&s_mutex);
-    
-    QString timestamp = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz");
-    QString logMessage = QString("[%1] [%2] %3")
-                         .arg(timestamp)
-                         .arg(levelToString(level))
-                         .arg(message);
-    
-    // 输出到控制台
-    std::cout << logMessage.toStdString() << std::endl;
-    
-    // 输出到文件
-    if (!s_logFilePath.isEmpty()) {
-        QFile file(s_logFilePath);
-        if (file.open(QIODevice::WriteOnly | QIODevice::Append)) {
-            QTextStream stream(&file);
-            stream << logMessage << Qt::endl;
-            file.close();
-        }
+void Logger::enqueueEvent(LogLevel level, const char* category, const QString& widgetId,
+                          const char* messageTemplate, QVector<BinaryLog::Arg>&& args) {
+    LogWriter* writer = s_writer.load(std::memory_order_acquire);
+    if (writer && writer->isAccepting()) {
+        LogRecord record;
+        record.timestampMs = QDateTime::currentMSecsSinceEpoch();
+        record.level = level;
+        record.threadId = reinterpret_cast<quintptr>(QThread::currentThreadId());
+        record.category = category;
+        record.widgetId = widgetId;
+        record.messageTemplate = messageTemplate;
+        record.args = std::move(args);
+        writer->enqueue(std::move(record), level >= Error ? Block : s_overflowPolicy.load(std::memory_order_relaxed));
+        return;
+    }
+
+    QString message = BinaryLog::formatMessage(QString::fromUtf8(messageTemplate), args);
+    if (!widgetId.isEmpty()) {
+        message = QString("[%1] %2").arg(widgetId, message);
+    }
+    writeToConsole(level, category, message);
+}
+
+bool Logger::flush(int timeoutMs) {
+    LogWriter* writer = s_writer.load();
+    return writer ? writer->flush(timeoutMs) : true;
+}
+
+void Logger::shutdown() {
+    LogWriter* writer = s_writer.load();
+    if (!writer || !writer->isAccepting()) {
+        return;
+    }
+
+    const LogStats stats = writer->statistics();
+    if (stats.droppedCount > 0 || stats.blockedCount > 0) {
+        info(QString("日志统计: 写出 %1 条, 丢弃 %2 条, 等待 %3 次, 最大队列深度 %4")
+             .arg(stats.writtenCount)
+             .arg(stats.droppedCount)
+             .arg(stats.blockedCount)
+             .arg(stats.maxQueueDepth));
+    }
+    writer->stop();
+}
+
+LogStats Logger::getStatistics() {
+    LogWriter* writer = s_writer.load();
+    return writer ? writer->statistics() : LogStats();
+}
+
+void Logger::installCrashHandlers() {
+    const std::pair<int, const char*> handled[] = {
+        {SIGSEGV, "SIGSEGV"}, {SIGABRT, "SIGABRT"}, {SIGFPE, "SIGFPE"}, {SIGILL, "SIGILL"}
+    };
+    static_assert(sizeof(handled) / sizeof(handled[0]) == sizeof(s_crashMessages) / sizeof(s_crashMessages[0]),
+                  "one crash message per handled signal");
+
+    for (size_t i = 0; i < sizeof(handled) / sizeof(handled[0]); ++i) {
+        CrashMessage& message = s_crashMessages[i];
+        const QByteArray text = QString("[%1] 程序异常终止 (%2)\n")
+                                .arg(levelToString(Error), QLatin1String(handled[i].second)).toUtf8();
+        message.length = qMin<size_t>(text.size(), sizeof(message.text));
+        std::memcpy(message.text, text.constData(), message.length);
+        message.signal = handled[i].first;
+        std::signal(handled[i].first, onFatalSignal);
+    }
+}
+
+/**
+ * 处理函数可能随时读到s_crashFd并向它写入，因此已发布的描述符号从不关闭：
+ * 新文件打开后用dup2原子地替换同一个号码指向的文件；清空时把号码指向空设备，
+ * 释放对旧文件的占用（Windows上被打开的文件不能重命名）
+ */
+void Logger::setCrashLogFile(const QString& filePath) {
+    int fd = -1;
+#ifdef Q_OS_WIN
+    if (filePath.isEmpty()) {
+        fd = _open("NUL", _O_WRONLY | _O_BINARY);
+    } else {
+        fd = _wopen(reinterpret_cast<const wchar_t*>(filePath.utf16()), _O_WRONLY | _O_APPEND | _O_CREAT | _O_BINARY,
+                    _S_IREAD | _S_IWRITE);
+    }
+#else
+    if (filePath.isEmpty()) {
+        fd = ::open("/dev/null", O_WRONLY | O_CLOEXEC);
+    } else {
+        fd = ::open(QFile::encodeName(filePath).constData(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+    }
+#endif
+
+    QMutexLocker locker(&s_crashFileMutex);
+    if (filePath.isEmpty() || fd < 0) {
+        s_crashFd.store(-1);
+    }
+    if (fd < 0) {
+        return;
+    }
+#ifdef Q_OS_WIN
+    const bool replaced = s_crashFdSlot >= 0 && _dup2(fd, s_crashFdSlot) == 0;
+#else
+    const bool replaced = s_crashFdSlot >= 0 && ::dup2(fd, s_crashFdSlot) >= 0;
+#endif
+    if (replaced) {
+#ifdef Q_OS_WIN
+        _close(fd);
+#else
+        ::close(fd);
+#endif
+    } else {
+        s_crashFdSlot = fd;     // 第一次设置；dup2失败时旧号码继续指向旧文件，同样不关闭
+    }
+    if (!filePath.isEmpty()) {
+        s_crashFd.store(s_crashFdSlot);
     }
 }
 
@@ -77,4 +324,14 @@ QString Logger::levelToString(LogLevel level) {
         case Error: return "ERROR";
         default: return "UNKNOWN";
     }
-} 
\ No newline at end of file
+}
+
+QtMsgType Logger::toMsgType(LogLevel level) {
+    switch (level) {
+        case Debug: return QtDebugMsg;
+        case Info: return QtInfoMsg;
+        case Warning: return QtWarningMsg;
+        case Error: return QtCriticalMsg;
+        default: return QtInfoMsg;
+    }
+}
@@ -0,0 +1,306 @@
+#include "Utils/MetricsArchive.h"
+#include "Utils/LogCategories.h"
+#include <QDateTime>
+#include <QDir>
+#include <QStandardPaths>
+#include <QStringList>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace {
+    constexpr char kMagic[4] = {'U', 'W', 'M', 'A'};
+    constexpr quint32 kVersion = 1;
+    constexpr qint64 kDayMs = 24 * 3600 * 1000LL;
+
+    const QString kSegmentPrefix = QStringLiteral("metrics-");
+    const QString kSegmentSuffix = QStringLiteral(".uwm");
+
+    QString segmentName(qint64 createdMs) {
+        return kSegmentPrefix + QString("%1").arg(createdMs, 13, 10, QLatin1Char('0')) + kSegmentSuffix;
+    }
+
+    // 段文件名按创建时间升序
+    QStringList segmentNames(const QDir& directory) {
+        return directory.entryList({kSegmentPrefix + "*" + kSegmentSuffix}, QDir::Files, QDir::Name);
+    }
+
+    qint64 segmentCreatedMs(const QString& name) {
+        return name.mid(kSegmentPrefix.size(), name.size() - kSegmentPrefix.size() - kSegmentSuffix.size())
+            .toLongLong();
+    }
+
+    // 已写入条数是写入方和读取方之间唯一的同步点：写入方写完记录后以release存储发布，
+    // 读取方以acquire读取，读到的条数之内的记录对读取方总是完整可见。
+    // 映射内存中的count按4字节对齐，以布局相同的无锁std::atomic访问
+    using AtomicCount = std::atomic<quint32>;
+    static_assert(sizeof(AtomicCount) == sizeof(quint32) && AtomicCount::is_always_lock_free,
+                  "archive record count must be accessible as a lock-free atomic");
+
+    quint32 loadCount(const MetricsArchiveHeader& header) {
+        return reinterpret_cast<const AtomicCount&>(header.count).load(std::memory_order_acquire);
+    }
+
+    void publishCount(MetricsArchiveHeader& header, quint32 count) {
+        reinterpret_cast<AtomicCount&>(header.count).store(count, std::memory_order_release);
+    }
+
+    // 头部有效，且文件足以容纳头部声明的容量
+    bool isValidSegment(const MetricsArchiveHeader& header, qint64 fileSize) {
+        return std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+               header.version == kVersion &&
+               header.recordSize == sizeof(MetricsArchiveRecord) &&
+               loadCount(header) <= header.capacity &&
+               fileSize >= qint64(sizeof(MetricsArchiveHeader)) + qint64(header.capacity) * header.recordSize;
+    }
+}
+
+MetricsArchive::MetricsArchive()
+    : m_header(nullptr)
+    , m_records(nullptr)
+    , m_segmentRecords(kDefaultSegmentRecords)
+    , m_retentionDays(kDefaultRetentionDays)
+    , m_hasPending(false)
+{
+}
+
+MetricsArchive::~MetricsArchive() {
+    close();
+}
+
+QString MetricsArchive::defaultDirectory() {
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/metrics";
+}
+
+bool MetricsArchive::open(const QString& directory, int segmentRecords) {
+    close();
+    if (!QDir().mkpath(directory)) {
+        qCDebug(lcMonitor) << "Failed to create metrics archive directory" << directory;
+        return false;
+    }
+    m_directory = directory;
+    m_segmentRecords = qMax(1, segmentRecords);
+
+    const QDir dir(m_directory);
+    const QStringList names = segmentNames(dir);
+    if (!names.isEmpty() && mapSegment(dir.filePath(names.last()), false)) {
+        if (m_header->count < m_header->capacity) {
+            return true;
+        }
+        close();
+    }
+    return createSegment();
+}
+
+/**
+ * 先发布当前这一秒的记录，再解除映射；不刷盘，脏页交给操作系统写回
+ */
+void MetricsArchive::close() {
+    publishPending();
+    if (m_header) {
+        m_file.unmap(reinterpret_cast<uchar*>(m_header));
+        m_header = nullptr;
+        m_records = nullptr;
+    }
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+}
+
+void MetricsArchive::setRetentionDays(int days) {
+    m_retentionDays = qBound(1, days, kMaxSegments);
+}
+
+bool MetricsArchive::createSegment() {
+    close();
+    const QDir dir(m_directory);
+    qint64 createdMs = QDateTime::currentMSecsSinceEpoch();
+    while (dir.exists(segmentName(createdMs))) {
+        createdMs++;
+    }
+    if (!mapSegment(dir.filePath(segmentName(createdMs)), true)) {
+        qCDebug(lcMonitor) << "Failed to create metrics archive segment in" << m_directory;
+        return false;
+    }
+    pruneSegments();
+    return true;
+}
+
+/**
+ * 新段一次性扩展到最终大小再映射，之后写入不再改变文件大小（Windows上已映射的文件不能改变大小）
+ */
+bool MetricsArchive::mapSegment(const QString& filePath, bool create) {
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        return false;
+    }
+    if (create) {
+        const qint64 size = qint64(sizeof(MetricsArchiveHeader)) + qint64(m_segmentRecords) * sizeof(MetricsArchiveRecord);
+        if (!m_file.resize(size)) {
+            m_file.close();
+            QFile::remove(filePath);
+            return false;
+        }
+    }
+
+    const qint64 fileSize = m_file.size();
+    uchar* map = fileSize >= qint64(sizeof(MetricsArchiveHeader)) ? m_file.map(0, fileSize) : nullptr;
+    if (!map) {
+        m_file.close();
+        return false;
+    }
+
+    MetricsArchiveHeader* header = reinterpret_cast<MetricsArchiveHeader*>(map);
+    if (create) {
+        std::memset(header, 0, sizeof(MetricsArchiveHeader));
+        std::memcpy(header->magic, kMagic, sizeof(kMagic));
+        header->version = kVersion;
+        header->recordSize = sizeof(MetricsArchiveRecord);
+        header->capacity = static_cast<quint32>(m_segmentRecords);
+    } else if (!isValidSegment(*header, fileSize)) {
+        m_file.unmap(map);
+        m_file.close();
+        return false;
+    }
+
+    m_header = header;
+    m_records = reinterpret_cast<MetricsArchiveRecord*>(map + sizeof(MetricsArchiveHeader));
+    return true;
+}
+
+/**
+ * 一个段覆盖从它的创建到下一个段创建之间的时间，下一个段也早于保留期限时整段删除；
+ * 段数超过上限时再从最旧的删起。当前段总是保留
+ */
+void MetricsArchive::pruneSegments() {
+    QDir dir(m_directory);
+    QStringList names = segmentNames(dir);
+    const qint64 cutoffMs = QDateTime::currentMSecsSinceEpoch() - qint64(m_retentionDays) * kDayMs;
+
+    while (names.size() > 1 && (names.size() > kMaxSegments || segmentCreatedMs(names[1]) < cutoffMs)) {
+        if (!dir.remove(names.first())) {
+            qCDebug(lcMonitor) << "Failed to remove metrics archive segment" << names.first();
+        }
+        names.removeFirst();
+    }
+}
+
+/**
+ * 同一秒内（或时钟回拨后）的样本并入尚未发布的当前记录，进入新的一秒时才发布上一条，
+ * 保证每秒至多一条、时间单调递增，且读取方可见的记录不会再被修改
+ */
+void MetricsArchive::append(const MetricsArchiveRecord& record) {
+    if (!m_header) {
+        return;
+    }
+    if (m_hasPending) {
+        if (record.timestampMs / 1000 <= m_pending.timestampMs / 1000) {
+            merge(m_pending, record);
+            m_pending.timestampMs = qMax(m_pending.timestampMs, record.timestampMs);
+            return;
+        }
+        publishPending();
+        if (!m_header) {
+            return;     // 滚动到新段失败
+        }
+    }
+
+    m_pending = record;
+    m_hasPending = true;
+    const quint32 count = m_header->count;
+    if (count > 0) {
+        // 重新打开归档后时钟早于最后一条已发布的记录：排在它的下一秒
+        const qint64 nextSecondMs = (m_records[count - 1].timestampMs / 1000 + 1) * 1000;
+        m_pending.timestampMs = qMax(m_pending.timestampMs, nextSecondMs);
+    }
+}
+
+/**
+ * 记录完整写入count位置之后才以release存储发布条数；段已满时先滚动到新段
+ */
+void MetricsArchive::publishPending() {
+    if (!m_hasPending) {
+        return;
+    }
+    m_hasPending = false;   // 先清除，createSegment()中的close()不会重复发布
+    if (!m_header || (m_header->count >= m_header->capacity && !createSegment())) {
+        return;
+    }
+    const quint32 count = m_header->count;
+    if (count == 0) {
+        m_header->firstTimestampMs = m_pending.timestampMs;
+    }
+    m_records[count] = m_pending;
+    publishCount(*m_header, count + 1);
+}
+
+void MetricsArchive::merge(MetricsArchiveRecord& target, const MetricsArchiveRecord& update) {
+    if (update.fields & MetricsArchiveRecord::CpuField) {
+        target.cpuUsage = update.cpuUsage;
+    }
+    if (update.fields & MetricsArchiveRecord::MemoryField) {
+        target.memoryUsage = update.memoryUsage;
+        target.usedMemoryMB = update.usedMemoryMB;
+        target.totalMemoryMB = update.totalMemoryMB;
+    }
+    if (update.fields & MetricsArchiveRecord::DiskField) {
+        target.diskUsage = update.diskUsage;
+        target.diskReadKBps = update.diskReadKBps;
+        target.diskWriteKBps = update.diskWriteKBps;
+    }
+    if (update.fields & MetricsArchiveRecord::NetworkField) {
+        target.networkUpload = update.networkUpload;
+        target.networkDownload = update.networkDownload;
+    }
+    if (update.fields & MetricsArchiveRecord::VolumesField) {
+        target.usedDiskGB = update.usedDiskGB;
+        target.totalDiskGB = update.totalDiskGB;
+    }
+    target.fields |= update.fields;
+}
+
+MetricsArchiveReader::MetricsArchiveReader(const QString& directory)
+    : m_directory(directory)
+{
+}
+
+/**
+ * 只打开与时间范围相交的段；段内记录按时间递增，二分查找起点
+ */
+qint64 MetricsArchiveReader::replay(qint64 fromMs, qint64 toMs,
+                                    const std::function<void(const MetricsArchiveRecord&)>& visitor) const {
+    const QDir dir(m_directory);
+    const QStringList names = segmentNames(dir);
+    qint64 replayed = 0;
+
+    for (int i = 0; i < names.size(); ++i) {
+        if (i + 1 < names.size() && segmentCreatedMs(names[i + 1]) < fromMs) {
+            continue;   // 整段早于范围
+        }
+        if (segmentCreatedMs(names[i]) > toMs) {
+            break;
+        }
+
+        QFile file(dir.filePath(names[i]));
+        if (!file.open(QIODevice::ReadOnly) || file.size() < qint64(sizeof(MetricsArchiveHeader))) {
+            continue;
+        }
+        uchar* map = file.map(0, file.size());
+        if (!map) {
+            continue;
+        }
+        const MetricsArchiveHeader* header = reinterpret_cast<const MetricsArchiveHeader*>(map);
+        if (isValidSegment(*header, file.size())) {
+            const MetricsArchiveRecord* begin = reinterpret_cast<const MetricsArchiveRecord*>(map + sizeof(MetricsArchiveHeader));
+            const MetricsArchiveRecord* end = begin + loadCount(*header);
+            const MetricsArchiveRecord* it = std::lower_bound(begin, end, fromMs,
+                [](const MetricsArchiveRecord& record, qint64 timeMs) { return record.timestampMs < timeMs; });
+            for (; it != end && it->timestampMs <= toMs; ++it) {
+                visitor(*it);
+                replayed++;
+            }
+        }
+        file.unmap(map);
+    }
+    return replayed;
+}
@@ -0,0 +1,260 @@
+#include "Utils/MetricsHistory.h"
+#include <QDateTime>
+#include <limits>
+
+namespace {
+    constexpr qint64 kSecondMs = 1000;
+    constexpr qint64 kMinuteMs = 60 * kSecondMs;
+    constexpr qint64 kQuarterHourMs = 15 * kMinuteMs;
+    constexpr float kNoData = std::numeric_limits<float>::quiet_NaN();
+
+    constexpr int tierIndex(HistoryResolution resolution) {
+        return static_cast<int>(resolution);
+    }
+}
+
+void MetricsHistory::Tier::allocate(int size, bool withRange) {
+    capacity = size;
+    head = 0;
+    count = 0;
+    timeMs.assign(size, 0);
+    for (int m = 0; m < kMetricCount; ++m) {
+        avg[m].assign(size, kNoData);
+        if (withRange) {
+            min[m].assign(size, kNoData);
+            max[m].assign(size, kNoData);
+        }
+    }
+}
+
+int MetricsHistory::Tier::append(qint64 bucketStartMs) {
+    const int slot = head;
+    timeMs[slot] = bucketStartMs;
+    for (int m = 0; m < kMetricCount; ++m) {
+        avg[m][slot] = kNoData;
+        if (!min[m].empty()) {
+            min[m][slot] = kNoData;
+            max[m][slot] = kNoData;
+        }
+    }
+    head = (head + 1) % capacity;
+    count = qMin(count + 1, capacity);
+    return slot;
+}
+
+void MetricsHistory::Accumulator::reset(qint64 bucketStart) {
+    bucketStartMs = bucketStart;
+    for (int m = 0; m < kMetricCount; ++m) {
+        sum[m] = 0.0;
+        min[m] = kNoData;
+        max[m] = kNoData;
+        samples[m] = 0;
+    }
+}
+
+MetricsHistory::MetricsHistory()
+    : m_currentSecond(-1)
+{
+    m_tiers[tierIndex(HistoryResolution::Second)].allocate(kSecondCapacity, false);
+    m_tiers[tierIndex(HistoryResolution::Minute)].allocate(kMinuteCapacity, true);
+    m_tiers[tierIndex(HistoryResolution::QuarterHour)].allocate(kQuarterHourCapacity, true);
+    m_minuteAcc.reset(-1);
+    m_quarterAcc.reset(-1);
+}
+
+void MetricsHistory::clear() {
+    QMutexLocker locker(&m_mutex);
+    for (Tier& tier : m_tiers) {
+        tier.head = 0;
+        tier.count = 0;
+    }
+    m_minuteAcc.reset(-1);
+    m_quarterAcc.reset(-1);
+    m_currentSecond = -1;
+}
+
+/**
+ * 同一秒内的多次采样写入同一个槽位（以最后一次为准），但都计入分钟汇总；
+ * 时钟回拨时样本并入当前槽位，不会打乱时间顺序
+ */
+void MetricsHistory::record(qint64 timestampMs, quint32 mask, const double (&values)[kMetricCount]) {
+    QMutexLocker locker(&m_mutex);
+
+    const qint64 minuteStart = timestampMs - timestampMs % kMinuteMs;
+    if (m_minuteAcc.bucketStartMs >= 0 && minuteStart > m_minuteAcc.bucketStartMs) {
+        flushMinute();
+    }
+    if (m_minuteAcc.bucketStartMs < 0) {
+        m_minuteAcc.reset(minuteStart);
+    }
+
+    Tier& seconds = m_tiers[tierIndex(HistoryResolution::Second)];
+    const qint64 second = timestampMs / kSecondMs;
+    int slot;
+    if (m_currentSecond < 0 || second > m_currentSecond) {
+        slot = seconds.append(second * kSecondMs);
+        m_currentSecond = second;
+    } else {
+        slot = seconds.last();
+    }
+
+    for (int m = 0; m < kMetricCount; ++m) {
+        if (!(mask & (1u << m))) {
+            continue;
+        }
+        const float value = static_cast<float>(values[m]);
+        seconds.avg[m][slot] = value;
+        addToAccumulator(m_minuteAcc, m, value, value, value, 1);
+    }
+}
+
+void MetricsHistory::record(const MetricsArchiveRecord& sample) {
+    double values[kMetricCount] = {};
+    quint32 mask = 0;
+    auto set = [&](HistoryMetric metric, double value) {
+        values[static_cast<int>(metric)] = value;
+        mask |= 1u << static_cast<int>(metric);
+    };
+
+    if (sample.fields & MetricsArchiveRecord::CpuField) {
+        set(HistoryMetric::Cpu, sample.cpuUsage);
+    }
+    if (sample.fields & MetricsArchiveRecord::MemoryField) {
+        set(HistoryMetric::Memory, sample.memoryUsage);
+    }
+    if (sample.fields & MetricsArchiveRecord::DiskField) {
+        set(HistoryMetric::Disk, sample.diskUsage);
+    }
+    if (sample.fields & MetricsArchiveRecord::NetworkField) {
+        set(HistoryMetric::NetworkUpload, sample.networkUpload);
+        set(HistoryMetric::NetworkDownload, sample.networkDownload);
+    }
+    if (mask != 0) {
+        record(sample.timestampMs, mask, values);
+    }
+}
+
+void MetricsHistory::addToAccumulator(Accumulator& acc, int metric, float avg, float min, float max, int samples) {
+    if (acc.samples[metric] == 0) {
+        acc.min[metric] = min;
+        acc.max[metric] = max;
+    } else {
+        acc.min[metric] = qMin(acc.min[metric], min);
+        acc.max[metric] = qMax(acc.max[metric], max);
+    }
+    acc.sum[metric] += double(avg) * samples;
+    acc.samples[metric] += samples;
+}
+
+/**
+ * 把已结束的一分钟写入分钟档，并按样本数加权并入15分钟汇总
+ */
+void MetricsHistory::flushMinute() {
+    Tier& minutes = m_tiers[tierIndex(HistoryResolution::Minute)];
+    const qint64 bucketStart = m_minuteAcc.bucketStartMs;
+    const int slot = minutes.append(bucketStart);
+
+    const qint64 quarterStart = bucketStart - bucketStart % kQuarterHourMs;
+    if (m_quarterAcc.bucketStartMs >= 0 && quarterStart > m_quarterAcc.bucketStartMs) {
+        flushQuarterHour();
+    }
+    if (m_quarterAcc.bucketStartMs < 0) {
+        m_quarterAcc.reset(quarterStart);
+    }
+
+    for (int m = 0; m < kMetricCount; ++m) {
+        const int samples = m_minuteAcc.samples[m];
+        if (samples == 0) {
+            continue;
+        }
+        const float avg = static_cast<float>(m_minuteAcc.sum[m] / samples);
+        minutes.avg[m][slot] = avg;
+        minutes.min[m][slot] = m_minuteAcc.min[m];
+        minutes.max[m][slot] = m_minuteAcc.max[m];
+        addToAccumulator(m_quarterAcc, m, avg, m_minuteAcc.min[m], m_minuteAcc.max[m], samples);
+    }
+    m_minuteAcc.reset(-1);
+}
+
+void MetricsHistory::flushQuarterHour() {
+    Tier& quarters = m_tiers[tierIndex(HistoryResolution::QuarterHour)];
+    const int slot = quarters.append(m_quarterAcc.bucketStartMs);
+    for (int m = 0; m < kMetricCount; ++m) {
+        const int samples = m_quarterAcc.samples[m];
+        if (samples == 0) {
+            continue;
+        }
+        quarters.avg[m][slot] = static_cast<float>(m_quarterAcc.sum[m] / samples);
+        quarters.min[m][slot] = m_quarterAcc.min[m];
+        quarters.max[m][slot] = m_quarterAcc.max[m];
+    }
+    m_quarterAcc.reset(-1);
+}
+
+HistoryResolution MetricsHistory::resolutionForWindow(int windowSeconds) {
+    if (windowSeconds <= kSecondCapacity) {
+        return HistoryResolution::Second;
+    }
+    if (windowSeconds <= kMinuteCapacity * 60) {
+        return HistoryResolution::Minute;
+    }
+    return HistoryResolution::QuarterHour;
+}
+
+qint64 MetricsHistory::resolutionMs(HistoryResolution resolution) {
+    switch (resolution) {
+        case HistoryResolution::Second: return kSecondMs;
+        case HistoryResolution::Minute: return kMinuteMs;
+        default: return kQuarterHourMs;
+    }
+}
+
+void MetricsHistory::query(HistoryMetric metric, int windowSeconds, HistorySeries& out) const {
+    const qint64 sinceMs = QDateTime::currentMSecsSinceEpoch() - qint64(windowSeconds) * kSecondMs;
+    query(metric, resolutionForWindow(windowSeconds), sinceMs, out);
+}
+
+/**
+ * 汇总档还会附上正在累积的区间，最近几分钟的数据不必等区间结束才可见
+ */
+void MetricsHistory::query(HistoryMetric metric, HistoryResolution resolution, qint64 sinceMs,
+                           HistorySeries& out) const {
+    out.clear();
+    out.resolution = resolution;
+    const int m = static_cast<int>(metric);
+    if (m < 0 || m >= kMetricCount) {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    const Tier& tier = m_tiers[tierIndex(resolution)];
+    const bool hasRange = !tier.min[m].empty();
+
+    out.timeMs.reserve(tier.count + 1);
+    out.avg.reserve(tier.count + 1);
+    out.min.reserve(tier.count + 1);
+    out.max.reserve(tier.count + 1);
+
+    for (int i = 0; i < tier.count; ++i) {
+        const int slot = (tier.head - tier.count + i + tier.capacity) % tier.capacity;
+        if (tier.timeMs[slot] < sinceMs) {
+            continue;
+        }
+        const float avg = tier.avg[m][slot];
+        out.timeMs.append(tier.timeMs[slot]);
+        out.avg.append(avg);
+        out.min.append(hasRange ? tier.min[m][slot] : avg);
+        out.max.append(hasRange ? tier.max[m][slot] : avg);
+    }
+
+    if (resolution == HistoryResolution::Second) {
+        return;
+    }
+    const Accumulator& pending = resolution == HistoryResolution::Minute ? m_minuteAcc : m_quarterAcc;
+    if (pending.bucketStartMs >= sinceMs && pending.samples[m] > 0) {
+        out.timeMs.append(pending.bucketStartMs);
+        out.avg.append(static_cast<float>(pending.sum[m] / pending.samples[m]));
+        out.min.append(pending.min[m]);
+        out.max.append(pending.max[m]);
+    }
+}
@@ -0,0 +1,394 @@
+#include "Utils/MetricsSampler.h"
+#include "Utils/LogCategories.h"
+#include <QDebug>
+#include <algorithm>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <pdh.h>
+#include <pdhmsg.h>
+#endif
+
+#ifdef Q_OS_LINUX
+#include <cstdio>
+#endif
+
+MetricsSampler::MetricsSampler()
+    : m_lastCpuTotal(0)
+    , m_lastCpuIdle(0)
+    , m_lastCpuUsage(0.0)
+#ifdef Q_OS_WIN
+    , m_hQuery(nullptr)
+    , m_hCpuTotal(nullptr)
+    , m_hCoreTime(nullptr)
+    , m_hCoreFrequency(nullptr)
+#endif
+#ifdef Q_OS_LINUX
+    , m_statFile("/proc/stat")
+    , m_meminfoFile("/proc/meminfo")
+#endif
+{
+#ifdef Q_OS_WIN
+    initializePdh();
+#endif
+}
+
+MetricsSampler::~MetricsSampler() {
+#ifdef Q_OS_WIN
+    uninitializePdh();
+#endif
+}
+
+/**
+ * 每个来源只读取一次；稳定运行后读取本身不分配内存，
+ * 写入data中与上一份快照共享的数组时按写时复制分离
+ */
+void MetricsSampler::sample(MetricSources sources, PerformanceData& data) {
+#ifdef Q_OS_WIN
+    if (m_hQuery) {
+        // 所有PDH计数器共用一次收集
+        if (PdhCollectQueryData(m_hQuery) != ERROR_SUCCESS) {
+            qCDebug(lcMonitor) << "PdhCollectQueryData failed";
+        }
+    }
+    if (sources.testFlag(MetricSource::Cpu)) {
+        data.cpuUsage = m_hQuery ? getCpuUsagePdh() : getCpuUsage();
+    }
+    if (sources.testFlag(MetricSource::CpuCores)) {
+        getPerCoreInfoPdh(data.coreUsage, data.coreFrequencyMhz);
+    }
+#elif defined(Q_OS_LINUX)
+    if (sources.testFlag(MetricSource::CpuCores)) {
+        // 每核心数据需要读取整个/proc/stat，总使用率顺带从同一次读取中得到
+        getPerCoreInfo(data.coreUsage, data.coreFrequencyMhz,
+                       sources.testFlag(MetricSource::Cpu) ? &data.cpuUsage : nullptr);
+    } else if (sources.testFlag(MetricSource::Cpu)) {
+        data.cpuUsage = getCpuUsage();
+    }
+#else
+    if (sources.testFlag(MetricSource::Cpu)) {
+        data.cpuUsage = getCpuUsage();
+    }
+#endif
+
+    if (sources.testFlag(MetricSource::Disk)) {
+        sampleDisks(data);
+    }
+    if (sources.testFlag(MetricSource::Network)) {
+        sampleNetwork(data);
+    }
+
+    if (sources.testFlag(MetricSource::Memory)) {
+        getMemoryInfo(data.totalMemory, data.usedMemory);
+        data.memoryUsage = data.totalMemory > 0 ? (double)data.usedMemory / data.totalMemory * 100.0 : 0.0;
+    }
+    if (sources.testFlag(MetricSource::Processes)) {
+        // 扫描受时间预算限制，进程很多时一轮扫描分摊到多次采样
+        m_processScanner.scan();
+        m_processScanner.topByCpu(ProcessScanner::kMaxTopCount, data.topCpuProcesses);
+        m_processScanner.topByMemory(ProcessScanner::kMaxTopCount, data.topMemoryProcesses);
+        data.processScanStats = m_processScanner.stats();
+    }
+}
+
+void MetricsSampler::setIgnoredInterfaces(const QStringList& prefixes) {
+    m_networkSampler.setIgnoredPrefixes(prefixes);
+}
+
+/**
+ * 磁盘使用率取各物理磁盘中最忙的一块，吞吐为各磁盘之和
+ */
+void MetricsSampler::sampleDisks(PerformanceData& data) {
+    if (!m_diskSampler.sample()) {
+        qCDebug(lcMonitor) << "Failed to read disk I/O counters";
+        return;
+    }
+    data.diskUsage = m_diskSampler.busiestPercent();
+    data.diskReadKBps = m_diskSampler.readKBps();
+    data.diskWriteKBps = m_diskSampler.writeKBps();
+    m_diskSampler.topDevices(DiskIoSampler::kMaxTopCount, data.diskDevices);
+}
+
+/**
+ * 总吞吐为未被过滤的各接口之和；接口列表按收发速率之和排序
+ */
+void MetricsSampler::sampleNetwork(PerformanceData& data) {
+    if (!m_networkSampler.sample()) {
+        qCDebug(lcNetwork) << "Failed to read network interface counters";
+        return;
+    }
+    data.networkUpload = m_networkSampler.uploadKBps();
+    data.networkDownload = m_networkSampler.downloadKBps();
+    m_networkSampler.topInterfaces(NetworkSampler::kMaxTopCount, data.topInterfaces);
+}
+
+/**
+ * 由累计的总时间片和空闲时间片计算两次读取之间的使用率；
+ * 第一次读取只作为基准，计数器倒退（例如休眠唤醒后）时沿用上一次的值
+ */
+double MetricsSampler::updateCpuUsage(quint64 total, quint64 idle) {
+    if (m_lastCpuTotal > 0 && total > m_lastCpuTotal && idle >= m_lastCpuIdle) {
+        const quint64 totalDiff = total - m_lastCpuTotal;
+        const quint64 idleDiff = idle - m_lastCpuIdle;
+        if (idleDiff <= totalDiff) {
+            m_lastCpuUsage = (totalDiff - idleDiff) * 100.0 / totalDiff;
+        }
+    }
+    m_lastCpuTotal = total;
+    m_lastCpuIdle = idle;
+    return m_lastCpuUsage;
+}
+
+#ifdef Q_OS_WIN
+void MetricsSampler::initializePdh() {
+    PDH_STATUS status = PdhOpenQuery(nullptr, 0, &m_hQuery);
+    if (status != ERROR_SUCCESS) {
+        qCDebug(lcMonitor) << "Failed to open PDH query";
+        m_hQuery = nullptr;
+        return;
+    }
+
+    // 添加CPU计数器
+    status = PdhAddCounter(m_hQuery, L"\\Processor(_Total)\\% Processor Time", 0, &m_hCpuTotal);
+    if (status != ERROR_SUCCESS) {
+        qCDebug(lcMonitor) << "Failed to add CPU counter";
+    }
+
+    // 添加每核心计数器（通配符实例，一次收集得到所有核心）
+    status = PdhAddCounter(m_hQuery, L"\\Processor Information(*)\\% Processor Time", 0, &m_hCoreTime);
+    if (status != ERROR_SUCCESS) {
+        qCDebug(lcMonitor) << "Failed to add per-core CPU counter";
+        m_hCoreTime = nullptr;
+    }
+    status = PdhAddCounter(m_hQuery, L"\\Processor Information(*)\\Processor Frequency", 0, &m_hCoreFrequency);
+    if (status != ERROR_SUCCESS) {
+        qCDebug(lcMonitor) << "Failed to add per-core frequency counter";
+        m_hCoreFrequency = nullptr;
+    }
+
+    // 收集第一个样本
+    status = PdhCollectQueryData(m_hQuery);
+    if (status != ERROR_SUCCESS) {
+        qCDebug(lcMonitor) << "Failed to collect initial PDH data";
+    }
+}
+
+void MetricsSampler::uninitializePdh() {
+    if (m_hQuery) {
+        PdhCloseQuery(m_hQuery);
+        m_hQuery = nullptr;
+    }
+}
+
+double MetricsSampler::getCpuUsagePdh() {
+    if (!m_hQuery || !m_hCpuTotal) {
+        return getCpuUsage(); // 回退到基本方法
+    }
+
+    // 计数器数据已由sample统一收集
+    PDH_FMT_COUNTERVALUE value;
+    PDH_STATUS status = PdhGetFormattedCounterValue(m_hCpuTotal, PDH_FMT_DOUBLE, nullptr, &value);
+    if (status != ERROR_SUCCESS) {
+        return getCpuUsage();
+    }
+
+    return value.doubleValue;
+}
+
+namespace {
+    // Processor Information的实例名为"处理器组,编号"，汇总实例（_Total、0,_Total）返回-1
+    int pdhCoreSortKey(const wchar_t* name) {
+        const QString instance = QString::fromWCharArray(name);
+        if (instance.contains(QLatin1String("_Total"))) {
+            return -1;
+        }
+        bool groupOk = false;
+        bool indexOk = false;
+        const int comma = instance.indexOf(QLatin1Char(','));
+        const int group = comma >= 0 ? instance.left(comma).toInt(&groupOk) : 0;
+        const int index = instance.mid(comma + 1).toInt(&indexOk);
+        if ((comma >= 0 && !groupOk) || !indexOk) {
+            return -1;
+        }
+        return group * 1024 + index;
+    }
+}
+
+/**
+ * 读取通配符计数器的所有实例，按处理器组和编号排序后写入values
+ */
+bool MetricsSampler::readPdhCoreArray(PDH_HCOUNTER counter, QVector<float>& values) {
+    if (!counter) {
+        return false;
+    }
+
+    DWORD bufferSize = 0;
+    DWORD itemCount = 0;
+    PDH_STATUS status = PdhGetFormattedCounterArrayW(counter, PDH_FMT_DOUBLE, &bufferSize, &itemCount, nullptr);
+    if (status != PDH_MORE_DATA) {
+        return false;
+    }
+    if (m_pdhArrayBuffer.size() < static_cast<qsizetype>(bufferSize)) {
+        m_pdhArrayBuffer.resize(static_cast<qsizetype>(bufferSize));
+    }
+    auto* items = reinterpret_cast<PDH_FMT_COUNTERVALUE_ITEM_W*>(m_pdhArrayBuffer.data());
+    status = PdhGetFormattedCounterArrayW(counter, PDH_FMT_DOUBLE, &bufferSize, &itemCount, items);
+    if (status != ERROR_SUCCESS) {
+        return false;
+    }
+
+    m_pdhCoreValues.clear();
+    for (DWORD i = 0; i < itemCount; ++i) {
+        const int key = pdhCoreSortKey(items[i].szName);
+        if (key < 0) {
+            continue;
+        }
+        const bool valid = items[i].FmtValue.CStatus == ERROR_SUCCESS;
+        m_pdhCoreValues.emplace_back(key, valid ? static_cast<float>(items[i].FmtValue.doubleValue) : 0.0f);
+    }
+    std::sort(m_pdhCoreValues.begin(), m_pdhCoreValues.end());
+
+    values.resize(static_cast<qsizetype>(m_pdhCoreValues.size()));
+    for (size_t i = 0; i < m_pdhCoreValues.size(); ++i) {
+        values[static_cast<qsizetype>(i)] = m_pdhCoreValues[i].second;
+    }
+    return true;
+}
+
+void MetricsSampler::getPerCoreInfoPdh(QVector<float>& usage, QVector<float>& frequencyMhz) {
+    if (!m_hQuery || !readPdhCoreArray(m_hCoreTime, usage)) {
+        usage.clear();
+        frequencyMhz.clear();
+        return;
+    }
+    for (float& value : usage) {
+        value = qBound(0.0f, value, 100.0f);
+    }
+    // Processor Frequency在部分虚拟机上不可用，此时频率全部为0
+    if (!readPdhCoreArray(m_hCoreFrequency, frequencyMhz) || frequencyMhz.size() != usage.size()) {
+        frequencyMhz.fill(0.0f, usage.size());
+    }
+}
+
+void MetricsSampler::getMemoryInfo(qint64& total, qint64& used) {
+    MEMORYSTATUSEX memInfo;
+    memInfo.dwLength = sizeof(MEMORYSTATUSEX);
+    if (GlobalMemoryStatusEx(&memInfo)) {
+        total = memInfo.ullTotalPhys / (1024 * 1024); // MB
+        used = (memInfo.ullTotalPhys - memInfo.ullAvailPhys) / (1024 * 1024); // MB
+    } else {
+        total = 0; 
+        used = 0;
+    }
+}
+
+/**
+ * GetSystemTimes的内核时间包含空闲时间，总时间片为内核时间加用户时间
+ */
+double MetricsSampler::getCpuUsage() {
+    FILETIME idleTime, kernelTime, userTime;
+    if (!GetSystemTimes(&idleTime, &kernelTime, &userTime)) {
+        return m_lastCpuUsage;
+    }
+
+    auto ticks = [](const FILETIME& time) {
+        return (quint64(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+    };
+    return updateCpuUsage(ticks(kernelTime) + ticks(userTime), ticks(idleTime));
+}
+#elif defined(Q_OS_LINUX)
+/**
+ * /proc/stat第一行为所有CPU的累计时间片：user nice system idle iowait irq softirq steal ...
+ */
+double MetricsSampler::getCpuUsage() {
+    char buffer[512];   // 只需要第一行，不复制后面每个核心和中断的统计
+    if (m_statFile.readHead(buffer, sizeof(buffer)) <= 0) {
+        return m_lastCpuUsage;
+    }
+
+    quint64 total = 0;
+    quint64 idle = 0;
+    if (!ProcFs::parseCpuSummary(buffer, total, idle)) {
+        return m_lastCpuUsage;
+    }
+    return updateCpuUsage(total, idle);
+}
+
+/**
+ * 一次pread读取整个/proc/stat，解析"cpu"汇总行和所有"cpuN"行；
+ * 离线的核心不出现在文件中，其计数器保持不变，使用率为0。
+ * 当前频率来自cpufreq的scaling_cur_freq（kHz），文件在首次发现该核心时打开并保持常开
+ */
+void MetricsSampler::getPerCoreInfo(QVector<float>& usage, QVector<float>& frequencyMhz, double* totalUsage) {
+    if (!m_statFile.readAll(m_readBuffer)) {
+        return;
+    }
+
+    quint64 total = 0;
+    quint64 idle = 0;
+    if (ProcFs::parseCpuStat(m_readBuffer.data(), total, idle, m_coreTotal, m_coreIdle) && totalUsage) {
+        *totalUsage = updateCpuUsage(total, idle);
+    }
+
+    const size_t coreCount = m_coreTotal.size();
+    if (m_prevCoreTotal.size() != coreCount) {
+        // 第一次采样或核心数变化：以本次为基准
+        m_prevCoreTotal = m_coreTotal;
+        m_prevCoreIdle = m_coreIdle;
+    }
+
+    usage.resize(static_cast<qsizetype>(coreCount));
+    ProcFs::computeCoreUsage(m_coreTotal.data(), m_coreIdle.data(), m_prevCoreTotal.data(),
+                             m_prevCoreIdle.data(), usage.data(), coreCount);
+    std::copy(m_coreTotal.begin(), m_coreTotal.end(), m_prevCoreTotal.begin());
+    std::copy(m_coreIdle.begin(), m_coreIdle.end(), m_prevCoreIdle.begin());
+
+    while (m_coreFrequencyFiles.size() < coreCount) {
+        char path[96];
+        std::snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%zu/cpufreq/scaling_cur_freq",
+                      m_coreFrequencyFiles.size());
+        m_coreFrequencyFiles.emplace_back(path);
+    }
+
+    frequencyMhz.resize(static_cast<qsizetype>(coreCount));
+    char buffer[32];
+    for (size_t core = 0; core < coreCount; ++core) {
+        quint64 frequencyKhz = 0;
+        if (m_coreFrequencyFiles[core].readHead(buffer, sizeof(buffer)) > 0) {
+            ProcFs::Scanner(buffer).readUInt(frequencyKhz);
+        }
+        frequencyMhz[static_cast<qsizetype>(core)] = static_cast<float>(frequencyKhz / 1000.0);
+    }
+}
+
+void MetricsSampler::getMemoryInfo(qint64& total, qint64& used) {
+    total = 0;
+    used = 0;
+
+    char buffer[512];   // MemTotal、MemFree、MemAvailable、Buffers、Cached都在最前面
+    if (m_meminfoFile.readHead(buffer, sizeof(buffer)) <= 0) {
+        return;
+    }
+
+    quint64 totalKb = 0;
+    quint64 availableKb = 0;
+    if (!ProcFs::parseMemInfo(buffer, totalKb, availableKb)) {
+        return;
+    }
+
+    total = static_cast<qint64>(totalKb / 1024); // MB
+    used = static_cast<qint64>((totalKb - qMin(availableKb, totalKb)) / 1024); // MB
+}
+
+#else
+// 其他平台暂无实现，各项数据为0
+double MetricsSampler::getCpuUsage() {
+    return 0.0;
+}
+
+void MetricsSampler::getMemoryInfo(qint64& total, qint64& used) {
+    total = 0;
+    used = 0;
+}
+#endif
+
@@ -0,0 +1,226 @@
+#include "Utils/NetworkSampler.h"
+#include <algorithm>
+
+#ifdef Q_OS_WIN
+#include <winsock2.h>
+#include <windows.h>
+#include <iphlpapi.h>
+#endif
+
+#ifdef Q_OS_LINUX
+#include <cstdio>
+#endif
+
+NetworkSampler::NetworkSampler()
+    : m_ignoredPrefixes(defaultIgnoredPrefixes())
+    , m_elapsedMs(0)
+    , m_generation(0)
+    , m_uploadKBps(0.0)
+    , m_downloadKBps(0.0)
+#ifdef Q_OS_LINUX
+    , m_netDevFile("/proc/net/dev")
+#endif
+{
+}
+
+NetworkSampler::~NetworkSampler() = default;
+
+/**
+ * 容器和虚拟机的接口（docker0、vethXXX、br-XXX、virbr0、Hyper-V的vEthernet）
+ * 转发的流量同时经过物理网卡，计入总量会重复计数
+ */
+QStringList NetworkSampler::defaultIgnoredPrefixes() {
+    return {QStringLiteral("docker"), QStringLiteral("veth"), QStringLiteral("br-"),
+            QStringLiteral("virbr"), QStringLiteral("vEthernet")};
+}
+
+void NetworkSampler::setIgnoredPrefixes(const QStringList& prefixes) {
+    m_ignoredPrefixes = prefixes;
+    for (Entry& entry : m_entries) {
+        entry.ignored = entry.loopback || isIgnored(entry.name);
+    }
+}
+
+bool NetworkSampler::isIgnored(const QString& name) const {
+    for (const QString& prefix : m_ignoredPrefixes) {
+        if (!prefix.isEmpty() && name.startsWith(prefix, Qt::CaseInsensitive)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * 64位计数器在可见的时间内不会回绕，变小只可能是接口被重建或驱动重置了计数器；
+ * 按回绕计算会得到一个接近2^32的差值，在曲线上形成一个尖峰
+ */
+quint64 NetworkSampler::counterDelta(quint64 current, quint64 previous, int counterBits) {
+    if (current >= previous) {
+        return current - previous;
+    }
+    if (counterBits == 32 && previous <= 0xFFFFFFFFull && current <= 0xFFFFFFFFull) {
+        return current + (0x100000000ull - previous);   // 32位计数器回绕
+    }
+    return 0;   // 计数器重置，调用方以本次读数为新基准
+}
+
+bool NetworkSampler::sample() {
+    // 读取失败时不重新计时，下一次成功读取的间隔从上一次成功读取算起，速率不会被放大
+    m_elapsedMs = m_clock.isValid() ? m_clock.elapsed() : 0;
+    m_generation++;
+    if (!readCounters()) {
+        return false;
+    }
+    m_clock.start();
+
+    double upload = 0.0;
+    double download = 0.0;
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (it->generation != m_generation) {
+            it = m_entries.erase(it);   // 接口已移除
+            continue;
+        }
+        if (!it->ignored) {
+            upload += it->uploadKBps;
+            download += it->downloadKBps;
+        }
+        ++it;
+    }
+    m_uploadKBps = upload;
+    m_downloadKBps = download;
+    return true;
+}
+
+NetworkSampler::EntryMap::iterator NetworkSampler::addEntry(const QByteArray& key, const QString& name, bool loopback) {
+    Entry entry;
+    entry.name = name;
+    entry.loopback = loopback;
+    entry.ignored = loopback || isIgnored(name);
+    return m_entries.insert(key, entry);
+}
+
+void NetworkSampler::updateCounters(Entry& entry, quint64 rxBytes, quint64 txBytes) {
+    if (entry.hasBaseline && m_elapsedMs > 0) {
+        const double scale = 1000.0 / (m_elapsedMs * 1024.0);
+        entry.downloadKBps = counterDelta(rxBytes, entry.rxBytes) * scale;
+        entry.uploadKBps = counterDelta(txBytes, entry.txBytes) * scale;
+    } else {
+        entry.downloadKBps = 0.0;
+        entry.uploadKBps = 0.0;
+    }
+    entry.rxBytes = rxBytes;
+    entry.txBytes = txBytes;
+    entry.hasBaseline = true;
+    entry.generation = m_generation;
+}
+
+/**
+ * partial_sort取前count个，只有几个到几十个接口，不需要nth_element
+ */
+void NetworkSampler::topInterfaces(int count, QVector<InterfaceThroughput>& out) {
+    m_ranking.clear();
+    for (const Entry& entry : m_entries) {
+        if (!entry.ignored) {
+            m_ranking.emplace_back(entry.uploadKBps + entry.downloadKBps, &entry);
+        }
+    }
+
+    const size_t n = std::min<size_t>(m_ranking.size(), static_cast<size_t>(qBound(0, count, kMaxTopCount)));
+    std::partial_sort(m_ranking.begin(), m_ranking.begin() + n, m_ranking.end(),
+                      [](const std::pair<double, const Entry*>& a, const std::pair<double, const Entry*>& b) {
+                          // 速率相同（通常都为0）时按名称排序，避免列表顺序跳动
+                          return a.first != b.first ? a.first > b.first : a.second->name < b.second->name;
+                      });
+
+    out.resize(static_cast<qsizetype>(n));
+    for (size_t i = 0; i < n; ++i) {
+        const Entry& entry = *m_ranking[i].second;
+        InterfaceThroughput& item = out[static_cast<qsizetype>(i)];
+        item.name = entry.name;
+        item.uploadKBps = entry.uploadKBps;
+        item.downloadKBps = entry.downloadKBps;
+        item.txBytes = entry.txBytes;
+        item.rxBytes = entry.rxBytes;
+    }
+}
+
+#ifdef Q_OS_WIN
+/**
+ * GetIfTable2的收发计数为64位（GetIfTable的dwInOctets为32位，万兆网卡几秒就回绕）。
+ * NDIS过滤驱动会为同一块网卡生成额外的条目，只统计非过滤条目，否则流量重复计数
+ */
+bool NetworkSampler::readCounters() {
+    PMIB_IF_TABLE2 table = nullptr;
+    if (GetIfTable2(&table) != NO_ERROR) {
+        return false;
+    }
+    for (ULONG i = 0; i < table->NumEntries; ++i) {
+        const MIB_IF_ROW2& row = table->Table[i];
+        if (row.InterfaceAndOperStatusFlags.FilterInterface || row.OperStatus != IfOperStatusUp) {
+            continue;
+        }
+        const QByteArray key = QByteArray::fromRawData(reinterpret_cast<const char*>(&row.InterfaceLuid),
+                                                       sizeof(row.InterfaceLuid));
+        auto it = m_entries.find(key);
+        if (it == m_entries.end()) {
+            it = addEntry(QByteArray(key.constData(), key.size()), QString::fromWCharArray(row.Alias),
+                          row.Type == IF_TYPE_SOFTWARE_LOOPBACK);
+        }
+        updateCounters(*it, row.InOctets, row.OutOctets);
+    }
+    FreeMibTable(table);
+    return true;
+}
+#elif defined(Q_OS_LINUX)
+namespace {
+    // /sys/class/net/<name>/type为ARPHRD类型，772为回环
+    bool isLoopbackInterface(const char* name, qsizetype length) {
+        char path[128];
+        std::snprintf(path, sizeof(path), "/sys/class/net/%.*s/type", static_cast<int>(length), name);
+        ProcFs::ProcFile file(path);
+        char buffer[16];
+        quint64 type = 0;
+        if (file.readHead(buffer, sizeof(buffer)) > 0 && ProcFs::Scanner(buffer).readUInt(type)) {
+            return type == 772;
+        }
+        return length == 2 && name[0] == 'l' && name[1] == 'o';
+    }
+}
+
+/**
+ * /proc/net/dev每个接口一行："名称: 接收字节 包 错误 丢弃 fifo frame compressed multicast 发送字节 ..."
+ * 64位内核上计数器为64位；接口名只在第一次出现时复制
+ */
+bool NetworkSampler::readCounters() {
+    if (!m_netDevFile.readAll(m_readBuffer)) {
+        return false;
+    }
+
+    // 前两行为表头
+    ProcFs::Scanner scanner(m_readBuffer.data());
+    scanner.nextLine();
+    while (scanner.nextLine()) {
+        scanner.skipBlanks();
+        const char* name = scanner.position();
+        if (!scanner.skipPast(':')) {
+            continue;
+        }
+        const qsizetype nameLength = scanner.position() - 1 - name;
+        const quint64 rxBytes = scanner.readUInt();
+        scanner.skipFields(7);
+        const quint64 txBytes = scanner.readUInt();
+
+        auto it = m_entries.find(QByteArray::fromRawData(name, nameLength));
+        if (it == m_entries.end()) {
+            it = addEntry(QByteArray(name, nameLength), QString::fromLatin1(name, nameLength),
+                          isLoopbackInterface(name, nameLength));
+        }
+        updateCounters(*it, rxBytes, txBytes);
+    }
+    return true;
+}
+#else
+bool NetworkSampler::readCounters() {
+    return false;
+}
+#endif
@@ -0,0 +1,524 @@
+#include "Utils/PerformanceMonitor.h"
+#include "Utils/Logger.h"
+#include "Utils/LogCategories.h"
+#include "Utils/SystemInfoCollector.h"
+#include <QCoreApplication>
+#include <QDeadlineTimer>
+#include <QDebug>
+#include <QPointer>
+#include <algorithm>
+
+namespace {
+    constexpr int kSamplingReportInterval = 300;   // 每隔多少次采样记录一次开销统计
+    constexpr int kMinIntervalMs = 100;            // 订阅周期下限
+    constexpr int kAlignSlackMs = 50;              // 相差不到该时间的来源合并到同一次采样
+    constexpr int kDeliverySlackMs = 100;          // 订阅者提前该时间内收到快照也算到期
+    constexpr double kFastScale = 0.5;             // 数值剧烈变化或被查看时周期缩短为一半
+    constexpr double kSlowScale = 4.0;             // 长时间平稳时周期最多放慢到4倍
+    constexpr double kVolatileChange = 10.0;       // 相邻两次采样相差超过该百分点视为剧烈变化
+    constexpr double kQuietChange = 2.0;           // 相差不到该百分点视为平稳
+    constexpr int kQuietSamplesPerStep = 5;        // 连续平稳多少次后周期加倍
+    constexpr double kNetworkFloorKBps = 64.0;     // 网络按相对变化计算，低于该速率的波动视为噪声
+    constexpr int kVolumesMinIntervalMs = 10000;   // 挂载点容量变化缓慢，刷新周期不短于该值
+    // 启动时从归档恢复的时长，即MetricsHistory最粗档位覆盖的时间
+    constexpr qint64 kHistoryRestoreMs = qint64(MetricsHistory::kQuarterHourCapacity) * 15 * 60 * 1000;
+
+    constexpr MetricSource kSources[] = {
+        MetricSource::Cpu, MetricSource::Memory, MetricSource::Disk,
+        MetricSource::Network, MetricSource::Volumes, MetricSource::CpuCores,
+        MetricSource::Processes
+    };
+
+    QPointer<PerformanceMonitor> s_instance;
+}
+
+/**
+ * 实例挂在QCoreApplication下，随应用程序一起销毁
+ */
+PerformanceMonitor& PerformanceMonitor::instance() {
+    if (!s_instance) {
+        s_instance = new PerformanceMonitor(QCoreApplication::instance());
+    }
+    return *s_instance;
+}
+
+PerformanceMonitor* PerformanceMonitor::existingInstance() {
+    return s_instance.data();
+}
+
+PerformanceMonitor::PerformanceMonitor(QObject* parent)
+    : QThread(parent)
+    , m_nextSubscriptionId(1)
+    , m_running(true)
+    , m_scheduleChanged(false)
+    , m_networkFilterChanged(false)
+    , m_pendingArchiveRetentionDays(MetricsArchive::kDefaultRetentionDays)
+    , m_archiveRetentionChanged(false)
+{
+    setObjectName("PerformanceMonitor");
+    for (int i = 0; i < kSourceCount; ++i) {
+        m_nextDueMs[i] = -1;
+        m_cadenceScale[i] = 1.0;
+        m_quietSamples[i] = 0;
+        m_lastActivity[i] = -1.0;
+    }
+    m_deliveryClock.start();
+}
+
+PerformanceMonitor::~PerformanceMonitor() {
+    for (auto& subscription : m_subscriptions) {
+        disconnect(subscription.receiverConnection);
+    }
+    stopMonitoring();
+    wait();
+}
+
+MetricSubscriptionId PerformanceMonitor::subscribe(QObject* receiver, MetricSources sources, int intervalMs,
+                                                   std::function<void(const PerformanceSnapshot&)> callback) {
+    const MetricSubscriptionId id = m_nextSubscriptionId++;
+
+    Subscription subscription;
+    subscription.receiver = receiver;
+    subscription.sources = sources;
+    subscription.intervalMs = qMax(kMinIntervalMs, intervalMs);
+    subscription.callback = std::move(callback);
+    if (receiver) {
+        subscription.receiverConnection = connect(receiver, &QObject::destroyed, this, [this, id]() {
+            unsubscribe(id);
+        });
+    }
+    m_subscriptions.insert(id, subscription);
+
+    updateSchedule();
+    if (!isRunning()) {
+        start(QThread::LowPriority);
+    }
+    return id;
+}
+
+void PerformanceMonitor::unsubscribe(MetricSubscriptionId id) {
+    auto it = m_subscriptions.find(id);
+    if (it == m_subscriptions.end()) {
+        return;
+    }
+    disconnect(it->receiverConnection);
+    m_subscriptions.erase(it);
+    updateSchedule();
+}
+
+void PerformanceMonitor::updateSubscription(MetricSubscriptionId id, MetricSources sources, int intervalMs) {
+    auto it = m_subscriptions.find(id);
+    if (it == m_subscriptions.end()) {
+        return;
+    }
+    intervalMs = qMax(kMinIntervalMs, intervalMs);
+    if (it->sources == sources && it->intervalMs == intervalMs) {
+        return;
+    }
+    it->sources = sources;
+    it->intervalMs = intervalMs;
+    updateSchedule();
+}
+
+void PerformanceMonitor::setSubscriptionActive(MetricSubscriptionId id, bool active) {
+    auto it = m_subscriptions.find(id);
+    if (it == m_subscriptions.end() || it->active == active) {
+        return;
+    }
+    it->active = active;
+    if (active) {
+        it->lastDeliveredMs = -1;   // 恢复后的第一份快照立即交付
+    }
+    updateSchedule();
+}
+
+void PerformanceMonitor::setSubscriptionAdaptive(MetricSubscriptionId id, bool adaptive) {
+    auto it = m_subscriptions.find(id);
+    if (it == m_subscriptions.end() || it->adaptive == adaptive) {
+        return;
+    }
+    it->adaptive = adaptive;
+    updateSchedule();
+}
+
+int PerformanceMonitor::longestSampleInterval(int intervalMs, bool adaptive) {
+    intervalMs = qMax(kMinIntervalMs, intervalMs);
+    return adaptive ? static_cast<int>(intervalMs * kSlowScale) : intervalMs;
+}
+
+void PerformanceMonitor::setSubscriptionFocused(MetricSubscriptionId id, bool focused) {
+    auto it = m_subscriptions.find(id);
+    if (it == m_subscriptions.end() || it->focused == focused) {
+        return;
+    }
+    it->focused = focused;
+    updateSchedule();
+}
+
+/**
+ * 过滤规则由下一次网络采样在采样线程中应用，NetworkSampler本身不加锁
+ */
+void PerformanceMonitor::setIgnoredInterfaces(const QStringList& prefixes) {
+    QMutexLocker locker(&m_scheduleMutex);
+    m_pendingNetworkFilter = prefixes;
+    m_networkFilterChanged = true;
+}
+
+/**
+ * 保留天数由采样线程在下一轮调度时应用，旧段在下一次滚动时清理
+ */
+void PerformanceMonitor::setArchiveRetentionDays(int days) {
+    QMutexLocker locker(&m_scheduleMutex);
+    m_pendingArchiveRetentionDays = days;
+    m_archiveRetentionChanged = true;
+}
+
+/**
+ * 每个来源的采样周期取活动订阅者中最短的周期，没有订阅者（或订阅者都被隐藏而暂停）的来源不采样；
+ * 同时汇总各来源能否按自适应规则加快或放慢
+ */
+void PerformanceMonitor::updateSchedule() {
+    SourceSchedule schedule[kSourceCount];
+    for (const Subscription& subscription : std::as_const(m_subscriptions)) {
+        if (!subscription.active) {
+            continue;
+        }
+        for (int i = 0; i < kSourceCount; ++i) {
+            if (!subscription.sources.testFlag(kSources[i])) {
+                continue;
+            }
+            SourceSchedule& source = schedule[i];
+            if (source.intervalMs == 0 || subscription.intervalMs < source.intervalMs) {
+                source.intervalMs = subscription.intervalMs;
+            }
+            if (subscription.adaptive) {
+                source.adaptive = true;
+                source.focused = source.focused || subscription.focused;
+            } else {
+                source.fixed = true;
+            }
+        }
+    }
+
+    for (int i = 0; i < kSourceCount; ++i) {
+        if (kSources[i] == MetricSource::Volumes && schedule[i].intervalMs > 0) {
+            schedule[i].intervalMs = qMax(schedule[i].intervalMs, kVolumesMinIntervalMs);
+            schedule[i].adaptive = false;   // 容量周期固定，不随查看加快
+        }
+    }
+
+    QMutexLocker locker(&m_scheduleMutex);
+    for (int i = 0; i < kSourceCount; ++i) {
+        m_sourceSchedule[i] = schedule[i];
+    }
+    m_scheduleChanged = true;
+    m_scheduleCondition.wakeAll();
+}
+
+void PerformanceMonitor::stopMonitoring() {
+    QMutexLocker locker(&m_scheduleMutex);
+    m_running = false;
+    m_scheduleCondition.wakeAll();
+}
+
+PerformanceSnapshot PerformanceMonitor::latestSnapshot() const {
+    QMutexLocker locker(&m_dataMutex);
+    return m_latest;
+}
+
+SamplingStats PerformanceMonitor::getSamplingStats() const {
+    QMutexLocker locker(&m_dataMutex);
+    return m_samplingStats;
+}
+
+/**
+ * 自适应倍率只对有自适应订阅者的来源生效；有固定周期订阅者时只加快不放慢，被查看时至少加快到一半
+ */
+int PerformanceMonitor::effectiveInterval(int source) const {
+    const SourceSchedule& schedule = m_sourceSchedule[source];
+    if (!schedule.adaptive) {
+        return schedule.intervalMs;
+    }
+    double scale = m_cadenceScale[source];
+    if (schedule.fixed) {
+        scale = qMin(scale, 1.0);
+    }
+    if (schedule.focused) {
+        scale = qMin(scale, kFastScale);
+    }
+    return qMax(kMinIntervalMs, static_cast<int>(schedule.intervalMs * scale));
+}
+
+/**
+ * 按相邻两次采样的变化调整各来源的周期倍率：剧烈变化立即加快，
+ * 连续平稳时每kQuietSamplesPerStep次加倍，直到kSlowScale；挂载点容量不参与
+ */
+void PerformanceMonitor::updateCadence(MetricSources sources, const PerformanceData& data) {
+    for (int i = 0; i < kSourceCount; ++i) {
+        const MetricSource source = kSources[i];
+        if (!sources.testFlag(source) || source == MetricSource::Volumes) {
+            continue;
+        }
+
+        double value = 0.0;
+        switch (source) {
+            case MetricSource::Cpu: value = data.cpuUsage; break;
+            case MetricSource::Memory: value = data.memoryUsage; break;
+            case MetricSource::Disk: value = data.diskUsage; break;
+            case MetricSource::Network: value = data.networkUpload + data.networkDownload; break;
+            case MetricSource::CpuCores:
+                // 最忙的核心
+                for (float usage : data.coreUsage) {
+                    value = qMax(value, double(usage));
+                }
+                break;
+            case MetricSource::Processes:
+                value = data.topCpuProcesses.isEmpty() ? 0.0 : data.topCpuProcesses.first().cpuPercent;
+                break;
+            default: break;
+        }
+        const double previous = m_lastActivity[i];
+        m_lastActivity[i] = value;
+        if (previous < 0.0) {
+            continue;
+        }
+
+        double change = qAbs(value - previous);
+        if (source == MetricSource::Network) {
+            change = change / qMax(kNetworkFloorKBps, qMax(value, previous)) * 100.0;
+        }
+
+        if (change >= kVolatileChange) {
+            m_cadenceScale[i] = kFastScale;
+            m_quietSamples[i] = 0;
+        } else if (change < kQuietChange) {
+            if (++m_quietSamples[i] >= kQuietSamplesPerStep) {
+                m_cadenceScale[i] = qMin(m_cadenceScale[i] * 2.0, kSlowScale);
+                m_quietSamples[i] = 0;
+            }
+        } else {
+            m_cadenceScale[i] = 1.0;
+            m_quietSamples[i] = 0;
+        }
+    }
+}
+
+/**
+ * 采样线程：等到最早到期的来源，把到期时间相近的来源合并为一次采样；
+ * 没有任何订阅时无限期休眠，直到订阅变化或停止。
+ * 截止时间在单调时钟上按周期累加，唤醒延迟和采样耗时不会累积成漂移
+ */
+void PerformanceMonitor::run() {
+    m_sampleClock.start();
+    openArchive();
+
+    QMutexLocker locker(&m_scheduleMutex);
+    while (m_running) {
+        const qint64 now = m_sampleClock.elapsed();
+
+        if (m_archiveRetentionChanged) {
+            m_archive.setRetentionDays(m_pendingArchiveRetentionDays);
+            m_archiveRetentionChanged = false;
+        }
+
+        if (m_scheduleChanged) {
+            // 新订阅的来源立即采样，周期缩短的来源提前到新的周期内
+            for (int i = 0; i < kSourceCount; ++i) {
+                if (m_sourceSchedule[i].intervalMs == 0) {
+                    m_nextDueMs[i] = -1;
+                } else if (m_nextDueMs[i] < 0) {
+                    m_nextDueMs[i] = now;
+                } else {
+                    m_nextDueMs[i] = qMin(m_nextDueMs[i], now + effectiveInterval(i));
+                }
+            }
+            m_scheduleChanged = false;
+        }
+
+        MetricSources due;
+        qint64 deadline = -1;   // 本次采样中最早的截止时间，用于统计调度偏差
+        for (int i = 0; i < kSourceCount; ++i) {
+            if (m_nextDueMs[i] >= 0 && m_nextDueMs[i] <= now + kAlignSlackMs) {
+                due |= kSources[i];
+                if (deadline < 0 || m_nextDueMs[i] < deadline) {
+                    deadline = m_nextDueMs[i];
+                }
+            }
+        }
+
+        if (due.toInt() != 0) {
+            const double jitterUs = m_sampleClock.nsecsElapsed() / 1000.0 - deadline * 1000.0;
+            locker.unlock();
+            collectPerformanceData(due, jitterUs);
+            locker.relock();
+
+            // 倍率已按本次采样更新；落后超过一个周期时（系统休眠、调试暂停）从当前时间重新对齐，不补采
+            const qint64 sampledAt = m_sampleClock.elapsed();
+            int shortestInterval = 0;
+            for (int i = 0; i < kSourceCount; ++i) {
+                if (m_nextDueMs[i] < 0 || m_sourceSchedule[i].intervalMs == 0) {
+                    continue;   // 采样期间被退订，下一轮调度时清除
+                }
+                const int interval = effectiveInterval(i);
+                shortestInterval = shortestInterval == 0 ? interval : qMin(shortestInterval, interval);
+                if (!due.testFlag(kSources[i])) {
+                    continue;
+                }
+                m_nextDueMs[i] += interval;
+                if (m_nextDueMs[i] <= sampledAt) {
+                    m_nextDueMs[i] = sampledAt + interval;
+                }
+            }
+            {
+                QMutexLocker dataLocker(&m_dataMutex);
+                m_samplingStats.shortestIntervalMs = shortestInterval;
+            }
+            continue;
+        }
+
+        qint64 nextWake = -1;
+        for (int i = 0; i < kSourceCount; ++i) {
+            if (m_nextDueMs[i] >= 0 && (nextWake < 0 || m_nextDueMs[i] < nextWake)) {
+                nextWake = m_nextDueMs[i];
+            }
+        }
+        if (nextWake < 0) {
+            m_scheduleCondition.wait(&m_scheduleMutex);
+        } else {
+            // 高精度定时，避免系统把唤醒合并到粗粒度的定时器节拍上
+            m_scheduleCondition.wait(&m_scheduleMutex, QDeadlineTimer(nextWake - now, Qt::PreciseTimer));
+        }
+    }
+    m_archive.close();
+}
+
+/**
+ * 打开归档并把最近的记录回放到内存历史中，重启后历史曲线能接上之前的数据
+ */
+void PerformanceMonitor::openArchive() {
+    if (!m_archive.open(MetricsArchive::defaultDirectory())) {
+        qCDebug(lcMonitor) << "Metrics archive unavailable, history will not persist";
+        return;
+    }
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    const qint64 restored = MetricsArchiveReader(m_archive.directory()).replay(
+        nowMs - kHistoryRestoreMs, nowMs, [this](const MetricsArchiveRecord& record) { m_history.record(record); });
+    qCDebug(lcMonitor) << "Restored" << restored << "archived samples";
+}
+
+/**
+ * 只采样到期的来源，其余字段沿用上一份快照，然后发布新快照并交给界面线程分发
+ */
+void PerformanceMonitor::collectPerformanceData(MetricSources sources, double jitterUs) {
+    QElapsedTimer sampleTimer;
+    sampleTimer.start();
+
+    PerformanceData data;
+    {
+        QMutexLocker locker(&m_dataMutex);
+        if (m_latest) {
+            data = *m_latest;
+        }
+    }
+    data.updatedSources = sources;
+    data.timestamp = QDateTime::currentDateTime();
+
+    if (sources.testFlag(MetricSource::Network)) {
+        QMutexLocker locker(&m_scheduleMutex);
+        if (m_networkFilterChanged) {
+            m_sampler.setIgnoredInterfaces(m_pendingNetworkFilter);
+            m_networkFilterChanged = false;
+        }
+    }
+    m_sampler.sample(sources, data);
+
+    if (sources.testFlag(MetricSource::Volumes)) {
+        // 各挂载点容量只由采样线程读取；总容量为所有本地文件系统之和
+        data.volumes = SystemInfoCollector::getInstance().getDiskSpace();
+        qint64 totalBytes = 0;
+        qint64 availableBytes = 0;
+        for (auto it = data.volumes.cbegin(); it != data.volumes.cend(); ++it) {
+            totalBytes += it->first;
+            availableBytes += it->second;
+        }
+        data.totalDisk = totalBytes / (1024 * 1024 * 1024); // GB
+        data.usedDisk = (totalBytes - availableBytes) / (1024 * 1024 * 1024); // GB
+    }
+    updateCadence(sources, data);
+    const MetricsArchiveRecord record = toArchiveRecord(data);
+    m_archive.append(record);
+    m_history.record(record);
+    const PerformanceSnapshot snapshot = std::make_shared<const PerformanceData>(std::move(data));
+
+    const double costUs = sampleTimer.nsecsElapsed() / 1000.0;
+    SamplingStats stats;
+    {
+        QMutexLocker locker(&m_dataMutex);
+        m_latest = snapshot;
+        m_samplingStats.sampleCount++;
+        m_samplingStats.lastCostUs = costUs;
+        m_samplingStats.avgCostUs += (costUs - m_samplingStats.avgCostUs) / m_samplingStats.sampleCount;
+        m_samplingStats.maxCostUs = qMax(m_samplingStats.maxCostUs, costUs);
+        m_samplingStats.lastJitterUs = jitterUs;
+        m_samplingStats.avgJitterUs += (qAbs(jitterUs) - m_samplingStats.avgJitterUs) / m_samplingStats.sampleCount;
+        m_samplingStats.maxJitterUs = qMax(m_samplingStats.maxJitterUs, qAbs(jitterUs));
+        stats = m_samplingStats;
+    }
+
+    if (stats.sampleCount % kSamplingReportInterval == 0) {
+        LOG_CEVENT(Logger::Debug, lcMonitor, QString(), "性能采样开销: %1 次, 平均 %2us, 最大 %3us, 调度偏差平均 %4us, 最大 %5us",
+                   stats.sampleCount, stats.avgCostUs, stats.maxCostUs, stats.avgJitterUs, stats.maxJitterUs);
+    }
+
+    // 本对象属于界面线程，排队调用在界面线程中分发；对象销毁后排队的调用自动丢弃
+    QMetaObject::invokeMethod(this, [this, snapshot]() { deliver(snapshot); }, Qt::QueuedConnection);
+}
+
+/**
+ * 所有字段都按当前值写入，fields只标记本次采样更新过的来源
+ */
+MetricsArchiveRecord PerformanceMonitor::toArchiveRecord(const PerformanceData& data) {
+    constexpr quint32 kArchivedSources = MetricsArchiveRecord::CpuField | MetricsArchiveRecord::MemoryField |
+                                         MetricsArchiveRecord::DiskField | MetricsArchiveRecord::NetworkField |
+                                         MetricsArchiveRecord::VolumesField;
+    MetricsArchiveRecord record;
+    record.timestampMs = data.timestamp.toMSecsSinceEpoch();
+    record.fields = static_cast<quint32>(data.updatedSources.toInt()) & kArchivedSources;
+    record.cpuUsage = static_cast<float>(data.cpuUsage);
+    record.memoryUsage = static_cast<float>(data.memoryUsage);
+    record.diskUsage = static_cast<float>(data.diskUsage);
+    record.diskReadKBps = static_cast<float>(data.diskReadKBps);
+    record.diskWriteKBps = static_cast<float>(data.diskWriteKBps);
+    record.networkUpload = static_cast<float>(data.networkUpload);
+    record.networkDownload = static_cast<float>(data.networkDownload);
+    record.usedMemoryMB = static_cast<quint32>(data.usedMemory);
+    record.totalMemoryMB = static_cast<quint32>(data.totalMemory);
+    record.usedDiskGB = static_cast<quint32>(data.usedDisk);
+    record.totalDiskGB = static_cast<quint32>(data.totalDisk);
+    return record;
+}
+
+/**
+ * 在界面线程中把快照交给到期的订阅者；所有订阅者共享同一份快照
+ */
+void PerformanceMonitor::deliver(const PerformanceSnapshot& snapshot) {
+    const qint64 now = m_deliveryClock.elapsed();
+    const QList<MetricSubscriptionId> ids = m_subscriptions.keys();
+
+    for (MetricSubscriptionId id : ids) {
+        auto it = m_subscriptions.find(id);
+        if (it == m_subscriptions.end() || !it->active || !(it->sources & snapshot->updatedSources)) {
+            continue; // 已被之前的回调退订、暂停或不关心本次更新的来源
+        }
+        // 自适应订阅随加快后的采样交付，最快为订阅周期的kFastScale倍
+        const int intervalMs = it->adaptive ? static_cast<int>(it->intervalMs * kFastScale) : it->intervalMs;
+        if (it->lastDeliveredMs >= 0 && now - it->lastDeliveredMs < intervalMs - kDeliverySlackMs) {
+            continue;
+        }
+        it->lastDeliveredMs = now;
+        std::function<void(const PerformanceSnapshot&)> callback = it->callback;
+        if (callback) {
+            callback(snapshot);
+        }
+    }
+}
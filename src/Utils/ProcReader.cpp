@@ -0,0 +1,242 @@
+#include "Utils/ProcReader.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace ProcFs {
+
+ProcBuffer::ProcBuffer(size_t initialCapacity)
+    : m_storage(initialCapacity > 0 ? initialCapacity : 1, '\0')
+    , m_size(0)
+{
+}
+
+ProcFile::ProcFile(const char* path) {
+    open(path);
+}
+
+ProcFile::~ProcFile() {
+    close();
+}
+
+ProcFile::ProcFile(ProcFile&& other) noexcept
+    : m_fd(other.m_fd)
+{
+    other.m_fd = -1;
+}
+
+ProcFile& ProcFile::operator=(ProcFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        m_fd = other.m_fd;
+        other.m_fd = -1;
+    }
+    return *this;
+}
+
+bool ProcFile::open(const char* path) {
+    close();
+    m_fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    return m_fd >= 0;
+}
+
+bool ProcFile::openAt(int dirFd, const char* relativePath) {
+    close();
+    m_fd = ::openat(dirFd, relativePath, O_RDONLY | O_CLOEXEC);
+    return m_fd >= 0;
+}
+
+void ProcFile::close() {
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+/**
+ * /proc文件可能分多次返回，循环pread直到文件结束或缓冲区写满
+ */
+qint64 ProcFile::read(char* buffer, size_t size) const {
+    if (m_fd < 0 || size == 0) {
+        return -1;
+    }
+    size_t total = 0;
+    while (total < size - 1) {
+        const ssize_t n = ::pread(m_fd, buffer + total, size - 1 - total, static_cast<off_t>(total));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        if (n == 0) {
+            break;
+        }
+        total += static_cast<size_t>(n);
+    }
+    buffer[total] = '\0';
+    return static_cast<qint64>(total);
+}
+
+qint64 ProcFile::readHead(char* buffer, size_t size) const {
+    if (m_fd < 0 || size == 0) {
+        return -1;
+    }
+    ssize_t n;
+    do {
+        n = ::pread(m_fd, buffer, size - 1, 0);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0) {
+        return -1;
+    }
+    buffer[n] = '\0';
+    return n;
+}
+
+/**
+ * 缓冲区被读满说明文件可能更长：扩容一倍后重读，保证拿到完整且一致的一份内容。
+ * 扩容只在文件第一次变大时发生，稳态下不分配
+ */
+bool ProcFile::readAll(ProcBuffer& buffer) const {
+    for (;;) {
+        const qint64 n = read(buffer.m_storage.data(), buffer.m_storage.size());
+        if (n < 0) {
+            buffer.m_size = 0;
+            buffer.m_storage[0] = '\0';
+            return false;
+        }
+        if (static_cast<size_t>(n) < buffer.m_storage.size() - 1) {
+            buffer.m_size = static_cast<size_t>(n);
+            return true;
+        }
+        buffer.m_storage.resize(buffer.m_storage.size() * 2);
+    }
+}
+
+bool readFileAt(int dirFd, const char* relativePath, char* buffer, size_t size) {
+    ProcFile file;
+    if (!file.openAt(dirFd, relativePath)) {
+        return false;
+    }
+    return file.read(buffer, size) > 0;
+}
+
+void parseCpuTimes(Scanner& scanner, quint64& total, quint64& idle) {
+    total = 0;
+    idle = 0;
+    for (int i = 0; i < 8; ++i) {
+        const quint64 value = scanner.readUInt();
+        total += value;
+        if (i == 3 || i == 4) {
+            idle += value;   // idle + iowait
+        }
+    }
+}
+
+bool parseCpuSummary(const char* text, quint64& total, quint64& idle) {
+    Scanner scanner(text);
+    if (!scanner.consume("cpu ")) {
+        return false;
+    }
+    parseCpuTimes(scanner, total, idle);
+    return true;
+}
+
+/**
+ * 离线的核心不出现在文件中，其计数器保持上一次的值
+ */
+bool parseCpuStat(const char* text, quint64& total, quint64& idle,
+                  std::vector<quint64>& coreTotal, std::vector<quint64>& coreIdle) {
+    bool hasSummary = false;
+    Scanner scanner(text);
+    while (scanner.consume("cpu")) {
+        if (scanner.peek() == ' ') {
+            parseCpuTimes(scanner, total, idle);
+            hasSummary = true;
+        } else {
+            const size_t core = static_cast<size_t>(scanner.readUInt());
+            if (core >= coreTotal.size()) {
+                // 只在第一次采样或有核心上线时扩容
+                coreTotal.resize(core + 1, 0);
+                coreIdle.resize(core + 1, 0);
+            }
+            parseCpuTimes(scanner, coreTotal[core], coreIdle[core]);
+        }
+        if (!scanner.nextLine()) {
+            break;
+        }
+    }
+    return hasSummary;
+}
+
+/**
+ * 数组连续、循环体只有整数选择，-O3下GCC/Clang会向量化。
+ * 一个采样周期内的时间片差值远小于2^31，因此用32位整数计算，转换为float也不需要AVX-512；
+ * 核心下线后计数器重置时差值为负，结果记为0
+ */
+void computeCoreUsage(const quint64* total, const quint64* idle,
+                      const quint64* prevTotal, const quint64* prevIdle,
+                      float* usage, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        qint32 totalDelta = static_cast<qint32>(total[i] - prevTotal[i]);
+        qint32 busyDelta = totalDelta - static_cast<qint32>(idle[i] - prevIdle[i]);
+        busyDelta = totalDelta > 0 ? busyDelta : 0;
+        busyDelta = busyDelta > 0 ? busyDelta : 0;
+        totalDelta = totalDelta > 0 ? totalDelta : 1;
+        busyDelta = busyDelta < totalDelta ? busyDelta : totalDelta;
+        usage[i] = static_cast<float>(busyDelta) * 100.0f / static_cast<float>(totalDelta);
+    }
+}
+
+namespace {
+
+bool findValue(const char* text, const char* key, quint64& value) {
+    Scanner scanner(text);
+    return scanner.findLine(key) && scanner.readUInt(value);
+}
+
+} // namespace
+
+bool parseMemInfo(const char* text, quint64& totalKb, quint64& availableKb) {
+    if (!findValue(text, "MemTotal:", totalKb)) {
+        return false;
+    }
+    if (!findValue(text, "MemAvailable:", availableKb)) {
+        // 3.14之前的内核没有MemAvailable，用空闲+缓存近似
+        quint64 freeKb = 0, buffersKb = 0, cachedKb = 0;
+        findValue(text, "MemFree:", freeKb);
+        findValue(text, "Buffers:", buffersKb);
+        findValue(text, "Cached:", cachedKb);
+        availableKb = freeKb + buffersKb + cachedKb;
+    }
+    return true;
+}
+
+/**
+ * 进程名在括号中且可能含空格和括号，因此从最后一个')'之后解析；
+ * 之后依次为state(3) ... utime(14) stime(15) ... starttime(22)
+ */
+bool parseProcessStat(const char* text, ProcessStat& stat) {
+    const char* nameBegin = std::strchr(text, '(');
+    const char* nameEnd = std::strrchr(text, ')');
+    if (!nameBegin || !nameEnd || nameEnd < nameBegin || nameEnd[1] == '\0' || nameEnd[2] == '\0') {
+        return false;
+    }
+
+    // 跳过") "和state，从第4个字段开始逐个读取到starttime
+    Scanner scanner(nameEnd + 3);
+    qint64 fields[19];
+    for (qint64& field : fields) {
+        if (!scanner.readInt(field)) {   // nice等字段可能为负
+            return false;
+        }
+    }
+    stat.name = nameBegin + 1;
+    stat.nameLength = static_cast<size_t>(nameEnd - nameBegin - 1);
+    stat.cpuTime = static_cast<quint64>(fields[14 - 4] + fields[15 - 4]);
+    stat.startTime = static_cast<quint64>(fields[22 - 4]);
+    return true;
+}
+
+} // namespace ProcFs
@@ -0,0 +1,312 @@
+#include "Utils/ProcessScanner.h"
+#include <algorithm>
+
+#ifdef Q_OS_LINUX
+#include "Utils/ProcReader.h"
+#include <cstdio>
+#include <unistd.h>
+#endif
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <tlhelp32.h>
+#include <psapi.h>
+#endif
+
+#ifdef Q_OS_LINUX
+ProcessScanner::ProcessScanner()
+    : ProcessScanner("/proc")
+{
+}
+
+ProcessScanner::ProcessScanner(const char* procRoot)
+    : m_cursor(0)
+    , m_generation(0)
+    , m_scanBudgetUs(kScanBudgetUs)
+    , m_procDir(::opendir(procRoot))
+    , m_procFd(m_procDir ? ::dirfd(m_procDir) : -1)
+    , m_clockTicks(::sysconf(_SC_CLK_TCK))
+    , m_pageSize(::sysconf(_SC_PAGESIZE))
+{
+}
+#else
+ProcessScanner::ProcessScanner()
+    : m_cursor(0)
+    , m_generation(0)
+    , m_scanBudgetUs(kScanBudgetUs)
+{
+}
+#endif
+
+ProcessScanner::~ProcessScanner() {
+    for (Entry& entry : m_entries) {
+        releaseEntry(entry);
+    }
+#ifdef Q_OS_LINUX
+    if (m_procDir) {
+        ::closedir(m_procDir);
+    }
+#endif
+}
+
+/**
+ * 一轮扫描从枚举进程开始，之后每次调用从上次停下的位置继续，直到用完时间预算；
+ * 预算每采样16个进程检查一次，每次调用至少推进16个进程，保证一轮扫描总能结束
+ */
+void ProcessScanner::scan() {
+    QElapsedTimer timer;
+    timer.start();
+    if (!m_clock.isValid()) {
+        m_clock.start();
+    }
+    const qint64 budgetNs = qint64(m_scanBudgetUs) * 1000;
+
+    if (m_cursor == 0) {
+        m_generation++;
+        if (!enumerateProcesses()) {
+            m_pids.clear();
+        }
+    }
+
+    int refreshed = 0;
+    bool budgetHit = false;
+    while (m_cursor < m_pids.size()) {
+        if (refreshed > 0 && (refreshed & 15) == 0 && timer.nsecsElapsed() > budgetNs) {
+            budgetHit = true;
+            break;
+        }
+        const qint64 pid = m_pids[m_cursor++];
+        Entry& entry = m_entries[pid];
+        entry.generation = m_generation;
+        if (!sampleProcess(pid, entry)) {
+            // 进程在枚举之后退出
+            releaseEntry(entry);
+            m_entries.remove(pid);
+        }
+        refreshed++;
+    }
+    if (m_cursor >= m_pids.size()) {
+        finishRound();
+    }
+
+    const double costUs = timer.nsecsElapsed() / 1000.0;
+    m_stats.scanCount++;
+    m_stats.processCount = m_entries.size();
+    m_stats.refreshedCount = refreshed;
+    m_stats.lastScanUs = costUs;
+    m_stats.avgScanUs += (costUs - m_stats.avgScanUs) / m_stats.scanCount;
+    m_stats.maxScanUs = qMax(m_stats.maxScanUs, costUs);
+    if (budgetHit) {
+        m_stats.budgetHits++;
+    }
+}
+
+// 一轮结束：清理本轮枚举中没有出现的进程
+void ProcessScanner::finishRound() {
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (it->generation != m_generation) {
+            releaseEntry(*it);
+            it = m_entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    m_cursor = 0;
+}
+
+void ProcessScanner::topByCpu(int count, QVector<ProcessSample>& out) {
+    selectTop(count, true, out);
+}
+
+void ProcessScanner::topByMemory(int count, QVector<ProcessSample>& out) {
+    selectTop(count, false, out);
+}
+
+/**
+ * nth_element把前count个选出来，只对这count个排序，复杂度O(n + k log k)
+ */
+void ProcessScanner::selectTop(int count, bool byCpu, QVector<ProcessSample>& out) {
+    m_ranking.clear();
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        if (it->lastSampleMs >= 0) {
+            m_ranking.emplace_back(it.key(), &it.value());
+        }
+    }
+
+    const size_t n = std::min<size_t>(m_ranking.size(), static_cast<size_t>(qBound(0, count, kMaxTopCount)));
+    auto higher = [byCpu](const std::pair<qint64, const Entry*>& a, const std::pair<qint64, const Entry*>& b) {
+        return byCpu ? a.second->cpuPercent > b.second->cpuPercent : a.second->rssBytes > b.second->rssBytes;
+    };
+    if (n < m_ranking.size()) {
+        std::nth_element(m_ranking.begin(), m_ranking.begin() + n, m_ranking.end(), higher);
+    }
+    std::sort(m_ranking.begin(), m_ranking.begin() + n, higher);
+
+    out.resize(static_cast<qsizetype>(n));
+    for (size_t i = 0; i < n; ++i) {
+        ProcessSample& sample = out[static_cast<qsizetype>(i)];
+        const Entry& entry = *m_ranking[i].second;
+        sample.pid = m_ranking[i].first;
+        sample.name = entry.name;
+        sample.cpuPercent = entry.cpuPercent;
+        sample.rssBytes = entry.rssBytes;
+    }
+}
+
+#ifdef Q_OS_WIN
+namespace {
+    quint64 fileTimeToUInt64(const FILETIME& time) {
+        return (quint64(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+    }
+}
+
+bool ProcessScanner::enumerateProcesses() {
+    HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+    if (snapshot == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    m_pids.clear();
+    PROCESSENTRY32W process;
+    process.dwSize = sizeof(process);
+    for (BOOL ok = Process32FirstW(snapshot, &process); ok; ok = Process32NextW(snapshot, &process)) {
+        if (process.th32ProcessID == 0) {
+            continue;   // System Idle Process
+        }
+        const qint64 pid = process.th32ProcessID;
+        m_pids.push_back(pid);
+        Entry& entry = m_entries[pid];
+        if (entry.name.isEmpty()) {
+            entry.name = QString::fromWCharArray(process.szExeFile);
+        }
+    }
+    CloseHandle(snapshot);
+    return true;
+}
+
+/**
+ * 句柄在进程第一次出现时打开并一直保留；无权访问的进程（系统服务等）只尝试打开一次
+ */
+bool ProcessScanner::sampleProcess(qint64 pid, Entry& entry) {
+    if (!entry.handle) {
+        HANDLE handle = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, static_cast<DWORD>(pid));
+        entry.handle = handle ? handle : INVALID_HANDLE_VALUE;
+    }
+    if (entry.handle == INVALID_HANDLE_VALUE) {
+        return true;
+    }
+    HANDLE handle = static_cast<HANDLE>(entry.handle);
+
+    DWORD exitCode = 0;
+    if (!GetExitCodeProcess(handle, &exitCode) || exitCode != STILL_ACTIVE) {
+        return false;
+    }
+
+    FILETIME createTime, exitTime, kernelTime, userTime;
+    if (!GetProcessTimes(handle, &createTime, &exitTime, &kernelTime, &userTime)) {
+        return false;
+    }
+    const quint64 cpuTime = fileTimeToUInt64(kernelTime) + fileTimeToUInt64(userTime);
+    const qint64 now = m_clock.elapsed();
+    if (entry.lastSampleMs >= 0 && now > entry.lastSampleMs && cpuTime >= entry.cpuTime) {
+        // 100ns单位：差值 / (毫秒 * 10000) * 100
+        entry.cpuPercent = static_cast<float>((cpuTime - entry.cpuTime) / ((now - entry.lastSampleMs) * 100.0));
+    }
+    entry.cpuTime = cpuTime;
+    entry.startTime = fileTimeToUInt64(createTime);
+    entry.lastSampleMs = now;
+
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(handle, &counters, sizeof(counters))) {
+        entry.rssBytes = static_cast<qint64>(counters.WorkingSetSize);
+    }
+    return true;
+}
+
+void ProcessScanner::releaseEntry(Entry& entry) {
+    if (entry.handle && entry.handle != INVALID_HANDLE_VALUE) {
+        CloseHandle(static_cast<HANDLE>(entry.handle));
+    }
+    entry.handle = nullptr;
+}
+#elif defined(Q_OS_LINUX)
+bool ProcessScanner::enumerateProcesses() {
+    if (!m_procDir) {
+        return false;
+    }
+
+    m_pids.clear();
+    ::rewinddir(m_procDir);
+    while (const dirent* item = ::readdir(m_procDir)) {
+        const char* name = item->d_name;
+        if (name[0] < '1' || name[0] > '9') {
+            continue;   // 只有数字目录是进程
+        }
+        ProcFs::Scanner scanner(name);
+        quint64 pid = 0;
+        if (scanner.readUInt(pid) && scanner.atEnd()) {
+            m_pids.push_back(static_cast<qint64>(pid));
+        }
+    }
+    return true;
+}
+
+/**
+ * /proc/[pid]/stat提供进程名、CPU时间和启动时间，/proc/[pid]/statm的第二个字段为常驻页数
+ */
+bool ProcessScanner::sampleProcess(qint64 pid, Entry& entry) {
+    char path[48];
+    char buffer[1024];
+
+    std::snprintf(path, sizeof(path), "%lld/stat", static_cast<long long>(pid));
+    ProcFs::ProcessStat stat;
+    if (!ProcFs::readFileAt(m_procFd, path, buffer, sizeof(buffer)) || !ProcFs::parseProcessStat(buffer, stat)) {
+        return false;
+    }
+    const quint64 cpuTime = stat.cpuTime;
+
+    if (entry.name.isEmpty() || entry.startTime != stat.startTime) {
+        // 新进程或PID被复用
+        entry.name = QString::fromUtf8(stat.name, static_cast<int>(stat.nameLength));
+        entry.startTime = stat.startTime;
+        entry.lastSampleMs = -1;
+        entry.cpuPercent = 0.0f;
+    }
+
+    const qint64 now = m_clock.elapsed();
+    if (entry.lastSampleMs >= 0 && now > entry.lastSampleMs && cpuTime >= entry.cpuTime && m_clockTicks > 0) {
+        // 滴答差值 / (每秒滴答数 * 秒数) * 100
+        entry.cpuPercent = static_cast<float>((cpuTime - entry.cpuTime) * 100000.0 /
+                                              (double(m_clockTicks) * (now - entry.lastSampleMs)));
+    }
+    entry.cpuTime = cpuTime;
+    entry.lastSampleMs = now;
+
+    std::snprintf(path, sizeof(path), "%lld/statm", static_cast<long long>(pid));
+    if (ProcFs::readFileAt(m_procFd, path, buffer, sizeof(buffer))) {
+        ProcFs::Scanner statm(buffer);
+        statm.readUInt();                                      // size
+        const quint64 residentPages = statm.readUInt();
+        entry.rssBytes = static_cast<qint64>(residentPages * static_cast<quint64>(m_pageSize));
+    }
+    return true;
+}
+
+void ProcessScanner::releaseEntry(Entry& entry) {
+    Q_UNUSED(entry);
+}
+#else
+bool ProcessScanner::enumerateProcesses() {
+    return false;
+}
+
+bool ProcessScanner::sampleProcess(qint64 pid, Entry& entry) {
+    Q_UNUSED(pid);
+    Q_UNUSED(entry);
+    return false;
+}
+
+void ProcessScanner::releaseEntry(Entry& entry) {
+    Q_UNUSED(entry);
+}
+#endif
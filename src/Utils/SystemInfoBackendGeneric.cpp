@@ -0,0 +1,47 @@
+#include "Utils/SystemInfoBackend.h"
+#include <QStorageInfo>
+#include <QSysInfo>
+
+namespace {
+
+// 其他平台（如macOS）的通用实现：只用Qt提供的接口，
+// CPU型号退化为架构名，磁盘空间来自QStorageInfo
+class GenericSystemInfoBackend : public SystemInfoBackend {
+public:
+    QString cpuModel() override;
+    void osInfo(QString& osName, QString& osVersion, QString& computerName, QString& userName) override;
+    QMap<QString, QPair<qint64, qint64>> diskSpace() override;
+};
+
+QString GenericSystemInfoBackend::cpuModel() {
+    return QSysInfo::currentCpuArchitecture();
+}
+
+void GenericSystemInfoBackend::osInfo(QString& osName, QString& osVersion, QString& computerName, QString& userName) {
+    osName = QSysInfo::prettyProductName();
+    osVersion = QSysInfo::productVersion();
+    computerName = QSysInfo::machineHostName();
+    userName = qEnvironmentVariable("USER");
+}
+
+QMap<QString, QPair<qint64, qint64>> GenericSystemInfoBackend::diskSpace() {
+    QMap<QString, QPair<qint64, qint64>> result;
+    for (const QStorageInfo& storage : QStorageInfo::mountedVolumes()) {
+        // 只读卷（如系统快照、镜像）和网络卷不统计
+        if (!storage.isValid() || !storage.isReady() || storage.isReadOnly() || storage.bytesTotal() <= 0) {
+            continue;
+        }
+        const QByteArray fsType = storage.fileSystemType();
+        if (fsType == "nfs" || fsType == "smbfs" || fsType == "afpfs" || fsType == "webdav") {
+            continue;
+        }
+        result[storage.rootPath()] = qMakePair(storage.bytesTotal(), storage.bytesAvailable());
+    }
+    return result;
+}
+
+} // namespace
+
+std::unique_ptr<SystemInfoBackend> SystemInfoBackend::create() {
+    return std::unique_ptr<SystemInfoBackend>(new GenericSystemInfoBackend());
+}
@@ -0,0 +1,256 @@
+#include "Utils/SystemInfoBackend.h"
+#include "Utils/ProcReader.h"
+#include <QByteArray>
+#include <QFile>
+#include <QSet>
+#include <QSysInfo>
+#include <QVector>
+#include <poll.h>
+#include <pwd.h>
+#include <sys/statvfs.h>
+#include <unistd.h>
+
+namespace {
+
+// mountinfo中的路径把空格、制表符、换行和反斜杠转义为\ooo
+QString unescapeMountPath(const QByteArray& path) {
+    QByteArray result;
+    result.reserve(path.size());
+    for (qsizetype i = 0; i < path.size(); ++i) {
+        if (path.at(i) == '\\' && i + 3 < path.size()) {
+            const QByteArray digits = path.mid(i + 1, 3);
+            bool ok = false;
+            const int code = digits.toInt(&ok, 8);
+            if (ok && digits.size() == 3) {
+                result.append(static_cast<char>(code));
+                i += 3;
+                continue;
+            }
+        }
+        result.append(path.at(i));
+    }
+    return QString::fromUtf8(result);
+}
+
+// os-release中的值可能带引号和反斜杠转义
+QString unquoteOsReleaseValue(QByteArray value) {
+    value = value.trimmed();
+    if (value.size() >= 2 && (value.front() == '"' || value.front() == '\'') && value.back() == value.front()) {
+        value = value.mid(1, value.size() - 2);
+    }
+    QByteArray result;
+    result.reserve(value.size());
+    for (qsizetype i = 0; i < value.size(); ++i) {
+        if (value.at(i) == '\\' && i + 1 < value.size()) {
+            ++i;
+        }
+        result.append(value.at(i));
+    }
+    return QString::fromUtf8(result);
+}
+
+// 本地磁盘之外的文件系统不统计：伪文件系统没有容量意义，
+// 网络文件系统在服务器无响应时statvfs()会阻塞界面线程
+bool isLocalDiskMount(const QByteArray& fsType, const QByteArray& source) {
+    static const char* const kIgnoredTypes[] = {
+        "squashfs", "iso9660", "udf", "overlay", "tmpfs", "devtmpfs", "ramfs"
+    };
+    for (const char* type : kIgnoredTypes) {
+        if (fsType == type) {
+            return false;
+        }
+    }
+    if (fsType == "zfs" || fsType == "bcachefs") {
+        return true;   // 数据集名称不是设备路径
+    }
+    return source.startsWith("/dev/") && !source.startsWith("/dev/loop");
+}
+
+// Linux实现：/proc和statvfs，采样路径上只有pread、poll和statvfs系统调用；
+// CPU和内存由MetricsSampler直接读取/proc
+class LinuxSystemInfoBackend : public SystemInfoBackend {
+public:
+    LinuxSystemInfoBackend();
+    ~LinuxSystemInfoBackend() override;
+
+    QString cpuModel() override;
+    void osInfo(QString& osName, QString& osVersion, QString& computerName, QString& userName) override;
+    QMap<QString, QPair<qint64, qint64>> diskSpace() override;
+
+private:
+    bool mountTableChanged();
+    void reloadMounts();
+
+    ProcFs::ProcFile m_mountinfoFile;
+    ProcFs::ProcBuffer m_mountinfoBuffer;
+
+    // 挂载表只在内核通知变化时重新解析
+    QVector<QString> m_mountPoints;
+    bool m_mountsLoaded;
+};
+
+LinuxSystemInfoBackend::LinuxSystemInfoBackend()
+    : m_mountinfoFile("/proc/self/mountinfo")
+    , m_mountsLoaded(false)
+{
+}
+
+LinuxSystemInfoBackend::~LinuxSystemInfoBackend() = default;
+
+QString LinuxSystemInfoBackend::cpuModel() {
+    QFile file("/proc/cpuinfo");
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return QString();
+    }
+
+    // x86为"model name"，部分ARM内核只提供"Hardware"或"Model"，MIPS为"cpu model"
+    static const char* const kKeys[] = {"model name", "Hardware", "Model", "cpu model", "Processor"};
+    QMap<QByteArray, QString> values;
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine();
+        if (line.trimmed().isEmpty() && values.contains(kKeys[0])) {
+            break;   // 第一个处理器的信息块已读完
+        }
+        const qsizetype colon = line.indexOf(':');
+        if (colon <= 0) {
+            continue;
+        }
+        const QByteArray key = line.left(colon).trimmed();
+        if (!values.contains(key)) {
+            values.insert(key, QString::fromUtf8(line.mid(colon + 1).trimmed()));
+        }
+    }
+
+    for (const char* key : kKeys) {
+        const QString value = values.value(key);
+        if (!value.isEmpty()) {
+            return value;
+        }
+    }
+    return QString();
+}
+
+void LinuxSystemInfoBackend::osInfo(QString& osName, QString& osVersion, QString& computerName, QString& userName) {
+    QFile file("/etc/os-release");
+    if (!file.exists()) {
+        file.setFileName("/usr/lib/os-release");
+    }
+
+    QString name, versionId, prettyName;
+    if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        while (!file.atEnd()) {
+            const QByteArray line = file.readLine().trimmed();
+            const qsizetype equals = line.indexOf('=');
+            if (line.startsWith('#') || equals <= 0) {
+                continue;
+            }
+            const QByteArray key = line.left(equals);
+            if (key == "NAME") {
+                name = unquoteOsReleaseValue(line.mid(equals + 1));
+            } else if (key == "VERSION_ID") {
+                versionId = unquoteOsReleaseValue(line.mid(equals + 1));
+            } else if (key == "PRETTY_NAME") {
+                prettyName = unquoteOsReleaseValue(line.mid(equals + 1));
+            }
+        }
+    }
+
+    if (!name.isEmpty()) {
+        osName = name;
+        osVersion = versionId;
+    } else if (!prettyName.isEmpty()) {
+        osName = prettyName;
+        osVersion.clear();
+    } else {
+        osName = QSysInfo::prettyProductName();
+        osVersion = QSysInfo::productVersion();
+    }
+
+    computerName = QSysInfo::machineHostName();
+
+    userName = qEnvironmentVariable("USER");
+    if (userName.isEmpty()) {
+        if (const passwd* pw = ::getpwuid(::geteuid())) {
+            userName = QString::fromLocal8Bit(pw->pw_name);
+        }
+    }
+}
+
+/**
+ * 挂载表发生变化时内核在mountinfo上报告POLLPRI|POLLERR，重新读取后清除
+ */
+bool LinuxSystemInfoBackend::mountTableChanged() {
+    if (!m_mountsLoaded) {
+        return true;
+    }
+    if (!m_mountinfoFile.isOpen()) {
+        return false;
+    }
+    pollfd pfd;
+    pfd.fd = m_mountinfoFile.fd();
+    pfd.events = POLLPRI;
+    pfd.revents = 0;
+    return ::poll(&pfd, 1, 0) > 0 && (pfd.revents & (POLLPRI | POLLERR));
+}
+
+/**
+ * mountinfo每行格式：
+ * ID 父ID 主:次设备号 根 挂载点 挂载选项 [可选字段...] - 文件系统类型 来源 超级块选项
+ */
+void LinuxSystemInfoBackend::reloadMounts() {
+    m_mountsLoaded = true;
+    m_mountPoints.clear();
+    if (!m_mountinfoFile.readAll(m_mountinfoBuffer)) {
+        m_mountPoints.append("/");
+        return;
+    }
+
+    // 挂载表很少变化，这里按行拆分的分配不在每次采样的路径上
+    const QByteArray data = QByteArray::fromRawData(m_mountinfoBuffer.data(),
+                                                    static_cast<qsizetype>(m_mountinfoBuffer.size()));
+    QSet<QByteArray> seenDevices;
+    for (const QByteArray& line : data.split('\n')) {
+        const QList<QByteArray> fields = line.split(' ');
+        const qsizetype separator = fields.indexOf("-");
+        if (fields.size() < 7 || separator < 6 || separator + 2 >= fields.size()) {
+            continue;
+        }
+
+        const QByteArray& device = fields.at(2);
+        const QByteArray& fsType = fields.at(separator + 1);
+        const QByteArray& source = fields.at(separator + 2);
+        if (!isLocalDiskMount(fsType, source)) {
+            continue;
+        }
+        // 同一设备的绑定挂载只统计第一个（通常是其主挂载点）
+        if (seenDevices.contains(device)) {
+            continue;
+        }
+        seenDevices.insert(device);
+        m_mountPoints.append(unescapeMountPath(fields.at(4)));
+    }
+}
+
+QMap<QString, QPair<qint64, qint64>> LinuxSystemInfoBackend::diskSpace() {
+    if (mountTableChanged()) {
+        reloadMounts();
+    }
+
+    QMap<QString, QPair<qint64, qint64>> result;
+    for (const QString& mountPoint : m_mountPoints) {
+        struct statvfs stats;
+        if (::statvfs(QFile::encodeName(mountPoint).constData(), &stats) != 0 || stats.f_blocks == 0) {
+            continue;
+        }
+        const qint64 total = static_cast<qint64>(stats.f_blocks) * static_cast<qint64>(stats.f_frsize);
+        const qint64 available = static_cast<qint64>(stats.f_bavail) * static_cast<qint64>(stats.f_frsize);
+        result[mountPoint] = qMakePair(total, available);
+    }
+    return result;
+}
+
+} // namespace
+
+std::unique_ptr<SystemInfoBackend> SystemInfoBackend::create() {
+    return std::unique_ptr<SystemInfoBackend>(new LinuxSystemInfoBackend());
+}
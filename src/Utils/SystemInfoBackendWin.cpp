@@ -0,0 +1,86 @@
+#include "Utils/SystemInfoBackend.h"
+#include <QSysInfo>
+#include <QStorageInfo>
+#include <QProcess>
+#include <QRegularExpression>
+#include <windows.h>
+
+namespace {
+
+// Windows实现：注册表/wmic和QStorageInfo；CPU和内存由MetricsSampler通过PDH读取
+class WindowsSystemInfoBackend : public SystemInfoBackend {
+public:
+    WindowsSystemInfoBackend();
+    ~WindowsSystemInfoBackend() override;
+
+    QString cpuModel() override;
+    void osInfo(QString& osName, QString& osVersion, QString& computerName, QString& userName) override;
+    QMap<QString, QPair<qint64, qint64>> diskSpace() override;
+};
+
+WindowsSystemInfoBackend::WindowsSystemInfoBackend() = default;
+
+WindowsSystemInfoBackend::~WindowsSystemInfoBackend() = default;
+
+QString WindowsSystemInfoBackend::cpuModel() {
+    // 方法1：尝试从注册表获取CPU信息
+    QString cpuName;
+    HKEY hKey;
+    if (RegOpenKeyEx(HKEY_LOCAL_MACHINE,
+                     L"HARDWARE\\DESCRIPTION\\System\\CentralProcessor\\0",
+                     0, KEY_READ, &hKey) == ERROR_SUCCESS) {
+        WCHAR buffer[256];
+        DWORD bufferSize = sizeof(buffer);
+        if (RegQueryValueEx(hKey, L"ProcessorNameString", NULL, NULL,
+                           (LPBYTE)buffer, &bufferSize) == ERROR_SUCCESS) {
+            cpuName = QString::fromWCharArray(buffer).trimmed();
+        }
+        RegCloseKey(hKey);
+    }
+
+    // 如果注册表方法成功，返回结果
+    if (!cpuName.isEmpty()) {
+        return cpuName;
+    }
+
+    // 方法2：备用方案 - 使用wmic命令（结果由SystemInfoCollector缓存，只执行一次）
+    QProcess process;
+    process.start("wmic", QStringList() << "cpu" << "get" << "name" << "/format:list");
+    process.waitForFinished(3000); // 3秒超时
+
+    if (process.exitCode() == 0) {
+        QString output = QString::fromLocal8Bit(process.readAllStandardOutput());
+        QRegularExpression regex("Name=(.+)");
+        QRegularExpressionMatch match = regex.match(output);
+        if (match.hasMatch()) {
+            cpuName = match.captured(1).trimmed();
+        }
+    }
+    return cpuName;
+}
+
+void WindowsSystemInfoBackend::osInfo(QString& osName, QString& osVersion, QString& computerName, QString& userName) {
+    osName = QSysInfo::prettyProductName();
+    osVersion = QSysInfo::productVersion();
+    computerName = QSysInfo::machineHostName();   // Qt Core即可，主程序不链接Qt Network
+    userName = qgetenv("USERNAME");
+}
+
+QMap<QString, QPair<qint64, qint64>> WindowsSystemInfoBackend::diskSpace() {
+    QMap<QString, QPair<qint64, qint64>> result;
+    foreach(const QStorageInfo &storage, QStorageInfo::mountedVolumes()) {
+        if (storage.isValid() && storage.isReady()) {
+            QString rootPath = storage.rootPath();
+            qint64 total = storage.bytesTotal();
+            qint64 available = storage.bytesAvailable();
+            result[rootPath] = qMakePair(total, available);
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+std::unique_ptr<SystemInfoBackend> SystemInfoBackend::create() {
+    return std::unique_ptr<SystemInfoBackend>(new WindowsSystemInfoBackend());
+}
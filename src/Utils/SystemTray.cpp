@@ -157,10 +157,11 @@ void SystemTray::toggleAvoidMinimizeAll() {
         int successCount = 0;
         int totalCount = widgetIds.size();
         
+        // 所有小组件的修改合并为一次widgetsChanged和一次保存
+        m_widgetManager->beginBatch();
         for (const QString& widgetId : widgetIds) {
-            auto widget = m_widgetManager->getWidget(widgetId);
-            if (widget) {
-                WidgetConfig config = widget->getConfig();
+            if (m_widgetManager->hasWidget(widgetId)) {
+                WidgetConfig config = m_widgetManager->getWidgetConfig(widgetId);
                 
                 // 在自定义设置中设置avoidMinimizeAll
                 config.customSettings["avoidMinimizeAll"] = enabled;
@@ -170,6 +171,7 @@ void SystemTray::toggleAvoidMinimizeAll() {
                 }
             }
         }
+        m_widgetManager->commitBatch();
         
         // 显示通知
         if (totalCount > 0) {
@@ -18,7 +18,7 @@
 AIRankingWidget::AIRankingWidget(const WidgetConfig& config, QWidget* parent)
     : BaseWidget(config, parent)
     , m_networkManager(nullptr)
-    , m_refreshTimer(nullptr)
+    , m_refreshJob(0)
     , m_isLoading(false)
     , m_hasError(false)
     , m_maxDisplayCount(5)
@@ -52,6 +52,18 @@ AIRankingWidget::AIRankingWidget(const WidgetConfig& config, QWidget* parent)
     parseCustomSettings();
     setMinimumSize(300, 250);
     
+    // 排行榜变化缓慢，帧预算紧张时可以顺延
+    setRenderPriority(RenderPriority::Low);
+    
+    // 边框和排行榜内容只在数据刷新、尺寸或配置变化时重绘；加载动画和错误提示是动态内容
+    addStaticLayer(QStringLiteral("frame"), [this](QPainter& painter) { drawFrame(painter); });
+    addStaticLayer(QStringLiteral("ranking"), [this](QPainter& painter) {
+        if (!m_isLoading && !m_hasError) {
+            drawHeader(painter);
+            drawRankingList(painter);
+        }
+    });
+    
     // 初始化一些默认数据
     initializeDefaultData();
     
@@ -70,13 +82,10 @@ void AIRankingWidget::setupNetworkManager() {
     connect(m_networkManager, &QNetworkAccessManager::finished,
             this, &AIRankingWidget::onNetworkReplyFinished);
     
-    // 设置刷新定时器
-    m_refreshTimer = new QTimer(this);
-    connect(m_refreshTimer, &QTimer::timeout, this, &AIRankingWidget::onDataRefreshTimer);
-    
-    if (m_autoRefresh && m_refreshInterval > 0) {
-        m_refreshTimer->start(m_refreshInterval * 60000); // 转换为毫秒
-    }
+    // 在共享调度器中注册刷新任务（分钟转换为毫秒）
+    m_refreshJob = WidgetFramework::instance().registerJob(
+        this, m_refreshInterval * 60000, TickClass::Coarse, [this]() { onDataRefreshTimer(); },
+        m_autoRefresh && m_refreshInterval > 0);
 }
 
 void AIRankingWidget::initializeDefaultData() {
@@ -204,7 +213,7 @@ void AIRankingWidget::fetchAIRankingData() {
     
     m_isLoading = true;
     m_hasError = false;
-    update(); // 触发重绘以显示加载状态
+    invalidateStaticLayer(QStringLiteral("ranking")); // 触发重绘以显示加载状态
     
     // 根据当前数据源选择不同的API端点
     QString apiUrl = getApiUrlForDataSource();
@@ -214,7 +223,7 @@ void AIRankingWidget::fetchAIRankingData() {
         QTimer::singleShot(1000, this, [this]() {
             initializeDefaultData();
             m_isLoading = false;
-            update();
+            invalidateStaticLayer(QStringLiteral("ranking"));
         });
         return;
     }
@@ -236,7 +245,7 @@ void AIRankingWidget::fetchAIRankingData() {
             initializeRecentModelData();
             m_hasError = false;
             m_errorMessage.clear();
-            update();
+            invalidateStaticLayer(QStringLiteral("ranking"));
         }
     });
     
@@ -495,13 +504,13 @@ void AIRankingWidget::updateContent() {
         }
     }
     
-    update(); // 触发重绘
+    scheduleRepaint(); // 触发重绘
 }
 
 void AIRankingWidget::drawContent(QPainter& painter) {
     painter.setRenderHint(QPainter::Antialiasing);
     
-    // 应用与系统信息小组件完全相同的样式
+    // 应用与系统信息小组件完全相同的样式（样式表变化会触发重新布局和重绘，只在内容不同时设置）
     QString style = QString(
         "QWidget { "
         "    border: 1px solid %1; "
@@ -510,14 +519,11 @@ void AIRankingWidget::drawContent(QPainter& painter) {
         "} "
     ).arg(palette().mid().color().name());
     
-    setStyleSheet(style);
-    
-    // 不绘制自定义背景，使用BaseWidget的默认背景（QColor(0, 0, 0, 50)）
-    
-    // 绘制边框
-    painter.setPen(QPen(m_borderColor, 1));
-    painter.drawRoundedRect(rect().adjusted(0, 0, -1, -1), 5, 5);
+    if (styleSheet() != style) {
+        setStyleSheet(style);
+    }
     
+    // 边框、标题头和排行榜列表由静态图层缓存提供
     if (m_isLoading) {
         drawLoadingIndicator(painter);
         return;
@@ -525,14 +531,13 @@ void AIRankingWidget::drawContent(QPainter& painter) {
     
     if (m_hasError) {
         drawErrorMessage(painter);
-        return;
     }
-    
-    // 绘制标题头
-    drawHeader(painter);
-    
-    // 绘制排行榜列表
-    drawRankingList(painter);
+}
+
+void AIRankingWidget::drawFrame(QPainter& painter) {
+    // 不绘制自定义背景，使用BaseWidget的默认背景（QColor(0, 0, 0, 50)）
+    painter.setPen(QPen(m_borderColor, 1));
+    painter.drawRoundedRect(rect().adjusted(0, 0, -1, -1), 5, 5);
 }
 
 void AIRankingWidget::drawHeader(QPainter& painter) {
@@ -686,7 +691,7 @@ void AIRankingWidget::drawLoadingIndicator(QPainter& painter) {
     // 启动定时器来更新动画
     QTimer::singleShot(500, this, [this]() {
         if (m_isLoading) {
-            update();
+            scheduleRepaint();
         }
     });
 }
@@ -820,7 +825,7 @@ void AIRankingWidget::onNetworkReplyFinished() {
     }
     
     reply->deleteLater();
-    update();
+    invalidateStaticLayer(QStringLiteral("ranking"));
     
     // 记录获取数据的日志
     qDebug() << QString("AIRankingWidget: 数据更新完成 - 数据源: %1, 能力: %2, 模型数量: %3")
@@ -835,20 +840,32 @@ void AIRankingWidget::onDataRefreshTimer() {
     }
 }
 
+void AIRankingWidget::onSuspended() {
+    // 暂停期间不再发起网络刷新，恢复时由updateContent()检查数据是否过期
+    WidgetFramework::instance().setJobActive(m_refreshJob, false);
+}
+
+void AIRankingWidget::onResumed() {
+    WidgetFramework::instance().setJobActive(m_refreshJob, m_autoRefresh && m_refreshInterval > 0);
+}
+
 void AIRankingWidget::applyConfig() {
     BaseWidget::applyConfig();
     
+    if (!configDelta().has(ConfigAspect::CustomSettings)) {
+        return;
+    }
+    
     QString oldDataSource = m_currentDataSource;
     QString oldCapability = m_currentCapability;
     
     parseCustomSettings();
     
     // 重新设置刷新定时器
-    if (m_refreshTimer) {
-        m_refreshTimer->stop();
-        if (m_autoRefresh && m_refreshInterval > 0) {
-            m_refreshTimer->start(m_refreshInterval * 60000);
-        }
+    if (m_refreshJob && configDelta().anyCustomKeyChanged({"autoRefresh", "refreshInterval"})) {
+        WidgetFramework& framework = WidgetFramework::instance();
+        framework.setJobPeriod(m_refreshJob, m_refreshInterval * 60000);
+        framework.setJobActive(m_refreshJob, !isSuspended() && m_autoRefresh && m_refreshInterval > 0);
     }
     
     // 如果数据源或能力指标发生了变化，重新初始化数据
@@ -0,0 +1,35 @@
+/**
+ * @file BuiltinWidgets.cpp
+ * @brief 内置小组件类型的注册
+ * @details 内置小组件和配置窗口编译在程序中，注册表在uwidget-framework共享库中，
+ *          由程序启动时把内置类型登记到注册表
+ */
+
+#include "Widgets/BuiltinWidgets.h"
+#include "Framework/BuiltinWidgetPlugin.h"
+#include "Framework/WidgetTypeRegistry.h"
+#include "Widgets/ClockWidget.h"
+#include "Widgets/SystemPerformanceWidget.h"
+#include "Widgets/SimpleNotesWidget.h"
+#include "Widgets/CalendarWidget.h"
+#include "Widgets/SystemInfoWidget.h"
+#include "BackendManagement/ConfigWindow.h"
+
+/**
+ * @brief 注册内置的小组件类型
+ *
+ * 默认尺寸和更新间隔与创建对话框原先的默认值一致。
+ * 天气和AI排行榜在plugins目录中（见plugins/weather、plugins/aiRanking）。
+ */
+void registerBuiltinWidgets(WidgetTypeRegistry& registry) {
+    registry.registerBuiltin(new BuiltinWidgetPlugin<ClockWidget, ConfigWindow>(
+        "clock", "时钟", WidgetType::Clock, QSize(200, 100), 1000));
+    registry.registerBuiltin(new BuiltinWidgetPlugin<SystemInfoWidget, ConfigWindow>(
+        "systemInfo", "系统信息", WidgetType::SystemInfo, QSize(300, 200), 2000));
+    registry.registerBuiltin(new BuiltinWidgetPlugin<CalendarWidget, ConfigWindow>(
+        "calendar", "日历", WidgetType::Calendar, QSize(250, 200), 60000));
+    registry.registerBuiltin(new BuiltinWidgetPlugin<SimpleNotesWidget, ConfigWindow>(
+        "simpleNotes", "极简便签", WidgetType::SimpleNotes, QSize(250, 200), 0));
+    registry.registerBuiltin(new BuiltinWidgetPlugin<SystemPerformanceWidget, ConfigWindow>(
+        "systemPerformance", "系统性能监测", WidgetType::SystemPerformance, QSize(280, 220), 2000));
+}
@@ -41,6 +41,12 @@ CalendarWidget::CalendarWidget(const WidgetConfig& config, QWidget* parent)
     parseCustomSettings();
     setMinimumSize(280, 320);
     setFixedSize(300, 350);
+    
+    // 边框、标题、星期标签和网格只在切换月份或配置变化时重绘
+    addStaticLayer(QStringLiteral("frame"), [this](QPainter& painter) { drawFrame(painter); });
+    addStaticLayer(QStringLiteral("header"), [this](QPainter& painter) { drawHeader(painter); });
+    addStaticLayer(QStringLiteral("weekHeaders"), [this](QPainter& painter) { drawWeekHeaders(painter); });
+    addStaticLayer(QStringLiteral("grid"), [this](QPainter& painter) { drawCalendarGrid(painter); });
 }
 
 void CalendarWidget::setupDefaultConfig() {
@@ -160,7 +166,7 @@ void CalendarWidget::parseCustomSettings() {
         m_useBackgroundImage = settings["useBackgroundImage"].toBool();
     }
     
-    if (settings.contains("backgroundImagePath")) {
+    if (settings.contains("backgroundImagePath") && configDelta().customKeyChanged("backgroundImagePath")) {
         m_backgroundImagePath = settings["backgroundImagePath"].toString();
         if (!m_backgroundImagePath.isEmpty()) {
             loadBackgroundImage();
@@ -297,13 +303,13 @@ void CalendarWidget::drawBackground(QPainter& painter) {
 
 void CalendarWidget::updateContent() {
     m_today = QDate::currentDate();
-    update(); // 触发重绘
+    scheduleRepaint(); // 触发重绘
 }
 
 void CalendarWidget::drawContent(QPainter& painter) {
     painter.setRenderHint(QPainter::Antialiasing);
     
-    // 应用与系统信息小组件完全相同的样式
+    // 应用与系统信息小组件完全相同的样式（样式表变化会触发重新布局和重绘，只在内容不同时设置）
     QString style = QString(
         "QWidget { "
         "    border: 1px solid %1; "
@@ -312,11 +318,16 @@ void CalendarWidget::drawContent(QPainter& painter) {
         "} "
     ).arg(palette().mid().color().name());
     
-    setStyleSheet(style);
-    
-    // 使用BaseWidget的默认背景（QColor(0, 0, 0, 50)），绘制日历内容
+    if (styleSheet() != style) {
+        setStyleSheet(style);
+    }
     
-    // 绘制边框
+    // 边框、标题、星期标签和网格由静态图层缓存提供，这里只绘制日期（今天和选中日期会变化）
+    drawDates(painter);
+}
+
+void CalendarWidget::drawFrame(QPainter& painter) {
+    // 使用BaseWidget的默认背景（QColor(0, 0, 0, 50)），绘制日历边框
     if (m_style != CalendarStyle::Minimal) {
         painter.setPen(QPen(QColor(255, 255, 255, 30), 1));
         if (m_style == CalendarStyle::Rounded) {
@@ -325,12 +336,6 @@ void CalendarWidget::drawContent(QPainter& painter) {
             painter.drawRect(rect().adjusted(1, 1, -1, -1));
         }
     }
-    
-    // 绘制日历各部分
-    drawHeader(painter);
-    drawWeekHeaders(painter);
-    drawCalendarGrid(painter);
-    drawDates(painter);
 }
 
 void CalendarWidget::drawHeader(QPainter& painter) {
@@ -681,12 +686,16 @@ void CalendarWidget::wheelEvent(QWheelEvent* event) {
 }
 
 void CalendarWidget::onMonthChanged() {
-    // 月份变化时的处理
-    // 可以在这里添加月份变化的通知或其他逻辑
+    // 月份变化时标题文字和网格行数会变，重绘这两个静态图层
+    invalidateStaticLayer(QStringLiteral("header"));
+    invalidateStaticLayer(QStringLiteral("grid"));
 }
 
 void CalendarWidget::applyConfig() {
     BaseWidget::applyConfig();
-    parseCustomSettings();
-    updateContent();
+    
+    if (configDelta().has(ConfigAspect::CustomSettings)) {
+        parseCustomSettings();
+        updateContent();
+    }
 } 
\ No newline at end of file
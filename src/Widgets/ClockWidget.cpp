@@ -72,6 +72,13 @@ ClockWidget::ClockWidget(const WidgetConfig& config, QWidget* parent)
     
     // 设置最小尺寸以确保文本可读性
     setMinimumSize(150, 60);
+    
+    // 秒数显示对时间最敏感，帧预算紧张时优先重绘
+    setRenderPriority(RenderPriority::High);
+    
+    // 背景和边框每秒不变，作为静态图层缓存，每次更新只绘制时间文本
+    addStaticLayer(QStringLiteral("background"), [this](QPainter& painter) { drawBackground(painter); });
+    addStaticLayer(QStringLiteral("frame"), [this](QPainter& painter) { drawFrame(painter); });
 }
 
 void ClockWidget::setupDefaultConfig() {
@@ -125,7 +132,7 @@ void ClockWidget::parseCustomSettings() {
         m_useBackgroundImage = settings["useBackgroundImage"].toBool();
     }
     
-    if (settings.contains("backgroundImagePath")) {
+    if (settings.contains("backgroundImagePath") && configDelta().customKeyChanged("backgroundImagePath")) {
         m_backgroundImagePath = settings["backgroundImagePath"].toString();
         if (!m_backgroundImagePath.isEmpty()) {
             loadBackgroundImage();
@@ -247,20 +254,19 @@ void ClockWidget::drawBackground(QPainter& painter) {
 
 void ClockWidget::updateContent() {
     m_currentTime = QDateTime::currentDateTime();
-    update(); // 触发重绘
+    scheduleRepaint(); // 触发重绘
 }
 
-void ClockWidget::drawContent(QPainter& painter) {
-    painter.setRenderHint(QPainter::Antialiasing);
-    
-    // 绘制背景（主题图片或纯色背景）
-    drawBackground(painter);
-    
+void ClockWidget::drawFrame(QPainter& painter) {
     // 绘制边框（仅在没有背景图片时显示）
     if (!m_useBackgroundImage || m_backgroundImage.isNull()) {
         painter.setPen(QPen(QColor(255, 255, 255, 50), 1));
         painter.drawRoundedRect(rect().adjusted(1, 1, -1, -1), 5, 5);
     }
+}
+
+void ClockWidget::drawContent(QPainter& painter) {
+    // 背景和边框由静态图层缓存提供
     
     // 计算文本区域
     QRect timeRect = rect();
@@ -292,6 +298,9 @@ void ClockWidget::drawContent(QPainter& painter) {
 
 void ClockWidget::applyConfig() {
     BaseWidget::applyConfig();
-    parseCustomSettings();
-    updateContent();
+    
+    if (configDelta().has(ConfigAspect::CustomSettings)) {
+        parseCustomSettings();
+        updateContent();
+    }
 } 
\ No newline at end of file
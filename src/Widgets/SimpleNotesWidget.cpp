@@ -28,20 +28,24 @@ SimpleNotesWidget::SimpleNotesWidget(const WidgetConfig& config, QWidget* parent
     , m_textColor(Qt::black)
     , m_backgroundColor(Qt::white)
     , m_widgetBackgroundColor(QColor(255, 255, 220)) // 浅黄色，类似便签纸
-    , m_autoSaveTimer(nullptr)
+    , m_autoSaveJob(0)
 {
     parseCustomSettings();
     setupUI();
     loadNote();
     
-    // 设置自动保存定时器
-    m_autoSaveTimer = new QTimer(this);
-    connect(m_autoSaveTimer, &QTimer::timeout, this, &SimpleNotesWidget::onAutoSave);
-    if (m_autoSave) {
-        m_autoSaveTimer->start(m_autoSaveInterval);
-    }
+    // 在共享调度器中注册自动保存任务
+    m_autoSaveJob = WidgetFramework::instance().registerJob(
+        this, m_autoSaveInterval, TickClass::Coarse, [this]() { onAutoSave(); }, m_autoSave);
     
     setMinimumSize(200, 150);
+    
+    // 便签纸没有周期性内容，帧预算紧张时可以顺延
+    setRenderPriority(RenderPriority::Low);
+    
+    // 便签纸完全是静态内容：用纸张图层替换BaseWidget默认的半透明背景
+    removeStaticLayer(QStringLiteral("base"));
+    addStaticLayer(QStringLiteral("paper"), [this](QPainter& painter) { drawPaper(painter); });
 }
 
 void SimpleNotesWidget::setupUI() {
@@ -196,6 +200,7 @@ void SimpleNotesWidget::onChangeFont() {
         settings["fontFamily"] = m_textFont.family();
         settings["fontSize"] = m_textFont.pointSize();
         m_config.customSettings = settings;
+        emit configChanged(m_config);
         
         m_textChanged = true;
     }
@@ -228,6 +233,7 @@ void SimpleNotesWidget::onChangeBackgroundColor() {
         QJsonObject settings = m_config.customSettings;
         settings["backgroundColor"] = m_backgroundColor.name();
         m_config.customSettings = settings;
+        emit configChanged(m_config);
         
         update(); // 触发重绘
         m_textChanged = true;
@@ -263,21 +269,13 @@ void SimpleNotesWidget::updateContent() {
     // 可以在这里检查文件变化等，但一般不需要
 }
 
-void SimpleNotesWidget::paintEvent(QPaintEvent* event) {
-    QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing);
-    
-    // 直接调用子类的绘制方法，不绘制BaseWidget的默认半透明背景
-    drawContent(painter);
-    
-    // 不调用BaseWidget::paintEvent，避免绘制半透明背景
-    QWidget::paintEvent(event);
+void SimpleNotesWidget::drawContent(QPainter& painter) {
+    // 纸张背景、边框和横线都由静态图层缓存提供
+    Q_UNUSED(painter);
 }
 
-void SimpleNotesWidget::drawContent(QPainter& painter) {
+void SimpleNotesWidget::drawPaper(QPainter& painter) {
     // 绘制米白色纸张背景，不使用半透明效果
-    painter.setRenderHint(QPainter::Antialiasing);
-    
     // 使用米白色背景（类似便签纸的颜色）
     QColor paperColor = m_widgetBackgroundColor; // 默认是 QColor(255, 255, 220)
     painter.setBrush(QBrush(paperColor));
@@ -304,18 +302,21 @@ void SimpleNotesWidget::drawContent(QPainter& painter) {
 
 void SimpleNotesWidget::applyConfig() {
     BaseWidget::applyConfig();
+    
+    if (!configDelta().has(ConfigAspect::CustomSettings)) {
+        return;
+    }
+    
     parseCustomSettings();
     updateTextStyle();
     
-    if (m_autoSaveTimer) {
-        if (m_autoSave) {
-            m_autoSaveTimer->start(m_autoSaveInterval);
-        } else {
-            m_autoSaveTimer->stop();
-        }
+    if (m_autoSaveJob && configDelta().anyCustomKeyChanged({"autoSave", "autoSaveInterval"})) {
+        WidgetFramework& framework = WidgetFramework::instance();
+        framework.setJobPeriod(m_autoSaveJob, m_autoSaveInterval);
+        framework.setJobActive(m_autoSaveJob, m_autoSave);
     }
     
-    update();
+    scheduleRepaint();
 }
 
 void SimpleNotesWidget::resizeEvent(QResizeEvent* event) {
@@ -6,6 +6,7 @@
 
 SystemInfoWidget::SystemInfoWidget(const WidgetConfig& config, QWidget* parent)
     : BaseWidget(config, parent)
+    , usageSubscription(0)
     , systemInfo(SystemInfoCollector::getInstance())
 {
     setObjectName("SystemInfoWidget");
@@ -15,18 +16,18 @@ SystemInfoWidget::SystemInfoWidget(const WidgetConfig& config, QWidget* parent)
 }
 
 SystemInfoWidget::~SystemInfoWidget() {
-    if (updateTimer) {
-        updateTimer->stop();
-        delete updateTimer;
+    // 退出阶段采样线程可能已随QCoreApplication销毁，不能为退订重新创建
+    if (PerformanceMonitor* monitor = PerformanceMonitor::existingInstance()) {
+        monitor->unsubscribe(usageSubscription);
     }
 }
 
 void SystemInfoWidget::updateContent() {
     // 在这里更新小组件的内容
     updateSystemInfo();
-    updateCPUUsage();
-    updateMemoryUsage();
-    updateDiskUsage();
+    if (PerformanceSnapshot snapshot = PerformanceMonitor::instance().latestSnapshot()) {
+        applySnapshot(*snapshot);
+    }
 }
 
 void SystemInfoWidget::drawContent(QPainter& painter) {
@@ -34,6 +35,14 @@ void SystemInfoWidget::drawContent(QPainter& painter) {
     Q_UNUSED(painter);
 }
 
+void SystemInfoWidget::onSuspended() {
+    PerformanceMonitor::instance().setSubscriptionActive(usageSubscription, false);
+}
+
+void SystemInfoWidget::onResumed() {
+    PerformanceMonitor::instance().setSubscriptionActive(usageSubscription, true);
+}
+
 void SystemInfoWidget::initUI() {
     mainLayout = new QVBoxLayout(this);
     mainLayout->setSpacing(10);
@@ -85,16 +94,14 @@ void SystemInfoWidget::initUI() {
     mainLayout->addWidget(sysGroup);
     mainLayout->addWidget(diskGroup);
     
-    // 创建更新定时器
-    updateTimer = new QTimer(this);
-    updateTimer->setInterval(2000); // 每2秒更新一次
-    updateTimer->start();
 }
 
 void SystemInfoWidget::initConnections() {
-    connect(updateTimer, &QTimer::timeout, this, &SystemInfoWidget::updateCPUUsage);
-    connect(updateTimer, &QTimer::timeout, this, &SystemInfoWidget::updateMemoryUsage);
-    connect(updateTimer, &QTimer::timeout, this, &SystemInfoWidget::updateDiskUsage);
+    // 订阅共享采样线程的CPU、内存和各卷容量，每2秒更新一次；
+    // 与性能监控小组件共用同一次采样，不再自行读取计数器
+    usageSubscription = PerformanceMonitor::instance().subscribe(
+        this, MetricSource::Cpu | MetricSource::Memory | MetricSource::Volumes, 2000,
+        [this](const PerformanceSnapshot& snapshot) { applySnapshot(*snapshot); });
 }
 
 void SystemInfoWidget::updateTheme() {
@@ -146,7 +153,7 @@ QString SystemInfoWidget::formatSize(qint64 bytes) {
 }
 
 void SystemInfoWidget::updateSystemInfo() {
-    auto info = systemInfo.collectSystemInfo();
+    auto info = systemInfo.collectStaticInfo();
     
     // 更新CPU信息
     cpuModelLabel->setText("型号: " + info.cpuModel);
@@ -155,31 +162,38 @@ void SystemInfoWidget::updateSystemInfo() {
     // 更新系统信息
     osInfoLabel->setText(QString("操作系统: %1 %2").arg(info.osName, info.osVersion));
     computerInfoLabel->setText(QString("计算机名: %1\n用户名: %2").arg(info.computerName, info.userName));
-    
-    // 更新内存信息
-    memoryTotalLabel->setText("总内存: " + formatSize(info.totalMemory));
-    
-    // 更新磁盘信息
+}
+
+void SystemInfoWidget::applySnapshot(const PerformanceData& data) {
+    if (data.updatedSources.testFlag(MetricSource::Cpu)) {
+        updateCPUUsage(data);
+    }
+    if (data.updatedSources.testFlag(MetricSource::Memory)) {
+        updateMemoryUsage(data);
+    }
+    if (data.updatedSources.testFlag(MetricSource::Volumes)) {
+        updateDiskUsage(data);
+    }
+}
+
+void SystemInfoWidget::rebuildDiskRows(const QMap<QString, QPair<qint64, qint64>>& volumes) {
     // 清理旧的磁盘信息控件
     QLayoutItem* item;
     while ((item = diskLayout->takeAt(0)) != nullptr) {
         delete item->widget();
         delete item;
     }
+    diskUsageBars.clear();
+    diskLabels.clear();
     
     // 添加新的磁盘信息
     int row = 0;
-    for (auto it = info.diskSpace.constBegin(); it != info.diskSpace.constEnd(); ++it) {
+    for (auto it = volumes.constBegin(); it != volumes.constEnd(); ++it) {
         QString driveName = it.key();
-        qint64 total = it.value().first;
-        qint64 available = it.value().second;
         
-        QLabel* driveLabel = new QLabel(QString("%1 总容量: %2").arg(driveName, formatSize(total)), this);
+        QLabel* driveLabel = new QLabel(this);
         QProgressBar* usageBar = new QProgressBar(this);
         usageBar->setRange(0, 100);
-        int usagePercent = int((double(total - available) / total) * 100);
-        usageBar->setValue(usagePercent);
-        usageBar->setFormat(QString("%1 可用").arg(formatSize(available)));
         
         diskLayout->addWidget(driveLabel, row, 0);
         diskLayout->addWidget(usageBar, row, 1);
@@ -191,34 +205,41 @@ void SystemInfoWidget::updateSystemInfo() {
     }
 }
 
-void SystemInfoWidget::updateCPUUsage() {
-    double usage = systemInfo.getCurrentCpuUsage();
+void SystemInfoWidget::updateCPUUsage(const PerformanceData& data) {
+    double usage = data.cpuUsage;
     cpuUsageBar->setValue(int(usage));
     cpuUsageBar->setFormat(QString("使用率: %1%").arg(int(usage)));
 }
 
-void SystemInfoWidget::updateMemoryUsage() {
-    qint64 total, available;
-    systemInfo.updateMemoryInfo(total, available);
-    qint64 used = total - available;
-    int usagePercent = int((double(used) / total) * 100);
-    
+void SystemInfoWidget::updateMemoryUsage(const PerformanceData& data) {
+    // 快照中的内存以MB为单位
+    const qint64 mb = 1024 * 1024;
+    qint64 total = data.totalMemory * mb;
+    qint64 used = data.usedMemory * mb;
+    qint64 available = total - used;
+    int usagePercent = total > 0 ? int((double(used) / total) * 100) : 0;
+    
+    memoryTotalLabel->setText("总内存: " + formatSize(total));
     memoryUsageBar->setValue(usagePercent);
     memoryUsageBar->setFormat(QString("已用: %1 (可用: %2)").arg(formatSize(used), formatSize(available)));
 }
 
-void SystemInfoWidget::updateDiskUsage() {
-    auto diskSpace = systemInfo.getDiskSpace();
+void SystemInfoWidget::updateDiskUsage(const PerformanceData& data) {
+    const auto& diskSpace = data.volumes;
+    
+    // 挂载点增减时才重建控件，其余情况只更新数值
+    if (diskSpace.keys() != diskUsageBars.keys()) {
+        rebuildDiskRows(diskSpace);
+    }
     
     for (auto it = diskSpace.constBegin(); it != diskSpace.constEnd(); ++it) {
         QString driveName = it.key();
         qint64 total = it.value().first;
         qint64 available = it.value().second;
         
-        if (diskUsageBars.contains(driveName)) {
-            int usagePercent = int((double(total - available) / total) * 100);
-            diskUsageBars[driveName]->setValue(usagePercent);
-            diskUsageBars[driveName]->setFormat(QString("%1 可用").arg(formatSize(available)));
-        }
+        int usagePercent = total > 0 ? int((double(total - available) / total) * 100) : 0;
+        diskLabels[driveName]->setText(QString("%1 总容量: %2").arg(driveName, formatSize(total)));
+        diskUsageBars[driveName]->setValue(usagePercent);
+        diskUsageBars[driveName]->setFormat(QString("%1 可用").arg(formatSize(available)));
     }
-} 
\ No newline at end of file
+}
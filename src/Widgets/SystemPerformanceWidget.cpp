@@ -1,382 +1,88 @@
 #include "Widgets/SystemPerformanceWidget.h"
+#include "Utils/Logger.h"
+#include "Utils/LogCategories.h"
+#include <QCoreApplication>
 #include <QPainter>
+#include <QPointer>
+#include <QThreadPool>
+#include <QJsonArray>
 #include <QJsonObject>
 #include <QRect>
+#include <QPolygonF>
+#include <QFontMetrics>
+#include <cmath>
 #include <QDebug>
-#include <QThread>
 
-#ifdef Q_OS_WIN
-#include <windows.h>
-#include <pdh.h>
-#include <psapi.h>
-#include <iphlpapi.h>
-#endif
-
-// PerformanceMonitor
-PerformanceMonitor::PerformanceMonitor(QObject* parent)
-    : QThread(parent)
-    , m_running(true)
-    , m_lastBytesReceived(0)
-    , m_lastBytesSent(0)
-#ifdef Q_OS_WIN
-    , m_hQuery(nullptr)
-    , m_hCpuTotal(nullptr)
-    , m_hDiskTime(nullptr)
-    , m_hNetworkTotal(nullptr)
-#endif
-{
-    m_lastNetworkCheckTime = QDateTime::currentDateTime();
-#ifdef Q_OS_WIN
-    initializePdh();
-#endif
-}
-
-PerformanceMonitor::~PerformanceMonitor() {
-    m_running = false;
-    wait();
-#ifdef Q_OS_WIN
-    uninitializePdh();
-#endif
-}
-
-void PerformanceMonitor::stopMonitoring() {
-    m_running = false;
-}
-
-PerformanceData PerformanceMonitor::getCurrentData() const {
-    QMutexLocker locker(&m_dataMutex);
-    return m_currentData;
-}
-
-void PerformanceMonitor::run() {
-    while (m_running) {
-#ifdef Q_OS_WIN
-        if (m_hQuery) {
-            collectPerformanceData();
-        } else {
-            qDebug() << "PDH query not initialized, falling back to basic monitoring";
-            // 使用基本监控方法
-            collectPerformanceData();
+namespace {
+    // 万兆网卡满载时约为1.2GB/s，按量级选择单位
+    QString formatRate(double kbps) {
+        if (kbps >= 1024.0 * 1024.0) {
+            return QString("%1 GB/s").arg(QString::number(kbps / (1024.0 * 1024.0), 'f', 2));
         }
-#else
-        collectPerformanceData();
-#endif
-        QThread::msleep(1000); // 每秒更新一次
-    }
-}
-
-void PerformanceMonitor::collectPerformanceData() {
-    PerformanceData data;
-    data.timestamp = QDateTime::currentDateTime();
-
-#ifdef Q_OS_WIN
-    if (m_hQuery) {
-        // 使用PDH API获取性能数据
-        data.cpuUsage = getCpuUsagePdh();
-        data.diskUsage = getDiskUsagePdh();
-        getNetworkInfoPdh(data.networkUpload, data.networkDownload);
-    } else {
-        // 使用基本方法获取性能数据
-        data.cpuUsage = getCpuUsage();
-        getNetworkInfo(data.networkUpload, data.networkDownload);
-    }
-#else
-    // 非Windows平台使用基本方法
-    data.cpuUsage = getCpuUsage();
-    getNetworkInfo(data.networkUpload, data.networkDownload);
-#endif
-
-    // 获取内存和磁盘信息（这些使用Windows API而不是PDH）
-    getMemoryInfo(data.totalMemory, data.usedMemory);
-    getDiskInfo(data.totalDisk, data.usedDisk);
-    
-    data.memoryUsage = data.totalMemory > 0 ? (double)data.usedMemory / data.totalMemory * 100.0 : 0.0;
-
-    {
-        QMutexLocker locker(&m_dataMutex);
-        m_currentData = data;
-    }
-
-    emit dataUpdated(data);
-}
-
-#ifdef Q_OS_WIN
-void PerformanceMonitor::initializePdh() {
-    PDH_STATUS status = PdhOpenQuery(nullptr, 0, &m_hQuery);
-    if (status != ERROR_SUCCESS) {
-        qDebug() << "Failed to open PDH query";
-        m_hQuery = nullptr;
-        return;
-    }
-
-    // 添加CPU计数器
-    status = PdhAddCounter(m_hQuery, L"\\Processor(_Total)\\% Processor Time", 0, &m_hCpuTotal);
-    if (status != ERROR_SUCCESS) {
-        qDebug() << "Failed to add CPU counter";
-    }
-
-    // 添加磁盘计数器
-    status = PdhAddCounter(m_hQuery, L"\\PhysicalDisk(_Total)\\% Disk Time", 0, &m_hDiskTime);
-    if (status != ERROR_SUCCESS) {
-        qDebug() << "Failed to add disk counter";
-    }
-
-    // 添加网络计数器
-    status = PdhAddCounter(m_hQuery, L"\\Network Interface(*)\\Bytes Total/sec", 0, &m_hNetworkTotal);
-    if (status != ERROR_SUCCESS) {
-        qDebug() << "Failed to add network counter";
-    }
-
-    // 收集第一个样本
-    status = PdhCollectQueryData(m_hQuery);
-    if (status != ERROR_SUCCESS) {
-        qDebug() << "Failed to collect initial PDH data";
-    }
-}
-
-void PerformanceMonitor::uninitializePdh() {
-    if (m_hQuery) {
-        PdhCloseQuery(m_hQuery);
-        m_hQuery = nullptr;
-    }
-}
-
-double PerformanceMonitor::getCpuUsagePdh() {
-    if (!m_hQuery || !m_hCpuTotal) {
-        return getCpuUsage(); // 回退到基本方法
-    }
-
-    PDH_STATUS status = PdhCollectQueryData(m_hQuery);
-    if (status != ERROR_SUCCESS) {
-        return getCpuUsage();
-    }
-
-    PDH_FMT_COUNTERVALUE value;
-    status = PdhGetFormattedCounterValue(m_hCpuTotal, PDH_FMT_DOUBLE, nullptr, &value);
-    if (status != ERROR_SUCCESS) {
-        return getCpuUsage();
-    }
-
-    return value.doubleValue;
-}
-
-double PerformanceMonitor::getDiskUsagePdh() {
-    if (!m_hQuery || !m_hDiskTime) {
-        return 0.0; // 没有基本的回退方法
-    }
-
-    PDH_STATUS status = PdhCollectQueryData(m_hQuery);
-    if (status != ERROR_SUCCESS) {
-        return 0.0;
-    }
-
-    PDH_FMT_COUNTERVALUE value;
-    status = PdhGetFormattedCounterValue(m_hDiskTime, PDH_FMT_DOUBLE, nullptr, &value);
-    if (status != ERROR_SUCCESS) {
-        return 0.0;
-    }
-
-    return value.doubleValue;
-}
-
-void PerformanceMonitor::getNetworkInfoPdh(double& upload, double& download) {
-    if (!m_hQuery || !m_hNetworkTotal) {
-        getNetworkInfo(upload, download); // 回退到基本方法
-        return;
-    }
-
-    PDH_STATUS status = PdhCollectQueryData(m_hQuery);
-    if (status != ERROR_SUCCESS) {
-        getNetworkInfo(upload, download);
-        return;
-    }
-
-    PDH_FMT_COUNTERVALUE value;
-    status = PdhGetFormattedCounterValue(m_hNetworkTotal, PDH_FMT_DOUBLE, nullptr, &value);
-    if (status != ERROR_SUCCESS) {
-        getNetworkInfo(upload, download);
-        return;
-    }
-
-    // PDH返回的是总字节/秒，我们将其分成上传和下载
-    // 这是一个简化的处理方式，实际上可能需要分别监控上传和下载计数器
-    double totalBytes = value.doubleValue;
-    upload = totalBytes / 2.0 / 1024.0;    // 转换为KB/s
-    download = totalBytes / 2.0 / 1024.0;   // 转换为KB/s
-}
-
-void PerformanceMonitor::getMemoryInfo(qint64& total, qint64& used) {
-    MEMORYSTATUSEX memInfo;
-    memInfo.dwLength = sizeof(MEMORYSTATUSEX);
-    if (GlobalMemoryStatusEx(&memInfo)) {
-        total = memInfo.ullTotalPhys / (1024 * 1024); // MB
-        used = (memInfo.ullTotalPhys - memInfo.ullAvailPhys) / (1024 * 1024); // MB
-    } else {
-        total = 0; 
-        used = 0;
-    }
-}
-
-void PerformanceMonitor::getDiskInfo(qint64& total, qint64& used) {
-    ULARGE_INTEGER freeBytesAvailable, totalBytes, totalFreeBytes;
-    if (GetDiskFreeSpaceExW(L"C:\\", &freeBytesAvailable, &totalBytes, &totalFreeBytes)) {
-        total = totalBytes.QuadPart / (1024 * 1024 * 1024); // GB
-        used = (totalBytes.QuadPart - totalFreeBytes.QuadPart) / (1024 * 1024 * 1024); // GB
-    } else {
-        total = 0;
-        used = 0;
-    }
-}
-
-double PerformanceMonitor::getCpuUsage() {
-    FILETIME idleTime, kernelTime, userTime;
-    static FILETIME lastIdleTime = {0, 0}, lastKernelTime = {0, 0}, lastUserTime = {0, 0};
-    static double lastCpuUsage = 0.0;
-
-    if (!GetSystemTimes(&idleTime, &kernelTime, &userTime)) {
-        return lastCpuUsage;
-    }
-
-    ULARGE_INTEGER idle, kernel, user, lastIdle, lastKernel, lastUser;
-    idle.LowPart = idleTime.dwLowDateTime;
-    idle.HighPart = idleTime.dwHighDateTime;
-    kernel.LowPart = kernelTime.dwLowDateTime;
-    kernel.HighPart = kernelTime.dwHighDateTime;
-    user.LowPart = userTime.dwLowDateTime;
-    user.HighPart = userTime.dwHighDateTime;
-
-    lastIdle.LowPart = lastIdleTime.dwLowDateTime;
-    lastIdle.HighPart = lastIdleTime.dwHighDateTime;
-    lastKernel.LowPart = lastKernelTime.dwLowDateTime;
-    lastKernel.HighPart = lastKernelTime.dwHighDateTime;
-    lastUser.LowPart = lastUserTime.dwLowDateTime;
-    lastUser.HighPart = lastUserTime.dwHighDateTime;
-
-    ULONGLONG idleDiff = idle.QuadPart - lastIdle.QuadPart;
-    ULONGLONG kernelDiff = kernel.QuadPart - lastKernel.QuadPart;
-    ULONGLONG userDiff = user.QuadPart - lastUser.QuadPart;
-    ULONGLONG totalDiff = kernelDiff + userDiff;
-
-    if (totalDiff > 0) {
-        lastCpuUsage = ((totalDiff - idleDiff) * 100.0) / totalDiff;
-    }
-
-    lastIdleTime = idleTime;
-    lastKernelTime = kernelTime;
-    lastUserTime = userTime;
-
-    return lastCpuUsage;
-}
-
-void PerformanceMonitor::getNetworkInfo(double& upload, double& download) {
-    MIB_IFTABLE* pIfTable = nullptr;
-    DWORD dwSize = 0;
-    static DWORD lastTime = 0;
-    static ULONG64 lastBytesIn = 0;
-    static ULONG64 lastBytesOut = 0;
-    DWORD currentTime = GetTickCount();
-    
-    upload = download = 0.0;  // 初始化为0
-    
-    // 获取所需缓冲区大小
-    if (GetIfTable(nullptr, &dwSize, TRUE) == ERROR_INSUFFICIENT_BUFFER) {
-        pIfTable = (MIB_IFTABLE*)malloc(dwSize);
-        if (pIfTable) {
-            if (GetIfTable(pIfTable, &dwSize, TRUE) == NO_ERROR) {
-                ULONG64 totalBytesIn = 0;
-                ULONG64 totalBytesOut = 0;
-                
-                // 累加所有活动的网络接口的流量
-                for (DWORD i = 0; i < pIfTable->dwNumEntries; i++) {
-                    // 检查接口是否为以太网或无线网络接口
-                    if (pIfTable->table[i].dwType == IF_TYPE_ETHERNET_CSMACD ||
-                        pIfTable->table[i].dwType == IF_TYPE_IEEE80211) {
-                        
-                        // 检查接口是否处于活动状态且有流量
-                        if ((pIfTable->table[i].dwOperStatus == IF_OPER_STATUS_OPERATIONAL) &&
-                            (pIfTable->table[i].dwInOctets > 0 || pIfTable->table[i].dwOutOctets > 0)) {
-                            
-                            totalBytesIn += pIfTable->table[i].dwInOctets;
-                            totalBytesOut += pIfTable->table[i].dwOutOctets;
-                            
-                            qDebug() << "Interface" << i 
-                                    << "Type:" << pIfTable->table[i].dwType
-                                    << "Status:" << pIfTable->table[i].dwOperStatus
-                                    << "In:" << pIfTable->table[i].dwInOctets
-                                    << "Out:" << pIfTable->table[i].dwOutOctets;
-                        }
-                    }
-                }
-                
-                // 计算速率（KB/s）
-                if (lastTime > 0) {
-                    DWORD timeDiff = currentTime - lastTime;
-                    if (timeDiff > 0) {
-                        // 处理计数器溢出的情况
-                        if (totalBytesIn >= lastBytesIn) {
-                            download = ((totalBytesIn - lastBytesIn) * 1000.0) / (timeDiff * 1024.0);
-                        }
-                        if (totalBytesOut >= lastBytesOut) {
-                            upload = ((totalBytesOut - lastBytesOut) * 1000.0) / (timeDiff * 1024.0);
-                        }
-                        
-                        qDebug() << "Network Speed -"
-                                << "Upload:" << upload << "KB/s,"
-                                << "Download:" << download << "KB/s,"
-                                << "Time diff:" << timeDiff << "ms,"
-                                << "Total In:" << totalBytesIn
-                                << "Last In:" << lastBytesIn
-                                << "Total Out:" << totalBytesOut
-                                << "Last Out:" << lastBytesOut;
-                    }
-                }
-                
-                lastBytesIn = totalBytesIn;
-                lastBytesOut = totalBytesOut;
-            } else {
-                qDebug() << "Failed to get network interface table";
-            }
-            free(pIfTable);
-        } else {
-            qDebug() << "Failed to allocate memory for network interface table";
+        if (kbps >= 1024.0) {
+            return QString("%1 MB/s").arg(QString::number(kbps / 1024.0, 'f', 1));
         }
-    } else {
-        qDebug() << "Failed to get network interface table size";
+        return QString("%1 KB/s").arg(QString::number(kbps, 'f', 1));
     }
-    
-    lastTime = currentTime;
-    
-    // 确保返回的值是有效的
-    if (upload < 0) upload = 0;
-    if (download < 0) download = 0;
 }
-#endif
 
 // SystemPerformanceWidget
 SystemPerformanceWidget::SystemPerformanceWidget(const WidgetConfig& config, QWidget* parent)
     : BaseWidget(config, parent)
-    , m_monitor(nullptr)
+    , m_subscription(0)
+    , m_replayEndMs(0)
+    , m_replayWindow(0)
+    , m_replayGeneration(0)
 {
     setupDefaultConfig();
     parseCustomSettings();
     setMinimumSize(250, 200);
     
-    // 创建性能监测器
-    m_monitor = new PerformanceMonitor(this);
-    connect(m_monitor, &PerformanceMonitor::dataUpdated, 
-            this, &SystemPerformanceWidget::onPerformanceDataUpdated);
+    // 边框、标签和进度条底色只在布局或配置变化时重绘，每秒的数据更新只绘制数值
+    addStaticLayer(QStringLiteral("frame"), [this](QPainter& painter) { drawFrame(painter); });
+    addStaticLayer(QStringLiteral("labels"), [this](QPainter& painter) { drawItems(painter, PaintPass::Static); });
     
-    // 启动监测
-    m_monitor->start();
+    // 订阅共享的性能采样线程，只订阅需要显示的指标
+    m_subscription = PerformanceMonitor::instance().subscribe(
+        this, subscribedSources(), m_config.updateInterval,
+        [this](const PerformanceSnapshot& snapshot) { onPerformanceDataUpdated(*snapshot); });
+    PerformanceMonitor::instance().setSubscriptionAdaptive(m_subscription, m_adaptiveSampling);
 }
 
 SystemPerformanceWidget::~SystemPerformanceWidget() {
-    if (m_monitor) {
-        m_monitor->stopMonitoring();
-        delete m_monitor;
+    // 退出阶段采样线程可能已随QCoreApplication销毁，不能为退订重新创建
+    if (PerformanceMonitor* monitor = PerformanceMonitor::existingInstance()) {
+        monitor->unsubscribe(m_subscription);
     }
 }
 
+MetricSources SystemPerformanceWidget::subscribedSources() const {
+    MetricSources sources;
+    if (m_showCpu) {
+        sources |= MetricSource::Cpu;
+        if (m_showCoreHeatmap) {
+            sources |= MetricSource::CpuCores;
+        }
+    }
+    if (m_showMemory) {
+        sources |= MetricSource::Memory;
+    }
+    if (m_showDisk) {
+        sources |= MetricSource::Disk;
+        if (m_showDetailed && !m_showDiskDevices) {
+            // 容量明细来自各挂载点，刷新周期由采样线程放宽
+            sources |= MetricSource::Volumes;
+        }
+    }
+    if (m_showNetwork) {
+        sources |= MetricSource::Network;
+    }
+    if (m_showProcesses) {
+        sources |= MetricSource::Processes;
+    }
+    return sources;
+}
+
 void SystemPerformanceWidget::setupDefaultConfig() {
     m_labelFont = QFont("微软雅黑", 9);
     m_valueFont = QFont("微软雅黑", 11, QFont::Bold);
@@ -395,6 +101,18 @@ void SystemPerformanceWidget::setupDefaultConfig() {
     m_showNetwork = true;
     m_showDetailed = true;
     m_showProgressBars = true;
+    m_graphStyle = GraphStyle::Bar;
+    m_historyWindow = 3600;
+    m_showCoreHeatmap = false;
+    m_showProcesses = false;
+    m_sortProcessesByMemory = false;
+    m_processCount = 5;
+    m_showDebugOverlay = false;
+    m_adaptiveSampling = true;
+    m_showInterfaces = false;
+    m_interfaceCount = 3;
+    m_showDiskDevices = false;
+    m_diskDeviceCount = 3;
     
     m_itemSpacing = 8;
     m_borderRadius = 8;
@@ -464,6 +182,82 @@ void SystemPerformanceWidget::parseCustomSettings() {
         m_itemSpacing = settings["itemSpacing"].toInt();
     }
     
+    if (settings.contains("graphStyle")) {
+        m_graphStyle = settings["graphStyle"].toString() == "sparkline" ? GraphStyle::Sparkline : GraphStyle::Bar;
+    }
+    
+    if (settings.contains("historyWindow")) {
+        // 最长7天，与MetricsHistory最粗档位的保留时间一致
+        m_historyWindow = qBound(60, settings["historyWindow"].toInt(), 7 * 24 * 3600);
+    }
+    
+    // 回放归档中的一段时间：曲线固定显示该时间段，数值仍为实时数据
+    if (settings.contains("replayFrom")) {
+        const QDateTime from = QDateTime::fromString(settings["replayFrom"].toString(), Qt::ISODate);
+        const QDateTime to = settings.contains("replayTo")
+            ? QDateTime::fromString(settings["replayTo"].toString(), Qt::ISODate)
+            : QDateTime::currentDateTime();
+        loadReplay(from, to);
+    } else {
+        m_replayGeneration++;
+        m_replayHistory.reset();
+    }
+    
+    if (settings.contains("cpuView")) {
+        m_showCoreHeatmap = settings["cpuView"].toString() == "cores";
+    }
+    
+    if (settings.contains("showProcesses")) {
+        m_showProcesses = settings["showProcesses"].toBool();
+    }
+    
+    if (settings.contains("processSortBy")) {
+        m_sortProcessesByMemory = settings["processSortBy"].toString() == "memory";
+    }
+    
+    if (settings.contains("processCount")) {
+        m_processCount = qBound(1, settings["processCount"].toInt(), ProcessScanner::kMaxTopCount);
+    }
+    
+    if (settings.contains("showDebugOverlay")) {
+        m_showDebugOverlay = settings["showDebugOverlay"].toBool();
+    }
+    
+    if (settings.contains("adaptiveSampling")) {
+        m_adaptiveSampling = settings["adaptiveSampling"].toBool();
+    }
+    
+    if (settings.contains("networkView")) {
+        m_showInterfaces = settings["networkView"].toString() == "interfaces";
+    }
+    
+    if (settings.contains("interfaceCount")) {
+        m_interfaceCount = qBound(1, settings["interfaceCount"].toInt(), NetworkSampler::kMaxTopCount);
+    }
+    
+    if (settings.contains("diskView")) {
+        m_showDiskDevices = settings["diskView"].toString() == "devices";
+    }
+    
+    if (settings.contains("diskDeviceCount")) {
+        m_diskDeviceCount = qBound(1, settings["diskDeviceCount"].toInt(), DiskIoSampler::kMaxTopCount);
+    }
+    
+    if (settings.contains("ignoredInterfaces")) {
+        // 采样线程是共享的，过滤规则对所有监控小组件生效
+        QStringList prefixes;
+        for (const QJsonValue& value : settings["ignoredInterfaces"].toArray()) {
+            prefixes.append(value.toString());
+        }
+        PerformanceMonitor::instance().setIgnoredInterfaces(prefixes);
+    }
+
+    if (settings.contains("archiveRetentionDays")) {
+        // 归档同样由共享采样线程写入；段数上限决定了最长保留天数
+        PerformanceMonitor::instance().setArchiveRetentionDays(
+            qBound(1, settings["archiveRetentionDays"].toInt(), MetricsArchive::kMaxSegments));
+    }
+    
     if (settings.contains("borderRadius")) {
         m_borderRadius = settings["borderRadius"].toInt();
     }
@@ -475,21 +269,66 @@ void SystemPerformanceWidget::parseCustomSettings() {
     }
 }
 
+/**
+ * 把归档中的一段记录回放到独立的历史缓冲区，最长7天；时间无效时回到实时曲线。
+ * 7天的归档有数十万条记录，回放在线程池中进行，完成前曲线保持原样
+ */
+void SystemPerformanceWidget::loadReplay(const QDateTime& from, const QDateTime& to) {
+    const quint64 generation = ++m_replayGeneration;
+    if (!from.isValid() || !to.isValid() || from >= to) {
+        qCWarning(lcWidget) << "Invalid replay range" << from << to;
+        m_replayHistory.reset();
+        return;
+    }
+    
+    const qint64 endMs = to.toMSecsSinceEpoch();
+    const qint64 fromMs = qMax(from.toMSecsSinceEpoch(), endMs - qint64(7 * 24 * 3600) * 1000);
+    const int windowSeconds = qMax(60, static_cast<int>((endMs - fromMs) / 1000));
+    const QString directory = MetricsArchive::defaultDirectory();
+    const QPointer<SystemPerformanceWidget> guard(this);
+    
+    QThreadPool::globalInstance()->start([guard, generation, directory, fromMs, endMs, windowSeconds]() {
+        auto history = std::make_shared<MetricsHistory>();
+        MetricsHistory* target = history.get();
+        const qint64 replayed = MetricsArchiveReader(directory).replay(
+            fromMs, endMs, [target](const MetricsArchiveRecord& record) { target->record(record); });
+        qCDebug(lcWidget) << "Replayed" << replayed << "archived samples";
+        
+        // 小组件可能已在回放期间销毁：以应用对象为上下文排队，在界面线程中再检查guard
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [guard, generation, history, endMs, windowSeconds]() {
+            if (guard) {
+                guard->applyReplay(generation, history, endMs, windowSeconds);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void SystemPerformanceWidget::applyReplay(quint64 generation, const std::shared_ptr<MetricsHistory>& history,
+                                          qint64 endMs, int windowSeconds) {
+    if (generation != m_replayGeneration) {
+        return;   // 回放期间配置又变了
+    }
+    m_replayHistory = history;
+    m_replayEndMs = endMs;
+    m_replayWindow = windowSeconds;
+    invalidateStaticLayers();   // 回放时标签布局按曲线样式绘制
+}
+
 void SystemPerformanceWidget::onPerformanceDataUpdated(const PerformanceData& data) {
     QMutexLocker locker(&m_dataMutex);
     m_currentData = data;
-    update(); // 触发重绘
+    scheduleRepaint(); // 触发重绘
 }
 
 void SystemPerformanceWidget::updateContent() {
-    // 性能数据由后台线程更新，这里只需要触发重绘
-    update();
+    // 性能数据由共享采样线程推送，这里只需要触发重绘
+    scheduleRepaint();
 }
 
 void SystemPerformanceWidget::drawContent(QPainter& painter) {
     painter.setRenderHint(QPainter::Antialiasing);
     
-    // 应用与系统信息小组件完全相同的样式
+    // 应用与系统信息小组件完全相同的样式（样式表变化会触发重新布局和重绘，只在内容不同时设置）
     QString style = QString(
         "QWidget { "
         "    border: 1px solid %1; "
@@ -498,21 +337,26 @@ void SystemPerformanceWidget::drawContent(QPainter& painter) {
         "} "
     ).arg(palette().mid().color().name());
     
-    setStyleSheet(style);
-    
-    // 不绘制自定义背景，使用BaseWidget的默认背景（QColor(0, 0, 0, 50)）
+    if (styleSheet() != style) {
+        setStyleSheet(style);
+    }
     
-    // 绘制边框
-    painter.setPen(QPen(m_borderColor, 1));
-    painter.drawRoundedRect(rect().adjusted(1, 1, -1, -1), m_borderRadius, m_borderRadius);
+    // 边框、标签和进度条底色由静态图层缓存提供，这里只绘制数值
+    drawItems(painter, PaintPass::Dynamic);
     
-    // 获取当前性能数据
-    PerformanceData data;
-    {
+    if (m_showDebugOverlay) {
         QMutexLocker locker(&m_dataMutex);
-        data = m_currentData;
+        drawDebugOverlay(painter, m_currentData);
     }
-    
+}
+
+void SystemPerformanceWidget::drawFrame(QPainter& painter) {
+    // 不绘制自定义背景，使用BaseWidget的默认背景（QColor(0, 0, 0, 50)）
+    painter.setPen(QPen(m_borderColor, 1));
+    painter.drawRoundedRect(rect().adjusted(1, 1, -1, -1), m_borderRadius, m_borderRadius);
+}
+
+void SystemPerformanceWidget::drawItems(QPainter& painter, PaintPass pass) {
     // 计算布局
     int margin = 10;
     int availableHeight = rect().height() - 2 * margin;
@@ -522,16 +366,28 @@ void SystemPerformanceWidget::drawContent(QPainter& painter) {
     if (m_showMemory) itemCount++;
     if (m_showDisk) itemCount++;
     if (m_showNetwork) itemCount++;
+    if (m_showProcesses) itemCount++;
     
     if (itemCount == 0) return;
     
+    // 动态部分使用当前性能数据的快照
+    PerformanceData data;
+    if (pass == PaintPass::Dynamic) {
+        QMutexLocker locker(&m_dataMutex);
+        data = m_currentData;
+    }
+    
     int itemHeight = (availableHeight - (itemCount - 1) * m_itemSpacing) / itemCount;
     int currentY = margin;
     
     // 绘制CPU信息
     if (m_showCpu) {
         QRect cpuRect(margin, currentY, rect().width() - 2 * margin, itemHeight);
-        drawPerformanceGraph(painter, cpuRect, "CPU", data.cpuUsage, m_cpuColor);
+        if (m_showCoreHeatmap) {
+            drawCoreHeatmap(painter, cpuRect, pass, data);
+        } else {
+            drawPerformanceGraph(painter, cpuRect, pass, "CPU", HistoryMetric::Cpu, data.cpuUsage, m_cpuColor);
+        }
         currentY += itemHeight + m_itemSpacing;
     }
     
@@ -539,9 +395,9 @@ void SystemPerformanceWidget::drawContent(QPainter& painter) {
     if (m_showMemory) {
         QRect memRect(margin, currentY, rect().width() - 2 * margin, itemHeight);
         if (m_showDetailed) {
-            drawMemoryInfo(painter, memRect);
+            drawMemoryInfo(painter, memRect, pass, data);
         } else {
-            drawPerformanceGraph(painter, memRect, "内存", data.memoryUsage, m_memoryColor);
+            drawPerformanceGraph(painter, memRect, pass, "内存", HistoryMetric::Memory, data.memoryUsage, m_memoryColor);
         }
         currentY += itemHeight + m_itemSpacing;
     }
@@ -549,10 +405,12 @@ void SystemPerformanceWidget::drawContent(QPainter& painter) {
     // 绘制磁盘信息
     if (m_showDisk) {
         QRect diskRect(margin, currentY, rect().width() - 2 * margin, itemHeight);
-        if (m_showDetailed) {
-            drawDiskInfo(painter, diskRect);
+        if (m_showDiskDevices) {
+            drawDiskDeviceTable(painter, diskRect, pass, data);
+        } else if (m_showDetailed) {
+            drawDiskInfo(painter, diskRect, pass, data);
         } else {
-            drawPerformanceGraph(painter, diskRect, "磁盘", data.diskUsage, m_diskColor);
+            drawPerformanceGraph(painter, diskRect, pass, "磁盘", HistoryMetric::Disk, data.diskUsage, m_diskColor);
         }
         currentY += itemHeight + m_itemSpacing;
     }
@@ -560,41 +418,58 @@ void SystemPerformanceWidget::drawContent(QPainter& painter) {
     // 绘制网络信息
     if (m_showNetwork) {
         QRect netRect(margin, currentY, rect().width() - 2 * margin, itemHeight);
-        drawNetworkInfo(painter, netRect);
+        if (m_showInterfaces) {
+            drawInterfaceTable(painter, netRect, pass, data);
+        } else {
+            drawNetworkInfo(painter, netRect, pass, data);
+        }
+        currentY += itemHeight + m_itemSpacing;
+    }
+    
+    // 绘制进程列表
+    if (m_showProcesses) {
+        QRect processRect(margin, currentY, rect().width() - 2 * margin, itemHeight);
+        drawProcessTable(painter, processRect, pass, data);
     }
 }
 
-void SystemPerformanceWidget::drawPerformanceGraph(QPainter& painter, const QRect& rect, 
-                                                  const QString& label, double value, 
+void SystemPerformanceWidget::drawPerformanceGraph(QPainter& painter, const QRect& rect, PaintPass pass,
+                                                  const QString& label, HistoryMetric metric, double value, 
                                                   const QColor& color, const QString& unit) {
-    // 绘制标签
-    painter.setFont(m_labelFont);
-    painter.setPen(m_textColor);
-    
     QRect labelRect = rect;
     labelRect.setHeight(rect.height() / 2);
-    painter.drawText(labelRect, Qt::AlignLeft | Qt::AlignVCenter, label);
     
-    // 绘制数值
-    painter.setFont(m_valueFont);
-    QString valueText = QString("%1%2").arg(QString::number(value, 'f', 1)).arg(unit);
-    painter.drawText(labelRect, Qt::AlignRight | Qt::AlignVCenter, valueText);
+    if (pass == PaintPass::Static) {
+        // 绘制标签
+        painter.setFont(m_labelFont);
+        painter.setPen(m_textColor);
+        painter.drawText(labelRect, Qt::AlignLeft | Qt::AlignVCenter, label);
+    } else {
+        // 绘制数值
+        painter.setFont(m_valueFont);
+        painter.setPen(m_textColor);
+        QString valueText = QString("%1%2").arg(QString::number(value, 'f', 1)).arg(unit);
+        painter.drawText(labelRect, Qt::AlignRight | Qt::AlignVCenter, valueText);
+    }
     
-    // 绘制进度条
-    if (m_showProgressBars) {
+    // 绘制进度条或历史曲线
+    if (m_showProgressBars || showsSparkline()) {
         QRect progressRect = rect;
         progressRect.setTop(rect.top() + rect.height() / 2 + 2);
         progressRect.setHeight(rect.height() / 2 - 4);
-        drawProgressBar(painter, progressRect, value, color);
+        drawValueTrack(painter, progressRect, pass, metric, value, color);
     }
 }
 
-void SystemPerformanceWidget::drawProgressBar(QPainter& painter, const QRect& rect, 
+void SystemPerformanceWidget::drawProgressBar(QPainter& painter, const QRect& rect, PaintPass pass,
                                             double value, const QColor& color) {
     // 绘制背景
-    painter.setPen(Qt::NoPen);
-    painter.setBrush(QColor(color.red(), color.green(), color.blue(), 50));
-    painter.drawRoundedRect(rect, 3, 3);
+    if (pass == PaintPass::Static) {
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(QColor(color.red(), color.green(), color.blue(), 50));
+        painter.drawRoundedRect(rect, 3, 3);
+        return;
+    }
     
     // 绘制进度
     if (value > 0) {
@@ -605,105 +480,280 @@ void SystemPerformanceWidget::drawProgressBar(QPainter& painter, const QRect& re
         gradient.setColorAt(0, color);
         gradient.setColorAt(1, color.darker(120));
         
+        painter.setPen(Qt::NoPen);
         painter.setBrush(gradient);
         painter.drawRoundedRect(progressRect, 3, 3);
     }
 }
 
-void SystemPerformanceWidget::drawMemoryInfo(QPainter& painter, const QRect& rect) {
-    PerformanceData data;
-    {
-        QMutexLocker locker(&m_dataMutex);
-        data = m_currentData;
+void SystemPerformanceWidget::drawValueTrack(QPainter& painter, const QRect& rect, PaintPass pass,
+                                             HistoryMetric metric, double value, const QColor& color) {
+    if (showsSparkline()) {
+        drawSparkline(painter, rect, pass, metric, color);
+    } else {
+        drawProgressBar(painter, rect, pass, value, color);
+    }
+}
+
+/**
+ * 历史面积图：横轴为最近m_historyWindow秒（回放时为回放的时间段），纵轴0-100%；
+ * 分钟及以上的汇总档额外绘制min/max范围带，缺数据处断开曲线
+ */
+void SystemPerformanceWidget::drawSparkline(QPainter& painter, const QRect& rect, PaintPass pass,
+                                            HistoryMetric metric, const QColor& color) {
+    // 绘制背景
+    if (pass == PaintPass::Static) {
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(QColor(color.red(), color.green(), color.blue(), 30));
+        painter.drawRoundedRect(rect, 3, 3);
+        return;
     }
     
+    if (rect.width() <= 2 || rect.height() <= 2) {
+        return;
+    }
+    
+    const MetricsHistory& history = m_replayHistory ? *m_replayHistory : PerformanceMonitor::instance().history();
+    const int windowSeconds = m_replayHistory ? m_replayWindow : m_historyWindow;
+    const qint64 endMs = m_replayHistory ? m_replayEndMs : QDateTime::currentMSecsSinceEpoch();
+    const qint64 windowMs = qint64(windowSeconds) * 1000;
+    const qint64 startMs = endMs - windowMs;
+    history.query(metric, MetricsHistory::resolutionForWindow(windowSeconds), startMs, m_historySeries);
+    if (m_historySeries.size() == 0) {
+        return;
+    }
+    
+    // 相邻两点间隔超过2.5个周期视为缺数据（例如暂停或休眠期间）；周期取分辨率和最长采样间隔中较大者，
+    // 自适应采样平稳时每秒档中相邻两点可能相隔数秒，不能当作缺数据断开曲线
+    const qint64 sampleIntervalMs = PerformanceMonitor::longestSampleInterval(m_config.updateInterval, m_adaptiveSampling);
+    const qint64 gapMs = qMax(MetricsHistory::resolutionMs(m_historySeries.resolution), sampleIntervalMs) * 5 / 2;
+    const bool showRange = m_historySeries.resolution != HistoryResolution::Second;
+    const double left = rect.left();
+    const double width = rect.width();
+    const double bottom = rect.bottom();
+    const double height = rect.height();
+    auto xAt = [&](qint64 timeMs) { return left + width * double(timeMs - startMs) / double(windowMs); };
+    auto yAt = [&](float value) { return bottom - height * qBound(0.0, double(value) / 100.0, 1.0); };
+    
+    const QColor areaColor(color.red(), color.green(), color.blue(), 80);
+    const QColor rangeColor(color.red(), color.green(), color.blue(), 50);
+    QPolygonF line;
+    QPolygonF range;    // 上沿为max，下沿为min（逆序追加）
+    QPolygonF lower;
+    
+    auto flushSegment = [&]() {
+        if (!line.isEmpty()) {
+            if (showRange) {
+                for (int i = lower.size() - 1; i >= 0; --i) {
+                    range << lower[i];
+                }
+                painter.setPen(Qt::NoPen);
+                painter.setBrush(rangeColor);
+                painter.drawPolygon(range);
+            }
+            
+            QPolygonF area(line);
+            area << QPointF(line.last().x(), bottom) << QPointF(line.first().x(), bottom);
+            painter.setPen(Qt::NoPen);
+            painter.setBrush(areaColor);
+            painter.drawPolygon(area);
+            
+            painter.setPen(QPen(color, 1.5));
+            painter.setBrush(Qt::NoBrush);
+            painter.drawPolyline(line);
+        }
+        line.clear();
+        range.clear();
+        lower.clear();
+    };
+    
+    painter.save();
+    painter.setClipRect(rect);
+    
+    qint64 previousMs = -1;
+    for (int i = 0; i < m_historySeries.size(); ++i) {
+        const qint64 timeMs = m_historySeries.timeMs[i];
+        const float avg = m_historySeries.avg[i];
+        if (qIsNaN(avg)) {
+            flushSegment();
+            previousMs = -1;
+            continue;
+        }
+        if (previousMs >= 0 && timeMs - previousMs > gapMs) {
+            flushSegment();
+        }
+        previousMs = timeMs;
+        
+        const double x = xAt(timeMs);
+        line << QPointF(x, yAt(avg));
+        if (showRange) {
+            range << QPointF(x, yAt(m_historySeries.max[i]));
+            lower << QPointF(x, yAt(m_historySeries.min[i]));
+        }
+    }
+    flushSegment();
+    
+    painter.restore();
+}
+
+/**
+ * 每核心热力图：第一行为总使用率、最忙核心和平均频率，下方每个格子对应一个核心，
+ * 颜色深浅表示使用率；格子排列尽量接近正方形，128核以上也能放进一栏
+ */
+void SystemPerformanceWidget::drawCoreHeatmap(QPainter& painter, const QRect& rect, PaintPass pass,
+                                              const PerformanceData& data) {
+    QRect labelRect = rect;
+    labelRect.setHeight(rect.height() / 3);
+    QRect gridRect = rect;
+    gridRect.setTop(rect.top() + rect.height() / 3 + 2);
+    
+    if (pass == PaintPass::Static) {
+        painter.setFont(m_labelFont);
+        painter.setPen(m_textColor);
+        painter.drawText(labelRect, Qt::AlignLeft | Qt::AlignVCenter, "CPU");
+        
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(QColor(m_cpuColor.red(), m_cpuColor.green(), m_cpuColor.blue(), 30));
+        painter.drawRoundedRect(gridRect, 3, 3);
+        return;
+    }
+    
+    const int coreCount = data.coreUsage.size();
+    float busiest = 0.0f;
+    double frequencySum = 0.0;
+    int frequencyCount = 0;
+    for (int i = 0; i < coreCount; ++i) {
+        busiest = qMax(busiest, data.coreUsage[i]);
+        if (i < data.coreFrequencyMhz.size() && data.coreFrequencyMhz[i] > 0.0f) {
+            frequencySum += data.coreFrequencyMhz[i];
+            frequencyCount++;
+        }
+    }
+    
+    // 第一行：总使用率、最忙核心、平均频率
+    QString valueText = QString("%1%").arg(QString::number(data.cpuUsage, 'f', 1));
+    if (coreCount > 0) {
+        valueText += QString("  峰值 %1%").arg(QString::number(busiest, 'f', 0));
+    }
+    if (frequencyCount > 0) {
+        valueText += QString("  %1GHz").arg(QString::number(frequencySum / frequencyCount / 1000.0, 'f', 1));
+    }
+    painter.setFont(m_labelFont);
+    painter.setPen(m_textColor);
+    painter.drawText(labelRect, Qt::AlignRight | Qt::AlignVCenter, valueText);
+    
+    if (coreCount == 0 || gridRect.width() <= 0 || gridRect.height() <= 0) {
+        return;
+    }
+    
+    // 列数按区域宽高比估算，再收紧到刚好放下所有核心
+    int columns = qBound(1, int(std::ceil(std::sqrt(double(coreCount) * gridRect.width() / gridRect.height()))), coreCount);
+    const int rows = (coreCount + columns - 1) / columns;
+    columns = (coreCount + rows - 1) / rows;
+    const double cellWidth = double(gridRect.width()) / columns;
+    const double cellHeight = double(gridRect.height()) / rows;
+    const double gap = qMin(cellWidth, cellHeight) > 6.0 ? 1.0 : 0.0;
+    
+    painter.setPen(Qt::NoPen);
+    for (int i = 0; i < coreCount; ++i) {
+        const int row = i / columns;
+        const int column = i % columns;
+        const QRectF cell(gridRect.left() + column * cellWidth, gridRect.top() + row * cellHeight,
+                          cellWidth - gap, cellHeight - gap);
+        const double load = qBound(0.0, double(data.coreUsage[i]) / 100.0, 1.0);
+        painter.setBrush(QColor(m_cpuColor.red(), m_cpuColor.green(), m_cpuColor.blue(), 40 + int(215 * load)));
+        painter.drawRect(cell);
+    }
+}
+
+void SystemPerformanceWidget::drawMemoryInfo(QPainter& painter, const QRect& rect, PaintPass pass,
+                                             const PerformanceData& data) {
     painter.setFont(m_labelFont);
     painter.setPen(m_textColor);
     
     // 第一行：标签和百分比
     QRect firstLineRect = rect;
     firstLineRect.setHeight(rect.height() / 3);
-    painter.drawText(firstLineRect, Qt::AlignLeft | Qt::AlignVCenter, "内存");
     
-    QString percentText = QString("%1%").arg(QString::number(data.memoryUsage, 'f', 1));
-    painter.drawText(firstLineRect, Qt::AlignRight | Qt::AlignVCenter, percentText);
-    
-    // 第二行：详细信息
-    if (data.totalMemory > 0) {
-        QRect secondLineRect = rect;
-        secondLineRect.setTop(rect.top() + rect.height() / 3);
-        secondLineRect.setHeight(rect.height() / 3);
+    if (pass == PaintPass::Static) {
+        painter.drawText(firstLineRect, Qt::AlignLeft | Qt::AlignVCenter, "内存");
+    } else {
+        QString percentText = QString("%1%").arg(QString::number(data.memoryUsage, 'f', 1));
+        painter.drawText(firstLineRect, Qt::AlignRight | Qt::AlignVCenter, percentText);
         
-        painter.setFont(QFont(m_labelFont.family(), m_labelFont.pointSize() - 1));
-        QString detailText = QString("%1MB / %2MB")
-            .arg(data.usedMemory)
-            .arg(data.totalMemory);
-        painter.drawText(secondLineRect, Qt::AlignCenter, detailText);
+        // 第二行：详细信息
+        if (data.totalMemory > 0) {
+            QRect secondLineRect = rect;
+            secondLineRect.setTop(rect.top() + rect.height() / 3);
+            secondLineRect.setHeight(rect.height() / 3);
+            
+            painter.setFont(QFont(m_labelFont.family(), m_labelFont.pointSize() - 1));
+            QString detailText = QString("%1MB / %2MB")
+                .arg(data.usedMemory)
+                .arg(data.totalMemory);
+            painter.drawText(secondLineRect, Qt::AlignCenter, detailText);
+        }
     }
     
     // 第三行：进度条
-    if (m_showProgressBars) {
+    if (m_showProgressBars || showsSparkline()) {
         QRect progressRect = rect;
         progressRect.setTop(rect.top() + 2 * rect.height() / 3 + 2);
         progressRect.setHeight(rect.height() / 3 - 4);
-        drawProgressBar(painter, progressRect, data.memoryUsage, m_memoryColor);
+        drawValueTrack(painter, progressRect, pass, HistoryMetric::Memory, data.memoryUsage, m_memoryColor);
     }
 }
 
-void SystemPerformanceWidget::drawDiskInfo(QPainter& painter, const QRect& rect) {
-    PerformanceData data;
-    {
-        QMutexLocker locker(&m_dataMutex);
-        data = m_currentData;
-    }
-    
+void SystemPerformanceWidget::drawDiskInfo(QPainter& painter, const QRect& rect, PaintPass pass,
+                                           const PerformanceData& data) {
     painter.setFont(m_labelFont);
     painter.setPen(m_textColor);
     
     // 第一行：标签和百分比
     QRect firstLineRect = rect;
     firstLineRect.setHeight(rect.height() / 3);
-    painter.drawText(firstLineRect, Qt::AlignLeft | Qt::AlignVCenter, "磁盘");
-    
-    QString percentText = QString("%1%").arg(QString::number(data.diskUsage, 'f', 1));
-    painter.drawText(firstLineRect, Qt::AlignRight | Qt::AlignVCenter, percentText);
     
-    // 第二行：详细信息
-    if (data.totalDisk > 0) {
-        QRect secondLineRect = rect;
-        secondLineRect.setTop(rect.top() + rect.height() / 3);
-        secondLineRect.setHeight(rect.height() / 3);
+    if (pass == PaintPass::Static) {
+        painter.drawText(firstLineRect, Qt::AlignLeft | Qt::AlignVCenter, "磁盘");
+    } else {
+        QString percentText = QString("%1%").arg(QString::number(data.diskUsage, 'f', 1));
+        painter.drawText(firstLineRect, Qt::AlignRight | Qt::AlignVCenter, percentText);
         
-        painter.setFont(QFont(m_labelFont.family(), m_labelFont.pointSize() - 1));
-        QString detailText = QString("%1GB / %2GB")
-            .arg(data.usedDisk)
-            .arg(data.totalDisk);
-        painter.drawText(secondLineRect, Qt::AlignCenter, detailText);
+        // 第二行：详细信息
+        if (data.totalDisk > 0) {
+            QRect secondLineRect = rect;
+            secondLineRect.setTop(rect.top() + rect.height() / 3);
+            secondLineRect.setHeight(rect.height() / 3);
+            
+            painter.setFont(QFont(m_labelFont.family(), m_labelFont.pointSize() - 1));
+            QString detailText = QString("%1GB / %2GB")
+                .arg(data.usedDisk)
+                .arg(data.totalDisk);
+            painter.drawText(secondLineRect, Qt::AlignCenter, detailText);
+        }
     }
     
     // 第三行：进度条
-    if (m_showProgressBars) {
+    if (m_showProgressBars || showsSparkline()) {
         QRect progressRect = rect;
         progressRect.setTop(rect.top() + 2 * rect.height() / 3 + 2);
         progressRect.setHeight(rect.height() / 3 - 4);
-        drawProgressBar(painter, progressRect, data.diskUsage, m_diskColor);
+        drawValueTrack(painter, progressRect, pass, HistoryMetric::Disk, data.diskUsage, m_diskColor);
     }
 }
 
-void SystemPerformanceWidget::drawNetworkInfo(QPainter& painter, const QRect& rect) {
-    PerformanceData data;
-    {
-        QMutexLocker locker(&m_dataMutex);
-        data = m_currentData;
-    }
-    
+void SystemPerformanceWidget::drawNetworkInfo(QPainter& painter, const QRect& rect, PaintPass pass,
+                                              const PerformanceData& data) {
     painter.setFont(m_labelFont);
     painter.setPen(m_textColor);
     
     // 第一行：标签
-    QRect firstLineRect = rect;
-    firstLineRect.setHeight(rect.height() / 2);
-    painter.drawText(firstLineRect, Qt::AlignLeft | Qt::AlignVCenter, "网络");
+    if (pass == PaintPass::Static) {
+        QRect firstLineRect = rect;
+        firstLineRect.setHeight(rect.height() / 2);
+        painter.drawText(firstLineRect, Qt::AlignLeft | Qt::AlignVCenter, "网络");
+        return;
+    }
     
     // 第二行：上传/下载速度
     QRect secondLineRect = rect;
@@ -712,8 +762,8 @@ void SystemPerformanceWidget::drawNetworkInfo(QPainter& painter, const QRect& re
     
     painter.setFont(QFont(m_labelFont.family(), m_labelFont.pointSize() - 1));
     
-    QString uploadText = QString("↑ %1 KB/s").arg(QString::number(data.networkUpload, 'f', 1));
-    QString downloadText = QString("↓ %1 KB/s").arg(QString::number(data.networkDownload, 'f', 1));
+    QString uploadText = QString("↑ %1").arg(formatRate(data.networkUpload));
+    QString downloadText = QString("↓ %1").arg(formatRate(data.networkDownload));
     
     // 分两列显示上传和下载
     QRect uploadRect = secondLineRect;
@@ -725,10 +775,182 @@ void SystemPerformanceWidget::drawNetworkInfo(QPainter& painter, const QRect& re
     painter.drawText(downloadRect, Qt::AlignLeft | Qt::AlignVCenter, downloadText);
 }
 
-void SystemPerformanceWidget::applyConfig() {
-    BaseWidget::applyConfig();
-    parseCustomSettings();
-    updateContent();
+/**
+ * 表头为总吞吐，其下每行一个接口，按收发速率之和排序
+ */
+void SystemPerformanceWidget::drawInterfaceTable(QPainter& painter, const QRect& rect, PaintPass pass,
+                                                 const PerformanceData& data) {
+    QRect headerRect = rect;
+    headerRect.setHeight(qMin(rect.height(), QFontMetrics(m_labelFont).height() + 2));
+    
+    painter.setFont(m_labelFont);
+    painter.setPen(m_textColor);
+    if (pass == PaintPass::Static) {
+        painter.drawText(headerRect, Qt::AlignLeft | Qt::AlignVCenter, "网络");
+        return;
+    }
+    painter.drawText(headerRect, Qt::AlignRight | Qt::AlignVCenter,
+                     QString("↑ %1  ↓ %2").arg(formatRate(data.networkUpload), formatRate(data.networkDownload)));
+    
+    const QFont rowFont(m_labelFont.family(), m_labelFont.pointSize() - 1);
+    painter.setFont(rowFont);
+    const QFontMetrics metrics(rowFont);
+    const int rowHeight = metrics.height();
+    const int valueWidth = metrics.horizontalAdvance("↑ 0000.0 KB/s  ↓ 0000.0 KB/s");
+    
+    int y = headerRect.bottom() + 1;
+    const int count = qMin(m_interfaceCount, data.topInterfaces.size());
+    for (int i = 0; i < count && y + rowHeight <= rect.bottom() + 1; ++i, y += rowHeight) {
+        const InterfaceThroughput& item = data.topInterfaces[i];
+        const QRect nameRect(rect.left(), y, qMax(0, rect.width() - valueWidth), rowHeight);
+        const QRect valueRect(rect.right() - valueWidth, y, valueWidth, rowHeight);
+        painter.drawText(nameRect, Qt::AlignLeft | Qt::AlignVCenter,
+                         metrics.elidedText(item.name, Qt::ElideRight, nameRect.width()));
+        painter.drawText(valueRect, Qt::AlignRight | Qt::AlignVCenter,
+                         QString("↑ %1  ↓ %2").arg(formatRate(item.uploadKBps), formatRate(item.downloadKBps)));
+    }
+}
+
+/**
+ * 表头为所有磁盘的读写速度，其下每行一块磁盘：读写速度、IOPS和平均耗时
+ */
+void SystemPerformanceWidget::drawDiskDeviceTable(QPainter& painter, const QRect& rect, PaintPass pass,
+                                                  const PerformanceData& data) {
+    QRect headerRect = rect;
+    headerRect.setHeight(qMin(rect.height(), QFontMetrics(m_labelFont).height() + 2));
+    
+    painter.setFont(m_labelFont);
+    painter.setPen(m_textColor);
+    if (pass == PaintPass::Static) {
+        painter.drawText(headerRect, Qt::AlignLeft | Qt::AlignVCenter, "磁盘");
+        return;
+    }
+    painter.drawText(headerRect, Qt::AlignRight | Qt::AlignVCenter,
+                     QString("R %1  W %2").arg(formatRate(data.diskReadKBps), formatRate(data.diskWriteKBps)));
+    
+    const QFont rowFont(m_labelFont.family(), m_labelFont.pointSize() - 1);
+    painter.setFont(rowFont);
+    const QFontMetrics metrics(rowFont);
+    const int rowHeight = metrics.height();
+    const int valueWidth = metrics.horizontalAdvance("R 0000.0 KB/s  W 0000.0 KB/s  00000 IOPS  000.0 ms");
+    
+    int y = headerRect.bottom() + 1;
+    const int count = qMin(m_diskDeviceCount, data.diskDevices.size());
+    for (int i = 0; i < count && y + rowHeight <= rect.bottom() + 1; ++i, y += rowHeight) {
+        const DiskDeviceStats& device = data.diskDevices[i];
+        const QRect nameRect(rect.left(), y, qMax(0, rect.width() - valueWidth), rowHeight);
+        const QRect valueRect(rect.right() - valueWidth, y, valueWidth, rowHeight);
+        painter.drawText(nameRect, Qt::AlignLeft | Qt::AlignVCenter,
+                         metrics.elidedText(device.name, Qt::ElideRight, nameRect.width()));
+        painter.drawText(valueRect, Qt::AlignRight | Qt::AlignVCenter,
+                         QString("R %1  W %2  %3 IOPS  %4 ms")
+                             .arg(formatRate(device.readKBps), formatRate(device.writeKBps))
+                             .arg(qRound(device.readIops + device.writeIops))
+                             .arg(QString::number(device.avgServiceMs, 'f', 1)));
+    }
 }
 
+void SystemPerformanceWidget::drawProcessTable(QPainter& painter, const QRect& rect, PaintPass pass,
+                                               const PerformanceData& data) {
+    QRect headerRect = rect;
+    headerRect.setHeight(qMin(rect.height(), QFontMetrics(m_labelFont).height() + 2));
+    
+    painter.setFont(m_labelFont);
+    painter.setPen(m_textColor);
+    if (pass == PaintPass::Static) {
+        painter.drawText(headerRect, Qt::AlignLeft | Qt::AlignVCenter, "进程");
+        painter.drawText(headerRect, Qt::AlignRight | Qt::AlignVCenter, m_sortProcessesByMemory ? "内存" : "CPU");
+        return;
+    }
+    
+    const QVector<ProcessSample>& processes = m_sortProcessesByMemory ? data.topMemoryProcesses : data.topCpuProcesses;
+    const QFont rowFont(m_labelFont.family(), m_labelFont.pointSize() - 1);
+    painter.setFont(rowFont);
+    const QFontMetrics metrics(rowFont);
+    const int rowHeight = metrics.height();
+    const int valueWidth = metrics.horizontalAdvance("0000.0 MB");
+    
+    int y = headerRect.bottom() + 1;
+    const int count = qMin(m_processCount, processes.size());
+    for (int i = 0; i < count && y + rowHeight <= rect.bottom() + 1; ++i, y += rowHeight) {
+        const ProcessSample& process = processes[i];
+        const QRect nameRect(rect.left(), y, rect.width() - valueWidth, rowHeight);
+        const QRect valueRect(rect.right() - valueWidth, y, valueWidth, rowHeight);
+        
+        const QString valueText = m_sortProcessesByMemory
+            ? QString("%1 MB").arg(QString::number(process.rssBytes / (1024.0 * 1024.0), 'f', 1))
+            : QString("%1%").arg(QString::number(process.cpuPercent, 'f', 1));
+        painter.drawText(nameRect, Qt::AlignLeft | Qt::AlignVCenter,
+                         metrics.elidedText(process.name, Qt::ElideRight, nameRect.width()));
+        painter.drawText(valueRect, Qt::AlignRight | Qt::AlignVCenter, valueText);
+    }
+}
 
+/**
+ * 调试信息：共享采样线程的平均/最大耗时和进程扫描的耗时，用于确认采样开销在预算内
+ */
+void SystemPerformanceWidget::drawDebugOverlay(QPainter& painter, const PerformanceData& data) {
+    const SamplingStats sampling = PerformanceMonitor::instance().getSamplingStats();
+    QString text = QString("采样 %1/%2us 偏差 %3/%4ms 周期 %5ms")
+        .arg(QString::number(sampling.avgCostUs, 'f', 0))
+        .arg(QString::number(sampling.maxCostUs, 'f', 0))
+        .arg(QString::number(sampling.avgJitterUs / 1000.0, 'f', 1))
+        .arg(QString::number(sampling.maxJitterUs / 1000.0, 'f', 1))
+        .arg(sampling.shortestIntervalMs);
+    if (m_showProcesses) {
+        const ProcessScanStats& scan = data.processScanStats;
+        text += QString("  进程扫描 %1/%2us %3/%4 超预算%5")
+            .arg(QString::number(scan.lastScanUs, 'f', 0))
+            .arg(QString::number(scan.maxScanUs, 'f', 0))
+            .arg(scan.refreshedCount)
+            .arg(scan.processCount)
+            .arg(scan.budgetHits);
+    }
+    
+    const QFont font(m_labelFont.family(), qMax(6, m_labelFont.pointSize() - 2));
+    const QFontMetrics metrics(font);
+    QRect overlayRect = rect().adjusted(4, 0, -4, -4);
+    overlayRect.setTop(overlayRect.bottom() - metrics.height());
+    
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(0, 0, 0, 160));
+    painter.drawRect(overlayRect);
+    painter.setFont(font);
+    painter.setPen(QColor(255, 255, 0));
+    painter.drawText(overlayRect, Qt::AlignLeft | Qt::AlignVCenter,
+                     metrics.elidedText(text, Qt::ElideRight, overlayRect.width()));
+}
+
+void SystemPerformanceWidget::onSuspended() {
+    PerformanceMonitor::instance().setSubscriptionActive(m_subscription, false);
+}
+
+void SystemPerformanceWidget::onResumed() {
+    PerformanceMonitor::instance().setSubscriptionActive(m_subscription, true);
+}
+
+// 鼠标悬停视为正在查看，自适应订阅在此期间按较快的周期刷新
+void SystemPerformanceWidget::enterEvent(QEnterEvent* event) {
+    BaseWidget::enterEvent(event);
+    PerformanceMonitor::instance().setSubscriptionFocused(m_subscription, true);
+}
+
+void SystemPerformanceWidget::leaveEvent(QEvent* event) {
+    BaseWidget::leaveEvent(event);
+    PerformanceMonitor::instance().setSubscriptionFocused(m_subscription, false);
+}
+
+void SystemPerformanceWidget::applyConfig() {
+    BaseWidget::applyConfig();
+    
+    if (configDelta().has(ConfigAspect::CustomSettings)) {
+        parseCustomSettings();
+        updateContent();
+    }
+    // 来源和刷新间隔变化时同步更新性能监视器的订阅
+    if (configDelta().has(ConfigAspect::CustomSettings) || configDelta().has(ConfigAspect::UpdateInterval)) {
+        PerformanceMonitor::instance().updateSubscription(m_subscription, subscribedSources(),
+                                                          m_config.updateInterval);
+        PerformanceMonitor::instance().setSubscriptionAdaptive(m_subscription, m_adaptiveSampling);
+    }
+}
@@ -1,4 +1,5 @@
 #include "Widgets/WeatherWidget.h"
+#include "Utils/LogCategories.h"
 #include <QPainter>
 #include <QJsonObject>
 #include <QJsonDocument>
@@ -33,11 +34,11 @@ WeatherWidget::WeatherWidget(const WidgetConfig& config, QWidget* parent)
     setupDefaultConfig();
     parseCustomSettings();
     
-    qDebug() << "WeatherWidget构造函数: 解析配置完成";
-    qDebug() << "  API Provider:" << m_apiProvider;
-    qDebug() << "  API Host:" << (m_apiHost.isEmpty() ? "默认" : m_apiHost);
-    qDebug() << "  API Key长度:" << m_apiKey.length();
-    qDebug() << "  City Name:" << m_cityName;
+    qCDebug(lcConfig) << "WeatherWidget构造函数: 解析配置完成";
+    qCDebug(lcConfig) << "  API Provider:" << m_apiProvider;
+    qCDebug(lcConfig) << "  API Host:" << (m_apiHost.isEmpty() ? "默认" : m_apiHost);
+    qCDebug(lcConfig) << "  API Key长度:" << m_apiKey.length();
+    qCDebug(lcConfig) << "  City Name:" << m_cityName;
     
     // 初始化网络管理器
     m_networkManager = new QNetworkAccessManager(this);
@@ -46,7 +47,7 @@ WeatherWidget::WeatherWidget(const WidgetConfig& config, QWidget* parent)
     connect(m_networkManager, &QNetworkAccessManager::sslErrors,
             [](QNetworkReply* reply, const QList<QSslError>& errors) {
                 Q_UNUSED(errors)
-                qDebug() << "WeatherWidget忽略SSL错误:" << errors;
+                qCDebug(lcConfig) << "WeatherWidget忽略SSL错误:" << errors;
                 reply->ignoreSslErrors();
             });
     
@@ -59,15 +60,21 @@ WeatherWidget::WeatherWidget(const WidgetConfig& config, QWidget* parent)
     // 初始化天气数据为无效状态
     m_weatherData.isValid = false;
     
+    // 天气内容变化缓慢，帧预算紧张时可以顺延
+    setRenderPriority(RenderPriority::Low);
+    
+    // 天气内容只在数据到达或配置变化时改变，整体作为静态图层缓存
+    addStaticLayer(QStringLiteral("weather"), [this](QPainter& painter) { drawWeather(painter); });
+    
     // 如果有有效的API配置，立即获取一次天气数据
     if (!m_apiKey.isEmpty() && m_apiKey != "your_api_key_here" && !m_cityName.isEmpty()) {
-        qDebug() << "配置有效，立即获取天气数据";
+        qCDebug(lcConfig) << "配置有效，立即获取天气数据";
         fetchWeatherData();
     } else {
-        qDebug() << "配置无效，跳过天气数据获取";
-        qDebug() << "  API Key是否为空:" << m_apiKey.isEmpty();
-        qDebug() << "  API Key是否为默认值:" << (m_apiKey == "your_api_key_here");
-        qDebug() << "  城市名称是否为空:" << m_cityName.isEmpty();
+        qCDebug(lcConfig) << "配置无效，跳过天气数据获取";
+        qCDebug(lcConfig) << "  API Key是否为空:" << m_apiKey.isEmpty();
+        qCDebug(lcConfig) << "  API Key是否为默认值:" << (m_apiKey == "your_api_key_here");
+        qCDebug(lcConfig) << "  城市名称是否为空:" << m_cityName.isEmpty();
     }
     
     // 设置更新间隔
@@ -151,22 +158,28 @@ void WeatherWidget::parseCustomSettings() {
 void WeatherWidget::applyConfig() {
     BaseWidget::applyConfig();
     
-    qDebug() << "WeatherWidget::applyConfig: 开始应用配置";
-    qDebug() << "配置ID:" << m_config.id;
-    qDebug() << "配置名称:" << m_config.name;
+    if (!configDelta().has(ConfigAspect::CustomSettings)) {
+        return;
+    }
+    
+    qCDebug(lcConfig) << "WeatherWidget::applyConfig: 开始应用配置";
+    qCDebug(lcConfig) << "配置ID:" << m_config.id;
+    qCDebug(lcConfig) << "配置名称:" << m_config.name;
     
     parseCustomSettings();
     
-    qDebug() << "解析后的API设置:";
-    qDebug() << "  API Provider:" << m_apiProvider;
-    qDebug() << "  API Host:" << (m_apiHost.isEmpty() ? "默认" : m_apiHost);
-    qDebug() << "  API Key:" << m_apiKey;
-    qDebug() << "  City Name:" << m_cityName;
+    qCDebug(lcConfig) << "解析后的API设置:";
+    qCDebug(lcConfig) << "  API Provider:" << m_apiProvider;
+    qCDebug(lcConfig) << "  API Host:" << (m_apiHost.isEmpty() ? "默认" : m_apiHost);
+    qCDebug(lcConfig) << "  API Key:" << m_apiKey;
+    qCDebug(lcConfig) << "  City Name:" << m_cityName;
     
-    // 如果配置有变化，重新获取天气数据
-    fetchWeatherData();
+    // 只有数据源相关的设置变化时才重新获取天气数据
+    if (configDelta().anyCustomKeyChanged({"apiKey", "apiHost", "cityName", "location", "apiProvider"})) {
+        fetchWeatherData();
+    }
     
-    update();
+    scheduleRepaint();
 }
 
 void WeatherWidget::updateContent() {
@@ -180,15 +193,15 @@ void WeatherWidget::updateContent() {
 }
 
 void WeatherWidget::fetchWeatherData() {
-    qDebug() << "WeatherWidget::fetchWeatherData: 开始获取天气数据";
-    qDebug() << "API Provider:" << m_apiProvider;
-    qDebug() << "API Key:" << (m_apiKey.isEmpty() ? "empty" : "configured");
-    qDebug() << "City Name:" << m_cityName;
+    qCDebug(lcNetwork) << "WeatherWidget::fetchWeatherData: 开始获取天气数据";
+    qCDebug(lcNetwork) << "API Provider:" << m_apiProvider;
+    qCDebug(lcNetwork) << "API Key:" << (m_apiKey.isEmpty() ? "empty" : "configured");
+    qCDebug(lcNetwork) << "City Name:" << m_cityName;
     
     if (m_apiKey.isEmpty() || m_apiKey == "your_api_key_here") {
-        qDebug() << "Weather API key not configured";
+        qCDebug(lcNetwork) << "Weather API key not configured";
         m_weatherData.isValid = false;
-        update(); // 触发重绘以显示错误信息
+        invalidateStaticLayer(QStringLiteral("weather")); // 触发重绘以显示错误信息
         return;
     }
     
@@ -222,7 +235,7 @@ void WeatherWidget::fetchWeatherData() {
         }
         
         query.addQueryItem("location", location);
-        qDebug() << "WeatherWidget使用位置参数:" << m_cityName << "->" << location;
+        qCDebug(lcNetwork) << "WeatherWidget使用位置参数:" << m_cityName << "->" << location;
         
         // 检查是否为JWT token（包含点号）还是传统API key
         bool isJWT = m_apiKey.contains('.');
@@ -246,13 +259,13 @@ void WeatherWidget::fetchWeatherData() {
         query.addQueryItem("units", "metric");
         query.addQueryItem("lang", "zh_cn");
     } else {
-        qDebug() << "Unsupported API provider:" << m_apiProvider;
+        qCDebug(lcNetwork) << "Unsupported API provider:" << m_apiProvider;
         return;
     }
     
     url.setQuery(query);
     
-    qDebug() << "发送天气API请求到:" << url.toString();
+    qCDebug(lcNetwork) << "发送天气API请求到:" << url.toString();
     
     QNetworkRequest request(url);
     
@@ -295,50 +308,50 @@ void WeatherWidget::fetchWeatherData() {
 
 void WeatherWidget::onWeatherDataReceived() {
     if (!m_currentReply) {
-        qDebug() << "WeatherWidget::onWeatherDataReceived: reply为空";
+        qCDebug(lcNetwork) << "WeatherWidget::onWeatherDataReceived: reply为空";
         return;
     }
     
-    qDebug() << "WeatherWidget::onWeatherDataReceived: 收到响应";
-    qDebug() << "HTTP状态码:" << m_currentReply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
-    qDebug() << "网络错误:" << m_currentReply->error();
+    qCDebug(lcNetwork) << "WeatherWidget::onWeatherDataReceived: 收到响应";
+    qCDebug(lcNetwork) << "HTTP状态码:" << m_currentReply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    qCDebug(lcNetwork) << "网络错误:" << m_currentReply->error();
     
     if (m_currentReply->error() == QNetworkReply::NoError) {
         QByteArray data = m_currentReply->readAll();
-        qDebug() << "响应数据长度:" << data.length();
-        qDebug() << "响应数据内容:" << QString::fromUtf8(data.left(500)); // 只显示前500字符
+        qCDebug(lcNetwork) << "响应数据长度:" << data.length();
+        qCDebug(lcNetwork) << "响应数据内容:" << QString::fromUtf8(data.left(500)); // 只显示前500字符
         
         QJsonParseError parseError;
         QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
         
         if (parseError.error != QJsonParseError::NoError) {
-            qDebug() << "JSON解析错误:" << parseError.errorString();
+            qCDebug(lcNetwork) << "JSON解析错误:" << parseError.errorString();
             m_weatherData.isValid = false;
         } else {
             QJsonObject json = doc.object();
-            qDebug() << "JSON解析成功，开始解析天气数据";
+            qCDebug(lcNetwork) << "JSON解析成功，开始解析天气数据";
             
             // 根据不同API提供商解析数据
             if (m_apiProvider == "qweather" || m_apiProvider.isEmpty()) {
-                qDebug() << "使用和风天气解析器";
+                qCDebug(lcNetwork) << "使用和风天气解析器";
                 parseQWeatherData(json);
             } else if (m_apiProvider == "seniverse") {
-                qDebug() << "使用心知天气解析器";
+                qCDebug(lcNetwork) << "使用心知天气解析器";
                 parseSeniverseData(json);
             } else if (m_apiProvider == "openweathermap") {
-                qDebug() << "使用OpenWeatherMap解析器";
+                qCDebug(lcNetwork) << "使用OpenWeatherMap解析器";
                 parseOpenWeatherMapData(json);
             }
             
-            qDebug() << "天气数据解析完成:";
-            qDebug() << "  有效性:" << m_weatherData.isValid;
-            qDebug() << "  位置:" << m_weatherData.location;
-            qDebug() << "  温度:" << m_weatherData.temperature;
-            qDebug() << "  描述:" << m_weatherData.description;
+            qCDebug(lcNetwork) << "天气数据解析完成:";
+            qCDebug(lcNetwork) << "  有效性:" << m_weatherData.isValid;
+            qCDebug(lcNetwork) << "  位置:" << m_weatherData.location;
+            qCDebug(lcNetwork) << "  温度:" << m_weatherData.temperature;
+            qCDebug(lcNetwork) << "  描述:" << m_weatherData.description;
         }
     } else {
-        qDebug() << "Weather API error:" << m_currentReply->errorString();
-        qDebug() << "Error details:" << m_currentReply->readAll();
+        qCDebug(lcNetwork) << "Weather API error:" << m_currentReply->errorString();
+        qCDebug(lcNetwork) << "Error details:" << m_currentReply->readAll();
         m_weatherData.isValid = false;
     }
     
@@ -346,19 +359,19 @@ void WeatherWidget::onWeatherDataReceived() {
     m_currentReply = nullptr;
     
     // 更新显示
-    update();
+    invalidateStaticLayer(QStringLiteral("weather"));
 }
 
 void WeatherWidget::onNetworkError(QNetworkReply::NetworkError error) {
-    qDebug() << "Network error:" << error;
+    qCDebug(lcNetwork) << "Network error:" << error;
     m_weatherData.isValid = false;
-    update();
+    invalidateStaticLayer(QStringLiteral("weather"));
 }
 
 void WeatherWidget::drawContent(QPainter& painter) {
-    painter.setRenderHint(QPainter::Antialiasing);
+    Q_UNUSED(painter);
     
-    // 应用与系统信息小组件完全相同的样式
+    // 应用与系统信息小组件完全相同的样式（样式表变化会触发重新布局和重绘，只在内容不同时设置）
     QString style = QString(
         "QWidget { "
         "    border: 1px solid %1; "
@@ -367,17 +380,23 @@ void WeatherWidget::drawContent(QPainter& painter) {
         "} "
     ).arg(palette().mid().color().name());
     
-    setStyleSheet(style);
+    if (styleSheet() != style) {
+        setStyleSheet(style);
+    }
     
+    // 天气内容由静态图层缓存提供
+}
+
+void WeatherWidget::drawWeather(QPainter& painter) {
     // 不绘制自定义背景，使用BaseWidget的默认背景（QColor(0, 0, 0, 50)）
     
-    qDebug() << "WeatherWidget::drawContent: 开始绘制";
-    qDebug() << "天气数据有效性:" << m_weatherData.isValid;
-    qDebug() << "显示样式:" << static_cast<int>(m_displayStyle);
+    qCDebug(lcRender) << "WeatherWidget::drawWeather: 开始绘制";
+    qCDebug(lcRender) << "天气数据有效性:" << m_weatherData.isValid;
+    qCDebug(lcRender) << "显示样式:" << static_cast<int>(m_displayStyle);
     
     if (!m_weatherData.isValid) {
         // 显示错误信息
-        qDebug() << "绘制错误信息";
+        qCDebug(lcRender) << "绘制错误信息";
         painter.setPen(m_infoColor);
         painter.setFont(m_infoFont);
         painter.drawText(rect(), Qt::AlignCenter, 
@@ -385,7 +404,7 @@ void WeatherWidget::drawContent(QPainter& painter) {
         return;
     }
     
-    qDebug() << "绘制天气数据:" << m_weatherData.location << m_weatherData.temperature << "°C";
+    qCDebug(lcRender) << "绘制天气数据:" << m_weatherData.location << m_weatherData.temperature << "°C";
     
     QRect contentRect = rect().adjusted(m_padding, m_padding, -m_padding, -m_padding);
     
@@ -596,7 +615,7 @@ void WeatherWidget::parseQWeatherData(const QJsonObject& json) {
     // 和风天气API响应格式
     QString code = json["code"].toString();
     if (code != "200") {
-        qDebug() << "QWeather API error, code:" << code;
+        qCDebug(lcNetwork) << "QWeather API error, code:" << code;
         m_weatherData.isValid = false;
         return;
     }
@@ -623,7 +642,7 @@ void WeatherWidget::parseSeniverseData(const QJsonObject& json) {
     // 心知天气API响应格式
     QJsonArray results = json["results"].toArray();
     if (results.isEmpty()) {
-        qDebug() << "Seniverse API error: no results";
+        qCDebug(lcNetwork) << "Seniverse API error: no results";
         m_weatherData.isValid = false;
         return;
     }
@@ -35,9 +35,12 @@
 #include <QDateTime>
 #include <QSharedMemory>
 #include "Framework/WidgetManager.h"
+#include "Framework/WidgetTypeRegistry.h"
+#include "Widgets/BuiltinWidgets.h"
 #include "Utils/SystemTray.h"
 #include "BackendManagement/ManagementWindow.h"
 #include "Utils/Logger.h"
+#include "Utils/LogCategories.h"
 
 /**
  * @brief 主程序入口函数
@@ -85,14 +88,23 @@ int main(int argc, char *argv[])
     QApplication::setQuitOnLastWindowClosed(false);
     
     // 初始化日志系统 - 必须在其他组件之前初始化
+    // 设置UWIDGET_LOG_FORMAT=binary时写入紧凑的二进制日志，用uwidget-logdump查看
+    if (qEnvironmentVariable("UWIDGET_LOG_FORMAT").compare("binary", Qt::CaseInsensitive) == 0) {
+        Logger::setFileFormat(Logger::BinaryFormat);
+    }
     Logger::initialize();
-    Logger::info("应用程序启动");
+    LOG_INFO("应用程序启动");
     
     // 创建应用程序数据目录
     // 确保配置文件、日志文件等有存储位置
     QString appDataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
     QDir().mkpath(appDataPath);
     
+    // 登记内置类型和外部小组件插件：插件只读取元数据，配置中用到的类型在实例化时才加载
+    // 需在管理窗口之前完成，类型下拉框依赖注册表中的类型列表
+    registerBuiltinWidgets(WidgetTypeRegistry::instance());
+    WidgetTypeRegistry::instance().scanPluginDirectory(WidgetTypeRegistry::defaultPluginDirectory());
+    
     // 创建核心组件
     // 注意：组件创建顺序很重要，WidgetManager必须先创建
     WidgetManager widgetManager;           // 小组件管理系统 (梁智搏 YumeshioAmami)
@@ -110,53 +122,25 @@ int main(int argc, char *argv[])
     // 使用Lambda表达式处理不同类型Widget的默认配置
     QObject::connect(&systemTray, &SystemTray::createWidgetRequested,
                      [&widgetManager](WidgetType type) {
-                         // 创建基础配置
-                         WidgetConfig config;
+                         // 默认名称、尺寸和更新间隔由类型注册表中对应的插件提供
+                         WidgetTypeRegistry& registry = WidgetTypeRegistry::instance();
+                         WidgetConfig config = registry.defaultConfig(registry.builtinTypeKey(type));
                          config.type = type;
                          config.id = QString("widget_%1").arg(QDateTime::currentMSecsSinceEpoch());
-                         
-                         // 根据Widget类型设置默认参数
-                         // 每种Widget都有适合的默认尺寸和名称
-                         switch (type) {
-                             case WidgetType::Clock:
-                                 config.name = "时钟";
-                                 config.size = QSize(200, 100);  // 时钟适中尺寸
-                                 break;
-                             case WidgetType::Weather:
-                                 config.name = "天气";
-                                 config.size = QSize(250, 150);  // 天气信息较多
-                                 break;
-                             case WidgetType::SystemInfo:
-                                 config.name = "系统信息";
-                                 config.size = QSize(300, 200);  // 系统信息需要更大空间
-                                 break;
-                             case WidgetType::Calendar:
-                                 config.name = "日历";
-                                 config.size = QSize(250, 200);  // 日历标准尺寸
-                                 break;
-                             case WidgetType::SimpleNotes:
-                                 config.name = "极简便签";
-                                 config.size = QSize(250, 200);  // 极简版较小
-                                 break;
-                             case WidgetType::AIRanking:
-                                 config.name = "AI排行榜";
-                                 config.size = QSize(400, 300);  // 排行榜需要列表空间
-                                 break;
-                             default:
-                                 config.name = "自定义";
-                                 break;
+                         if (config.name.isEmpty()) {
+                             config.name = "自定义";
                          }
                          
                          // 创建并启动Widget
                          if (widgetManager.createWidget(config)) {
                              widgetManager.startWidget(config.id);
-                             Logger::info(QString("创建并启动Widget: %1").arg(config.name));
+                             LOG_CINFO(lcWidget, QString("创建并启动Widget: %1").arg(config.name));
                          }
                      });
     
     // 3. 系统托盘 -> 应用程序：退出处理
     QObject::connect(&systemTray, &SystemTray::exitRequested, [&]() {
-        Logger::info("应用程序退出");
+        LOG_INFO("应用程序退出");
         // 清理所有Widget资源
         widgetManager.cleanupAllWidgets();
         // 优雅退出Qt事件循环
@@ -164,12 +148,14 @@ int main(int argc, char *argv[])
     });
     
     // 4. Widget管理器 -> 管理窗口：Widget列表同步
-    // 当Widget被创建时，更新管理界面的列表
-    QObject::connect(&widgetManager, &WidgetManager::widgetCreated,
+    // 创建、删除和配置更新由管理窗口自身订阅widgetsChanged，批量操作只刷新一次
+    
+    // 加载配置后（小组件可能尚未实例化）刷新列表
+    QObject::connect(&widgetManager, &WidgetManager::configurationChanged,
                      &managementWindow, &ManagementWindow::refreshWidgetList);
     
-    // 当Widget被删除时，更新管理界面的列表
-    QObject::connect(&widgetManager, &WidgetManager::widgetRemoved,
+    // 分批实例化完成后刷新一次列表中的加载状态
+    QObject::connect(&widgetManager, &WidgetManager::loadingFinished,
                      &managementWindow, &ManagementWindow::refreshWidgetList);
     
     // 5. 管理窗口 -> 系统托盘：窗口隐藏通知
@@ -178,9 +164,10 @@ int main(int argc, char *argv[])
                      &systemTray, &SystemTray::showManagementWindowHiddenNotification);
     
     // 加载用户配置文件
-    // 恢复上次关闭时的Widget状态
+    // 恢复上次关闭时的Widget状态：这里只登记配置，自动启动的Widget在事件循环中分批创建，
+    // 其余Widget在首次启动时才创建
     if (!widgetManager.loadConfiguration()) {
-        Logger::warning("无法加载配置文件，将使用默认设置");
+        LOG_CWARNING(lcConfig, "无法加载配置文件，将使用默认设置");
         // 即使配置加载失败，程序仍可正常运行
     }
     
@@ -188,7 +175,7 @@ int main(int argc, char *argv[])
     systemTray.show();
     systemTray.showStartupNotification();
     
-    Logger::info("应用程序初始化完成");
+    LOG_INFO("应用程序初始化完成");
     
     // 启动Qt事件循环，程序正式运行
     // 程序将在此处持续运行，直到用户退出
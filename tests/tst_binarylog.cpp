@@ -0,0 +1,142 @@
+// BinaryLog：varint和zigzag编码的往返、截断数据的检测，以及消息模板的格式化
+
+#include "Utils/BinaryLogFormat.h"
+#include <QTest>
+#include <limits>
+
+Q_DECLARE_METATYPE(BinaryLog::Arg)
+
+class TestBinaryLog : public QObject {
+    Q_OBJECT
+
+private slots:
+    void varintRoundTrip_data();
+    void varintRoundTrip();
+    void zigzagRoundTrip_data();
+    void zigzagRoundTrip();
+    void doubleAndStringRoundTrip();
+    void truncatedInputIsRejected();
+    void formatMessage_data();
+    void formatMessage();
+};
+
+void TestBinaryLog::varintRoundTrip_data() {
+    QTest::addColumn<quint64>("value");
+    QTest::addColumn<int>("encodedSize");
+    QTest::newRow("zero") << quint64(0) << 1;
+    QTest::newRow("one byte max") << quint64(127) << 1;
+    QTest::newRow("two bytes min") << quint64(128) << 2;
+    QTest::newRow("300") << quint64(300) << 2;
+    QTest::newRow("2^32") << (quint64(1) << 32) << 5;
+    QTest::newRow("2^63") << (quint64(1) << 63) << 10;
+    QTest::newRow("max") << std::numeric_limits<quint64>::max() << 10;
+}
+
+void TestBinaryLog::varintRoundTrip() {
+    QFETCH(quint64, value);
+    QFETCH(int, encodedSize);
+
+    QByteArray encoded;
+    BinaryLog::putVarint(encoded, value);
+    QCOMPARE(int(encoded.size()), encodedSize);
+
+    BinaryLog::Reader reader(encoded.constData(), encoded.size());
+    QCOMPARE(reader.varint(), value);
+    QVERIFY(reader.ok());
+    QVERIFY(reader.atEnd());
+}
+
+void TestBinaryLog::zigzagRoundTrip_data() {
+    QTest::addColumn<qint64>("value");
+    QTest::addColumn<int>("encodedSize");   // 含1字节类型
+    QTest::newRow("zero") << qint64(0) << 2;
+    QTest::newRow("minus one") << qint64(-1) << 2;
+    QTest::newRow("one") << qint64(1) << 2;
+    QTest::newRow("minus 64") << qint64(-64) << 2;
+    QTest::newRow("minus 65") << qint64(-65) << 3;
+    QTest::newRow("min") << std::numeric_limits<qint64>::min() << 11;
+    QTest::newRow("max") << std::numeric_limits<qint64>::max() << 11;
+}
+
+void TestBinaryLog::zigzagRoundTrip() {
+    QFETCH(qint64, value);
+    QFETCH(int, encodedSize);
+
+    QByteArray encoded;
+    BinaryLog::putArg(encoded, BinaryLog::Arg(static_cast<long long>(value)));
+    QCOMPARE(int(encoded.size()), encodedSize);
+
+    BinaryLog::Reader reader(encoded.constData(), encoded.size());
+    const BinaryLog::Arg decoded = reader.arg();
+    QVERIFY(reader.ok());
+    QVERIFY(reader.atEnd());
+    QCOMPARE(decoded.type, BinaryLog::IntArg);
+    QCOMPARE(decoded.i, value);
+}
+
+void TestBinaryLog::doubleAndStringRoundTrip() {
+    QByteArray encoded;
+    BinaryLog::putArg(encoded, BinaryLog::Arg(-12.375));
+    BinaryLog::putArg(encoded, BinaryLog::Arg(QStringLiteral("小组件 %1")));
+
+    BinaryLog::Reader reader(encoded.constData(), encoded.size());
+    const BinaryLog::Arg number = reader.arg();
+    const BinaryLog::Arg text = reader.arg();
+    QVERIFY(reader.ok());
+    QVERIFY(reader.atEnd());
+    QCOMPARE(number.type, BinaryLog::DoubleArg);
+    QCOMPARE(number.d, -12.375);
+    QCOMPARE(text.type, BinaryLog::StringArg);
+    QCOMPARE(text.s, QStringLiteral("小组件 %1"));
+}
+
+void TestBinaryLog::truncatedInputIsRejected() {
+    QByteArray encoded;
+    BinaryLog::putVarint(encoded, 300);
+    encoded.chop(1);
+    BinaryLog::Reader varintReader(encoded.constData(), encoded.size());
+    varintReader.varint();
+    QVERIFY(!varintReader.ok());
+
+    QByteArray string;
+    BinaryLog::putString(string, QStringLiteral("truncated"));
+    string.chop(2);
+    BinaryLog::Reader stringReader(string.constData(), string.size());
+    stringReader.string();
+    QVERIFY(!stringReader.ok());
+}
+
+void TestBinaryLog::formatMessage_data() {
+    QTest::addColumn<QString>("messageTemplate");
+    QTest::addColumn<QVector<BinaryLog::Arg>>("args");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("in order") << QStringLiteral("%1 + %2") << QVector<BinaryLog::Arg>{1, 2}
+                              << QStringLiteral("1 + 2");
+    QTest::newRow("reordered") << QStringLiteral("%2 before %1") << QVector<BinaryLog::Arg>{"a", "b"}
+                               << QStringLiteral("b before a");
+    QTest::newRow("lowest number first") << QStringLiteral("%3 %5") << QVector<BinaryLog::Arg>{"x", "y"}
+                                         << QStringLiteral("x y");
+    QTest::newRow("repeated") << QStringLiteral("%1-%1") << QVector<BinaryLog::Arg>{7}
+                              << QStringLiteral("7-7");
+    QTest::newRow("two digits") << QStringLiteral("%10!") << QVector<BinaryLog::Arg>{"ten"}
+                                << QStringLiteral("ten!");
+    QTest::newRow("missing argument") << QStringLiteral("%1 %2") << QVector<BinaryLog::Arg>{"only"}
+                                      << QStringLiteral("only %2");
+    QTest::newRow("placeholder in argument") << QStringLiteral("%1 %2") << QVector<BinaryLog::Arg>{"%2", "b"}
+                                             << QStringLiteral("%2 b");
+    QTest::newRow("double") << QStringLiteral("%1us") << QVector<BinaryLog::Arg>{3.14159}
+                            << QStringLiteral("3.14us");
+    QTest::newRow("literal percent") << QStringLiteral("100% %0") << QVector<BinaryLog::Arg>{"unused"}
+                                     << QStringLiteral("100% %0");
+}
+
+void TestBinaryLog::formatMessage() {
+    QFETCH(QString, messageTemplate);
+    QFETCH(QVector<BinaryLog::Arg>, args);
+    QFETCH(QString, expected);
+    QCOMPARE(BinaryLog::formatMessage(messageTemplate, args), expected);
+}
+
+QTEST_APPLESS_MAIN(TestBinaryLog)
+#include "tst_binarylog.moc"
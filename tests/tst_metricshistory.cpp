@@ -0,0 +1,193 @@
+// MetricsHistory：同一秒内的合并、缺失指标、分钟和15分钟汇总及其区间边界、环形缓冲区回绕
+
+#include "Utils/MetricsHistory.h"
+#include <QTest>
+
+namespace {
+    // 对齐到15分钟边界的起点，便于构造跨区间的样本
+    constexpr qint64 kBaseMs = qint64(1888888) * 15 * 60 * 1000;
+    constexpr qint64 kSecondMs = 1000;
+    constexpr qint64 kMinuteMs = 60 * kSecondMs;
+
+    void recordCpu(MetricsHistory& history, qint64 timestampMs, double cpu) {
+        double values[MetricsHistory::kMetricCount] = {};
+        values[static_cast<int>(HistoryMetric::Cpu)] = cpu;
+        history.record(timestampMs, 1u << static_cast<int>(HistoryMetric::Cpu), values);
+    }
+}
+
+class TestMetricsHistory : public QObject {
+    Q_OBJECT
+
+private slots:
+    void samplesInOneSecondShareASlot();
+    void clockGoingBackwardsMergesIntoLastSlot();
+    void unsampledMetricIsNaN();
+    void skippedSecondsTakeNoSlot();
+    void minuteRollup();
+    void pendingMinuteIsVisible();
+    void quarterHourBoundary();
+    void archiveRecordUpdatesOnlyValidFields();
+    void secondTierWrapsAround();
+    void resolutionForWindow();
+};
+
+void TestMetricsHistory::samplesInOneSecondShareASlot() {
+    MetricsHistory history;
+    recordCpu(history, kBaseMs + 100, 10.0);
+    recordCpu(history, kBaseMs + 900, 20.0);
+
+    HistorySeries series;
+    history.query(HistoryMetric::Cpu, HistoryResolution::Second, kBaseMs, series);
+    QCOMPARE(series.size(), 1);
+    QCOMPARE(series.timeMs[0], kBaseMs);
+    QCOMPARE(series.avg[0], 20.0f);   // 以最后一次为准
+
+    // 两次都计入分钟汇总
+    history.query(HistoryMetric::Cpu, HistoryResolution::Minute, kBaseMs, series);
+    QCOMPARE(series.size(), 1);
+    QCOMPARE(series.avg[0], 15.0f);
+    QCOMPARE(series.min[0], 10.0f);
+    QCOMPARE(series.max[0], 20.0f);
+}
+
+void TestMetricsHistory::clockGoingBackwardsMergesIntoLastSlot() {
+    MetricsHistory history;
+    recordCpu(history, kBaseMs + 5 * kSecondMs, 10.0);
+    recordCpu(history, kBaseMs + 3 * kSecondMs, 30.0);
+
+    HistorySeries series;
+    history.query(HistoryMetric::Cpu, HistoryResolution::Second, kBaseMs, series);
+    QCOMPARE(series.size(), 1);
+    QCOMPARE(series.timeMs[0], kBaseMs + 5 * kSecondMs);
+    QCOMPARE(series.avg[0], 30.0f);
+}
+
+void TestMetricsHistory::unsampledMetricIsNaN() {
+    MetricsHistory history;
+    recordCpu(history, kBaseMs, 50.0);
+
+    HistorySeries series;
+    history.query(HistoryMetric::Memory, HistoryResolution::Second, kBaseMs, series);
+    QCOMPARE(series.size(), 1);
+    QVERIFY(qIsNaN(series.avg[0]));
+
+    // 分钟汇总中没有样本的指标不附加正在累积的点
+    history.query(HistoryMetric::Memory, HistoryResolution::Minute, kBaseMs, series);
+    QCOMPARE(series.size(), 0);
+}
+
+void TestMetricsHistory::skippedSecondsTakeNoSlot() {
+    MetricsHistory history;
+    recordCpu(history, kBaseMs, 1.0);
+    recordCpu(history, kBaseMs + 4 * kSecondMs, 2.0);   // 例如自适应采样放慢到4秒
+
+    HistorySeries series;
+    history.query(HistoryMetric::Cpu, HistoryResolution::Second, kBaseMs, series);
+    QCOMPARE(series.size(), 2);
+    QCOMPARE(series.timeMs[1] - series.timeMs[0], 4 * kSecondMs);
+}
+
+void TestMetricsHistory::minuteRollup() {
+    MetricsHistory history;
+    for (int second = 0; second < 60; ++second) {
+        recordCpu(history, kBaseMs + second * kSecondMs, second);
+    }
+    recordCpu(history, kBaseMs + kMinuteMs, 100.0);   // 进入下一分钟，上一分钟写入分钟档
+
+    HistorySeries series;
+    history.query(HistoryMetric::Cpu, HistoryResolution::Minute, kBaseMs, series);
+    QCOMPARE(series.resolution, HistoryResolution::Minute);
+    QCOMPARE(series.size(), 2);
+    QCOMPARE(series.timeMs[0], kBaseMs);
+    QCOMPARE(series.avg[0], 29.5f);
+    QCOMPARE(series.min[0], 0.0f);
+    QCOMPARE(series.max[0], 59.0f);
+    QCOMPARE(series.timeMs[1], kBaseMs + kMinuteMs);
+    QCOMPARE(series.avg[1], 100.0f);
+
+    // sinceMs之前的区间不返回
+    history.query(HistoryMetric::Cpu, HistoryResolution::Minute, kBaseMs + 1, series);
+    QCOMPARE(series.size(), 1);
+    QCOMPARE(series.timeMs[0], kBaseMs + kMinuteMs);
+}
+
+void TestMetricsHistory::pendingMinuteIsVisible() {
+    MetricsHistory history;
+    recordCpu(history, kBaseMs + 10 * kSecondMs, 40.0);
+    recordCpu(history, kBaseMs + 59 * kSecondMs + 999, 60.0);   // 仍在同一分钟
+
+    HistorySeries series;
+    history.query(HistoryMetric::Cpu, HistoryResolution::Minute, kBaseMs, series);
+    QCOMPARE(series.size(), 1);
+    QCOMPARE(series.timeMs[0], kBaseMs);
+    QCOMPARE(series.avg[0], 50.0f);
+}
+
+/**
+ * 每分钟一个样本，值为分钟序号：第0~14分钟汇总为一个15分钟区间，
+ * 第15分钟在第16分钟的样本到来时写入下一个区间
+ */
+void TestMetricsHistory::quarterHourBoundary() {
+    MetricsHistory history;
+    for (int minute = 0; minute <= 16; ++minute) {
+        recordCpu(history, kBaseMs + minute * kMinuteMs, minute);
+    }
+
+    HistorySeries series;
+    history.query(HistoryMetric::Cpu, HistoryResolution::QuarterHour, kBaseMs, series);
+    QCOMPARE(series.size(), 2);
+    QCOMPARE(series.timeMs[0], kBaseMs);
+    QCOMPARE(series.avg[0], 7.0f);
+    QCOMPARE(series.min[0], 0.0f);
+    QCOMPARE(series.max[0], 14.0f);
+    QCOMPARE(series.timeMs[1], kBaseMs + 15 * kMinuteMs);
+    QCOMPARE(series.avg[1], 15.0f);
+}
+
+void TestMetricsHistory::archiveRecordUpdatesOnlyValidFields() {
+    MetricsHistory history;
+    MetricsArchiveRecord record;
+    record.timestampMs = kBaseMs;
+    record.fields = MetricsArchiveRecord::NetworkField;
+    record.cpuUsage = 99.0f;            // 字段组无效，不应写入
+    record.networkUpload = 12.0f;
+    record.networkDownload = 34.0f;
+    history.record(record);
+
+    HistorySeries series;
+    history.query(HistoryMetric::NetworkDownload, HistoryResolution::Second, kBaseMs, series);
+    QCOMPARE(series.size(), 1);
+    QCOMPARE(series.avg[0], 34.0f);
+    history.query(HistoryMetric::Cpu, HistoryResolution::Second, kBaseMs, series);
+    QCOMPARE(series.size(), 1);
+    QVERIFY(qIsNaN(series.avg[0]));
+}
+
+void TestMetricsHistory::secondTierWrapsAround() {
+    MetricsHistory history;
+    const int total = MetricsHistory::kSecondCapacity + 10;
+    for (int second = 0; second < total; ++second) {
+        recordCpu(history, kBaseMs + second * kSecondMs, second % 100);
+    }
+
+    HistorySeries series;
+    history.query(HistoryMetric::Cpu, HistoryResolution::Second, 0, series);
+    QCOMPARE(series.size(), MetricsHistory::kSecondCapacity);
+    QCOMPARE(series.timeMs.first(), kBaseMs + 10 * kSecondMs);   // 最早的10秒被覆盖
+    QCOMPARE(series.timeMs.last(), kBaseMs + (total - 1) * kSecondMs);
+    for (int i = 1; i < series.size(); ++i) {
+        QVERIFY(series.timeMs[i] > series.timeMs[i - 1]);
+    }
+}
+
+void TestMetricsHistory::resolutionForWindow() {
+    QCOMPARE(MetricsHistory::resolutionForWindow(60), HistoryResolution::Second);
+    QCOMPARE(MetricsHistory::resolutionForWindow(MetricsHistory::kSecondCapacity), HistoryResolution::Second);
+    QCOMPARE(MetricsHistory::resolutionForWindow(MetricsHistory::kSecondCapacity + 1), HistoryResolution::Minute);
+    QCOMPARE(MetricsHistory::resolutionForWindow(24 * 3600), HistoryResolution::Minute);
+    QCOMPARE(MetricsHistory::resolutionForWindow(24 * 3600 + 1), HistoryResolution::QuarterHour);
+}
+
+QTEST_APPLESS_MAIN(TestMetricsHistory)
+#include "tst_metricshistory.moc"
@@ -0,0 +1,141 @@
+// MpscRingBuffer：容量取整、先进先出、回绕、多生产者下每个生产者的顺序以及崩溃处理用的只读遍历
+
+#include "Utils/MpscRingBuffer.h"
+#include <QTest>
+#include <QVector>
+#include <thread>
+#include <vector>
+
+class TestMpscRingBuffer : public QObject {
+    Q_OBJECT
+
+private slots:
+    void capacityRoundsUpToPowerOfTwo();
+    void popsInPushOrder();
+    void rejectsPushWhenFull();
+    void wrapsAroundManyTimes();
+    void keepsPerProducerOrder();
+    void peekPendingDoesNotConsume();
+};
+
+void TestMpscRingBuffer::capacityRoundsUpToPowerOfTwo() {
+    QCOMPARE(MpscRingBuffer<int>(0).capacity(), size_t(2));
+    QCOMPARE(MpscRingBuffer<int>(5).capacity(), size_t(8));
+    QCOMPARE(MpscRingBuffer<int>(64).capacity(), size_t(64));
+}
+
+void TestMpscRingBuffer::popsInPushOrder() {
+    MpscRingBuffer<int> queue(8);
+    QVERIFY(queue.isEmpty());
+    for (int i = 0; i < 5; ++i) {
+        QVERIFY(queue.tryPush(int(i)));
+    }
+    QCOMPARE(queue.sizeApprox(), size_t(5));
+
+    int value = -1;
+    for (int i = 0; i < 5; ++i) {
+        QVERIFY(queue.tryPop(value));
+        QCOMPARE(value, i);
+    }
+    QVERIFY(!queue.tryPop(value));
+    QVERIFY(queue.isEmpty());
+}
+
+void TestMpscRingBuffer::rejectsPushWhenFull() {
+    MpscRingBuffer<int> queue(4);
+    for (int i = 0; i < 4; ++i) {
+        QVERIFY(queue.tryPush(int(i)));
+    }
+    QVERIFY(!queue.tryPush(4));
+
+    int value = -1;
+    QVERIFY(queue.tryPop(value));
+    QCOMPARE(value, 0);
+    QVERIFY(queue.tryPush(4));   // 腾出一个槽位后又能写入
+}
+
+void TestMpscRingBuffer::wrapsAroundManyTimes() {
+    MpscRingBuffer<QString> queue(4);
+    QString value;
+    for (int i = 0; i < 1000; ++i) {
+        QVERIFY(queue.tryPush(QString::number(i)));
+        QVERIFY(queue.tryPush(QString::number(i + 1)));
+        QVERIFY(queue.tryPop(value));
+        QCOMPARE(value, QString::number(i));
+        QVERIFY(queue.tryPop(value));
+        QCOMPARE(value, QString::number(i + 1));
+    }
+    QVERIFY(queue.isEmpty());
+}
+
+void TestMpscRingBuffer::keepsPerProducerOrder() {
+    constexpr int kProducers = 4;
+    constexpr quint64 kPerProducer = 20000;
+    MpscRingBuffer<quint64> queue(64);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&queue, p]() {
+            for (quint64 i = 0; i < kPerProducer; ++i) {
+                const quint64 value = (quint64(p) << 32) | i;
+                while (!queue.tryPush(quint64(value))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // 同一个生产者的值必须按写入顺序出队，且一个都不少；先让生产者全部结束再断言
+    quint64 expected[kProducers] = {};
+    quint64 received = 0;
+    bool ordered = true;
+    quint64 value = 0;
+    while (received < kProducers * kPerProducer) {
+        if (!queue.tryPop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        const int producer = int(value >> 32);
+        if (producer >= kProducers || (value & 0xFFFFFFFFull) != expected[producer]) {
+            ordered = false;
+        } else {
+            expected[producer]++;
+        }
+        received++;
+    }
+    for (std::thread& producer : producers) {
+        producer.join();
+    }
+    QVERIFY(ordered);
+    for (int p = 0; p < kProducers; ++p) {
+        QCOMPARE(expected[p], kPerProducer);
+    }
+    QVERIFY(queue.isEmpty());
+}
+
+void TestMpscRingBuffer::peekPendingDoesNotConsume() {
+    MpscRingBuffer<int> queue(4);
+    int value = -1;
+    // 先推进到回绕之后，遍历的起点不在槽位0
+    for (int i = 0; i < 3; ++i) {
+        QVERIFY(queue.tryPush(int(i)));
+        QVERIFY(queue.tryPop(value));
+    }
+    for (int i = 10; i < 14; ++i) {
+        QVERIFY(queue.tryPush(int(i)));
+    }
+
+    QVector<int> seen;
+    queue.peekPending([&seen](const int& item) { seen.push_back(item); });
+    QCOMPARE(seen, QVector<int>({10, 11, 12, 13}));
+    QCOMPARE(queue.sizeApprox(), size_t(4));
+
+    QVERIFY(queue.tryPop(value));
+    QCOMPARE(value, 10);
+    seen.clear();
+    queue.peekPending([&seen](const int& item) { seen.push_back(item); });
+    QCOMPARE(seen, QVector<int>({11, 12, 13}));
+}
+
+QTEST_APPLESS_MAIN(TestMpscRingBuffer)
+#include "tst_mpscringbuffer.moc"
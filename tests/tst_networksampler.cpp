@@ -0,0 +1,42 @@
+// NetworkSampler::counterDelta：正常增长、计数器重置和32位来源的回绕
+
+#include "Utils/NetworkSampler.h"
+#include <QTest>
+
+class TestNetworkSampler : public QObject {
+    Q_OBJECT
+
+private slots:
+    void counterDelta_data();
+    void counterDelta();
+};
+
+void TestNetworkSampler::counterDelta_data() {
+    QTest::addColumn<quint64>("current");
+    QTest::addColumn<quint64>("previous");
+    QTest::addColumn<int>("counterBits");
+    QTest::addColumn<quint64>("expected");
+
+    QTest::newRow("growth") << quint64(1500) << quint64(1000) << 64 << quint64(500);
+    QTest::newRow("unchanged") << quint64(1000) << quint64(1000) << 64 << quint64(0);
+    QTest::newRow("growth past 32 bits") << quint64(0x100000010ull) << quint64(0xFFFFFFF0ull) << 64
+                                         << quint64(0x20);
+    // 64位来源变小只能是接口重建或驱动重置：不能按回绕算出接近4GB的尖峰
+    QTest::newRow("64-bit reset, small previous") << quint64(10) << quint64(0xFFFFFFF0ull) << 64 << quint64(0);
+    QTest::newRow("64-bit reset, large previous") << quint64(10) << quint64(0x123456789ull) << 64 << quint64(0);
+    QTest::newRow("32-bit wrap") << quint64(10) << quint64(0xFFFFFFF0ull) << 32 << quint64(26);
+    QTest::newRow("32-bit wrap at boundary") << quint64(0) << quint64(0xFFFFFFFFull) << 32 << quint64(1);
+    QTest::newRow("32-bit source with 64-bit previous") << quint64(10) << quint64(0x123456789ull) << 32
+                                                        << quint64(0);
+}
+
+void TestNetworkSampler::counterDelta() {
+    QFETCH(quint64, current);
+    QFETCH(quint64, previous);
+    QFETCH(int, counterBits);
+    QFETCH(quint64, expected);
+    QCOMPARE(NetworkSampler::counterDelta(current, previous, counterBits), expected);
+}
+
+QTEST_APPLESS_MAIN(TestNetworkSampler)
+#include "tst_networksampler.moc"
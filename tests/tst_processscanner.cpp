@@ -0,0 +1,254 @@
+// ProcessScanner：/proc/[pid]/stat的解析，以及在伪造的/proc目录上验证每次扫描的预算、PID复用和前N个进程的选择
+
+#include "Utils/ProcessScanner.h"
+#include "Utils/ProcReader.h"
+#include <QDir>
+#include <QFile>
+#include <QScopedPointer>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QThread>
+#include <unistd.h>
+
+class TestProcessScanner : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+
+    void processStat();
+    void processStatNameWithParentheses();
+    void processStatNegativeFields();
+    void processStatTruncated_data();
+    void processStatTruncated();
+
+    void scanBudgetSplitsRound();
+    void pidReuseResetsEntry();
+    void topByMemory();
+    void topByCpu();
+    void exitedProcessRemovedAfterRound();
+
+private:
+    void writeProcess(qint64 pid, const QByteArray& name, quint64 cpuTicks, quint64 startTime, quint64 residentPages);
+    void removeProcess(qint64 pid);
+
+    QScopedPointer<QTemporaryDir> m_procRoot;
+};
+
+void TestProcessScanner::init() {
+    m_procRoot.reset(new QTemporaryDir);
+    QVERIFY(m_procRoot->isValid());
+    // 非数字目录不是进程，应被忽略
+    QVERIFY(QDir(m_procRoot->path()).mkpath(QStringLiteral("self")));
+}
+
+/**
+ * 写入伪造的/proc/[pid]/stat和statm：CPU时间全部记在utime上
+ */
+void TestProcessScanner::writeProcess(qint64 pid, const QByteArray& name, quint64 cpuTicks, quint64 startTime,
+                                      quint64 residentPages) {
+    const QString dir = m_procRoot->filePath(QString::number(pid));
+    QVERIFY(QDir().mkpath(dir));
+
+    QFile stat(dir + QStringLiteral("/stat"));
+    QVERIFY(stat.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    stat.write(QByteArray::number(pid) + " (" + name + ") S 1 1 1 0 -1 4194304 0 0 0 0 " +
+               QByteArray::number(cpuTicks) + " 0 0 0 20 0 1 0 " + QByteArray::number(startTime) + " 1000 100\n");
+
+    QFile statm(dir + QStringLiteral("/statm"));
+    QVERIFY(statm.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    statm.write("1000 " + QByteArray::number(residentPages) + " 0 0 0 0 0\n");
+}
+
+void TestProcessScanner::removeProcess(qint64 pid) {
+    QVERIFY(QDir(m_procRoot->filePath(QString::number(pid))).removeRecursively());
+}
+
+void TestProcessScanner::processStat() {
+    const char* text = "1234 (bash) S 1 1234 1234 34816 5678 4194304 2000 30000 0 1 150 25 "
+                       "40 10 20 0 1 0 987654 12345678 900 18446744073709551615\n";
+    ProcFs::ProcessStat stat;
+    QVERIFY(ProcFs::parseProcessStat(text, stat));
+    QCOMPARE(QByteArray(stat.name, int(stat.nameLength)), QByteArray("bash"));
+    QCOMPARE(stat.cpuTime, quint64(175));       // utime 150 + stime 25
+    QCOMPARE(stat.startTime, quint64(987654));
+}
+
+void TestProcessScanner::processStatNameWithParentheses() {
+    // 进程名可以包含空格和括号，字段从最后一个')'之后开始
+    const char* text = "77 (my (odd) name) R 1 77 77 0 -1 4194560 10 0 0 0 3 4 "
+                       "0 0 20 0 1 0 555 1000 10 0\n";
+    ProcFs::ProcessStat stat;
+    QVERIFY(ProcFs::parseProcessStat(text, stat));
+    QCOMPARE(QByteArray(stat.name, int(stat.nameLength)), QByteArray("my (odd) name"));
+    QCOMPARE(stat.cpuTime, quint64(7));
+    QCOMPARE(stat.startTime, quint64(555));
+}
+
+void TestProcessScanner::processStatNegativeFields() {
+    // tty_pgrp为-1，nice为-20
+    const char* text = "9 (kworker/0:1H) I 2 0 0 0 -1 69238880 0 0 0 0 0 12 "
+                       "0 0 0 -20 1 0 42 0 0 18446744073709551615\n";
+    ProcFs::ProcessStat stat;
+    QVERIFY(ProcFs::parseProcessStat(text, stat));
+    QCOMPARE(QByteArray(stat.name, int(stat.nameLength)), QByteArray("kworker/0:1H"));
+    QCOMPARE(stat.cpuTime, quint64(12));
+    QCOMPARE(stat.startTime, quint64(42));
+}
+
+void TestProcessScanner::processStatTruncated_data() {
+    QTest::addColumn<QByteArray>("text");
+    QTest::newRow("empty") << QByteArray("");
+    QTest::newRow("no name") << QByteArray("12 bash S 1 2 3");
+    QTest::newRow("ends after name") << QByteArray("12 (bash)");
+    QTest::newRow("ends after space") << QByteArray("12 (bash) ");
+    QTest::newRow("before starttime") << QByteArray("12 (bash) S 1 12 12 0 -1 0 0 0 0 0 5 6 0 0 20 0 1 0");
+}
+
+void TestProcessScanner::processStatTruncated() {
+    QFETCH(QByteArray, text);
+    ProcFs::ProcessStat stat;
+    QVERIFY(!ProcFs::parseProcessStat(text.constData(), stat));
+}
+
+void TestProcessScanner::scanBudgetSplitsRound() {
+    for (qint64 pid = 100; pid < 140; ++pid) {
+        writeProcess(pid, "worker", 10, 1000 + pid, 1);
+    }
+
+    // 预算为0时每次扫描只推进最少的16个进程，40个进程需要3次扫描才能完成一轮
+    ProcessScanner scanner(QFile::encodeName(m_procRoot->path()).constData());
+    scanner.setScanBudgetUs(0);
+
+    scanner.scan();
+    QCOMPARE(scanner.stats().refreshedCount, 16);
+    QCOMPARE(scanner.stats().processCount, 16);
+    QCOMPARE(scanner.stats().budgetHits, quint64(1));
+
+    scanner.scan();
+    QCOMPARE(scanner.stats().refreshedCount, 16);
+    QCOMPARE(scanner.stats().processCount, 32);
+    QCOMPARE(scanner.stats().budgetHits, quint64(2));
+
+    scanner.scan();
+    QCOMPARE(scanner.stats().refreshedCount, 8);
+    QCOMPARE(scanner.stats().processCount, 40);
+    QCOMPARE(scanner.stats().budgetHits, quint64(2));   // 一轮正常结束，不算超出预算
+
+    // 默认预算足够一次扫完
+    ProcessScanner unbounded(QFile::encodeName(m_procRoot->path()).constData());
+    unbounded.scan();
+    QCOMPARE(unbounded.stats().refreshedCount, 40);
+    QCOMPARE(unbounded.stats().budgetHits, quint64(0));
+}
+
+void TestProcessScanner::pidReuseResetsEntry() {
+    writeProcess(500, "old", 100, 4242, 10);
+    ProcessScanner scanner(QFile::encodeName(m_procRoot->path()).constData());
+    QVector<ProcessSample> top;
+
+    scanner.scan();
+    QThread::msleep(50);
+    writeProcess(500, "old", 150, 4242, 10);
+    scanner.scan();
+    scanner.topByCpu(1, top);
+    QCOMPARE(int(top.size()), 1);
+    QCOMPARE(top[0].name, QStringLiteral("old"));
+    QVERIFY(top[0].cpuPercent > 0.0f);
+
+    // 同一个PID、不同的启动时间：是另一个进程，不能和旧进程的CPU时间相减
+    QThread::msleep(50);
+    writeProcess(500, "new", 20, 9999, 10);
+    scanner.scan();
+    scanner.topByCpu(1, top);
+    QCOMPARE(int(top.size()), 1);
+    QCOMPARE(top[0].pid, qint64(500));
+    QCOMPARE(top[0].name, QStringLiteral("new"));
+    QCOMPARE(top[0].cpuPercent, 0.0f);
+
+    // 之后按新进程的CPU时间正常计算
+    QThread::msleep(50);
+    writeProcess(500, "new", 60, 9999, 10);
+    scanner.scan();
+    scanner.topByCpu(1, top);
+    QCOMPARE(top[0].name, QStringLiteral("new"));
+    QVERIFY(top[0].cpuPercent > 0.0f);
+}
+
+void TestProcessScanner::topByMemory() {
+    const quint64 residentPages[] = {5, 80, 20, 300, 1, 40, 7, 150, 60, 2, 90, 11, 33, 250};
+    const int processCount = int(sizeof(residentPages) / sizeof(residentPages[0]));
+    for (int i = 0; i < processCount; ++i) {
+        writeProcess(200 + i, "proc" + QByteArray::number(i), 0, 1, residentPages[i]);
+    }
+    ProcessScanner scanner(QFile::encodeName(m_procRoot->path()).constData());
+    scanner.scan();
+
+    const qint64 pageSize = ::sysconf(_SC_PAGESIZE);
+    QVector<ProcessSample> top;
+    scanner.topByMemory(3, top);
+    QCOMPARE(int(top.size()), 3);
+    QCOMPARE(top[0].pid, qint64(203));
+    QCOMPARE(top[0].rssBytes, qint64(300) * pageSize);
+    QCOMPARE(top[1].pid, qint64(213));
+    QCOMPARE(top[2].pid, qint64(207));
+
+    // 数量被限制在kMaxTopCount以内，且结果按内存从大到小排列
+    scanner.topByMemory(100, top);
+    QCOMPARE(int(top.size()), int(ProcessScanner::kMaxTopCount));
+    for (int i = 1; i < top.size(); ++i) {
+        QVERIFY(top[i - 1].rssBytes >= top[i].rssBytes);
+    }
+
+    scanner.topByMemory(0, top);
+    QVERIFY(top.isEmpty());
+}
+
+void TestProcessScanner::topByCpu() {
+    for (qint64 pid = 300; pid < 306; ++pid) {
+        writeProcess(pid, "busy", 1000, 1, 1);
+    }
+    ProcessScanner scanner(QFile::encodeName(m_procRoot->path()).constData());
+    scanner.scan();
+
+    // 第二次扫描时各进程增长的CPU时间不同，相差足够大，不受采样时刻毫秒级差异影响
+    QThread::msleep(100);
+    const quint64 deltas[] = {5, 80, 0, 40, 160, 20};
+    for (int i = 0; i < 6; ++i) {
+        writeProcess(300 + i, "busy", 1000 + deltas[i], 1, 1);
+    }
+    scanner.scan();
+
+    QVector<ProcessSample> top;
+    scanner.topByCpu(3, top);
+    QCOMPARE(int(top.size()), 3);
+    QCOMPARE(top[0].pid, qint64(304));
+    QCOMPARE(top[1].pid, qint64(301));
+    QCOMPARE(top[2].pid, qint64(303));
+    QVERIFY(top[0].cpuPercent > top[1].cpuPercent);
+    QVERIFY(top[1].cpuPercent > top[2].cpuPercent);
+}
+
+void TestProcessScanner::exitedProcessRemovedAfterRound() {
+    for (qint64 pid = 400; pid < 420; ++pid) {
+        writeProcess(pid, "short", 0, 1, 1);
+    }
+    ProcessScanner scanner(QFile::encodeName(m_procRoot->path()).constData());
+    scanner.scan();
+    QCOMPARE(scanner.stats().processCount, 20);
+
+    // 退出的进程在下一轮枚举中不再出现，一轮结束时被清理
+    removeProcess(403);
+    removeProcess(417);
+    scanner.scan();
+    QCOMPARE(scanner.stats().processCount, 18);
+
+    QVector<ProcessSample> top;
+    scanner.topByMemory(ProcessScanner::kMaxTopCount, top);
+    for (const ProcessSample& sample : top) {
+        QVERIFY(sample.pid != 403 && sample.pid != 417);
+    }
+}
+
+QTEST_APPLESS_MAIN(TestProcessScanner)
+#include "tst_processscanner.moc"
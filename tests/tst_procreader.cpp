@@ -0,0 +1,104 @@
+// ProcFs：/proc/stat和/proc/meminfo的解析，以及Scanner的数字读取
+
+#include "Utils/ProcReader.h"
+#include <QTest>
+#include <vector>
+
+class TestProcReader : public QObject {
+    Q_OBJECT
+
+private slots:
+    void scannerReadsNumbers();
+    void cpuStat();
+    void cpuUsageAfterCoreReset();
+    void memInfo();
+    void memInfoWithoutMemAvailable();
+};
+
+void TestProcReader::scannerReadsNumbers() {
+    ProcFs::Scanner scanner("  42\t-7 x 18446744073709551615\n9");
+    quint64 unsignedValue = 0;
+    qint64 signedValue = 0;
+    QVERIFY(scanner.readUInt(unsignedValue));
+    QCOMPARE(unsignedValue, quint64(42));
+    QVERIFY(scanner.readInt(signedValue));
+    QCOMPARE(signedValue, qint64(-7));
+    QVERIFY(!scanner.readUInt(unsignedValue));   // 非数字时失败，不修改输出
+    QCOMPARE(unsignedValue, quint64(42));
+    scanner.skipFields(1);
+    QVERIFY(scanner.readUInt(unsignedValue));
+    QCOMPARE(unsignedValue, quint64(18446744073709551615ull));
+    QVERIFY(scanner.nextLine());
+    QCOMPARE(scanner.readUInt(), quint64(9));
+}
+
+void TestProcReader::cpuStat() {
+    const char* text =
+        "cpu  100 0 50 800 50 0 0 0 0 0\n"
+        "cpu0 60 0 20 400 20 0 0 0 0 0\n"
+        "cpu2 40 0 30 400 30 0 0 0 0 0\n"   // cpu1离线，不出现在文件中
+        "intr 12345 0 0\n"
+        "ctxt 999\n";
+    quint64 total = 0;
+    quint64 idle = 0;
+    std::vector<quint64> coreTotal;
+    std::vector<quint64> coreIdle;
+    QVERIFY(ProcFs::parseCpuStat(text, total, idle, coreTotal, coreIdle));
+    QCOMPARE(total, quint64(1000));
+    QCOMPARE(idle, quint64(850));       // idle + iowait
+    QCOMPARE(coreTotal.size(), size_t(3));
+    QCOMPARE(coreTotal[0], quint64(500));
+    QCOMPARE(coreIdle[0], quint64(420));
+    QCOMPARE(coreTotal[1], quint64(0));
+    QCOMPARE(coreTotal[2], quint64(500));
+    QCOMPARE(coreIdle[2], quint64(430));
+
+    QVERIFY(ProcFs::parseCpuSummary(text, total, idle));
+    QCOMPARE(total, quint64(1000));
+    QVERIFY(!ProcFs::parseCpuSummary("cpu0 1 2 3 4 5 6 7 8\n", total, idle));
+}
+
+void TestProcReader::cpuUsageAfterCoreReset() {
+    const quint64 prevTotal[] = {1000, 1000, 5000};
+    const quint64 prevIdle[] = {500, 1000, 4000};
+    const quint64 total[] = {1200, 1100, 100};      // 第3个核心下线后计数器从头开始
+    const quint64 idle[] = {550, 1100, 50};
+    float usage[3] = {};
+    ProcFs::computeCoreUsage(total, idle, prevTotal, prevIdle, usage, 3);
+    QCOMPARE(usage[0], 75.0f);
+    QCOMPARE(usage[1], 0.0f);
+    QCOMPARE(usage[2], 0.0f);
+}
+
+void TestProcReader::memInfo() {
+    const char* text =
+        "MemTotal:       16384000 kB\n"
+        "MemFree:         1000000 kB\n"
+        "MemAvailable:    8192000 kB\n"
+        "Buffers:          200000 kB\n"
+        "Cached:          4000000 kB\n";
+    quint64 totalKb = 0;
+    quint64 availableKb = 0;
+    QVERIFY(ProcFs::parseMemInfo(text, totalKb, availableKb));
+    QCOMPARE(totalKb, quint64(16384000));
+    QCOMPARE(availableKb, quint64(8192000));
+    QVERIFY(!ProcFs::parseMemInfo("MemFree: 1 kB\n", totalKb, availableKb));
+}
+
+void TestProcReader::memInfoWithoutMemAvailable() {
+    // 3.14之前的内核
+    const char* text =
+        "MemTotal:       2048000 kB\n"
+        "MemFree:         100000 kB\n"
+        "Buffers:          20000 kB\n"
+        "Cached:          300000 kB\n"
+        "SwapCached:           0 kB\n";
+    quint64 totalKb = 0;
+    quint64 availableKb = 0;
+    QVERIFY(ProcFs::parseMemInfo(text, totalKb, availableKb));
+    QCOMPARE(totalKb, quint64(2048000));
+    QCOMPARE(availableKb, quint64(420000));
+}
+
+QTEST_APPLESS_MAIN(TestProcReader)
+#include "tst_procreader.moc"
@@ -0,0 +1,287 @@
+/**
+ * @file main.cpp
+ * @brief uwidget-logdump - 二进制日志解码工具
+ * @details 把Logger以二进制格式写出的.ulog文件（包括轮转后压缩的.ulog.qz）解码为文本或JSON
+ * @version 1.0.0
+ *
+ * 用法示例：
+ * - uwidget-logdump widget_system.ulog
+ * - uwidget-logdump --json --level warning widget_system.*.ulog.qz
+ * - uwidget-logdump --category uwidget.network --since 2025-05-01T08:00:00 widget_system.ulog
+ *
+ * 多个文件按命令行顺序依次解码；过滤条件之间为“与”的关系。
+ */
+
+#include "Utils/BinaryLogFormat.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <cstdio>
+
+namespace {
+
+// 解码后的一条事件
+struct DecodedEvent {
+    qint64 timestampMs = 0;
+    int level = 0;
+    QString category;
+    quint64 threadId = 0;
+    QString widgetId;
+    QString messageTemplate;
+    QVector<BinaryLog::Arg> args;
+    QString message;
+};
+
+struct Filter {
+    int minLevel = 0;
+    QStringList categories;   // 分类名前缀，任一匹配即可
+    QString widgetId;
+    QString text;
+    qint64 sinceMs = 0;
+    qint64 untilMs = 0;
+
+    bool accepts(const DecodedEvent& event) const {
+        if (event.level < minLevel) {
+            return false;
+        }
+        if (sinceMs > 0 && event.timestampMs < sinceMs) {
+            return false;
+        }
+        if (untilMs > 0 && event.timestampMs > untilMs) {
+            return false;
+        }
+        if (!widgetId.isEmpty() && event.widgetId != widgetId) {
+            return false;
+        }
+        if (!categories.isEmpty()) {
+            bool matched = false;
+            for (const QString& category : categories) {
+                if (event.category.startsWith(category)) {
+                    matched = true;
+                    break;
+                }
+            }
+            if (!matched) {
+                return false;
+            }
+        }
+        return text.isEmpty() || event.message.contains(text, Qt::CaseInsensitive);
+    }
+};
+
+int parseLevel(const QString& name) {
+    for (int level = 0; level <= 3; ++level) {
+        if (name.compare(QLatin1String(BinaryLog::levelName(level)), Qt::CaseInsensitive) == 0) {
+            return level;
+        }
+    }
+    bool ok = false;
+    const int level = name.toInt(&ok);
+    return ok ? level : -1;
+}
+
+qint64 parseTime(const QString& text) {
+    if (text.isEmpty()) {
+        return 0;
+    }
+    QDateTime time = QDateTime::fromString(text, Qt::ISODateWithMs);
+    if (!time.isValid()) {
+        time = QDateTime::fromString(text, "yyyy-MM-dd hh:mm:ss");
+    }
+    return time.isValid() ? time.toMSecsSinceEpoch() : -1;
+}
+
+void writeLine(const QString& line) {
+    const QByteArray utf8 = line.toUtf8();
+    std::fwrite(utf8.constData(), 1, static_cast<size_t>(utf8.size()), stdout);
+    std::fputc('\n', stdout);
+}
+
+QString toText(const DecodedEvent& event) {
+    QString prefix;
+    if (!event.category.isEmpty()) {
+        prefix += QString("[%1] ").arg(event.category);
+    }
+    if (!event.widgetId.isEmpty()) {
+        prefix += QString("[%1] ").arg(event.widgetId);
+    }
+    // 与文本格式日志的行格式一致，便于沿用已有的分析脚本
+    return QString("[%1] [%2] [%3] %4%5")
+           .arg(QDateTime::fromMSecsSinceEpoch(event.timestampMs).toString("yyyy-MM-dd hh:mm:ss.zzz"))
+           .arg(QLatin1String(BinaryLog::levelName(event.level)))
+           .arg(event.threadId, 0, 16)
+           .arg(prefix)
+           .arg(event.message);
+}
+
+QString toJson(const DecodedEvent& event) {
+    QJsonObject object;
+    object["ts"] = event.timestampMs;
+    object["time"] = QDateTime::fromMSecsSinceEpoch(event.timestampMs).toString(Qt::ISODateWithMs);
+    object["level"] = QLatin1String(BinaryLog::levelName(event.level));
+    if (!event.category.isEmpty()) {
+        object["category"] = event.category;
+    }
+    object["thread"] = QString::number(event.threadId, 16);
+    if (!event.widgetId.isEmpty()) {
+        object["widget"] = event.widgetId;
+    }
+    if (!event.messageTemplate.isEmpty()) {
+        object["template"] = event.messageTemplate;
+        QJsonArray args;
+        for (const BinaryLog::Arg& arg : event.args) {
+            switch (arg.type) {
+                case BinaryLog::IntArg: args.append(static_cast<qint64>(arg.i)); break;
+                case BinaryLog::DoubleArg: args.append(arg.d); break;
+                case BinaryLog::StringArg: args.append(arg.s); break;
+            }
+        }
+        object["args"] = args;
+    }
+    object["message"] = event.message;
+    return QString::fromUtf8(QJsonDocument(object).toJson(QJsonDocument::Compact));
+}
+
+/**
+ * 解码一个文件，返回输出的事件数；文件损坏时输出已解码的部分并报告位置
+ */
+qint64 dumpFile(const QString& filePath, const Filter& filter, bool json) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        std::fprintf(stderr, "无法打开文件: %s\n", qPrintable(filePath));
+        return -1;
+    }
+    QByteArray data = file.readAll();
+    file.close();
+
+    if (filePath.endsWith(".qz")) {
+        data = qUncompress(data);
+    }
+    if (!BinaryLog::hasHeader(data)) {
+        std::fprintf(stderr, "不是二进制日志文件: %s\n", qPrintable(filePath));
+        return -1;
+    }
+    if (static_cast<quint8>(data.at(4)) > BinaryLog::kVersion) {
+        std::fprintf(stderr, "不支持的日志格式版本 %d: %s\n", static_cast<quint8>(data.at(4)), qPrintable(filePath));
+        return -1;
+    }
+
+    QHash<quint64, QString> strings;
+    BinaryLog::Reader reader(data.constData() + BinaryLog::kHeaderSize, data.size() - BinaryLog::kHeaderSize);
+    qint64 printed = 0;
+
+    while (!reader.atEnd()) {
+        const qsizetype offset = data.size() - reader.remaining();
+        const quint8 kind = reader.byte();
+        const QByteArray payload = reader.bytes(reader.varint());
+        if (!reader.ok()) {
+            std::fprintf(stderr, "%s: 偏移 %lld 处的记录不完整，停止解码\n",
+                         qPrintable(filePath), static_cast<long long>(offset));
+            break;
+        }
+
+        BinaryLog::Reader record(payload.constData(), payload.size());
+        if (kind == BinaryLog::StringDef) {
+            const quint64 id = record.varint();
+            strings.insert(id, QString::fromUtf8(record.bytes(quint64(record.remaining()))));
+            continue;
+        }
+        if (kind != BinaryLog::Event) {
+            continue;   // 未知类型，按长度跳过
+        }
+
+        DecodedEvent event;
+        event.timestampMs = static_cast<qint64>(record.varint());
+        event.level = record.byte();
+        event.category = strings.value(record.varint());
+        event.threadId = record.varint();
+        event.widgetId = strings.value(record.varint());
+        const quint64 templateId = record.varint();
+        const int argCount = record.byte();
+        for (int i = 0; i < argCount && record.ok(); ++i) {
+            event.args.append(record.arg());
+        }
+        if (!record.ok()) {
+            std::fprintf(stderr, "%s: 偏移 %lld 处的事件已损坏，跳过\n",
+                         qPrintable(filePath), static_cast<long long>(offset));
+            continue;
+        }
+
+        if (templateId != 0) {
+            event.messageTemplate = strings.value(templateId);
+            event.message = BinaryLog::formatMessage(event.messageTemplate, event.args);
+        } else if (!event.args.isEmpty()) {
+            event.message = event.args.first().toString();
+            event.args.clear();
+        }
+
+        if (filter.accepts(event)) {
+            writeLine(json ? toJson(event) : toText(event));
+            printed++;
+        }
+    }
+    return printed;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("uwidget-logdump");
+    QCoreApplication::setApplicationVersion("1.0.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("解码uWidget的二进制日志文件（.ulog / .ulog.qz）");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("files", "要解码的日志文件", "<file>...");
+
+    const QCommandLineOption jsonOption("json", "每条记录输出一行JSON");
+    const QCommandLineOption levelOption(QStringList() << "l" << "level",
+                                         "只输出不低于该级别的记录（debug/info/warning/error）", "level");
+    const QCommandLineOption categoryOption(QStringList() << "c" << "category",
+                                            "只输出该分类（前缀匹配，可重复指定）的记录", "category");
+    const QCommandLineOption widgetOption(QStringList() << "w" << "widget", "只输出该小组件的记录", "id");
+    const QCommandLineOption grepOption(QStringList() << "g" << "grep", "只输出消息包含该文本的记录", "text");
+    const QCommandLineOption sinceOption("since", "起始时间（yyyy-MM-ddThh:mm:ss）", "time");
+    const QCommandLineOption untilOption("until", "结束时间（yyyy-MM-ddThh:mm:ss）", "time");
+    parser.addOptions({jsonOption, levelOption, categoryOption, widgetOption, grepOption, sinceOption, untilOption});
+    parser.process(app);
+
+    const QStringList files = parser.positionalArguments();
+    if (files.isEmpty()) {
+        parser.showHelp(1);
+    }
+
+    Filter filter;
+    if (parser.isSet(levelOption)) {
+        filter.minLevel = parseLevel(parser.value(levelOption));
+        if (filter.minLevel < 0) {
+            std::fprintf(stderr, "未知的日志级别: %s\n", qPrintable(parser.value(levelOption)));
+            return 1;
+        }
+    }
+    filter.categories = parser.values(categoryOption);
+    filter.widgetId = parser.value(widgetOption);
+    filter.text = parser.value(grepOption);
+    filter.sinceMs = parseTime(parser.value(sinceOption));
+    filter.untilMs = parseTime(parser.value(untilOption));
+    if (filter.sinceMs < 0 || filter.untilMs < 0) {
+        std::fprintf(stderr, "无法解析时间参数\n");
+        return 1;
+    }
+
+    int failures = 0;
+    for (const QString& filePath : files) {
+        if (dumpFile(filePath, filter, parser.isSet(jsonOption)) < 0) {
+            failures++;
+        }
+    }
+    std::fflush(stdout);
+    return failures == 0 ? 0 : 2;
+}
@@ -0,0 +1,176 @@
+/**
+ * @file main.cpp
+ * @brief uwidget-procbench - Linux采样路径的微基准
+ * @details 使用监控线程的MetricsSampler，按PerformanceMonitor每次采样的方式
+ *          （复制上一份快照、采样、make_shared发布）统计预热之后各阶段的堆分配次数和耗时。
+ *          新数据写入与上一份快照共享的数组时会按写时复制分配，次数与/proc文件的大小无关；
+ *          另外单独测量写入不共享的PerformanceData时的采样，
+ *          这部分（/proc读取、解析和各采样器）分配次数不为0时返回非零退出码
+ * @version 1.1.0
+ *
+ * 用法示例：
+ * - uwidget-procbench
+ * - uwidget-procbench 100000
+ *
+ * 分配计数通过替换全局operator new和glibc的malloc系列函数实现，Qt容器的分配同样会被计入。
+ */
+
+#include "Utils/MetricsSampler.h"
+#include "Utils/PerformanceMonitor.h"
+#include "Utils/ProcReader.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+#ifdef __GLIBC__
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void __libc_free(void* ptr);
+}
+#endif
+
+namespace {
+
+std::atomic<quint64> g_allocations{0};
+
+} // namespace
+
+#ifdef __GLIBC__
+extern "C" {
+void* malloc(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr) {
+    __libc_free(ptr);
+}
+}
+#endif
+
+void* operator new(size_t size) {
+#ifndef __GLIBC__
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+#endif
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+
+// Linux上PerformanceMonitor常用的来源；进程扫描在新进程出现时分配表项，不在这里测量
+constexpr MetricSources kBenchSources = MetricSources(MetricSource::Cpu) | MetricSource::CpuCores |
+                                        MetricSource::Memory | MetricSource::Disk | MetricSource::Network;
+
+struct StageResult {
+    double totalUs = 0.0;
+    quint64 allocations = 0;
+};
+
+// 计时并统计一个阶段的堆分配次数
+template <typename Stage>
+void measure(StageResult& result, Stage&& stage) {
+    const quint64 allocationsBefore = g_allocations.load();
+    const auto start = std::chrono::steady_clock::now();
+    stage();
+    const auto end = std::chrono::steady_clock::now();
+    result.totalUs += std::chrono::duration<double, std::micro>(end - start).count();
+    result.allocations += g_allocations.load() - allocationsBefore;
+}
+
+void printStage(const char* name, const StageResult& result, long iterations) {
+    std::printf("%s\n", name);
+    std::printf("  time per sample:        %.2f us\n", result.totalUs / iterations);
+    std::printf("  allocations:            %llu\n", static_cast<unsigned long long>(result.allocations));
+    std::printf("  allocations per sample: %.4f\n", double(result.allocations) / iterations);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const long iterations = argc > 1 ? std::strtol(argv[1], nullptr, 10) : 10000;
+    if (iterations <= 0) {
+        std::fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+        return 2;
+    }
+    if (!ProcFs::ProcFile("/proc/stat").isOpen() || !ProcFs::ProcFile("/proc/meminfo").isOpen()) {
+        std::fprintf(stderr, "failed to open /proc files\n");
+        return 2;
+    }
+
+    MetricsSampler sampler;
+    PerformanceSnapshot latest = std::make_shared<const PerformanceData>();
+    double checksum = 0.0;
+
+    // 与PerformanceMonitor::collectPerformanceData相同的一次采样：复制上一份快照，
+    // 采样到期的来源，再生成新快照
+    StageResult copying;
+    StageResult sampling;
+    StageResult publishing;
+    auto tick = [&]() {
+        PerformanceData data;
+        measure(copying, [&]() {
+            data = *latest;
+            data.updatedSources = kBenchSources;
+            data.timestamp = QDateTime::currentDateTime();
+        });
+        measure(sampling, [&]() { sampler.sample(kBenchSources, data); });
+        measure(publishing, [&]() { latest = std::make_shared<const PerformanceData>(std::move(data)); });
+        checksum += latest->cpuUsage + latest->usedMemory;   // 防止编译器把采样优化掉
+    };
+
+    // 预热：读取缓冲区、采样器的接口和磁盘表在这里扩容到所需大小
+    for (int i = 0; i < 10; ++i) {
+        tick();
+    }
+    copying = StageResult();
+    sampling = StageResult();
+    publishing = StageResult();
+    for (long i = 0; i < iterations; ++i) {
+        tick();
+    }
+
+    // 读取层本身：写入不与任何快照共享的PerformanceData，稳定后不应有任何分配
+    PerformanceData owned = *latest;
+    for (int i = 0; i < 10; ++i) {
+        sampler.sample(kBenchSources, owned);
+    }
+    StageResult reading;
+    for (long i = 0; i < iterations; ++i) {
+        measure(reading, [&]() { sampler.sample(kBenchSources, owned); });
+        checksum += owned.cpuUsage;
+    }
+
+    std::printf("samples:                  %ld\n", iterations);
+    printStage("tick: copy previous snapshot:", copying, iterations);
+    printStage("tick: MetricsSampler::sample (includes copy-on-write of shared arrays):", sampling, iterations);
+    printStage("tick: publish (make_shared):", publishing, iterations);
+    printStage("MetricsSampler::sample into an unshared PerformanceData:", reading, iterations);
+    std::printf("checksum:                 %.1f\n", checksum);
+    return reading.allocations == 0 ? 0 : 1;
+}